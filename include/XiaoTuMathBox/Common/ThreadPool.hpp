@@ -0,0 +1,311 @@
+#ifndef XTMB_COMMON_THREAD_POOL_H
+#define XTMB_COMMON_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 稠密矩阵运算的并行后端
+//
+// 全局只有一个线程池, 通过 SetNumThreads() 配置线程数, 默认为硬件线程数。
+// 各个计算核心只通过 ParallelFor 使用它, 尺寸低于阈值时直接串行执行。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 乘法类运算(Gemm, Trsm)的 m*n*k 超过该值时才并行
+    constexpr long ParallelGemmSize = 128L * 128 * 128;
+    //! @brief 逐元素运算的元素数量超过该值时才并行
+    constexpr long ParallelCwiseSize = 1L << 16;
+
+    //! @brief 线程池
+    //!
+    //! 只提供 ParallelFor 一种用法: 把 [0, n) 个任务块分给调用线程和各个工作线程一起执行。
+    //! 每个参与者先分到一段连续的任务块, 从前往后领取; 做完自己的一段之后,
+    //! 再从其它参与者那一段的末尾窃取, 直到所有任务块都被领走。
+    //! 同一时刻只执行一个 ParallelFor, 嵌套调用或者其它线程同时调用时退化为串行。
+    class ThreadPool {
+        public:
+            static ThreadPool & Instance()
+            {
+                static ThreadPool pool;
+                return pool;
+            }
+
+            ~ThreadPool()
+            {
+                Stop();
+            }
+
+            //! @brief 设置参与计算的线程数, 包括调用线程, 不能在并行区域内调用
+            void SetNumThreads(int n)
+            {
+                std::lock_guard<std::mutex> run(mRunMutex);
+                n = std::max(1, n);
+                if (n == mNumThreads)
+                    return;
+                Stop();
+                mNumThreads = n;
+            }
+
+            int NumThreads() const { return mNumThreads; }
+
+            //! @brief 当前线程是否正在执行某个 ParallelFor 的任务
+            static bool & InParallel()
+            {
+                static thread_local bool flag = false;
+                return flag;
+            }
+
+            //! @brief 并行执行 func(i), i = 0, 1, ..., n-1, 各个 i 的执行顺序不确定
+            //!
+            //! 任务中抛出的异常会在所有任务结束后, 在调用线程中重新抛出
+            template <typename Func>
+            void ParallelFor(int n, Func && func)
+            {
+                if (n <= 0)
+                    return;
+
+                std::unique_lock<std::mutex> run(mRunMutex, std::defer_lock);
+                if (1 == n || mNumThreads <= 1 || InParallel() || !run.try_lock()) {
+                    for (int i = 0; i < n; ++i)
+                        func(i);
+                    return;
+                }
+                // 持有 mRunMutex 期间线程数不会改变
+                int nt = mNumThreads;
+                Start(nt);
+
+                Job job;
+                job.func = [&func](int i) { func(i); };
+                job.np = std::min(nt, n);
+                job.ranges = mRanges.get();
+                for (int p = 0; p < job.np; ++p)
+                    job.ranges[p].Reset((long)n * p / job.np, (long)n * (p + 1) / job.np);
+                job.active = job.np - 1;
+
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mJob = &job;
+                    mGeneration++;
+                }
+                mCond.notify_all();
+
+                Work(job, 0);
+
+                {
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    mDone.wait(lock, [&job]() { return 0 == job.active; });
+                    mJob = nullptr;
+                }
+
+                if (job.error)
+                    std::rethrow_exception(job.error);
+            }
+
+        private:
+            //! @brief 一个参与者待领取的任务块 [lo, hi), 两端打包在一个 64 位原子量里
+            struct Range {
+                std::atomic<uint64_t> v{0};
+
+                void Reset(uint32_t lo, uint32_t hi)
+                {
+                    v.store((uint64_t(hi) << 32) | lo);
+                }
+
+                //! @brief 自己从前往后领取, 没有剩余时返回 -1
+                int PopFront()
+                {
+                    uint64_t old = v.load();
+                    while (true) {
+                        uint32_t lo = uint32_t(old);
+                        uint32_t hi = uint32_t(old >> 32);
+                        if (lo >= hi)
+                            return -1;
+                        if (v.compare_exchange_weak(old, (uint64_t(hi) << 32) | (lo + 1)))
+                            return lo;
+                    }
+                }
+
+                //! @brief 其它参与者从后往前窃取, 没有剩余时返回 -1
+                int PopBack()
+                {
+                    uint64_t old = v.load();
+                    while (true) {
+                        uint32_t lo = uint32_t(old);
+                        uint32_t hi = uint32_t(old >> 32);
+                        if (lo >= hi)
+                            return -1;
+                        if (v.compare_exchange_weak(old, (uint64_t(hi - 1) << 32) | lo))
+                            return hi - 1;
+                    }
+                }
+            };
+
+            struct Job {
+                std::function<void(int)> func;
+                int np = 0;
+                Range * ranges = nullptr;
+                //! @brief 尚未结束的工作线程数, 由 mMutex 保护
+                int active = 0;
+                std::once_flag errorOnce;
+                std::exception_ptr error;
+            };
+
+            ThreadPool()
+                : mNumThreads(std::max(1, (int)std::thread::hardware_concurrency()))
+            {}
+
+            ThreadPool(ThreadPool const &) = delete;
+            ThreadPool & operator = (ThreadPool const &) = delete;
+
+            //! @brief 按需创建工作线程和各个参与者的任务区间, nt 为参与计算的线程数
+            void Start(int nt)
+            {
+                if (!mWorkers.empty())
+                    return;
+                mRanges.reset(new Range[nt]);
+                for (int i = 1; i < nt; ++i)
+                    mWorkers.emplace_back([this, i]() { Loop(i); });
+            }
+
+            void Stop()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mStop = true;
+                }
+                mCond.notify_all();
+                for (auto & t : mWorkers)
+                    t.join();
+                mWorkers.clear();
+                mStop = false;
+            }
+
+            void Loop(int id)
+            {
+                InParallel() = true;
+                uint64_t seen = 0;
+                while (true) {
+                    Job * job = nullptr;
+                    {
+                        std::unique_lock<std::mutex> lock(mMutex);
+                        mCond.wait(lock, [&]() { return mStop || seen != mGeneration; });
+                        if (mStop)
+                            return;
+                        seen = mGeneration;
+                        job = mJob;
+                    }
+
+                    if (nullptr == job || id >= job->np)
+                        continue;
+
+                    Work(*job, id);
+
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    if (0 == --job->active)
+                        mDone.notify_all();
+                }
+            }
+
+            //! @brief 先领取自己的任务块, 再依次窃取其它参与者的
+            static void Work(Job & job, int id)
+            {
+                bool & flag = InParallel();
+                bool saved = flag;
+                flag = true;
+                try {
+                    int i;
+                    while ((i = job.ranges[id].PopFront()) >= 0)
+                        job.func(i);
+                    for (int k = 1; k < job.np; ++k) {
+                        Range & victim = job.ranges[(id + k) % job.np];
+                        while ((i = victim.PopBack()) >= 0)
+                            job.func(i);
+                    }
+                } catch (...) {
+                    std::call_once(job.errorOnce, [&job]() { job.error = std::current_exception(); });
+                    // 丢弃剩余的任务块
+                    for (int p = 0; p < job.np; ++p)
+                        job.ranges[p].Reset(0, 0);
+                }
+                flag = saved;
+            }
+
+        private:
+            //! @brief 只在持有 mRunMutex 时修改, 其它线程可以随时读取
+            std::atomic<int> mNumThreads;
+            std::vector<std::thread> mWorkers;
+            //! @brief 各个参与者的任务区间, 随工作线程一起创建, 每次 ParallelFor 复用
+            std::unique_ptr<Range[]> mRanges;
+
+            //! @brief 保证同一时刻只有一个 ParallelFor
+            std::mutex mRunMutex;
+            std::mutex mMutex;
+            std::condition_variable mCond;
+            std::condition_variable mDone;
+            Job * mJob = nullptr;
+            uint64_t mGeneration = 0;
+            bool mStop = false;
+    };
+
+    //! @brief 设置并行计算的线程数, 1 表示完全串行
+    inline void SetNumThreads(int n)
+    {
+        ThreadPool::Instance().SetNumThreads(n);
+    }
+
+    //! @brief 获取并行计算的线程数
+    inline int GetNumThreads()
+    {
+        return ThreadPool::Instance().NumThreads();
+    }
+
+    //! @brief 当前是否值得开启并行, 即线程数大于 1 且不在并行区域内
+    inline bool ParallelEnabled()
+    {
+        return GetNumThreads() > 1 && !ThreadPool::InParallel();
+    }
+
+    //! @brief 并行时每个任务块的大小
+    //!
+    //! 大约切成线程数的 4 倍个任务块, 以便窃取时平衡负载
+    //!
+    //! @param [in] n 总的尺寸
+    //! @param [in] align 任务块大小需要对齐的倍数
+    //! @param [in] min_grain 任务块的最小尺寸
+    inline int ParallelGrain(int n, int align, int min_grain)
+    {
+        int chunks = 4 * GetNumThreads();
+        int grain = (n + chunks - 1) / chunks;
+        grain = std::max(grain, min_grain);
+        return (grain + align - 1) / align * align;
+    }
+
+    //! @brief 把 [begin, end) 按 grain 切块, 并行执行 func(b, e)
+    template <typename Func>
+    void ParallelFor(int begin, int end, int grain, Func && func)
+    {
+        int n = end - begin;
+        if (n <= 0)
+            return;
+        grain = std::max(1, grain);
+        int chunks = (n + grain - 1) / grain;
+        ThreadPool::Instance().ParallelFor(chunks, [&](int i) {
+            int b = begin + i * grain;
+            func(b, std::min(end, b + grain));
+        });
+    }
+
+}
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef XTMB_COMMON_WORKSPACE_H
+#define XTMB_COMMON_WORKSPACE_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 计算核心的临时内存
+//
+// Gemm 的打包缓存、分块反射的中间矩阵等临时数组都从 Workspace 中按栈的方式申请和释放,
+// 不再每次调用都 new/delete。每个线程有一个默认的 Workspace, 调用者也可以通过
+// WorkspaceGuard 把自己预先分配好的 Workspace 绑定到当前线程。
+//
+// 容量不足时临时向堆申请, 同时记录峰值用量; 所有申请都释放以后, 一次性把容量扩到峰值。
+// 所以同样尺寸的问题只有第一次调用会申请内存, 之后的调用不再有堆分配。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 按栈的方式分配临时数组的内存池
+    //!
+    //! 只分配平凡类型的数组, 不调用构造和析构函数。
+    //! 通过 Mark() 记录栈顶, Release() 一次性释放之后申请的所有数组, 一般通过 WorkspaceFrame 使用。
+    class Workspace {
+        public:
+            //! @brief 每个数组的首地址按 64 字节对齐
+            constexpr static std::size_t Alignment = 64;
+
+            Workspace() {}
+
+            //! @brief 构造函数
+            //!
+            //! @param [in] bytes 预先分配的字节数
+            explicit Workspace(std::size_t bytes)
+            {
+                Reserve(bytes);
+            }
+
+            Workspace(Workspace const &) = delete;
+            Workspace & operator = (Workspace const &) = delete;
+
+            //! @brief 预留至少 bytes 字节的容量, 只能在没有未释放的数组时调用
+            void Reserve(std::size_t bytes)
+            {
+                assert(0 == mUsed);
+                bytes = RoundUp(bytes);
+                if (bytes <= mCapacity)
+                    return;
+                mBuffer.reset(new unsigned char[bytes + Alignment]);
+                std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(mBuffer.get());
+                mBase = mBuffer.get() + (RoundUp(addr) - addr);
+                mCapacity = bytes;
+            }
+
+            //! @brief 申请 n 个元素的数组, 内容未初始化
+            template <typename T>
+            T * Alloc(std::size_t n)
+            {
+                static_assert(std::is_trivially_destructible<T>::value, "Workspace 只分配平凡类型");
+                std::size_t bytes = RoundUp(n * sizeof(T));
+                std::size_t offset = mUsed;
+                mUsed += bytes;
+                if (mUsed > mPeak)
+                    mPeak = mUsed;
+
+                if (mUsed <= mCapacity)
+                    return reinterpret_cast<T *>(mBase + offset);
+
+                // 容量不足, 临时向堆申请, 释放到 offset 以下时归还
+                Overflow of;
+                of.offset = offset;
+                of.buffer.reset(new unsigned char[bytes + Alignment]);
+                std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(of.buffer.get());
+                unsigned char * p = of.buffer.get() + (RoundUp(addr) - addr);
+                mOverflow.push_back(std::move(of));
+                return reinterpret_cast<T *>(p);
+            }
+
+            //! @brief 当前的栈顶
+            std::size_t Mark() const { return mUsed; }
+
+            //! @brief 释放 mark 之后申请的所有数组
+            //!
+            //! 全部释放时, 若峰值超过了容量, 就把容量扩到峰值
+            void Release(std::size_t mark)
+            {
+                assert(mark <= mUsed);
+                mUsed = mark;
+                while (!mOverflow.empty() && mOverflow.back().offset >= mark)
+                    mOverflow.pop_back();
+                if (0 == mUsed && mPeak > mCapacity)
+                    Reserve(mPeak);
+            }
+
+            //! @brief 容量, 字节
+            std::size_t Capacity() const { return mCapacity; }
+            //! @brief 正在使用的字节数
+            std::size_t Used() const { return mUsed; }
+            //! @brief 历史峰值, 字节
+            std::size_t Peak() const { return mPeak; }
+
+        private:
+            static std::size_t RoundUp(std::size_t bytes)
+            {
+                return (bytes + Alignment - 1) / Alignment * Alignment;
+            }
+
+            //! @brief 容量不足时临时申请的内存
+            struct Overflow {
+                std::size_t offset;
+                std::unique_ptr<unsigned char[]> buffer;
+            };
+
+            std::unique_ptr<unsigned char[]> mBuffer;
+            unsigned char * mBase = nullptr;
+            std::size_t mCapacity = 0;
+            std::size_t mUsed = 0;
+            std::size_t mPeak = 0;
+            std::vector<Overflow> mOverflow;
+    };
+
+    //! @brief 当前线程绑定的 Workspace 指针, nullptr 表示使用线程默认的
+    inline Workspace *& BoundWorkspace()
+    {
+        static thread_local Workspace * ws = nullptr;
+        return ws;
+    }
+
+    //! @brief 当前线程使用的 Workspace
+    //!
+    //! 没有通过 WorkspaceGuard 绑定时, 返回线程自己的默认 Workspace。
+    //! 线程池的工作线程一直存在, 它们的默认 Workspace 也一样可以复用。
+    inline Workspace & CurrentWorkspace()
+    {
+        static thread_local Workspace local;
+        Workspace * ws = BoundWorkspace();
+        return (nullptr != ws) ? *ws : local;
+    }
+
+    //! @brief 在作用域内把 ws 绑定到当前线程, 之后的分解和计算核心都从 ws 中申请临时内存
+    //!
+    //! 只影响当前线程, 并行区域里其它线程使用各自默认的 Workspace。
+    //!
+    //!     Workspace ws(1 << 20);
+    //!     LU<DMatrix<double>> lu;
+    //!     while (running) {
+    //!         WorkspaceGuard guard(ws);
+    //!         lu.Decompose(A);
+    //!         lu.Solve(b, x);
+    //!     }
+    class WorkspaceGuard {
+        public:
+            explicit WorkspaceGuard(Workspace & ws)
+                : mPrev(BoundWorkspace())
+            {
+                BoundWorkspace() = &ws;
+            }
+
+            ~WorkspaceGuard()
+            {
+                BoundWorkspace() = mPrev;
+            }
+
+            WorkspaceGuard(WorkspaceGuard const &) = delete;
+            WorkspaceGuard & operator = (WorkspaceGuard const &) = delete;
+
+        private:
+            Workspace * mPrev;
+    };
+
+    //! @brief 临时数组的作用域, 析构时释放在其中申请的所有数组
+    class WorkspaceFrame {
+        public:
+            explicit WorkspaceFrame(Workspace & ws = CurrentWorkspace())
+                : mWorkspace(ws), mMark(ws.Mark())
+            {}
+
+            ~WorkspaceFrame()
+            {
+                mWorkspace.Release(mMark);
+            }
+
+            WorkspaceFrame(WorkspaceFrame const &) = delete;
+            WorkspaceFrame & operator = (WorkspaceFrame const &) = delete;
+
+            //! @brief 申请 n 个元素的数组, 内容未初始化
+            template <typename T>
+            T * Alloc(std::size_t n)
+            {
+                return mWorkspace.template Alloc<T>(n);
+            }
+
+        private:
+            Workspace & mWorkspace;
+            std::size_t mMark;
+    };
+
+}
+
+#endif
@@ -0,0 +1,468 @@
+#ifndef XTMB_LA_BATCHED_H
+#define XTMB_LA_BATCHED_H
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include <XiaoTuMathBox/Common/ThreadPool.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/Simd.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 大批量定长小矩阵的分解和求解
+//
+// 成千上万个相互独立的 3x3, 4x4, 6x6 方程组, 逐个构造 LU/Cholesky 对象时堆分配和分支判断的开销
+// 远大于计算本身。这里把它们按 SoA(structure of arrays) 的方式交错存放: 64 字节能装下几个元素就几个问题为一组,
+// 组内同一位置的元素连续存放, 一个向量寄存器装下多个问题的同一个元素, 对各个问题的计算即是对寄存器的计算。
+// 选主元、判断奇异等逐问题的分支都改写成按通道的选择。
+//
+// 计算核心与 Simd.hpp 一样通过 SimdRun 在运行时选择指令集, 各组之间通过 ParallelFor 并行。
+//
+/////////////////////////////////////////////////////////////////////////
+
+// 与 Simd.hpp 相同, 向量类型只以引用传递
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace xiaotu {
+
+    //! @brief 交错存放的一批定长矩阵
+    //!
+    //! 按 Lanes 个矩阵分组, 第 b 个矩阵的元素 (r, c) 位于第 b / Lanes 组,
+    //! 组内偏移为 ((r + c * Rows) * Lanes + b % Lanes), 即列优先的元素索引乘以通道数。
+    //! Lanes 取 64 字节能装下的元素个数, 对所有的 SIMD 级别都是向量宽度的整数倍。
+    //! 最后一组不满时, 多出来的通道填 0, 计算结果忽略。
+    template <typename T, int numRows, int numCols>
+    class BatchedMatrix {
+        public:
+            typedef T Scalar;
+            constexpr static int NumRows = numRows;
+            constexpr static int NumCols = numCols;
+            //! @brief 每组的矩阵数量
+            constexpr static int Lanes = 64 / sizeof(T);
+            //! @brief 每个矩阵的元素数量
+            constexpr static int Size = numRows * numCols;
+
+            BatchedMatrix() {}
+
+            //! @brief 构造函数
+            //!
+            //! @param [in] count 矩阵数量
+            explicit BatchedMatrix(int count)
+            {
+                Resize(count);
+            }
+
+            //! @brief 修改矩阵数量, 所有元素清零
+            BatchedMatrix & Resize(int count)
+            {
+                mCount = count;
+                mData.assign((long)NumPacks() * Size * Lanes, Scalar(0));
+                return *this;
+            }
+
+            //! @brief 矩阵数量
+            int Count() const { return mCount; }
+            //! @brief 分组数量
+            int NumPacks() const { return (mCount + Lanes - 1) / Lanes; }
+
+            //! @brief 第 b 个矩阵的元素 (r, c)
+            Scalar & At(int b, int r, int c)
+            {
+                assert(b < mCount && r < numRows && c < numCols);
+                return mData[((long)(b / Lanes) * Size + r + c * numRows) * Lanes + b % Lanes];
+            }
+
+            Scalar const & At(int b, int r, int c) const
+            {
+                assert(b < mCount && r < numRows && c < numCols);
+                return mData[((long)(b / Lanes) * Size + r + c * numRows) * Lanes + b % Lanes];
+            }
+
+            //! @brief 写入第 b 个矩阵
+            template <typename M>
+            void Set(int b, M const & m)
+            {
+                assert(m.Rows() == numRows && m.Cols() == numCols);
+                for (int c = 0; c < numCols; ++c)
+                    for (int r = 0; r < numRows; ++r)
+                        At(b, r, c) = m(r, c);
+            }
+
+            //! @brief 读出第 b 个矩阵
+            AMatrix<Scalar, numRows, numCols> Get(int b) const
+            {
+                AMatrix<Scalar, numRows, numCols> re;
+                for (int c = 0; c < numCols; ++c)
+                    for (int r = 0; r < numRows; ++r)
+                        re(r, c) = At(b, r, c);
+                return re;
+            }
+
+            //! @brief 第 p 组的起始地址
+            Scalar * Pack(int p) { return mData.data() + (long)p * Size * Lanes; }
+            Scalar const * Pack(int p) const { return mData.data() + (long)p * Size * Lanes; }
+
+        private:
+            int mCount = 0;
+            std::vector<Scalar> mData;
+    };
+
+    //! @brief 一个向量宽度上的批量分解核心, 每个通道是一个独立的问题
+    //!
+    //! 矩阵先整个载入到寄存器数组里, N 是编译期常量, 循环全部展开。
+    //! 各函数的参数 a, b 为一组中某个向量宽度的起始地址, 第 k 个元素位于 a[k * L]。
+    template <typename Scalar, int N, int Bytes>
+    struct BatchedKernel {
+        typedef SimdKernel<Scalar, Bytes> K;
+        typedef typename K::V V;
+        typedef decltype(V{} < V{}) Mask;
+        constexpr static int W = K::W;
+
+        static XTMB_ALWAYS_INLINE void Load(Scalar const * a, int L, V * m, int n)
+        {
+            // 经由局部变量载入, 直接 memcpy 到数组元素时 AVX2 下的代码明显变慢
+            for (int k = 0; k < n; ++k) {
+                V v;
+                K::Load(v, a + k * L);
+                m[k] = v;
+            }
+        }
+
+        static XTMB_ALWAYS_INLINE void Store(Scalar * a, int L, V const * m, int n)
+        {
+            for (int k = 0; k < n; ++k)
+                K::Store(a + k * L, m[k]);
+        }
+
+        //! @brief v = sqrt(v)
+        static XTMB_ALWAYS_INLINE void Sqrt(V & v)
+        {
+            for (int l = 0; l < W; ++l)
+                v[l] = std::sqrt(v[l]);
+        }
+
+        //! @brief 掩码中属于有效通道的个数, valid 为该向量中有效的通道数
+        static XTMB_ALWAYS_INLINE int CountFails(Mask const & fail, int valid)
+        {
+            int n = 0;
+            for (int l = 0; l < W && l < valid; ++l)
+                n += (0 != fail[l]);
+            return n;
+        }
+
+        //! @brief 列主元 LU 分解, 输出格式与 LU 类相同, piv[j] 为第 j 步与第 j 行交换的行索引
+        //! @return 有效通道中主元过小的个数
+        static XTMB_ALWAYS_INLINE int LU(Scalar * a, Scalar * piv, int L, int valid)
+        {
+            V m[N * N];
+            Load(a, L, m, N * N);
+            Mask fail = {};
+            for (int j = 0; j < N; ++j) {
+                V maxv = m[j + j * N];
+                K::Abs(maxv);
+                V p = V{} + Scalar(j);
+                for (int i = j + 1; i < N; ++i) {
+                    V t = m[i + j * N];
+                    K::Abs(t);
+                    Mask gt = t > maxv;
+                    maxv = gt ? t : maxv;
+                    p = gt ? (V{} + Scalar(i)) : p;
+                }
+                fail |= maxv < (V{} + Scalar(SMALL_VALUE));
+                K::Store(piv + j * L, p);
+
+                // 各通道交换的行不同, 逐行按掩码选择
+                for (int i = j + 1; i < N; ++i) {
+                    Mask sw = p == (V{} + Scalar(i));
+                    for (int c = 0; c < N; ++c) {
+                        V x = m[j + c * N];
+                        V y = m[i + c * N];
+                        m[j + c * N] = sw ? y : x;
+                        m[i + c * N] = sw ? x : y;
+                    }
+                }
+
+                V inv = 1 / m[j + j * N];
+                for (int i = j + 1; i < N; ++i)
+                    m[i + j * N] *= inv;
+                for (int c = j + 1; c < N; ++c) {
+                    V u = m[j + c * N];
+                    for (int i = j + 1; i < N; ++i)
+                        m[i + c * N] -= m[i + j * N] * u;
+                }
+            }
+            Store(a, L, m, N * N);
+            return CountFails(fail, valid);
+        }
+
+        //! @brief 用 LU 的分解结果原位求解 B 的 nrhs 列
+        static XTMB_ALWAYS_INLINE void LUSolve(Scalar const * a, Scalar const * piv, int L,
+                                               Scalar * b, int nrhs)
+        {
+            V m[N * N];
+            V p[N];
+            Load(a, L, m, N * N);
+            Load(piv, L, p, N);
+            for (int k = 0; k < nrhs; ++k) {
+                V x[N];
+                Load(b + k * N * L, L, x, N);
+                for (int j = 0; j < N; ++j) {
+                    for (int i = j + 1; i < N; ++i) {
+                        Mask sw = p[j] == (V{} + Scalar(i));
+                        V xj = x[j];
+                        x[j] = sw ? x[i] : xj;
+                        x[i] = sw ? xj : x[i];
+                    }
+                }
+                for (int j = 0; j < N; ++j)
+                    for (int i = j + 1; i < N; ++i)
+                        x[i] -= m[i + j * N] * x[j];
+                for (int j = N - 1; j >= 0; --j) {
+                    x[j] /= m[j + j * N];
+                    for (int i = 0; i < j; ++i)
+                        x[i] -= m[i + j * N] * x[j];
+                }
+                Store(b + k * N * L, L, x, N);
+            }
+        }
+
+        //! @brief Cholesky 分解, 输出时下三角为 L, 上三角置 0
+        //! @return 有效通道中非正定的个数
+        static XTMB_ALWAYS_INLINE int Cholesky(Scalar * a, int L, int valid)
+        {
+            V m[N * N];
+            Load(a, L, m, N * N);
+            Mask fail = {};
+            for (int j = 0; j < N; ++j) {
+                V d = m[j + j * N];
+                fail |= d <= V{};
+                Sqrt(d);
+                m[j + j * N] = d;
+
+                V inv = 1 / d;
+                for (int i = j + 1; i < N; ++i)
+                    m[i + j * N] *= inv;
+                for (int c = j + 1; c < N; ++c) {
+                    V l = m[c + j * N];
+                    for (int i = c; i < N; ++i)
+                        m[i + c * N] -= m[i + j * N] * l;
+                    m[j + c * N] = V{};
+                }
+            }
+            Store(a, L, m, N * N);
+            return CountFails(fail, valid);
+        }
+
+        //! @brief 用 Cholesky 的分解结果原位求解 B 的 nrhs 列
+        static XTMB_ALWAYS_INLINE void CholeskySolve(Scalar const * a, int L, Scalar * b, int nrhs)
+        {
+            V m[N * N];
+            Load(a, L, m, N * N);
+            for (int k = 0; k < nrhs; ++k) {
+                V x[N];
+                Load(b + k * N * L, L, x, N);
+                for (int j = 0; j < N; ++j) {
+                    x[j] /= m[j + j * N];
+                    for (int i = j + 1; i < N; ++i)
+                        x[i] -= m[i + j * N] * x[j];
+                }
+                for (int j = N - 1; j >= 0; --j) {
+                    for (int i = j + 1; i < N; ++i)
+                        x[j] -= m[i + j * N] * x[i];
+                    x[j] /= m[j + j * N];
+                }
+                Store(b + k * N * L, L, x, N);
+            }
+        }
+
+        //! @brief LDLT 分解, 输出时严格下三角为单位下三角阵 L 的对应部分, 对角线为 D, 上三角置 0
+        //! @return 有效通道中非正定的个数
+        static XTMB_ALWAYS_INLINE int LDLT(Scalar * a, int L, int valid)
+        {
+            V m[N * N];
+            Load(a, L, m, N * N);
+            Mask fail = {};
+            for (int j = 0; j < N; ++j) {
+                V d = m[j + j * N];
+                fail |= d <= V{};
+                V inv = 1 / d;
+                for (int c = j + 1; c < N; ++c) {
+                    V l = m[c + j * N] * inv;
+                    for (int i = c; i < N; ++i)
+                        m[i + c * N] -= m[i + j * N] * l;
+                    m[j + c * N] = V{};
+                }
+                for (int i = j + 1; i < N; ++i)
+                    m[i + j * N] *= inv;
+            }
+            Store(a, L, m, N * N);
+            return CountFails(fail, valid);
+        }
+
+        //! @brief 用 LDLT 的分解结果原位求解 B 的 nrhs 列
+        static XTMB_ALWAYS_INLINE void LDLTSolve(Scalar const * a, int L, Scalar * b, int nrhs)
+        {
+            V m[N * N];
+            Load(a, L, m, N * N);
+            for (int k = 0; k < nrhs; ++k) {
+                V x[N];
+                Load(b + k * N * L, L, x, N);
+                for (int j = 0; j < N; ++j)
+                    for (int i = j + 1; i < N; ++i)
+                        x[i] -= m[i + j * N] * x[j];
+                for (int j = 0; j < N; ++j)
+                    x[j] /= m[j + j * N];
+                for (int j = N - 1; j >= 0; --j)
+                    for (int i = j + 1; i < N; ++i)
+                        x[j] -= m[i + j * N] * x[i];
+                Store(b + k * N * L, L, x, N);
+            }
+        }
+    };
+
+    //! @brief 批量计算的类型
+    enum class EBatchedOp {
+        eLU,
+        eLUSolve,
+        eCholesky,
+        eCholeskySolve,
+        eLDLT,
+        eLDLTSolve
+    };
+
+    //! @brief 对 [begin, end) 组执行批量计算, 交给 SimdRun 按指令集分派
+    template <typename _Scalar, int N, EBatchedOp Op>
+    struct BatchedTask {
+        typedef _Scalar Scalar;
+        constexpr static int L = 64 / sizeof(Scalar);
+
+        int begin;
+        int end;
+        //! @brief 有效的矩阵数量, 用于忽略最后一组中填充的通道
+        int count;
+        Scalar * a;
+        Scalar * piv;
+        Scalar * b;
+        int nrhs;
+        int fails;
+
+        template <int Bytes>
+        XTMB_ALWAYS_INLINE void Run()
+        {
+            typedef BatchedKernel<Scalar, N, Bytes> BK;
+            constexpr int W = BK::W;
+            fails = 0;
+            for (int p = begin; p < end; ++p) {
+                Scalar * ap = a + (long)p * N * N * L;
+                Scalar * pp = (nullptr == piv) ? nullptr : piv + (long)p * N * L;
+                Scalar * bp = (nullptr == b) ? nullptr : b + (long)p * N * nrhs * L;
+                for (int s = 0; s < L; s += W) {
+                    int valid = count - p * L - s;
+                    if constexpr (EBatchedOp::eLU == Op)
+                        fails += BK::LU(ap + s, pp + s, L, valid);
+                    else if constexpr (EBatchedOp::eLUSolve == Op)
+                        BK::LUSolve(ap + s, pp + s, L, bp + s, nrhs);
+                    else if constexpr (EBatchedOp::eCholesky == Op)
+                        fails += BK::Cholesky(ap + s, L, valid);
+                    else if constexpr (EBatchedOp::eCholeskySolve == Op)
+                        BK::CholeskySolve(ap + s, L, bp + s, nrhs);
+                    else if constexpr (EBatchedOp::eLDLT == Op)
+                        fails += BK::LDLT(ap + s, L, valid);
+                    else
+                        BK::LDLTSolve(ap + s, L, bp + s, nrhs);
+                }
+            }
+        }
+    };
+
+    //! @brief 把各组分给线程池, 每个任务块内按当前的 SIMD 级别执行
+    //! @return 分解失败的矩阵数量
+    template <EBatchedOp Op, typename Scalar, int N>
+    int BatchedRun(int count, Scalar * a, Scalar * piv, Scalar * b, int nrhs)
+    {
+        constexpr int L = 64 / sizeof(Scalar);
+        int npacks = (count + L - 1) / L;
+        std::atomic<int> fails{0};
+        // 每组 N^3 L 次乘加左右, 任务块至少包含 64 组
+        ParallelFor(0, npacks, ParallelGrain(npacks, 1, 64), [&](int pb, int pe) {
+            BatchedTask<Scalar, N, Op> task{ pb, pe, count, a, piv, b, nrhs, 0 };
+            SimdRun(task);
+            fails.fetch_add(task.fails);
+        });
+        return fails.load();
+    }
+
+    //! @brief 批量的列主元 LU 分解, 原位计算
+    //!
+    //! 每个矩阵的结果与 LU 类相同: 上三角为 U, 严格下三角为 L 的对应部分。
+    //!
+    //! @param [in|out] A 一批 N x N 矩阵, 输出分解结果
+    //! @param [out] piv 行交换索引, 第 j 个元素为第 j 步与第 j 行交换的行
+    //! @return 奇异矩阵的数量, 它们的分解结果和解没有意义
+    template <typename Scalar, int N>
+    int BatchedLU(BatchedMatrix<Scalar, N, N> & A, BatchedMatrix<Scalar, N, 1> & piv)
+    {
+        if (piv.Count() != A.Count())
+            piv.Resize(A.Count());
+        return BatchedRun<EBatchedOp::eLU, Scalar, N>(A.Count(), A.Pack(0), piv.Pack(0), nullptr, 0);
+    }
+
+    //! @brief 用 BatchedLU 的结果原位求解 A_i X_i = B_i
+    //!
+    //! @param [in] LU, piv BatchedLU 的输出
+    //! @param [in|out] B 方程右侧, 输出解
+    template <typename Scalar, int N, int K>
+    void BatchedLUSolve(BatchedMatrix<Scalar, N, N> const & LU, BatchedMatrix<Scalar, N, 1> const & piv,
+                        BatchedMatrix<Scalar, N, K> & B)
+    {
+        assert(LU.Count() == B.Count() && piv.Count() == B.Count());
+        BatchedRun<EBatchedOp::eLUSolve, Scalar, N>(B.Count(), const_cast<Scalar *>(LU.Pack(0)),
+                                                     const_cast<Scalar *>(piv.Pack(0)), B.Pack(0), K);
+    }
+
+    //! @brief 批量的 Cholesky 分解, 原位计算, 输出时下三角为 L, 上三角为 0
+    //!
+    //! @return 非正定矩阵的数量, 它们的分解结果和解没有意义
+    template <typename Scalar, int N>
+    int BatchedCholesky(BatchedMatrix<Scalar, N, N> & A)
+    {
+        return BatchedRun<EBatchedOp::eCholesky, Scalar, N>(A.Count(), A.Pack(0), nullptr, nullptr, 0);
+    }
+
+    //! @brief 用 BatchedCholesky 的结果原位求解 A_i X_i = B_i
+    template <typename Scalar, int N, int K>
+    void BatchedCholeskySolve(BatchedMatrix<Scalar, N, N> const & L, BatchedMatrix<Scalar, N, K> & B)
+    {
+        assert(L.Count() == B.Count());
+        BatchedRun<EBatchedOp::eCholeskySolve, Scalar, N>(B.Count(), const_cast<Scalar *>(L.Pack(0)),
+                                                          nullptr, B.Pack(0), K);
+    }
+
+    //! @brief 批量的 LDLT 分解, 原位计算
+    //!
+    //! 输出时严格下三角为单位下三角阵 L 的对应部分, 对角线为 D, 上三角为 0。
+    //!
+    //! @return 非正定矩阵的数量, 它们的分解结果和解没有意义
+    template <typename Scalar, int N>
+    int BatchedLDLT(BatchedMatrix<Scalar, N, N> & A)
+    {
+        return BatchedRun<EBatchedOp::eLDLT, Scalar, N>(A.Count(), A.Pack(0), nullptr, nullptr, 0);
+    }
+
+    //! @brief 用 BatchedLDLT 的结果原位求解 A_i X_i = B_i
+    template <typename Scalar, int N, int K>
+    void BatchedLDLTSolve(BatchedMatrix<Scalar, N, N> const & LD, BatchedMatrix<Scalar, N, K> & B)
+    {
+        assert(LD.Count() == B.Count());
+        BatchedRun<EBatchedOp::eLDLTSolve, Scalar, N>(B.Count(), const_cast<Scalar *>(LD.Pack(0)),
+                                                      nullptr, B.Pack(0), K);
+    }
+
+}
+
+#pragma GCC diagnostic pop
+
+#endif
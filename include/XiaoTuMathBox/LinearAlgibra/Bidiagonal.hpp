@@ -25,10 +25,21 @@ namespace xiaotu {
              * @param [in] A 待二教化的矩阵
              */
             Bidiagonal(MatViewIn const & A)
-                : mB(A.Rows(), A.Cols()),
-                  mUT(A.Rows(), A.Rows()),
-                  mV(A.Cols(), A.Cols())
             {
+                Decompose(A);
+            }
+
+            /**
+             * @brief 二对角化, 尺寸与上次相同时复用已有的矩阵, 不再申请内存
+             * 
+             * @param [in] A 待二教化的矩阵
+             */
+            void Decompose(MatViewIn const & A)
+            {
+                mB.Resize(A.Rows(), A.Cols());
+                mUT.Resize(A.Rows(), A.Rows());
+                mV.Resize(A.Cols(), A.Cols());
+
                 mB = A;
                 mUT.Identity();
                 mV.Identity();
@@ -5,9 +5,78 @@
 #include <vector>
 #include <cmath>
 #include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+
+#include <XiaoTuMathBox/LinearAlgibra/Trsm.hpp>
 
 namespace xiaotu {
 
+    //! @brief 不分块的 Cholesky 分解, 用于分块算法中的对角块
+    //!
+    //! 逐列开方、缩放, 再用该列更新右侧各列, 内层循环都沿着列方向访问。
+    //! 只读写 A 的下三角, 输出时下三角为 L。
+    //!
+    //! @param [in] n A 的尺寸 n x n
+    //! @param [in|out] A, rsA, csA 待分解的对称正定矩阵
+    template <typename Scalar>
+    void CholeskyPanel(int n, Scalar * A, int rsA, int csA)
+    {
+        for (int j = 0; j < n; ++j) {
+            Scalar * aj = A + j * csA;
+            Scalar d = aj[j * rsA];
+            if (d <= 0.0)
+                throw std::runtime_error("非正定矩阵");
+            d = std::sqrt(d);
+            aj[j * rsA] = d;
+
+            Scalar inv = 1 / d;
+            for (int i = j + 1; i < n; ++i)
+                aj[i * rsA] *= inv;
+
+            for (int c = j + 1; c < n; ++c) {
+                Scalar * ac = A + c * csA;
+                Scalar l = aj[c * rsA];
+                for (int i = c; i < n; ++i)
+                    ac[i * rsA] -= aj[i * rsA] * l;
+            }
+        }
+    }
+
+    //! @brief 分块的左视 Cholesky 分解, 参考 LAPACK potrf 的下三角版本
+    //!
+    //! 逐个处理 nb 列的窄条, 先用左侧已经分解的部分更新该窄条:
+    //! 对角块 A_jj -= L_j L_j^T 由 SyrkLower 完成, 其下方的 A_2j -= L_2 L_j^T 由 Gemm 完成;
+    //! 再在缓存中分解对角块 A_jj = L_jj L_jj^T, 最后通过 Trsm 求解 L_2j = A_2j L_jj^{-T}。
+    //! 只读写 A 的下三角。
+    //!
+    //! @param [in] n A 的尺寸 n x n
+    //! @param [in|out] A, rsA, csA 待分解的对称正定矩阵, 输出时下三角为 L
+    //! @param [in] nb 分块大小
+    template <typename Scalar>
+    void CholeskyBlocked(int n, Scalar * A, int rsA, int csA, int nb)
+    {
+        for (int j = 0; j < n; j += nb) {
+            int jb = std::min(nb, n - j);
+            int m2 = n - j - jb;
+            Scalar * Lj = A + j * rsA;
+            Scalar * Ajj = Lj + j * csA;
+            Scalar * A2j = Ajj + jb * rsA;
+
+            SyrkLower(jb, j, Scalar(-1), Lj, rsA, csA, Scalar(1), Ajj, rsA, csA);
+            if (m2 > 0 && j > 0)
+                Gemm(m2, jb, j, Scalar(-1), Lj + jb * rsA, rsA, csA, Lj, csA, rsA,
+                     Scalar(1), A2j, rsA, csA);
+
+            CholeskyPanel(jb, Ajj, rsA, csA);
+
+            // A_2j L_jj^{-T} = (L_jj^{-1} A_2j^T)^T, 交换 A_2j 的行列步长即可
+            if (m2 > 0)
+                Trsm(true, false, jb, m2, Ajj, rsA, csA, A2j, csA, rsA);
+        }
+    }
+
     //! @brief 给定一个 n x n 的对称正定矩阵 A 进行 Cholesky 分解。A = L * L^T
     //! 结果记录在成员变量 ml 中。
     //!
@@ -15,22 +84,50 @@ namespace xiaotu {
     //! | l_10 l_11           | |      l_11 l_21 l_31 | = | a_10 a_11 a_21 a_31 |
     //! | l_20 l_21 l_22      | |           l_22 l_32 |   | a_20 a_21 a_22 a_32 |
     //! | l_30 l_31 l_32 l_33 | |                l_33 |   | a_30 a_31 a_32 a_33 |
+    //!
+    //! 分解采用 CholeskyBlocked 的分块算法, 只访问 ml 的下三角, 上三角保持为 0。
 
     template <typename MatrixViewA>
     class Cholesky {
         public:
             typedef typename MatrixViewA::Scalar Scalar;
 
+            //! @brief 分块大小, 即每个窄条的列数
+            constexpr static int BlockSize = 64;
+
+            //! @brief 默认构造函数, 之后通过 Decompose 分解
+            Cholesky()
+                : ml(nullptr, 0, 0)
+            {}
+
             Cholesky(MatrixViewA const & a)
-                : mBuffer(a.NumDatas()),
-                  ml(mBuffer.data(), a.Rows(), a.Cols())
+                : ml(nullptr, 0, 0)
+            {
+                Decompose(a);
+            }
+
+            //! @brief 分解矩阵 a
+            //!
+            //! 尺寸与上次分解相同时复用已有的内存, 不再申请
+            void Decompose(MatrixViewA const & a)
             {
                 assert(a.Rows() == a.Cols());
-                ml.Assign(a);
-                Decompose();
+                mBuffer.resize(a.NumDatas());
+                ml = mBuffer.data();
+                ml.Reshape(a.Rows(), a.Cols());
+
+                // 只拷贝下三角, 分解过程不会访问上三角
+                const int N = a.Rows();
+                for (int cidx = 0; cidx < N; ++cidx)
+                    for (int ridx = 0; ridx < N; ++ridx)
+                        ml(ridx, cidx) = (ridx >= cidx) ? a(ridx, cidx) : Scalar(0);
+                __Decompose__();
             }
 
             //! @brief 求解方程组 Ax=b, b 和 x 可以是同一个对象
+            //!
+            //! 依次求解 L y = b 和 L^T x = y, 所有列一起通过分块的 Trsm 求解,
+            //! L^T 通过交换 L 的行列步长得到
             //! 
             //! @param [in] b 方程右侧的列向量
             //! @param [out] x 对应 b 中每一列的解
@@ -38,26 +135,25 @@ namespace xiaotu {
             void Solve(MatrixViewB const & b, MatrixViewB & x)
             {
                 assert(b.Rows() == ml.Rows());
-            
-                const int N = ml.Rows();
-                const int M = b.Cols();
-                x.Assign(b);
-
-                // 遍历每一列
-                for (int cidx = 0; cidx < M; ++cidx) {
-                    for (int ridx = 0; ridx < N; ++ridx) {
-                        Scalar y = x(ridx, cidx);
-                        for (int k = 0; k < ridx; k++)
-                            y -= ml(ridx, k) * x(k, cidx);
-                        x(ridx, cidx) = y / ml(ridx, ridx);
-                    }
-
-                    for (int ridx = N-1; ridx >= 0; --ridx) {
-                        Scalar s = x(ridx, cidx);
-                        for (int k = ridx+1; k < N; ++k)
-                            s -= ml(k, ridx) * x(k, cidx);
-                        x(ridx, cidx) = s / ml(ridx, ridx);
-                    }
+                typedef typename std::remove_const<typename MatrixViewB::Scalar>::type BScalar;
+                if constexpr (MatrixViewB::IsStrided && std::is_same<BScalar, Scalar>::value) {
+                    const int N = ml.Rows();
+                    const int M = b.Cols();
+                    x.Assign(b);
+
+                    Scalar * X = x.StorBegin();
+                    int rsX = x.RowStride();
+                    int csX = x.ColStride();
+                    Scalar const * A = ml.StorBegin();
+                    int rsA = ml.RowStride();
+                    int csA = ml.ColStride();
+                    Trsm(true, false, N, M, A, rsA, csA, X, rsX, csX);
+                    Trsm(false, false, N, M, A, csA, rsA, X, rsX, csX);
+                } else {
+                    // 代理存储的矩阵先拷贝出来
+                    DMatrix<Scalar> tmp = b;
+                    Solve(tmp, tmp);
+                    x = tmp;
                 }
             }
 
@@ -69,31 +165,11 @@ namespace xiaotu {
             }
 
         private:
-            void Decompose()
+            void __Decompose__()
             {
-                const int N = ml.Rows();
-
-                for (int ridx = 0; ridx < N; ++ridx) {
-                    for (int cidx = ridx; cidx < N; ++cidx) {
-                        Scalar sum = ml(ridx, cidx);
-                        for (int k = ridx - 1; k >= 0; --k)
-                            sum -= ml(ridx, k) * ml(cidx, k);
-                        if (ridx == cidx) {
-                            if (sum <= 0.0)
-                                throw std::runtime_error("非正定矩阵");
-                            ml(ridx, ridx) = std::sqrt(sum);
-                        } else {
-                            ml(cidx, ridx) = sum / ml(ridx, ridx);
-                        }
-                    }
-                }
-
-                for (int ridx = 0; ridx < N; ++ridx)
-                    for (int cidx = 0; cidx < ridx; ++cidx)
-                        ml(cidx, ridx) = 0;
+                CholeskyBlocked(ml.Rows(), ml.StorBegin(), ml.RowStride(), ml.ColStride(), BlockSize);
             }
 
-
         public:
             //! @brief 获取 L 分解矩阵
             DMatrixView<Scalar> & operator() () { return ml; }
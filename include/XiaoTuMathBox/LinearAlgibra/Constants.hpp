@@ -22,7 +22,11 @@ namespace xiaotu {
         //! 可动态扩展 std::vector
         eStoreDyna = 0x03,
         //! 只是个代理,不管理内存,用于 SubMatrix
-        eStoreProxy = 0x04
+        eStoreProxy = 0x04,
+        //! 不管理内存, 按主维度步长访问, 用于连续存储矩阵的 SubMatrix
+        eStoreStride = 0x05,
+        //! 压缩存储的稀疏矩阵, 只保存非零元素, 用于 SparseMatrix
+        eStoreSparse = 0x06
     };
 
 }
@@ -5,6 +5,7 @@
 #include <vector>
 #include <iostream>
 #include <initializer_list>
+#include <utility>
 
 
 namespace xiaotu {
@@ -74,6 +75,18 @@ namespace xiaotu {
                 : mData(mv.mData), mRows(mv.Rows()), mCols(mv.Cols())
             {}
 
+            /**
+             * @brief 移动构造, 接管 mv 的存储, mv 变为 0x0 的空矩阵
+             * 
+             * @param [in] mv 移动对象
+             */
+            DMatrix(DMatrix && mv) noexcept
+                : mData(std::move(mv.mData)), mRows(mv.mRows), mCols(mv.mCols)
+            {
+                mv.mRows = 0;
+                mv.mCols = 0;
+            }
+
             /**
              * @brief 拷贝构造(深度)
              * 
@@ -86,7 +99,11 @@ namespace xiaotu {
                 mCols = mv.Cols();
                 mData.resize(mRows * mCols);
 
-                Assign(mv);
+                // 新分配的存储不会与表达式的操作数重叠
+                if constexpr (IsMatrixExpression<Mat>::value)
+                    mv.EvalNoAlias(*this, Scalar(1), Scalar(0));
+                else
+                    Assign(mv);
             }
 
             /**
@@ -102,6 +119,45 @@ namespace xiaotu {
                 return *this;
             }
 
+            /**
+             * @brief 移动赋值, 接管 mv 的存储, mv 变为 0x0 的空矩阵
+             * 
+             * @param [in] mv 移动对象
+             */
+            DMatrix & operator = (DMatrix && mv) noexcept
+            {
+                mData = std::move(mv.mData);
+                mRows = mv.mRows;
+                mCols = mv.mCols;
+                mv.mData.clear();
+                mv.mRows = 0;
+                mv.mCols = 0;
+                return *this;
+            }
+
+            /**
+             * @brief 拷贝赋值(深度), 尺寸不一致时重新分配内存
+             * 
+             * 与定长矩阵和视图不同, 赋值后的尺寸总是与 mv 相同, 原有的数据被丢弃。
+             * mv 引用了本矩阵的数据(例如本矩阵的子阵)时也是安全的。
+             * 
+             * @param [in] mv 拷贝对象, 可以是表达式
+             */
+            template <typename Mat, bool IsMatrix = Mat::IsMatrix>
+            DMatrix & operator = (Mat const & mv)
+            {
+                if (mRows == mv.Rows() && mCols == mv.Cols()) {
+                    // 表达式需要借助临时矩阵求值时, 直接接管临时矩阵的存储, 省去一次拷贝
+                    if constexpr (IsMatrixExpression<Mat>::value) {
+                        if (eAliasPartial == mv.AliasWith(*this))
+                            return *this = DMatrix(mv);
+                    }
+                    return Assign(mv);
+                }
+                // mv 可能引用了本矩阵的数据, 先求值再替换
+                return *this = DMatrix(mv);
+            }
+
             /**
              * @brief 构造一个全零矩阵
              * 
@@ -0,0 +1,134 @@
+#ifndef XTMB_LA_MATRIX_SUB_VIEW_D_H
+#define XTMB_LA_MATRIX_SUB_VIEW_D_H
+
+#include <cassert>
+#include <iostream>
+#include <initializer_list>
+
+namespace xiaotu {
+
+    template <typename T, EAlignType _align>
+    struct Traits<DMatrixSubView<T, _align>> {
+        typedef T Scalar;
+        constexpr static EAlignType Align = _align;
+        constexpr static EStoreType Store = EStoreType::eStoreStride;
+    };
+
+    template <typename T, EAlignType _align>
+    struct Traits<const DMatrixSubView<T, _align>> {
+        typedef T Scalar;
+        constexpr static EAlignType Align = _align;
+        constexpr static EStoreType Store = EStoreType::eStoreStride;
+    };
+
+    //! @brief 带主维度步长的矩阵视图
+    //!
+    //! 只记录首元素地址、行列数和主维度步长, 不引用原矩阵。
+    //! 连续存储的矩阵(Matrix, DMatrix, MatrixView, DMatrixView)的 SubMatrix, Row, Col 都返回该类型,
+    //! 它自己的子阵仍是同一个类型, 所以多层嵌套的子阵访问元素时也只有一次地址计算。
+    //! Data() 和 Stride() 可以直接交给 Gemm 等基于裸指针的计算核心。
+    //!
+    //! 与其它视图一样, 拷贝构造是浅拷贝, 赋值则拷贝元素。
+    template <typename Scalar, EAlignType _align>
+    class DMatrixSubView : public MatrixBase<DMatrixSubView<Scalar, _align>>
+    {
+        public:
+            typedef MatrixBase<DMatrixSubView> Base;
+
+            using Base::At;
+            using Base::Assign;
+            using Base::operator();
+            using Base::operator=;
+
+        public:
+            ////////////////////////////////////////////////////////
+            //
+            //  构造函数和拷贝
+            //
+            ////////////////////////////////////////////////////////
+
+            //! @brief 构造函数
+            //!
+            //! @param [in] data 首元素地址
+            //! @param [in] rows 行数
+            //! @param [in] cols 列数
+            //! @param [in] stride 主维度步长, 列优先时为相邻两列的间隔, 行优先时为相邻两行的间隔
+            DMatrixSubView(Scalar * data, int rows, int cols, int stride)
+                : mData(data), mRows(rows), mCols(cols), mStride(stride)
+            {}
+
+            //! @brief 浅拷贝构造
+            DMatrixSubView(DMatrixSubView const & mv) = default;
+
+            //! @brief 拷贝元素
+            DMatrixSubView & operator = (DMatrixSubView const & mv)
+            {
+                Assign(mv);
+                return *this;
+            }
+
+            //! @brief 重置子矩阵视图
+            DMatrixSubView & Reset(DMatrixSubView const & other)
+            {
+                mData = other.mData;
+                mRows = other.mRows;
+                mCols = other.mCols;
+                mStride = other.mStride;
+                return *this;
+            }
+
+            //! @brief 收缩成自己的一个子阵, 相对于自己
+            //!
+            //! @param [in] r 子阵的起始行
+            //! @param [in] c 子阵的起始列
+            //! @param [in] rows 子阵的行数
+            //! @param [in] cols 子阵的列数
+            DMatrixSubView & Shrink(int r, int c, int rows, int cols)
+            {
+                mData += r * Base::RowStride() + c * Base::ColStride();
+                mRows = rows;
+                mCols = cols;
+                return *this;
+            }
+
+        public:
+            //! @brief 获取首元素地址
+            inline Scalar * Data() { return mData; }
+            //! @brief 获取首元素地址
+            inline Scalar const * Data() const { return mData; }
+            //! @brief 主维度步长
+            inline int Stride() const { return mStride; }
+
+            //! @brief 获取矩阵数据存储的起始地址, 即首元素地址
+            inline Scalar * StorBegin() { return mData; }
+            //! @brief 获取矩阵数据存储的起始地址, 即首元素地址
+            inline Scalar const * StorBegin() const { return mData; }
+
+            //! @brief 获取矩阵行数
+            inline int Rows() const { return mRows; }
+            //! @brief 获取矩阵列数
+            inline int Cols() const { return mCols; }
+
+            //! @brief 计算指定行列索引的展开索引
+            //!
+            //! @param [in] row 行索引
+            //! @param [in] col 列索引
+            //! @return 元素相对于首元素的偏移量
+            inline int Idx(int row, int col) const
+            {
+                assert(row < mRows && col < mCols);
+                return (EAlignType::eRowMajor == _align)
+                      ? mStride * row + col
+                      : mStride * col + row;
+            }
+
+        private:
+            Scalar * mData = nullptr;
+            int mRows = 0;
+            int mCols = 0;
+            int mStride = 0;
+    };
+
+}
+
+#endif
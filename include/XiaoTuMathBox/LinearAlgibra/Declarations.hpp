@@ -16,6 +16,10 @@ namespace xiaotu {
     template <typename T, EAlignType align = EAlignType::eColMajor>
     class DMatrixView;
 
+    //! @brief 带主维度步长的矩阵视图, 连续存储矩阵的子阵
+    template <typename T, EAlignType align = EAlignType::eColMajor>
+    class DMatrixSubView;
+
     template <typename Derived>
     class MatrixSubView;
 
@@ -89,6 +93,12 @@ namespace xiaotu {
     template <typename T, EAlignType align = EAlignType::eColMajor>
     class DMatrix;
 
+    /**
+     * @brief 压缩存储的稀疏矩阵, 行优先时为 CSR, 列优先时为 CSC
+     */
+    template <typename T, EAlignType align = EAlignType::eColMajor>
+    class SparseMatrix;
+
     /**
      * @brief 乒乓队列, 主要用于 QR 迭代、SVD 分解
      */
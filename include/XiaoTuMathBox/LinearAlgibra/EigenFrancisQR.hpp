@@ -0,0 +1,422 @@
+#ifndef XTMB_LA_EIGEN_FRANCIS_QR_H
+#define XTMB_LA_EIGEN_FRANCIS_QR_H
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include <XiaoTuMathBox/LinearAlgibra/Householder.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/SchurEigenVectors.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 一般实矩阵的 Francis 双重步 QR 迭代, 输出实 Schur 分解
+//
+// 对上 Hessenberg 矩阵 H, 每次以右下角 2x2 块的一对特征值(可能是共轭复数)为偏移,
+// 隐式地完成两步 QR 迭代: 用第一列确定的 3 阶反射在左上角产生一个凸起, 再用一串 3 阶反射
+// 把它沿次对角线追赶出去。整个过程只有实数运算, 共轭复特征值也能正常收敛。
+//
+// 活动块足够大时, 每次迭代前先做激进的早期收缩(aggressive early deflation):
+// 对右下角的窗口单独求 Schur 分解, 检查它与窗口外唯一的耦合元素(spike)在变换后的大小,
+// 从窗口底部开始收缩那些 spike 可以忽略的特征值, 往往一次就能收缩好几个特征值。
+// 这里不对窗口内的 Schur 块重新排序, 只收缩窗口底部连续的可收缩部分。
+//
+// 矩阵都是列优先存储, 正交变换按 H = Q A Q^T 的约定左乘累积到 Q 上,
+// 与 UpperHessenbergByHouseholder 和 EigenImplicitQR 一致。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 在第 k, k+1 行和列上作用平面旋转 H = G H G^T, Q = G Q, 其中 G = [c s; -s c]
+    template <typename Scalar>
+    void SchurRotate(int n, Scalar * H, int ldH, Scalar * Q, int ldQ, int nq, int k, Scalar c, Scalar s)
+    {
+        for (int j = k; j < n; ++j) {
+            Scalar * h = H + j * ldH + k;
+            Scalar h0 = h[0], h1 = h[1];
+            h[0] = c * h0 + s * h1;
+            h[1] = c * h1 - s * h0;
+        }
+        Scalar * h0 = H + k * ldH;
+        Scalar * h1 = h0 + ldH;
+        for (int i = 0; i <= k + 1; ++i) {
+            Scalar a = h0[i], b = h1[i];
+            h0[i] = c * a + s * b;
+            h1[i] = c * b - s * a;
+        }
+        if (nullptr != Q) {
+            for (int j = 0; j < nq; ++j) {
+                Scalar * q = Q + j * ldQ + k;
+                Scalar q0 = q[0], q1 = q[1];
+                q[0] = c * q0 + s * q1;
+                q[1] = c * q1 - s * q0;
+            }
+        }
+    }
+
+    //! @brief 在第 k 到 k+nr-1 行和列上作用反射 P = I - tau v v^T, H = P H P^T, Q = P Q
+    //!
+    //! @param [in] c0 左乘时的起始列, 之前各列在这些行上已经为 0
+    //! @param [in] r1 右乘时的结束行(不含), 之后各行在这些列上已经为 0
+    template <typename Scalar>
+    void SchurReflect(int n, Scalar * H, int ldH, Scalar * Q, int ldQ, int nq,
+                      int k, int nr, Scalar const * v, Scalar tau, int c0, int r1)
+    {
+        HouseholderApply(nr, n - c0, v, 1, tau, H + k + c0 * ldH, 1, ldH);
+        HouseholderApply(nr, r1, v, 1, tau, H + k * ldH, ldH, 1);
+        if (nullptr != Q)
+            HouseholderApply(nr, nq, v, 1, tau, Q + k, 1, ldQ);
+    }
+
+    //! @brief 处理已经收缩出来的 2x2 对角块, 实特征值时旋转成上三角, 输出块的两个特征值
+    template <typename Scalar>
+    void SchurStandardize2x2(int n, Scalar * H, int ldH, Scalar * Q, int ldQ, int nq, int k,
+                             Scalar * wr, Scalar * wi)
+    {
+        Scalar * h = H + k + k * ldH;
+        Scalar a = h[0], b = h[ldH], c = h[1], d = h[ldH + 1];
+        Scalar p = (a - d) / 2;
+        Scalar disc = p * p + b * c;
+
+        if (disc >= 0 && 0 != c) {
+            // (z, c) 是 λ = d + z 的特征向量, 以它为第一个 Schur 向量
+            Scalar z = p + std::copysign(std::sqrt(disc), p);
+            Scalar r = std::hypot(z, c);
+            SchurRotate(n, H, ldH, Q, ldQ, nq, k, z / r, c / r);
+            h[1] = 0;
+        }
+
+        if (disc >= 0 || 0 == c) {
+            wr[k] = h[0];
+            wr[k + 1] = h[ldH + 1];
+            wi[k] = 0;
+            wi[k + 1] = 0;
+        } else {
+            wr[k] = wr[k + 1] = (a + d) / 2;
+            wi[k] = std::sqrt(-disc);
+            wi[k + 1] = -wi[k];
+        }
+    }
+
+    //! @brief 对活动块 [l, hi] 进行一次 Francis 双重步 QR 迭代
+    //!
+    //! @param [in] its 当前特征值已经迭代的次数, 每 10 次换用一次特别的偏移, 打破可能的循环
+    template <typename Scalar>
+    void FrancisSweep(int n, Scalar * H, int ldH, Scalar * Q, int ldQ, int nq, int l, int hi, int its)
+    {
+        auto h = [&](int r, int c) -> Scalar & { return H[r + c * ldH]; };
+
+        Scalar s, t;
+        if (its > 0 && 0 == its % 10) {
+            Scalar w = std::abs(h(hi, hi - 1)) + std::abs(h(hi - 1, hi - 2));
+            s = Scalar(1.5) * w;
+            t = w * w;
+        } else {
+            s = h(hi - 1, hi - 1) + h(hi, hi);
+            t = h(hi - 1, hi - 1) * h(hi, hi) - h(hi - 1, hi) * h(hi, hi - 1);
+        }
+
+        // (H - s1 I)(H - s2 I) e_0 的非零部分
+        Scalar x = h(l, l) * h(l, l) + h(l, l + 1) * h(l + 1, l) - s * h(l, l) + t;
+        Scalar y = h(l + 1, l) * (h(l, l) + h(l + 1, l + 1) - s);
+        Scalar z = h(l + 1, l) * h(l + 2, l + 1);
+
+        for (int k = l; k < hi; ++k) {
+            int nr = std::min(3, hi - k + 1);
+            Scalar v[3] = { x, y, z };
+            Scalar tau = HouseholderGenerate(nr, v, 1);
+
+            // 左乘时从第 k 列开始, 第 k-1 列上的凸起直接写成 (beta, 0, 0)
+            SchurReflect(n, H, ldH, Q, ldQ, nq, k, nr, v, tau, k, std::min(k + 4, hi + 1));
+            if (k > l) {
+                h(k, k - 1) = v[0];
+                h(k + 1, k - 1) = 0;
+                if (3 == nr)
+                    h(k + 2, k - 1) = 0;
+            }
+            x = h(k + 1, k);
+            y = (k + 2 <= hi) ? h(k + 2, k) : 0;
+            z = (k + 3 <= hi) ? h(k + 3, k) : 0;
+        }
+    }
+
+    template <typename Scalar>
+    int FrancisSchur(int n, Scalar * H, int ldH, Scalar * Q, int ldQ, int nq,
+                     Scalar * wr, Scalar * wi, int max_iter, int aed_min);
+
+    //! @brief 对活动块 [l, hi] 右下角 nw 阶的窗口进行激进的早期收缩
+    //!
+    //! 对窗口 W 求 Schur 分解 W = U^T T U, 窗口与左侧的耦合 s = H(ks, ks-1) 变换后成为一列 spike,
+    //! s U(:, 0)。从底部开始, spike 可以忽略的 1x1 或 2x2 块直接收缩; 剩余部分连同 spike
+    //! 通过反射恢复成上 Hessenberg 形式。没有可以收缩的特征值时不修改 H。
+    //!
+    //! @return 收缩的特征值数量
+    template <typename Scalar>
+    int SchurAggressiveDeflation(int n, Scalar * H, int ldH, Scalar * Q, int ldQ, int nq,
+                                 int l, int hi, int nw)
+    {
+        constexpr Scalar eps = std::numeric_limits<Scalar>::epsilon();
+        auto h = [&](int r, int c) -> Scalar & { return H[r + c * ldH]; };
+
+        int w = std::min(nw, hi - l + 1);
+        int ks = hi - w + 1;
+        Scalar s = (ks > l) ? h(ks, ks - 1) : Scalar(0);
+
+        WorkspaceFrame frame;
+        Scalar * W = frame.Alloc<Scalar>(w * w);
+        Scalar * U = frame.Alloc<Scalar>(w * w);
+        Scalar * sp = frame.Alloc<Scalar>(w);
+        Scalar * wr = frame.Alloc<Scalar>(w);
+        Scalar * wi = frame.Alloc<Scalar>(w);
+        for (int c = 0; c < w; ++c) {
+            for (int r = 0; r < w; ++r) {
+                W[r + c * w] = (r <= c + 1) ? h(ks + r, ks + c) : Scalar(0);
+                U[r + c * w] = (r == c) ? Scalar(1) : Scalar(0);
+            }
+        }
+        if (FrancisSchur(w, W, w, U, w, w, wr, wi, 30, w + 1) < 0)
+            return 0;
+
+        for (int j = 0; j < w; ++j)
+            sp[j] = s * U[j];
+
+        int j = w - 1;
+        while (j >= 0) {
+            bool pair = j > 0 && 0 != W[j + (j - 1) * w];
+            if (pair) {
+                Scalar foo = std::abs(W[j + j * w]) +
+                             std::sqrt(std::abs(W[j + (j - 1) * w])) * std::sqrt(std::abs(W[j - 1 + j * w]));
+                if (0 == foo)
+                    foo = std::abs(s);
+                if (std::max(std::abs(sp[j]), std::abs(sp[j - 1])) > eps * foo)
+                    break;
+                sp[j] = sp[j - 1] = 0;
+                j -= 2;
+            } else {
+                Scalar foo = std::abs(W[j + j * w]);
+                if (0 == foo)
+                    foo = std::abs(s);
+                if (std::abs(sp[j]) > eps * foo)
+                    break;
+                sp[j] = 0;
+                j -= 1;
+            }
+        }
+        int m = j + 1;
+        int nd = w - m;
+        if (0 == nd)
+            return 0;
+
+        // 把窗口的 Schur 分解作用到整个矩阵上
+        for (int c = 0; c < w; ++c)
+            for (int r = 0; r < w; ++r)
+                h(ks + r, ks + c) = W[r + c * w];
+        if (ks > l)
+            for (int r = 0; r < w; ++r)
+                h(ks + r, ks - 1) = sp[r];
+
+        int nright = n - hi - 1;
+        int nmax = std::max(std::max(nright, ks), nq);
+        Scalar * tmp = frame.Alloc<Scalar>(w * nmax);
+        if (nright > 0) {
+            for (int c = 0; c < nright; ++c)
+                std::copy(&h(ks, hi + 1 + c), &h(ks, hi + 1 + c) + w, tmp + c * w);
+            Gemm(w, nright, w, Scalar(1), U, 1, w, tmp, 1, w, Scalar(0), &h(ks, hi + 1), 1, ldH);
+        }
+        if (ks > 0) {
+            for (int c = 0; c < w; ++c)
+                std::copy(&h(0, ks + c), &h(0, ks + c) + ks, tmp + c * ks);
+            Gemm(ks, w, w, Scalar(1), tmp, 1, ks, U, w, 1, Scalar(0), &h(0, ks), 1, ldH);
+        }
+        if (nullptr != Q) {
+            for (int c = 0; c < nq; ++c)
+                std::copy(Q + ks + c * ldQ, Q + ks + c * ldQ + w, tmp + c * w);
+            Gemm(w, nq, w, Scalar(1), U, 1, w, tmp, 1, w, Scalar(0), Q + ks, 1, ldQ);
+        }
+
+        // 未收缩的部分连同 spike 恢复成上 Hessenberg 形式, 从 spike 所在的第 ks-1 列开始逐列反射
+        if (ks > l && m > 1) {
+            Scalar * v = frame.Alloc<Scalar>(m);
+            int end = ks + m;
+            for (int c = ks - 1; c < end - 2; ++c) {
+                int len = end - c - 1;
+                Scalar * x = &h(c + 1, c);
+                Scalar tau = HouseholderGenerate(len, x, 1);
+                v[0] = 1;
+                for (int i = 1; i < len; ++i) {
+                    v[i] = x[i];
+                    x[i] = 0;
+                }
+                SchurReflect(n, H, ldH, Q, ldQ, nq, c + 1, len, v, tau, c + 1, end);
+            }
+        }
+        return nd;
+    }
+
+    //! @brief 上 Hessenberg 矩阵的实 Schur 分解
+    //!
+    //! 输出时 H 为拟上三角矩阵 T, 对角线上的 2x2 块对应一对共轭复特征值, 其余为 1x1 块。
+    //! 变换累积到 Q 上, 若输入时 H = Q A Q^T, 则输出时 T = Q A Q^T。
+    //!
+    //! @param [in] n H 的尺寸
+    //! @param [in|out] H, ldH 上 Hessenberg 矩阵, 次对角线以下必须为 0
+    //! @param [in|out] Q, ldQ 累积变换的矩阵, n x nq, 可以为 nullptr
+    //! @param [in] nq Q 的列数
+    //! @param [out] wr, wi 特征值的实部和虚部, 共轭复特征值成对出现, 虚部为正的在前
+    //! @param [in] max_iter 每个特征值的最大迭代次数
+    //! @param [in] aed_min 活动块的尺寸不小于 aed_min 时进行激进的早期收缩
+    //! @return Francis 迭代的总次数, 不收敛时返回 -1
+    template <typename Scalar>
+    int FrancisSchur(int n, Scalar * H, int ldH, Scalar * Q, int ldQ, int nq,
+                     Scalar * wr, Scalar * wi, int max_iter, int aed_min)
+    {
+        constexpr Scalar eps = std::numeric_limits<Scalar>::epsilon();
+        constexpr Scalar tiny = std::numeric_limits<Scalar>::min();
+        auto h = [&](int r, int c) -> Scalar & { return H[r + c * ldH]; };
+
+        Scalar anorm = 0;
+        for (int c = 0; c < n; ++c)
+            for (int r = 0; r <= std::min(c + 1, n - 1); ++r)
+                anorm = std::max(anorm, std::abs(h(r, c)));
+
+        int total = 0;
+        int its = 0;
+        int hi = n - 1;
+        while (hi >= 0) {
+            // 从底部向上查找可以忽略的次对角元素, 确定活动块 [l, hi]
+            int l = hi;
+            for (; l > 0; --l) {
+                Scalar sub = std::abs(h(l, l - 1));
+                Scalar tst = std::abs(h(l - 1, l - 1)) + std::abs(h(l, l));
+                if (0 == tst)
+                    tst = anorm;
+                if (sub <= eps * tst || sub <= tiny) {
+                    h(l, l - 1) = 0;
+                    break;
+                }
+            }
+
+            if (l == hi) {
+                wr[hi] = h(hi, hi);
+                wi[hi] = 0;
+                hi -= 1;
+                its = 0;
+                continue;
+            }
+            if (l == hi - 1) {
+                SchurStandardize2x2(n, H, ldH, Q, ldQ, nq, hi - 1, wr, wi);
+                hi -= 2;
+                its = 0;
+                continue;
+            }
+            if (its >= max_iter)
+                return -1;
+
+            int na = hi - l + 1;
+            if (na >= aed_min) {
+                // 每次迭代都要做一次, 窗口太大时窗口的 Schur 分解反而比一次 Francis 迭代更贵
+                if (SchurAggressiveDeflation(n, H, ldH, Q, ldQ, nq, l, hi, 16) > 0) {
+                    its = 0;
+                    continue;
+                }
+            }
+
+            its++;
+            total++;
+            FrancisSweep(n, H, ldH, Q, ldQ, nq, l, hi, its);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Francis 双重步隐式 QR 迭代, 求一般实矩阵的实 Schur 分解
+     *
+     * QAQ^T = T, A = Q^T T Q, T 为拟上三角矩阵。
+     * 与 EigenImplicitQR 的单偏移迭代不同, 共轭复特征值对应 T 对角线上的 2x2 块,
+     * 其实部和虚部分别由 EigenValuesReal() 和 EigenValuesImag() 给出。
+     */
+    template <typename MatViewIn>
+    class EigenFrancisQR {
+        public:
+            typedef typename MatViewIn::Scalar Scalar;
+
+            //! @brief 活动块不小于该尺寸时进行激进的早期收缩
+            constexpr static int AedMinSize = 48;
+
+            /**
+             * @brief 默认构造函数
+             */
+            EigenFrancisQR()
+            {}
+
+            EigenFrancisQR(MatViewIn const & a, bool keep_q = true)
+            {
+                Iterate(a, 30, keep_q);
+            }
+
+            /**
+             * @brief 上 Hessenberg 化以后进行 Francis 双重步迭代
+             *
+             * 尺寸与上次分解相同时复用已有的内存, 不再申请
+             *
+             * @param [in] a 目标矩阵
+             * @param [in] max_iter 每个特征值的最大迭代次数
+             * @param [in] keep_q 是否需要保留正交矩阵 Q
+             * @return Francis 迭代的总次数
+             */
+            int Iterate(MatViewIn const & a, int max_iter = 30, bool keep_q = true)
+            {
+                assert(a.Rows() == a.Cols());
+                int n = a.Rows();
+
+                mT.Resize(n, n) = a;
+                mQ.Resize(n, n).Identity();
+                mT.UpperHessenbergByHouseholder(keep_q ? &mQ : nullptr);
+
+                mWr.resize(n);
+                mWi.resize(n);
+                int iter = FrancisSchur(n, mT.StorBegin(), n, keep_q ? mQ.StorBegin() : nullptr, n, n,
+                                        mWr.data(), mWi.data(), max_iter, AedMinSize);
+                if (iter < 0)
+                    throw std::runtime_error("迭代不收敛");
+                return iter;
+            }
+
+        public:
+            //! @brief 实 Schur 形式, 拟上三角矩阵
+            DMatrix<Scalar> const & T() const { return mT; }
+            //! @brief 正交矩阵, A = Q^T T Q, 只在 keep_q 时有效
+            DMatrix<Scalar> const & Q() const { return mQ; }
+            //! @brief 特征值的实部, 与 T 的对角块顺序一致
+            std::vector<Scalar> const & EigenValuesReal() const { return mWr; }
+            //! @brief 特征值的虚部, 共轭复特征值成对出现, 虚部为正的在前
+            std::vector<Scalar> const & EigenValuesImag() const { return mWi; }
+
+            /**
+             * @brief 通过 T 的回代和一次 Gemm 计算全部特征向量, 需要 keep_q
+             *
+             * 第 j 个特征值为实数时, V 的第 j 列为其特征向量;
+             * 第 j, j+1 个特征值为共轭复数时, V(:, j) +- i V(:, j+1) 分别为它们的特征向量。
+             *
+             * @param [out] V 特征向量, n x n
+             */
+            void EigenVectors(DMatrix<Scalar> & V) const
+            {
+                int n = mT.Rows();
+                V.Resize(n, n);
+                SchurEigenVectors(n, mT.StorBegin(), n, mQ.StorBegin(), n, V.StorBegin(), n);
+            }
+
+        private:
+            DMatrix<Scalar> mT;
+            DMatrix<Scalar> mQ;
+            std::vector<Scalar> mWr;
+            std::vector<Scalar> mWi;
+    };
+
+}
+
+#endif
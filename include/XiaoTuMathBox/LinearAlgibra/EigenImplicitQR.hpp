@@ -42,44 +42,33 @@ namespace xiaotu {
                 mQ.Resize(n, n).Identity();
                 mSigma.UpperHessenbergByHouseholder(&mQ);
 
-                std::vector<MatrixSubView<Mat>> parts0;
-                std::vector<MatrixSubView<Mat>> parts1;
-                std::vector<MatrixSubView<Mat>> * pParts0 = &parts0;
-                std::vector<MatrixSubView<Mat>> * pParts1 = &parts1;
-                pParts0->push_back(mSigma.SubMatrix(0, 0, n, n));
-
-
-                std::vector<MatrixSubView<Mat>> partQ0;
-                std::vector<MatrixSubView<Mat>> partQ1;
-                std::vector<MatrixSubView<Mat>> * pPartQ0 = &partQ0;
-                std::vector<MatrixSubView<Mat>> * pPartQ1 = &partQ1;
-                pPartQ0->push_back(mQ.SubMatrix(0, 0, n, n));
+                mSigmaPingPang.Init(mSigma.SubMatrix(0, 0, n, n));
+                mQPingPang.Init(mQ.SubMatrix(0, 0, n, n));
 
                 int i = 0;
                 for (; i < max_iter; i++) {
-                    if (pParts0->empty())
+                    auto & parts = mSigmaPingPang.Ping();
+                    if (parts.empty())
                         break;
-                    for (int idx = 0; idx < pParts0->size(); idx++) {
-                        auto & a0 = (*pParts0)[idx];
+                    for (int idx = 0; idx < parts.size(); idx++) {
+                        auto & a0 = parts[idx];
                         int n = a0.Rows();
                         Scalar offset = (0 == i && nullptr != first_off)
                                       ? *first_off
                                       : a0(n - 1, n - 1);
 
                         SubDiagScalar(a0, offset);
-                        MatrixSubView<Mat> * pQ0 = keep_q
-                                                 ? &(*pPartQ0)[idx]
+                        typename Mat::SubView * pQ0 = keep_q
+                                                 ? &mQPingPang.Ping()[idx]
                                                  : nullptr;
                         ImplicitQR(a0, pQ0);
 
                         AddDiagScalar(a0, offset);
-                        Partition(a0, *pParts1, pQ0, pPartQ1);
+                        Partition(a0, mSigmaPingPang.Pang(), pQ0, &mQPingPang.Pang());
                     }
 
-                    std::swap(pParts0, pParts1);
-                    std::swap(pPartQ0, pPartQ1);
-                    pParts1->clear();
-                    pPartQ1->clear();
+                    mSigmaPingPang.Swap();
+                    mQPingPang.Swap();
                 }
 
                 return i;
@@ -93,7 +82,7 @@ namespace xiaotu {
              *
              * @return true - 复特征值, false 实特征值
              */
-            bool Solve2x2(MatrixSubView<Mat> const & a1)
+            bool Solve2x2(typename Mat::SubView const & a1)
             {
                 assert(a1.Rows() == 2);
                 Scalar tr = a1(0, 0) + a1(1, 1);
@@ -116,10 +105,10 @@ namespace xiaotu {
              * @param [out] parts 输出分割列表
              * @return 分割的对角块数量
              */
-            int Partition(MatrixSubView<Mat> & a0,
-                          std::vector<MatrixSubView<Mat>> & parts,
-                          MatrixSubView<Mat> * pQ0,
-                          std::vector<MatrixSubView<Mat>> * partQ)
+            int Partition(typename Mat::SubView & a0,
+                          std::vector<typename Mat::SubView> & parts,
+                          typename Mat::SubView * pQ0,
+                          std::vector<typename Mat::SubView> * partQ)
             {
                 int n = a0.Rows();
                 int start = 0;
@@ -158,7 +147,7 @@ namespace xiaotu {
             /**
              * @brief 对子阵 H 进行隐式 QR 迭代
              */
-            void ImplicitQR(MatrixSubView<Mat> & H, MatrixSubView<Mat> * pQ)
+            void ImplicitQR(typename Mat::SubView & H, typename Mat::SubView * pQ)
             {
                 Givens<Scalar> G(0, 1, H(0, 0), H(1, 0));
                 G.LeftApplyOn(H);
@@ -198,9 +187,38 @@ namespace xiaotu {
                 return re;
             }
 
+            /**
+             * @brief 迭代收敛以后, 通过 Sigma 的回代和一次 Gemm 计算全部特征向量, 需要 keep_q
+             *
+             * 小于 SMALL_VALUE 的次对角元素视为 0, 其余的次对角元素对应一对共轭复特征值的 2x2 块。
+             * 输出格式与 EigenFrancisQR::EigenVectors 相同: 实特征值对应 V 的一列,
+             * 共轭复特征值对应相邻的两列 V(:, j) +- i V(:, j+1)。
+             *
+             * @param [out] V 特征向量, n x n
+             */
+            void EigenVectors(DMatrix<Scalar> & V) const
+            {
+                int n = mSigma.Rows();
+                V.Resize(n, n);
+
+                WorkspaceFrame frame;
+                Scalar * T = frame.Alloc<Scalar>(n * n);
+                for (int c = 0; c < n; c++) {
+                    for (int r = 0; r < n; r++) {
+                        Scalar v = (r <= c + 1) ? mSigma(r, c) : Scalar(0);
+                        T[r + c * n] = (r == c + 1 && std::abs(v) < SMALL_VALUE) ? Scalar(0) : v;
+                    }
+                }
+                SchurEigenVectors(n, T, n, mQ.StorBegin(), n, V.StorBegin(), n);
+            }
+
         private:
             DMatrix<Scalar> mSigma;
             DMatrix<Scalar> mQ;
+            //! @brief mSigma 对角块的乒乓队列, 作为成员保留容量, 重复迭代时不再申请内存
+            PingPangView<Mat> mSigmaPingPang;
+            //! @brief mQ 中与各个对角块对应的行块
+            PingPangView<Mat> mQPingPang;
     };
 
 }
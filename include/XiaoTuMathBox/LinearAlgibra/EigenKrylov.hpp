@@ -0,0 +1,522 @@
+#ifndef XTMB_LA_EIGEN_KRYLOV_H
+#define XTMB_LA_EIGEN_KRYLOV_H
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include <XiaoTuMathBox/LinearAlgibra/Gemm.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/Householder.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/SymmetricEigen.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/EigenFrancisQR.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 隐式重启的 Krylov 子空间方法, 求大型矩阵的 k 个特征对, 参考 ARPACK 和 Sorensen 的隐式重启
+//
+// Arnoldi 分解 A V_m = V_m H_m + f e_m^T 只需要线性算子 y = A x, 可以是矩阵也可以是函数。
+// 求出 m x m 的 H_m 的特征值 (Ritz 值) 后, 以不需要的 m - k 个 Ritz 值为偏移对 H_m 做 QR 迭代,
+// 把分解压缩到 k 列, 相当于用这些偏移构成的多项式过滤起始向量, 再扩展回 m 列, 直到前 k 个 Ritz 对收敛。
+// 对称的算子 H_m 为三对角矩阵, 即 Lanczos 方法; 一般的算子通过实 Schur 分解求 Ritz 值, 共轭复偏移合并为双重步。
+//
+// Krylov 基 V 在开始时一次申请, 每一步都通过两次经典 Gram-Schmidt (CGS2) 完全重正交化,
+// 每次正交化是两个 Gemv, 比逐列的修正 Gram-Schmidt 更适合向量化和并行。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief Krylov 方法求解的特征值
+    enum class KrylovWhich {
+        //! @brief 模最大
+        LargestMagnitude,
+        //! @brief 实部最大, 对称矩阵即代数最大
+        LargestReal,
+        //! @brief 实部最小, 对称矩阵即代数最小
+        SmallestReal,
+    };
+
+    //! @brief 按 which 的准则, 特征值 a 是否排在 b 的前面
+    template <typename Scalar>
+    bool KrylovPrefer(KrylovWhich which, Scalar ar, Scalar ai, Scalar br, Scalar bi)
+    {
+        switch (which) {
+            case KrylovWhich::LargestMagnitude:
+                return std::hypot(ar, ai) > std::hypot(br, bi);
+            case KrylovWhich::LargestReal:
+                return ar > br;
+            default:
+                return ar < br;
+        }
+    }
+
+    //! @brief 通过 CGS2 把 w 与 V 的前 k 列正交化
+    //!
+    //! 两次 h = V^T w, w = w - V h, 系数累加到 h 中
+    //!
+    //! @param [in] n 向量长度
+    //! @param [in] k V 的列数
+    //! @param [in] V, ldV 列优先存储的 n x k 矩阵, 各列为单位正交向量
+    //! @param [in|out] w 待正交化的向量
+    //! @param [out] h 正交化的系数, k 个元素
+    //! @return 正交化以后 w 的范数
+    template <typename Scalar>
+    Scalar KrylovOrthogonalize(int n, int k, Scalar const * V, int ldV, Scalar * w, Scalar * h)
+    {
+        WorkspaceFrame frame;
+        Scalar * c = frame.Alloc<Scalar>(k);
+        Gemv(k, n, Scalar(1), V, ldV, 1, w, Scalar(0), h);
+        Gemv(n, k, Scalar(-1), V, 1, ldV, h, Scalar(1), w);
+        Gemv(k, n, Scalar(1), V, ldV, 1, w, Scalar(0), c);
+        Gemv(n, k, Scalar(-1), V, 1, ldV, c, Scalar(1), w);
+        for (int i = 0; i < k; ++i)
+            h[i] += c[i];
+        return std::sqrt(SimdDot(n, w, w));
+    }
+
+    //! @brief 生成与 V 的前 k 列正交的随机单位向量, 写入 w
+    template <typename Scalar>
+    void KrylovRandomVector(int n, int k, Scalar const * V, int ldV, Scalar * w, std::mt19937 & gen)
+    {
+        WorkspaceFrame frame;
+        Scalar * h = frame.Alloc<Scalar>(std::max(k, 1));
+        std::uniform_real_distribution<Scalar> dist(-1, 1);
+        Scalar norm = 0;
+        while (0 == norm) {
+            for (int i = 0; i < n; ++i)
+                w[i] = dist(gen);
+            norm = (k > 0) ? KrylovOrthogonalize(n, k, V, ldV, w, h) : std::sqrt(SimdDot(n, w, w));
+        }
+        SimdScale(n, 1 / norm, w, w);
+    }
+
+    //! @brief 把 Arnoldi 分解 A V_j = V_j H_j + f e_j^T 从 j = start 扩展到 j = m
+    //!
+    //! 调用前 V 的前 start+1 列为单位正交向量, H 的前 start 列已经填好。
+    //! 第 j 步计算 w = A v_j, 与 V 的前 j+1 列正交化得到 H 的第 j 列, 归一化后作为 v_{j+1}。
+    //! symmetric 时同时写入 H 的第 j 行, 使 H 保持对称。
+    //! 出现不变子空间时以随机的正交向量继续, 对应的次对角元素为 0。
+    //!
+    //! @param [in] n 向量长度
+    //! @param [in] op 线性算子, op(x, y) 计算 y = A x
+    //! @param [in|out] V, ldV 列优先存储的 n x (m+1) 矩阵, 输出时第 m 列为归一化的残差向量
+    //! @param [in|out] H, ldH 列优先存储的 m x m 矩阵
+    //! @param [in] start, m 扩展的起止位置
+    //! @param [in] symmetric 算子是否对称
+    //! @param [in|out] gen 随机数发生器
+    //! @return 残差向量的范数 beta, f = beta v_m
+    template <typename Scalar, typename Op>
+    Scalar ArnoldiExtend(int n, Op & op, Scalar * V, int ldV, Scalar * H, int ldH,
+                         int start, int m, bool symmetric, std::mt19937 & gen)
+    {
+        WorkspaceFrame frame;
+        Scalar * h = frame.Alloc<Scalar>(m);
+        Scalar beta = 0;
+        for (int j = start; j < m; ++j) {
+            Scalar * w = V + (j + 1) * ldV;
+            op(V + j * ldV, w);
+            Scalar wnorm = std::sqrt(SimdDot(n, w, w));
+            beta = KrylovOrthogonalize(n, j + 1, V, ldV, w, h);
+            for (int i = 0; i <= j; ++i) {
+                H[i + j * ldH] = h[i];
+                if (symmetric)
+                    H[j + i * ldH] = h[i];
+            }
+
+            if (beta <= std::numeric_limits<Scalar>::epsilon() * wnorm) {
+                beta = 0;
+                KrylovRandomVector(n, j + 1, V, ldV, w, gen);
+            } else {
+                SimdScale(n, 1 / beta, w, w);
+            }
+            if (j + 1 < m) {
+                H[(j + 1) + j * ldH] = beta;
+                if (symmetric)
+                    H[j + (j + 1) * ldH] = beta;
+            }
+        }
+        return beta;
+    }
+
+    //! @brief 隐式重启的偏移, 以 (sr, si) 为偏移对 H 做 QR 迭代 H = Q^T H Q, 并累积 Z = Z Q
+    //!
+    //! 实偏移 mu 对 H - mu I 做 QR 分解; 共轭复偏移 mu, conj(mu) 必须相邻, 虚部为正的在前,
+    //! 合并为一次实的双重步, 对 H^2 - 2 Re(mu) H + |mu|^2 I 做 QR 分解。
+    //! H 只有 m x m, 直接对稠密矩阵做分块 Householder QR。
+    //!
+    //! @param [in] m H 的尺寸
+    //! @param [in|out] H, ldH 列优先存储的 m x m 矩阵
+    //! @param [in|out] Z, ldZ 列优先存储的 m x m 矩阵
+    //! @param [in] nshift 偏移的数量
+    //! @param [in] sr, si 偏移的实部和虚部
+    template <typename Scalar>
+    void KrylovApplyShifts(int m, Scalar * H, int ldH, Scalar * Z, int ldZ,
+                           int nshift, Scalar const * sr, Scalar const * si)
+    {
+        constexpr int nb = 32;
+        WorkspaceFrame frame;
+        Scalar * M = frame.Alloc<Scalar>(m * m);
+        Scalar * tau = frame.Alloc<Scalar>(m);
+        Scalar * T = frame.Alloc<Scalar>(nb * m);
+
+        for (int s = 0; s < nshift; ++s) {
+            if (0 == si[s]) {
+                for (int c = 0; c < m; ++c)
+                    for (int r = 0; r < m; ++r)
+                        M[r + c * m] = H[r + c * ldH] - ((r == c) ? sr[s] : Scalar(0));
+            } else {
+                Scalar t = 2 * sr[s];
+                Scalar d = sr[s] * sr[s] + si[s] * si[s];
+                Gemm(m, m, m, Scalar(1), H, 1, ldH, H, 1, ldH, Scalar(0), M, 1, m);
+                for (int c = 0; c < m; ++c)
+                    for (int r = 0; r < m; ++r)
+                        M[r + c * m] -= t * H[r + c * ldH] - ((r == c) ? d : Scalar(0));
+                ++s;
+            }
+
+            // H = Q^T H Q, 右乘 Q 即对 H^T 左乘 Q^T; Z = Z Q 同理
+            HouseholderQR(m, m, M, 1, m, tau, T, nb);
+            HouseholderApplyQ(m, m, m, M, 1, m, T, nb, true, H, 1, ldH);
+            HouseholderApplyQ(m, m, m, M, 1, m, T, nb, true, H, ldH, 1);
+            HouseholderApplyQ(m, m, m, M, 1, m, T, nb, true, Z, ldZ, 1);
+        }
+    }
+
+    /**
+     * @brief 隐式重启的 Krylov 子空间特征值求解器
+     *
+     * Symmetric 为 true 时即 Lanczos 方法, 只适用于对称的算子, 特征值都是实数;
+     * 否则为 Arnoldi 方法, 共轭复特征值成对出现。算子可以是矩阵, 也可以是计算 y = A x 的函数
+     * op(Scalar const * x, Scalar * y)。ComputeShiftInvert 对 (A - sigma I)^{-1} 迭代, 求最接近 sigma 的特征值。
+     *
+     * 特征向量与 EigenFrancisQR 的约定相同: 第 j 个特征值为实数时 V 的第 j 列为其单位特征向量;
+     * 第 j, j+1 个特征值为共轭复数时, V(:, j) +- i V(:, j+1) 分别为它们的特征向量。
+     * 第 k 个特征值是共轭对的前一个时, 多输出一个特征对。
+     */
+    template <typename _Scalar, bool Symmetric>
+    class KrylovEigen {
+        public:
+            typedef _Scalar Scalar;
+
+            /**
+             * @brief 默认构造函数, 之后通过 Compute 求解
+             */
+            KrylovEigen()
+            {}
+
+            /**
+             * @brief 求矩阵 A 的 k 个特征对
+             *
+             * @param [in] A n x n 的矩阵, 连续存储的浮点数矩阵直接交给 Gemv
+             * @param [in] k 特征值的数量, 小于 n
+             * @param [in] which 需要哪一端的特征值
+             * @param [in] ncv Krylov 子空间的维数, 0 时取 max(2k+1, 20), 不超过 n
+             * @param [in] tol 收敛的相对阈值, 0 时取 eps^(2/3)。残差小于 tol |lambda| 时认为收敛,
+             *                 特征值紧密聚集时残差很难降到机器精度
+             * @param [in] max_restarts 最大重启次数
+             * @return 重启的次数
+             */
+            template <typename MatrixA>
+            int Compute(MatrixA const & A, int k, KrylovWhich which = KrylovWhich::LargestMagnitude,
+                        int ncv = 0, Scalar tol = 0, int max_restarts = 300)
+            {
+                assert(A.Rows() == A.Cols());
+                int n = A.Rows();
+                auto op = [&A, n](Scalar const * x, Scalar * y) {
+                    if constexpr (GemmDispatchable<MatrixA, MatrixA, DMatrix<Scalar>>::value) {
+                        Gemv(n, n, Scalar(1), A.StorBegin(), A.RowStride(), A.ColStride(), x, Scalar(0), y);
+                    } else {
+                        for (int r = 0; r < n; ++r) {
+                            Scalar sum = 0;
+                            for (int c = 0; c < n; ++c)
+                                sum += A(r, c) * x[c];
+                            y[r] = sum;
+                        }
+                    }
+                };
+                return Compute(n, op, k, which, ncv, tol, max_restarts);
+            }
+
+            /**
+             * @brief 求线性算子的 k 个特征对
+             *
+             * @param [in] n 算子的维数
+             * @param [in] op 线性算子, op(x, y) 计算 y = A x, x 和 y 都是 n 个元素的连续存储
+             * @param 其余参数同上
+             */
+            template <typename Op>
+            int Compute(int n, Op && op, int k, KrylovWhich which = KrylovWhich::LargestMagnitude,
+                        int ncv = 0, Scalar tol = 0, int max_restarts = 300)
+            {
+                assert(k > 0 && k < n);
+                int m = (ncv > 0) ? ncv : std::max(2 * k + 1, 20);
+                m = std::min(std::max(m, k + 2), n);
+
+                constexpr Scalar eps = std::numeric_limits<Scalar>::epsilon();
+                Scalar eps23 = std::pow(eps, Scalar(2) / Scalar(3));
+                if (0 == tol)
+                    tol = eps23;
+
+                mV.Resize(n, m + 1);
+                mH.Resize(m, m);
+                mZ.Resize(m, m);
+                mWork.Resize(n, m);
+                std::fill(mH.StorBegin(), mH.StorBegin() + m * m, Scalar(0));
+                mWr.resize(m);
+                mWi.resize(m);
+                mShiftRe.resize(m);
+                mShiftIm.resize(m);
+                mResid.resize(m);
+                mOrder.resize(m);
+
+                Scalar * V = mV.StorBegin();
+                Scalar * H = mH.StorBegin();
+                std::mt19937 gen(5489u);
+                KrylovRandomVector(n, 0, V, n, V, gen);
+
+                int start = 0;
+                for (int restart = 0; ; ++restart) {
+                    Scalar beta = ArnoldiExtend(n, op, V, n, H, m, start, m, Symmetric, gen);
+                    Ritz(m, beta, which);
+
+                    int nconv = 0;
+                    for (int i = 0; i < k; ++i) {
+                        int idx = mOrder[i];
+                        Scalar lambda = std::hypot(mWr[idx], mWi[idx]);
+                        if (mResid[idx] <= tol * std::max(eps23, lambda))
+                            nconv++;
+                    }
+                    if (nconv >= k) {
+                        Output(n, m, k);
+                        return restart;
+                    }
+                    if (restart == max_restarts)
+                        throw std::runtime_error("迭代不收敛");
+
+                    // 与 ARPACK 相同, 保留的维数随着收敛的数量增加, 避免停滞; 不拆分共轭对
+                    int keep = k + std::min(nconv, (m - k) / 2);
+                    if (SplitsPair(keep))
+                        keep = (keep + 1 < m) ? keep + 1 : keep - 1;
+
+                    for (int i = keep; i < m; ++i) {
+                        mShiftRe[i - keep] = mWr[mOrder[i]];
+                        mShiftIm[i - keep] = mWi[mOrder[i]];
+                    }
+                    Restart(n, m, keep, beta, gen);
+                    start = keep;
+                }
+            }
+
+            /**
+             * @brief 移位求逆, 求矩阵 A 最接近 sigma 的 k 个特征对
+             *
+             * 对 A - sigma I 做 LU 分解, 以 (A - sigma I)^{-1} 为算子求模最大的特征值 theta,
+             * 则 lambda = sigma + 1 / theta。sigma 恰好为特征值时 LU 分解抛出异常。
+             */
+            template <typename MatrixA>
+            int ComputeShiftInvert(MatrixA const & A, int k, Scalar sigma,
+                                   int ncv = 0, Scalar tol = 0, int max_restarts = 300)
+            {
+                assert(A.Rows() == A.Cols());
+                int n = A.Rows();
+                DMatrix<Scalar> As = A;
+                SubDiagScalar(As, sigma);
+                LU<DMatrix<Scalar>> lu(As);
+                auto solve = [&lu, n](Scalar const * x, Scalar * y) {
+                    std::copy(x, x + n, y);
+                    DMatrixView<Scalar> yv(y, n, 1);
+                    lu.Solve(yv, yv);
+                };
+                return ComputeShiftInvert(n, solve, k, sigma, ncv, tol, max_restarts);
+            }
+
+            /**
+             * @brief 移位求逆, solve(x, y) 计算 y = (A - sigma I)^{-1} x, 适用于自己分解矩阵的场合
+             */
+            template <typename Solve>
+            int ComputeShiftInvert(int n, Solve && solve, int k, Scalar sigma,
+                                   int ncv = 0, Scalar tol = 0, int max_restarts = 300)
+            {
+                int num = Compute(n, solve, k, KrylovWhich::LargestMagnitude, ncv, tol, max_restarts);
+                for (size_t i = 0; i < mValuesReal.size(); ++i) {
+                    Scalar tr = mValuesReal[i], ti = mValuesImag[i];
+                    Scalar d = tr * tr + ti * ti;
+                    mValuesReal[i] = sigma + tr / d;
+                    mValuesImag[i] = -ti / d;
+                }
+                // 1 / theta 翻转了虚部的符号, 交换共轭对的两个特征值使虚部为正的在前
+                for (size_t i = 0; i + 1 < mValuesImag.size(); ++i) {
+                    if (mValuesImag[i] < 0 && mValuesImag[i + 1] > 0) {
+                        std::swap(mValuesImag[i], mValuesImag[i + 1]);
+                        int rows = mVectors.Rows();
+                        Scalar * im = mVectors.StorBegin() + (i + 1) * rows;
+                        for (int r = 0; r < rows; ++r)
+                            im[r] = -im[r];
+                        ++i;
+                    }
+                }
+                return num;
+            }
+
+        private:
+            /**
+             * @brief 求 H 的特征值和单位特征向量 Y, 并按 which 排序, 残差为 |beta e_m^T y|
+             */
+            void Ritz(int m, Scalar beta, KrylovWhich which)
+            {
+                if constexpr (Symmetric) {
+                    mSym.Decompose(mH);
+                    mY = mSym.EigenVectors();
+                    for (int i = 0; i < m; ++i) {
+                        mWr[i] = mSym.EigenValues()[i];
+                        mWi[i] = 0;
+                        mResid[i] = std::abs(beta * mY(m - 1, i));
+                    }
+                } else {
+                    mSchur.Iterate(mH);
+                    mSchur.EigenVectors(mY);
+                    for (int i = 0; i < m; ++i) {
+                        mWr[i] = mSchur.EigenValuesReal()[i];
+                        mWi[i] = mSchur.EigenValuesImag()[i];
+                    }
+                    for (int i = 0; i < m; ++i) {
+                        if (0 != mWi[i] && i + 1 < m) {
+                            mResid[i] = mResid[i + 1] = std::abs(beta) * std::hypot(mY(m - 1, i), mY(m - 1, i + 1));
+                            ++i;
+                        } else {
+                            mResid[i] = std::abs(beta * mY(m - 1, i));
+                        }
+                    }
+                }
+
+                for (int i = 0; i < m; ++i)
+                    mOrder[i] = i;
+                // 共轭对的排序键相同, 稳定排序使其保持相邻, 虚部为正的在前
+                std::stable_sort(mOrder.begin(), mOrder.end(), [&](int a, int b) {
+                    return KrylovPrefer(which, mWr[a], mWi[a], mWr[b], mWi[b]);
+                });
+            }
+
+            //! @brief 前 keep 个 Ritz 值是否拆开了一个共轭对
+            bool SplitsPair(int keep) const
+            {
+                return !Symmetric && keep < (int)mOrder.size() && mWi[mOrder[keep - 1]] > 0;
+            }
+
+            /**
+             * @brief 以 mShiftRe, mShiftIm 的前 m - keep 个元素为偏移压缩 Arnoldi 分解到 keep 列
+             *
+             * H = Z^T H Z, V = V Z 以后, A V_keep = V_keep H_keep + f_keep e_keep^T,
+             * 其中 f_keep = v_keep H(keep, keep-1) + f Z(m-1, keep-1)
+             */
+            void Restart(int n, int m, int keep, Scalar beta, std::mt19937 & gen)
+            {
+                Scalar * V = mV.StorBegin();
+                Scalar * H = mH.StorBegin();
+                Scalar * Z = mZ.StorBegin();
+                Scalar * W = mWork.StorBegin();
+
+                mZ.Identity();
+                KrylovApplyShifts(m, H, m, Z, m, m - keep, mShiftRe.data(), mShiftIm.data());
+                if constexpr (Symmetric) {
+                    for (int c = 0; c < m; ++c)
+                        for (int r = c + 1; r < m; ++r)
+                            H[r + c * m] = H[c + r * m] = (H[r + c * m] + H[c + r * m]) / 2;
+                }
+
+                // W = V_m Z(:, 0:keep+1), f = W(:, keep) H(keep, keep-1) + beta v_m Z(m-1, keep-1)
+                Gemm(n, keep + 1, m, Scalar(1), V, 1, n, Z, 1, m, Scalar(0), W, 1, n);
+                Scalar * f = V + keep * n;
+                SimdScale(n, H[keep + (keep - 1) * m], W + keep * n, f);
+                SimdAxpy(n, beta * Z[(m - 1) + (keep - 1) * m], V + m * n, f);
+                std::copy(W, W + keep * n, V);
+
+                Scalar f0 = std::sqrt(SimdDot(n, f, f));
+                Scalar fnorm = KrylovOrthogonalize(n, keep, V, n, f, W);
+                for (int c = 0; c < m; ++c)
+                    for (int r = 0; r < m; ++r)
+                        if (r >= keep || c >= keep)
+                            H[r + c * m] = 0;
+                if (fnorm <= std::numeric_limits<Scalar>::epsilon() * f0) {
+                    fnorm = 0;
+                    KrylovRandomVector(n, keep, V, n, f, gen);
+                } else {
+                    SimdScale(n, 1 / fnorm, f, f);
+                }
+                H[keep + (keep - 1) * m] = fnorm;
+                if (Symmetric)
+                    H[(keep - 1) + keep * m] = fnorm;
+            }
+
+            //! @brief 输出前 k 个特征值及特征向量 X = V_m Y
+            void Output(int n, int m, int k)
+            {
+                if (SplitsPair(k))
+                    k++;
+                mValuesReal.resize(k);
+                mValuesImag.resize(k);
+                WorkspaceFrame frame;
+                Scalar * Y = frame.Alloc<Scalar>(m * k);
+                for (int i = 0; i < k; ++i) {
+                    int idx = mOrder[i];
+                    mValuesReal[i] = mWr[idx];
+                    mValuesImag[i] = mWi[idx];
+                    // 共轭对的后一个取虚部, 即 Y 的下一列
+                    int col = (mWi[idx] < 0) ? mOrder[i - 1] + 1 : idx;
+                    for (int r = 0; r < m; ++r)
+                        Y[r + i * m] = mY(r, col);
+                }
+                mVectors.Resize(n, k);
+                Gemm(n, k, m, Scalar(1), mV.StorBegin(), 1, n, Y, 1, m, Scalar(0), mVectors.StorBegin(), 1, n);
+            }
+
+        public:
+            //! @brief 特征值, 对称时即 EigenValuesReal
+            std::vector<Scalar> const & EigenValues() const { return mValuesReal; }
+            //! @brief 特征值的实部, 按 which 的顺序排列
+            std::vector<Scalar> const & EigenValuesReal() const { return mValuesReal; }
+            //! @brief 特征值的虚部, 共轭复特征值成对出现, 虚部为正的在前
+            std::vector<Scalar> const & EigenValuesImag() const { return mValuesImag; }
+            //! @brief 特征向量, n x k
+            DMatrix<Scalar> const & EigenVectors() const { return mVectors; }
+
+        private:
+            //! @brief Krylov 基, n x (m+1), 最后一列为归一化的残差向量
+            DMatrix<Scalar> mV;
+            //! @brief 投影矩阵 H = V_m^T A V_m, m x m
+            DMatrix<Scalar> mH;
+            //! @brief H 的特征向量
+            DMatrix<Scalar> mY;
+            //! @brief 重启时累积的正交变换
+            DMatrix<Scalar> mZ;
+            //! @brief 重启时的工作空间, n x m
+            DMatrix<Scalar> mWork;
+            SymmetricEigen<DMatrix<Scalar>> mSym;
+            EigenFrancisQR<DMatrix<Scalar>> mSchur;
+            std::vector<Scalar> mWr;
+            std::vector<Scalar> mWi;
+            //! @brief 重启时的偏移, 即不需要的 Ritz 值
+            std::vector<Scalar> mShiftRe;
+            std::vector<Scalar> mShiftIm;
+            std::vector<Scalar> mResid;
+            std::vector<int> mOrder;
+
+            DMatrix<Scalar> mVectors;
+            std::vector<Scalar> mValuesReal;
+            std::vector<Scalar> mValuesImag;
+    };
+
+    //! @brief 对称算子的隐式重启 Lanczos 方法
+    template <typename Scalar>
+    using EigenLanczos = KrylovEigen<Scalar, true>;
+
+    //! @brief 一般算子的隐式重启 Arnoldi 方法
+    template <typename Scalar>
+    using EigenArnoldi = KrylovEigen<Scalar, false>;
+
+}
+
+#endif
@@ -40,14 +40,14 @@ namespace xiaotu {
                 DMatrix<Scalar> tmp1 = DMatrix<Scalar>::Zero(n, n);
                 // std::cout << "Hessenberg:" << h.H() << std::endl;
 
-                std::vector<MatrixSubView<Mat>> parts0;
-                std::vector<MatrixSubView<Mat>> parts1;
-                std::vector<MatrixSubView<Mat>> parts2;
-                std::vector<MatrixSubView<Mat>> parts3;
-                std::vector<MatrixSubView<Mat>> * pParts0 = &parts0;
-                std::vector<MatrixSubView<Mat>> * pParts1 = &parts1;
-                std::vector<MatrixSubView<Mat>> * pParts2 = &parts2;
-                std::vector<MatrixSubView<Mat>> * pParts3 = &parts3;
+                std::vector<typename Mat::SubView> parts0;
+                std::vector<typename Mat::SubView> parts1;
+                std::vector<typename Mat::SubView> parts2;
+                std::vector<typename Mat::SubView> parts3;
+                std::vector<typename Mat::SubView> * pParts0 = &parts0;
+                std::vector<typename Mat::SubView> * pParts1 = &parts1;
+                std::vector<typename Mat::SubView> * pParts2 = &parts2;
+                std::vector<typename Mat::SubView> * pParts3 = &parts3;
                 pParts0->push_back(tmp0.SubMatrix(0, 0, n, n));
                 pParts1->push_back(tmp1.SubMatrix(0, 0, n, n));
 
@@ -102,7 +102,7 @@ namespace xiaotu {
              *
              * @return true - 复特征值, false 实特征值
              */
-            bool Solve2x2(MatrixSubView<Mat> const & a1)
+            bool Solve2x2(typename Mat::SubView const & a1)
             {
                 assert(a1.Rows() == 2);
                 Scalar tr = a1(0, 0) + a1(1, 1);
@@ -131,10 +131,10 @@ namespace xiaotu {
              * @param [out] 输出分割列表 part4 对应 a1
              * @return 分割的对角块数量
              */
-            int Partition(MatrixSubView<Mat> & a0,
-                          MatrixSubView<Mat> & a1,
-                          std::vector<MatrixSubView<Mat>> & parts2,
-                          std::vector<MatrixSubView<Mat>> & parts3)
+            int Partition(typename Mat::SubView & a0,
+                          typename Mat::SubView & a1,
+                          std::vector<typename Mat::SubView> & parts2,
+                          std::vector<typename Mat::SubView> & parts3)
             {
                 int n = a1.Rows();
                 int start = 0;
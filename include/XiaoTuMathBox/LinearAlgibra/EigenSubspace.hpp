@@ -0,0 +1,213 @@
+#ifndef XTMB_LA_EIGEN_SUBSPACE_H
+#define XTMB_LA_EIGEN_SUBSPACE_H
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include <XiaoTuMathBox/LinearAlgibra/Gemm.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/Householder.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/SymmetricEigen.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 对称矩阵的块幂法 (子空间迭代), 求模最大的 k 个特征对
+//
+// 与 PowerIterate 每次只推进一个向量不同, 同时推进 p >= k 个向量 X, 每步的 Y = A X 是一次 Gemm,
+// 计算密度远高于矩阵向量乘法。每步在 p x p 的投影矩阵 X^T A X 上做 Rayleigh-Ritz,
+// 由 SymmetricEigen 求解, 把 X 旋转到 Ritz 向量上; 已经收敛的 Ritz 向量锁定 (locking),
+// 不再参与乘法, 其余向量与锁定的向量正交化后继续迭代。第 i 个向量的收敛速度为 |lambda_{p+1} / lambda_i|。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    /**
+     * @brief 对称矩阵的子空间迭代, 求模最大的 k 个特征值及特征向量
+     *
+     * 特征值按模降序排列。尺寸与上次相同时以上次的子空间为初值, 矩阵缓慢变化时 (例如周期性更新的核矩阵)
+     * 通常只需要很少的迭代。
+     */
+    template <typename MatViewIn>
+    class EigenSubspace {
+        public:
+            typedef typename MatViewIn::Scalar Scalar;
+
+            /**
+             * @brief 默认构造函数, 之后通过 Compute 求解
+             */
+            EigenSubspace()
+            {}
+
+            EigenSubspace(MatViewIn const & a, int k, int block = 0)
+            {
+                Compute(a, k, block);
+            }
+
+            /**
+             * @brief 求对称矩阵 a 模最大的 k 个特征对
+             *
+             * @param [in] a 对称矩阵, 连续存储的浮点数矩阵直接参与 Gemm, 否则先拷贝一份
+             * @param [in] k 特征值的数量
+             * @param [in] block 子空间的维数 p, 0 时取 max(k + k/2, k + 4), 不超过 n
+             * @param [in] tol 收敛的相对阈值, ||A x - lambda x|| <= tol max(|lambda|, ||A||) 时锁定, 0 时取 eps^(2/3)
+             * @param [in] max_iter 最大迭代次数
+             * @return 迭代次数
+             */
+            int Compute(MatViewIn const & a, int k, int block = 0, Scalar tol = 0, int max_iter = 1000)
+            {
+                assert(a.Rows() == a.Cols());
+                if constexpr (GemmDispatchable<MatViewIn, MatViewIn, DMatrix<Scalar>>::value) {
+                    return Solve(a.Rows(), a.StorBegin(), a.RowStride(), a.ColStride(), k, block, tol, max_iter);
+                } else {
+                    DMatrix<Scalar> A(a.Rows(), a.Cols());
+                    for (int c = 0; c < A.Cols(); c++)
+                        for (int r = 0; r < A.Rows(); r++)
+                            A(r, c) = a(r, c);
+                    return Solve(A.Rows(), A.StorBegin(), A.RowStride(), A.ColStride(), k, block, tol, max_iter);
+                }
+            }
+
+        private:
+            int Solve(int n, Scalar const * A, int rsA, int csA, int k, int block, Scalar tol, int max_iter)
+            {
+                assert(k > 0 && k <= n);
+                int p = (block > 0) ? block : std::max(k + k / 2, k + 4);
+                p = std::min(std::max(p, k), n);
+                if (0 == tol)
+                    tol = std::pow(std::numeric_limits<Scalar>::epsilon(), Scalar(2) / Scalar(3));
+
+                if (mX.Rows() != n || mX.Cols() != p) {
+                    mX.Resize(n, p);
+                    std::mt19937 gen(5489u);
+                    std::uniform_real_distribution<Scalar> dist(-1, 1);
+                    for (int i = 0; i < mX.NumDatas(); i++)
+                        mX(i) = dist(gen);
+                    HouseholderThinQ(n, p, mX.StorBegin(), n, (Scalar*)nullptr, p);
+                }
+                mY.Resize(n, p);
+                mValues.resize(p);
+                mOrder.resize(p);
+                mNorm = 0;
+
+                Scalar * X = mX.StorBegin();
+                Scalar * Y = mY.StorBegin();
+                int nl = 0;
+                for (int iter = 1; iter <= max_iter; iter++) {
+                    int pa = p - nl;
+                    Scalar * Xa = X + nl * n;
+                    Scalar * Ya = Y + nl * n;
+                    Gemm(n, pa, n, Scalar(1), A, rsA, csA, Xa, 1, n, Scalar(0), Ya, 1, n);
+
+                    int j = RayleighRitz(n, pa, Xa, Ya, mValues.data() + nl, tol, k - nl);
+                    nl += j;
+                    if (nl >= k) {
+                        mValues.resize(k);
+                        mVectors.Resize(n, k);
+                        std::copy(X, X + n * k, mVectors.StorBegin());
+                        return iter;
+                    }
+
+                    // 未锁定的向量继续做一次幂迭代, 与锁定的向量正交化 (两遍) 以后重新单位正交化
+                    pa = p - nl;
+                    Xa = X + nl * n;
+                    Ya = Y + nl * n;
+                    std::copy(Ya, Ya + n * pa, Xa);
+                    if (nl > 0) {
+                        WorkspaceFrame frame;
+                        Scalar * C = frame.Alloc<Scalar>(nl * pa);
+                        for (int pass = 0; pass < 2; pass++) {
+                            Gemm(nl, pa, n, Scalar(1), X, n, 1, Xa, 1, n, Scalar(0), C, 1, nl);
+                            Gemm(n, pa, nl, Scalar(-1), X, 1, n, C, 1, nl, Scalar(1), Xa, 1, n);
+                        }
+                    }
+                    HouseholderThinQ(n, pa, Xa, n, (Scalar*)nullptr, pa);
+                }
+                throw std::runtime_error("迭代不收敛");
+            }
+
+            /**
+             * @brief 在 Xa 张成的子空间上做 Rayleigh-Ritz, 并统计可以锁定的向量
+             *
+             * H = Xa^T Ya 的特征向量 S 按特征值的模降序排列, Xa = Xa S, Ya = Ya S,
+             * 即 Xa 为 Ritz 向量, Ya = A Xa。从第一列开始, 残差满足阈值的连续若干列可以锁定。
+             * 阈值以 Ritz 值的模与 ||A|| 的估计 (目前为止最大的 |theta|) 中较大者为尺度, 否则 0 特征值永远不会锁定。
+             *
+             * @param [in] n 向量长度
+             * @param [in] pa 活动向量的数量
+             * @param [in|out] Xa, Ya 列优先存储的 n x pa 矩阵
+             * @param [out] theta Ritz 值
+             * @param [in] tol 收敛的相对阈值
+             * @param [in] need 最多锁定的数量
+             * @return 锁定的数量
+             */
+            int RayleighRitz(int n, int pa, Scalar * Xa, Scalar * Ya, Scalar * theta, Scalar tol, int need)
+            {
+                mH.Resize(pa, pa);
+                Gemm(pa, pa, n, Scalar(1), Xa, n, 1, Ya, 1, n, Scalar(0), mH.StorBegin(), 1, pa);
+                mEig.Decompose(mH);
+                auto const & d = mEig.EigenValues();
+                auto const & V = mEig.EigenVectors();
+
+                std::vector<int> & order = mOrder;
+                order.resize(pa);
+                for (int i = 0; i < pa; i++)
+                    order[i] = i;
+                std::stable_sort(order.begin(), order.end(), [&d](int a, int b) {
+                    return std::abs(d[a]) > std::abs(d[b]);
+                });
+                for (int c = 0; c < pa; c++) {
+                    theta[c] = d[order[c]];
+                    for (int r = 0; r < pa; r++)
+                        mH(r, c) = V(r, order[c]);
+                }
+                mNorm = std::max(mNorm, std::abs(theta[0]));
+
+                WorkspaceFrame frame;
+                Scalar * W = frame.Alloc<Scalar>(n * pa);
+                Gemm(n, pa, pa, Scalar(1), Xa, 1, n, mH.StorBegin(), 1, pa, Scalar(0), W, 1, n);
+                std::copy(W, W + n * pa, Xa);
+                Gemm(n, pa, pa, Scalar(1), Ya, 1, n, mH.StorBegin(), 1, pa, Scalar(0), W, 1, n);
+                std::copy(W, W + n * pa, Ya);
+
+                int nconv = 0;
+                Scalar * r = W;
+                for (; nconv < std::min(pa, need); nconv++) {
+                    Scalar const * x = Xa + nconv * n;
+                    Scalar const * y = Ya + nconv * n;
+                    for (int i = 0; i < n; i++)
+                        r[i] = y[i] - theta[nconv] * x[i];
+                    if (std::sqrt(SimdDot(n, r, r)) > tol * std::max(std::abs(theta[nconv]), mNorm))
+                        break;
+                }
+                return nconv;
+            }
+
+        public:
+            //! @brief 模最大的 k 个特征值, 按模降序排列
+            std::vector<Scalar> const & EigenValues() const { return mValues; }
+            //! @brief 对应的单位特征向量, n x k
+            DMatrix<Scalar> const & EigenVectors() const { return mVectors; }
+
+        private:
+            //! @brief 子空间的单位正交基, n x p, 前面的若干列已经锁定
+            DMatrix<Scalar> mX;
+            //! @brief A X, n x p
+            DMatrix<Scalar> mY;
+            //! @brief 投影矩阵, 以及按序排列的 Ritz 向量
+            DMatrix<Scalar> mH;
+            SymmetricEigen<DMatrix<Scalar>> mEig;
+            std::vector<Scalar> mValues;
+            DMatrix<Scalar> mVectors;
+            //! @brief Ritz 值的排序
+            std::vector<int> mOrder;
+            //! @brief ||A|| 的估计, 即目前为止最大的 |theta|
+            Scalar mNorm = 0;
+    };
+
+}
+
+#endif
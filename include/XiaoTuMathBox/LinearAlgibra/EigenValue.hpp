@@ -1,10 +1,15 @@
 #ifndef XTMB_LA_MATRIX_EIGEN_VALUE_H
 #define XTMB_LA_MATRIX_EIGEN_VALUE_H
 
+#include <XiaoTuMathBox/LinearAlgibra/SchurEigenVectors.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/EigenNaiveQR.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/EigenShiftQR.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/EigenPartitionQR.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/EigenImplicitQR.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/EigenFrancisQR.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/SymmetricEigen.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/EigenKrylov.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/EigenSubspace.hpp>
 
 #include <cassert>
 #include <algorithm>
@@ -31,7 +36,7 @@ namespace xiaotu {
         typename MatrixA::Scalar re = 0;
         v = v / v.Norm();
         for (int i = 0; i < max_iter; i++) {
-            auto w = A * v;
+            DMatrix<typename MatrixA::Scalar> w = A * v;
             auto r = v.Dot(w);
             v = w / w.Norm();
 
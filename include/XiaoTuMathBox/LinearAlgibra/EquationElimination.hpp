@@ -205,6 +205,38 @@ namespace xiaotu {
         return GaussRowEliminate(tmp).size();
     }
 
+    //! @brief 回代求解上三角线性方程组 R x = b
+    //!
+    //! 只读取 R 左上角 n x n 的上三角部分, n 为 x 的行数, 可以直接传入紧凑保存的 QR 分解结果
+    //!
+    //! @param [in] R 上三角系数矩阵, 至少 n x n
+    //! @param [inout] x 线性方程组右侧的向量们, 输出解们
+    //! @return 对角元素接近 0 时返回 false
+    template <typename MatViewR, typename MatViewX>
+    bool BackSubstitute(MatViewR const & R, MatViewX & x)
+    {
+        typedef typename MatViewX::Scalar Scalar;
+
+        int n = x.Rows();
+        int m = x.Cols();
+        assert(R.Rows() >= n && R.Cols() >= n);
+
+        for (int i = 0; i < n; i++) {
+            if (std::abs(R(i, i)) < SMALL_VALUE)
+                return false;
+        }
+
+        for (int c = 0; c < m; c++) {
+            for (int j = n - 1; j >= 0; j--) {
+                Scalar xj = x(j, c) / R(j, j);
+                x(j, c) = xj;
+                for (int i = 0; i < j; i++)
+                    x(i, c) -= xj * R(i, j);
+            }
+        }
+        return true;
+    }
+
 
 }
 
@@ -0,0 +1,370 @@
+#ifndef XTMB_LA_GEMM_H
+#define XTMB_LA_GEMM_H
+
+#include <algorithm>
+
+#include <XiaoTuMathBox/Common/ThreadPool.hpp>
+#include <XiaoTuMathBox/Common/Workspace.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/Simd.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 通用矩阵乘法 GEMM, C = alpha * A * B + beta * C
+//
+// 参考 GotoBLAS/BLIS 的分块策略:
+//   jc 循环把 B 按 NC 列切块, pc 循环把 k 维按 KC 切块, B 的 KC x NC 块打包后驻留 L3;
+//   ic 循环把 A 按 MC 行切块, A 的 MC x KC 块打包后驻留 L2;
+//   宏内核遍历 MR x NR 的寄存器分块, 由微内核完成 kc 次秩 1 更新。
+//
+// 所有接口都基于裸指针和行/列步长，与矩阵的行优先/列优先存储方式无关。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief GEMM 的分块参数
+    //!
+    //! MR x NR 为微内核的寄存器分块, MC x KC 为 A 的打包块, KC x NC 为 B 的打包块
+    template <typename Scalar>
+    struct GemmBlocking {
+        constexpr static int MR = 4;
+        constexpr static int NR = 8;
+        constexpr static int MC = 128;
+        constexpr static int KC = 256;
+        constexpr static int NC = 2048;
+        //! m*n*k 不超过该值时直接三重循环, 打包的开销不划算
+        constexpr static long SmallSize = 16 * 16 * 16;
+    };
+
+    //! @brief 将 A 的 mc x kc 子块打包成若干 MR 行的连续条带, 不足 MR 行的部分补零
+    //!
+    //! @param [in] mc 子块行数
+    //! @param [in] kc 子块列数
+    //! @param [in] A 子块起始地址
+    //! @param [in] rsA A 的行步长
+    //! @param [in] csA A 的列步长
+    //! @param [out] buf 打包缓存, 至少 ceil(mc/MR)*MR*kc 个元素
+    template <typename Scalar, int MR>
+    void GemmPackA(int mc, int kc, Scalar const * A, int rsA, int csA, Scalar * buf)
+    {
+        for (int ir = 0; ir < mc; ir += MR) {
+            int mr = std::min(MR, mc - ir);
+            Scalar const * a = A + ir * rsA;
+            for (int p = 0; p < kc; ++p) {
+                Scalar const * ap = a + p * csA;
+                int i = 0;
+                for (; i < mr; ++i)
+                    buf[i] = ap[i * rsA];
+                for (; i < MR; ++i)
+                    buf[i] = 0;
+                buf += MR;
+            }
+        }
+    }
+
+    //! @brief 将 B 的 kc x nc 子块打包成若干 NR 列的连续条带, 不足 NR 列的部分补零
+    //!
+    //! @param [in] kc 子块行数
+    //! @param [in] nc 子块列数
+    //! @param [in] B 子块起始地址
+    //! @param [in] rsB B 的行步长
+    //! @param [in] csB B 的列步长
+    //! @param [out] buf 打包缓存, 至少 kc*ceil(nc/NR)*NR 个元素
+    template <typename Scalar, int NR>
+    void GemmPackB(int kc, int nc, Scalar const * B, int rsB, int csB, Scalar * buf)
+    {
+        for (int jr = 0; jr < nc; jr += NR) {
+            int nr = std::min(NR, nc - jr);
+            Scalar const * b = B + jr * csB;
+            for (int p = 0; p < kc; ++p) {
+                Scalar const * bp = b + p * rsB;
+                int j = 0;
+                for (; j < nr; ++j)
+                    buf[j] = bp[j * csB];
+                for (; j < NR; ++j)
+                    buf[j] = 0;
+                buf += NR;
+            }
+        }
+    }
+
+    //! @brief 微内核, C[0:mr, 0:nr] = alpha * a * b + beta * C
+    //!
+    //! 累加器 ab 是 MR x NR 的定长数组, 展开内层循环后编译器可以把它完全放进寄存器并向量化
+    //!
+    //! @param [in] kc 秩 1 更新的次数
+    //! @param [in] a 打包后的 A 条带, MR x kc
+    //! @param [in] b 打包后的 B 条带, kc x NR
+    //! @param [in] mr, nr C 中实际需要写回的行列数
+    template <typename Scalar, int MR, int NR>
+    inline void GemmMicroKernel(int kc, Scalar alpha, Scalar const * a, Scalar const * b,
+                                Scalar beta, Scalar * C, int rsC, int csC, int mr, int nr)
+    {
+        Scalar ab[MR * NR] = {};
+        for (int p = 0; p < kc; ++p) {
+#pragma GCC unroll 16
+            for (int j = 0; j < NR; ++j) {
+                Scalar bj = b[j];
+#pragma GCC unroll 16
+                for (int i = 0; i < MR; ++i)
+                    ab[j * MR + i] += a[i] * bj;
+            }
+            a += MR;
+            b += NR;
+        }
+
+        for (int j = 0; j < nr; ++j) {
+            for (int i = 0; i < mr; ++i) {
+                Scalar & cij = C[i * rsC + j * csC];
+                cij = (0 == beta) ? alpha * ab[j * MR + i]
+                                  : beta * cij + alpha * ab[j * MR + i];
+            }
+        }
+    }
+
+    //! @brief 小矩阵直接计算, 不打包, 按照 j-p-i 的顺序遍历, 适合列优先存储
+    template <typename Scalar>
+    void GemmSmall(int m, int n, int k, Scalar alpha,
+                   Scalar const * A, int rsA, int csA,
+                   Scalar const * B, int rsB, int csB,
+                   Scalar beta, Scalar * C, int rsC, int csC)
+    {
+        for (int j = 0; j < n; ++j) {
+            Scalar * c = C + j * csC;
+            if (0 == beta) {
+                for (int i = 0; i < m; ++i)
+                    c[i * rsC] = 0;
+            } else if (1 != beta) {
+                for (int i = 0; i < m; ++i)
+                    c[i * rsC] *= beta;
+            }
+
+            for (int p = 0; p < k; ++p) {
+                Scalar bpj = alpha * B[p * rsB + j * csB];
+                Scalar const * a = A + p * csA;
+                for (int i = 0; i < m; ++i)
+                    c[i * rsC] += a[i * rsA] * bpj;
+            }
+        }
+    }
+
+    //! @brief 编译期尺寸的小矩阵乘法, 循环次数都是常量, 编译器可以完全展开
+    //!
+    //! 用于 AMatrix 等定长矩阵, 累加器放在栈上, 不需要任何分配
+    template <typename Scalar, int M, int N, int K>
+    inline void GemmFixed(Scalar alpha,
+                          Scalar const * A, int rsA, int csA,
+                          Scalar const * B, int rsB, int csB,
+                          Scalar beta, Scalar * C, int rsC, int csC)
+    {
+        Scalar ab[M * N] = {};
+#pragma GCC unroll 16
+        for (int p = 0; p < K; ++p) {
+#pragma GCC unroll 16
+            for (int j = 0; j < N; ++j) {
+                Scalar bpj = B[p * rsB + j * csB];
+#pragma GCC unroll 16
+                for (int i = 0; i < M; ++i)
+                    ab[j * M + i] += A[i * rsA + p * csA] * bpj;
+            }
+        }
+
+#pragma GCC unroll 16
+        for (int j = 0; j < N; ++j) {
+#pragma GCC unroll 16
+            for (int i = 0; i < M; ++i) {
+                Scalar & cij = C[i * rsC + j * csC];
+                cij = (0 == beta) ? alpha * ab[j * M + i]
+                                  : beta * cij + alpha * ab[j * M + i];
+            }
+        }
+    }
+
+    //! @brief 单线程的通用矩阵乘法, 参数同 Gemm
+    template <typename Scalar>
+    void GemmSerial(int m, int n, int k, Scalar alpha,
+                    Scalar const * A, int rsA, int csA,
+                    Scalar const * B, int rsB, int csB,
+                    Scalar beta, Scalar * C, int rsC, int csC)
+    {
+        typedef GemmBlocking<Scalar> Blk;
+        constexpr int MR = Blk::MR;
+        constexpr int NR = Blk::NR;
+
+        if (m <= 0 || n <= 0)
+            return;
+
+        if (k <= 0 || 0 == alpha || (long)m * n * k <= Blk::SmallSize) {
+            GemmSmall(m, n, k, alpha, A, rsA, csA, B, rsB, csB, beta, C, rsC, csC);
+            return;
+        }
+
+        int mc_max = std::min(Blk::MC, (m + MR - 1) / MR * MR);
+        int kc_max = std::min(Blk::KC, k);
+        int nc_max = std::min(Blk::NC, (n + NR - 1) / NR * NR);
+        WorkspaceFrame frame;
+        Scalar * bufA = frame.Alloc<Scalar>(mc_max * kc_max);
+        Scalar * bufB = frame.Alloc<Scalar>(kc_max * nc_max);
+
+        for (int jc = 0; jc < n; jc += Blk::NC) {
+            int nc = std::min(Blk::NC, n - jc);
+
+            for (int pc = 0; pc < k; pc += Blk::KC) {
+                int kc = std::min(Blk::KC, k - pc);
+                // 只有第一个 kc 块需要考虑 beta, 之后都是累加
+                Scalar beta_pc = (0 == pc) ? beta : Scalar(1);
+                GemmPackB<Scalar, NR>(kc, nc, B + pc * rsB + jc * csB, rsB, csB, bufB);
+
+                for (int ic = 0; ic < m; ic += Blk::MC) {
+                    int mc = std::min(Blk::MC, m - ic);
+                    GemmPackA<Scalar, MR>(mc, kc, A + ic * rsA + pc * csA, rsA, csA, bufA);
+
+                    for (int jr = 0; jr < nc; jr += NR) {
+                        int nr = std::min(NR, nc - jr);
+                        Scalar const * b = bufB + jr * kc;
+                        for (int ir = 0; ir < mc; ir += MR) {
+                            int mr = std::min(MR, mc - ir);
+                            Scalar const * a = bufA + ir * kc;
+                            Scalar * c = C + (ic + ir) * rsC + (jc + jr) * csC;
+                            GemmMicroKernel<Scalar, MR, NR>(kc, alpha, a, b, beta_pc, c, rsC, csC, mr, nr);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    //! @brief 通用矩阵乘法 C = alpha * A * B + beta * C
+    //!
+    //! A 为 m x k, B 为 k x n, C 为 m x n, 元素 (i, j) 的地址为 ptr + i * rs + j * cs。
+    //! C 不能与 A, B 的存储重叠。beta 为 0 时不读取 C 原有的数据。
+    //! 计算量超过 ParallelGemmSize 时, 沿 C 较长的一边切块并行, 各块独立地打包和计算。
+    //!
+    //! @param [in] m, n, k 矩阵尺寸
+    //! @param [in] alpha 乘积的系数
+    //! @param [in] A, rsA, csA 矩阵 A 的起始地址和行列步长
+    //! @param [in] B, rsB, csB 矩阵 B 的起始地址和行列步长
+    //! @param [in] beta C 的系数
+    //! @param [in|out] C, rsC, csC 矩阵 C 的起始地址和行列步长
+    template <typename Scalar>
+    void Gemm(int m, int n, int k, Scalar alpha,
+              Scalar const * A, int rsA, int csA,
+              Scalar const * B, int rsB, int csB,
+              Scalar beta, Scalar * C, int rsC, int csC)
+    {
+        typedef GemmBlocking<Scalar> Blk;
+
+        if (m <= 0 || n <= 0)
+            return;
+
+        if ((long)m * n * k < ParallelGemmSize || !ParallelEnabled()) {
+            GemmSerial(m, n, k, alpha, A, rsA, csA, B, rsB, csB, beta, C, rsC, csC);
+            return;
+        }
+
+        // 每块至少 64 行/列, 摊薄重复打包另一个矩阵的开销
+        if (n >= m) {
+            ParallelFor(0, n, ParallelGrain(n, Blk::NR, 64), [&](int b, int e) {
+                GemmSerial(m, e - b, k, alpha, A, rsA, csA, B + b * csB, rsB, csB,
+                           beta, C + b * csC, rsC, csC);
+            });
+        } else {
+            ParallelFor(0, m, ParallelGrain(m, Blk::MR, 64), [&](int b, int e) {
+                GemmSerial(e - b, n, k, alpha, A + b * rsA, rsA, csA, B, rsB, csB,
+                           beta, C + b * rsC, rsC, csC);
+            });
+        }
+    }
+
+    //! @brief 对称秩 k 更新 C = alpha * A * A^T + beta * C, 只读写 C 的下三角
+    //!
+    //! 按 nb 列把 C 切块, 对角块以下的部分直接调用 Gemm; 对角块先用 Gemm 算到临时缓存里,
+    //! 再只把下三角写回 C, 对角块上多算的一半换来了 Gemm 的速度。
+    //!
+    //! @param [in] n, k A 的尺寸 n x k, C 为 n x n
+    //! @param [in] alpha 乘积的系数
+    //! @param [in] A, rsA, csA 矩阵 A 的起始地址和行列步长
+    //! @param [in] beta C 的系数
+    //! @param [in|out] C, rsC, csC 矩阵 C 的起始地址和行列步长, 严格上三角不读写
+    //! @param [in] nb 分块大小
+    template <typename Scalar>
+    void SyrkLower(int n, int k, Scalar alpha,
+                   Scalar const * A, int rsA, int csA,
+                   Scalar beta, Scalar * C, int rsC, int csC, int nb = 64)
+    {
+        if (n <= 0)
+            return;
+
+        WorkspaceFrame frame;
+        Scalar * W = frame.Alloc<Scalar>(std::min(nb, n) * std::min(nb, n));
+        for (int j = 0; j < n; j += nb) {
+            int jb = std::min(nb, n - j);
+            Scalar const * Aj = A + j * rsA;
+            Scalar * Cjj = C + j * rsC + j * csC;
+
+            // A_j^T 即交换 A_j 的行列步长
+            Gemm(jb, jb, k, alpha, Aj, rsA, csA, Aj, csA, rsA, Scalar(0), W, 1, jb);
+            for (int c = 0; c < jb; ++c) {
+                for (int r = c; r < jb; ++r) {
+                    Scalar & cij = Cjj[r * rsC + c * csC];
+                    cij = (0 == beta) ? W[r + c * jb] : beta * cij + W[r + c * jb];
+                }
+            }
+
+            if (j + jb < n)
+                Gemm(n - j - jb, jb, k, alpha, Aj + jb * rsA, rsA, csA, Aj, csA, rsA,
+                     beta, Cjj + jb * rsC, rsC, csC);
+        }
+    }
+
+    //! @brief 矩阵向量乘法 y = alpha * A * x + beta * y
+    //!
+    //! A 的列连续存储时按行切块, 每块 y 驻留 L1, 逐列通过 SimdAxpy 累加;
+    //! A 的行连续存储时 (例如转置的列优先矩阵) 每个元素是一次 SimdDot。两种情况都按 y 切块并行。
+    //! beta 为 0 时不读取 y 原有的数据。
+    //!
+    //! @param [in] m, n A 的尺寸 m x n, x 有 n 个元素, y 有 m 个元素
+    //! @param [in] alpha 乘积的系数
+    //! @param [in] A, rsA, csA 矩阵 A 的起始地址和行列步长
+    //! @param [in] x 连续存储的向量
+    //! @param [in] beta y 的系数
+    //! @param [in|out] y 连续存储的向量, 不能与 A, x 重叠
+    template <typename Scalar>
+    void Gemv(int m, int n, Scalar alpha, Scalar const * A, int rsA, int csA,
+              Scalar const * x, Scalar beta, Scalar * y)
+    {
+        if (m <= 0)
+            return;
+
+        auto scale = [&](int b, int e) {
+            if (0 == beta)
+                std::fill(y + b, y + e, Scalar(0));
+            else if (Scalar(1) != beta)
+                SimdScale(e - b, beta, y + b, y + b);
+        };
+
+        if (1 == rsA) {
+            ParallelFor(0, m, ParallelGrain(m, 64, std::max(256, 65536 / std::max(1, n))), [&](int b, int e) {
+                scale(b, e);
+                for (int j = 0; j < n; ++j)
+                    SimdAxpy(e - b, alpha * x[j], A + b + j * csA, y + b);
+            });
+        } else if (1 == csA) {
+            ParallelFor(0, m, ParallelGrain(m, 1, std::max(1, 65536 / std::max(1, n))), [&](int b, int e) {
+                scale(b, e);
+                for (int i = b; i < e; ++i)
+                    y[i] += alpha * SimdDot(n, A + i * rsA, x);
+            });
+        } else {
+            scale(0, m);
+            for (int i = 0; i < m; ++i) {
+                Scalar sum = 0;
+                for (int j = 0; j < n; ++j)
+                    sum += A[i * rsA + j * csA] * x[j];
+                y[i] += alpha * sum;
+            }
+        }
+    }
+
+}
+
+#endif
@@ -5,6 +5,8 @@
 #include <cassert>
 #include <vector>
 
+#include <XiaoTuMathBox/LinearAlgibra/Simd.hpp>
+
 namespace xiaotu {
 
     template <typename Scalar>
@@ -103,6 +105,37 @@ namespace xiaotu {
                 }
             }
 
+            /**
+             * @brief 对角化对称矩阵 [app apq; apq aqq] 的 Jacobi 旋转, 参考 Golub & Van Loan 算法 8.5.1
+             *
+             * 取转角较小的那个解, |theta| <= pi/4。右乘到列 p, q 上以后, 两列变为正交。
+             *
+             * @param [in] p 旋转 p-q 平面
+             * @param [in] q 旋转 p-q 平面
+             * @param [in] app, aqq, apq 对称矩阵的元素, 一侧 Jacobi 中为两列的内积
+             */
+            static Givens Jacobi(int p, int q, Scalar app, Scalar aqq, Scalar apq)
+            {
+                Givens G(p, q, Scalar(0));
+                if (0 != apq) {
+                    Scalar zeta = (aqq - app) / (2 * apq);
+                    Scalar t = std::copysign(Scalar(1), zeta) / (std::abs(zeta) + std::hypot(Scalar(1), zeta));
+                    G.c_ = 1 / std::sqrt(1 + t * t);
+                    G.s_ = G.c_ * t;
+                }
+                return G;
+            }
+
+            /**
+             * @brief 作用到两个连续存储的列上, [x y] = [x y] * G, 其中 x 为第 i 列, y 为第 j 列
+             *
+             * 与 RightApplyOn 相同, 只是直接通过 SIMD 核心作用在裸指针上
+             */
+            void RightApplyOn(int rows, Scalar * x, Scalar * y) const
+            {
+                SimdRotate(rows, c_, s_, x, y);
+            }
+
             /**
              * @brief 转换成矩阵的形式
              */
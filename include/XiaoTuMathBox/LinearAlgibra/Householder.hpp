@@ -0,0 +1,651 @@
+#ifndef XTMB_LA_HOUSEHOLDER_H
+#define XTMB_LA_HOUSEHOLDER_H
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+#include <XiaoTuMathBox/LinearAlgibra/Gemm.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Householder 反射及其分块形式
+//
+// 反射 H = I - tau * v * v^T, 其中 v(0) = 1 不显式保存, 只保存 v(1:) 和 tau。
+// 连续 k 个反射的乘积 H_0 H_1 ... H_{k-1} 可以写成紧凑 WY 形式 I - V T V^T,
+// V 为 m x k 的单位下梯形矩阵(各列为 v_i), T 为 k x k 的上三角矩阵。
+// 分块以后, 对其它矩阵的作用可以用三次 Gemm 完成。
+//
+// 与 Gemm.hpp 一样, 所有接口都基于裸指针和行/列步长。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 生成 Householder 反射, 使得 Hx = beta e_0, 且 beta >= 0
+    //!
+    //! 采用 Golub & Van Loan 算法 5.1.1 中的 Parlett 公式, 避免相消误差
+    //!
+    //! @param [in] n 向量长度
+    //! @param [in|out] x 输入向量 x, 输出时 x(0) = beta, x(1:n) = v(1:n)
+    //! @param [in] inc 元素步长
+    //! @return tau
+    template <typename Scalar>
+    Scalar HouseholderGenerate(int n, Scalar * x, int inc)
+    {
+        Scalar sigma = 0;
+        for (int i = 1; i < n; ++i)
+            sigma += x[i * inc] * x[i * inc];
+
+        Scalar x0 = x[0];
+        if (0 == sigma) {
+            if (x0 >= 0)
+                return 0;
+            // v = e_0, H = I - 2 e_0 e_0^T 只翻转符号
+            x[0] = -x0;
+            return 2;
+        }
+
+        Scalar mu = std::sqrt(x0 * x0 + sigma);
+        Scalar v0 = (x0 <= 0) ? x0 - mu : -sigma / (x0 + mu);
+        Scalar tau = 2 * v0 * v0 / (sigma + v0 * v0);
+
+        Scalar v0_inv = 1 / v0;
+        for (int i = 1; i < n; ++i)
+            x[i * inc] *= v0_inv;
+        x[0] = mu;
+        return tau;
+    }
+
+    //! @brief 左乘一个反射 C = (I - tau v v^T) C, 即秩 1 更新 C -= tau v (C^T v)^T
+    //!
+    //! @param [in] m, n C 的尺寸
+    //! @param [in] v, incv Householder 向量及其步长, v(0) = 1 不读取
+    //! @param [in] tau 反射系数
+    //! @param [in|out] C, rsC, csC 目标矩阵
+    template <typename Scalar>
+    void HouseholderApply(int m, int n, Scalar const * v, int incv, Scalar tau,
+                          Scalar * C, int rsC, int csC)
+    {
+        if (0 == tau)
+            return;
+
+        for (int j = 0; j < n; ++j) {
+            Scalar * c = C + j * csC;
+            Scalar w = c[0];
+            for (int i = 1; i < m; ++i)
+                w += v[i * incv] * c[i * rsC];
+            w *= tau;
+
+            c[0] -= w;
+            for (int i = 1; i < m; ++i)
+                c[i * rsC] -= w * v[i * incv];
+        }
+    }
+
+    //! @brief 不分块的 Householder QR 分解, 用于分块算法中的窄条
+    //!
+    //! 输出时 A 的上三角为 R, 严格下三角为各个 Householder 向量
+    //!
+    //! @param [in] m, n A 的尺寸
+    //! @param [in|out] A, rsA, csA 待分解矩阵
+    //! @param [out] tau 各个反射的系数, 至少 min(m, n) 个元素
+    template <typename Scalar>
+    void HouseholderPanel(int m, int n, Scalar * A, int rsA, int csA, Scalar * tau)
+    {
+        int k = std::min(m, n);
+        for (int i = 0; i < k; ++i) {
+            Scalar * a = A + i * rsA + i * csA;
+            tau[i] = HouseholderGenerate(m - i, a, rsA);
+            if (i + 1 < n)
+                HouseholderApply(m - i, n - i - 1, a, rsA, tau[i], a + csA, rsA, csA);
+        }
+    }
+
+    //! @brief 计算紧凑 WY 形式 H_0 ... H_{k-1} = I - V T V^T 中的上三角矩阵 T
+    //!
+    //! 逐列递推 T(0:i, i) = -tau_i T(0:i, 0:i) V(:, 0:i)^T v_i, T(i, i) = tau_i
+    //!
+    //! @param [in] m, k V 的尺寸
+    //! @param [in] V, rsV, csV 单位下梯形矩阵, 对角线及以上的元素不读取
+    //! @param [in] tau 各个反射的系数
+    //! @param [out] T, ldT 列优先存储的 k x k 上三角矩阵
+    template <typename Scalar>
+    void HouseholderBlockT(int m, int k, Scalar const * V, int rsV, int csV,
+                           Scalar const * tau, Scalar * T, int ldT)
+    {
+        for (int i = 0; i < k; ++i) {
+            Scalar * t = T + i * ldT;
+            Scalar const * vi = V + i * csV;
+
+            for (int j = 0; j < i; ++j) {
+                Scalar const * vj = V + j * csV;
+                Scalar s = vj[i * rsV];
+                for (int r = i + 1; r < m; ++r)
+                    s += vj[r * rsV] * vi[r * rsV];
+                t[j] = -tau[i] * s;
+            }
+
+            // t(0:i) = T(0:i, 0:i) t(0:i), 自上而下原位计算
+            for (int j = 0; j < i; ++j) {
+                Scalar s = 0;
+                for (int l = j; l < i; ++l)
+                    s += T[j + l * ldT] * t[l];
+                t[j] = s;
+            }
+
+            t[i] = tau[i];
+            for (int j = i + 1; j < k; ++j)
+                t[j] = 0;
+        }
+    }
+
+    //! @brief 左乘分块反射 C = (I - V T V^T) C, 或者 trans 时 C = (I - V T^T V^T) C
+    //!
+    //! 展开 V 的单位下梯形部分后, 通过三次 Gemm 完成: W = V^T C, W = op(T) W, C -= V W
+    //!
+    //! @param [in] m, n C 的尺寸
+    //! @param [in] k 反射的数量
+    //! @param [in] V, rsV, csV 单位下梯形矩阵, m x k
+    //! @param [in] T, ldT HouseholderBlockT 计算的上三角矩阵
+    //! @param [in] trans 是否使用 T 的转置, 即作用 (H_0 ... H_{k-1})^T
+    //! @param [in|out] C, rsC, csC 目标矩阵
+    template <typename Scalar>
+    void HouseholderBlockApply(int m, int n, int k, Scalar const * V, int rsV, int csV,
+                               Scalar const * T, int ldT, bool trans,
+                               Scalar * C, int rsC, int csC)
+    {
+        if (m <= 0 || n <= 0 || k <= 0)
+            return;
+
+        // 列数较少时逐个作用反射, 省去展开 V 和 Gemm 打包的开销, T 的对角线即为各个 tau
+        if (n < k) {
+            for (int b = 0; b < k; ++b) {
+                int i = trans ? b : k - 1 - b;
+                HouseholderApply(m - i, n, V + i * rsV + i * csV, rsV, T[i + i * ldT],
+                                 C + i * rsC, rsC, csC);
+            }
+            return;
+        }
+
+        WorkspaceFrame frame;
+        Scalar * Vd = frame.Alloc<Scalar>(m * k);
+        for (int j = 0; j < k; ++j) {
+            for (int r = 0; r < j; ++r)
+                Vd[r + j * m] = 0;
+            Vd[j + j * m] = 1;
+            for (int r = j + 1; r < m; ++r)
+                Vd[r + j * m] = V[r * rsV + j * csV];
+        }
+
+        Scalar * W = frame.Alloc<Scalar>(k * n);
+        Scalar * TW = frame.Alloc<Scalar>(k * n);
+        Gemm(k, n, m, Scalar(1), Vd, m, 1, C, rsC, csC, Scalar(0), W, 1, k);
+        if (trans)
+            Gemm(k, n, k, Scalar(1), T, ldT, 1, W, 1, k, Scalar(0), TW, 1, k);
+        else
+            Gemm(k, n, k, Scalar(1), T, 1, ldT, W, 1, k, Scalar(0), TW, 1, k);
+        Gemm(m, n, k, Scalar(-1), Vd, 1, m, TW, 1, k, Scalar(1), C, rsC, csC);
+    }
+
+    //! @brief 分块的 Householder QR 分解
+    //!
+    //! 每次对 nb 列的窄条做不分块的分解, 再以紧凑 WY 形式把这些反射一次性作用到右侧的矩阵上。
+    //! 输出时 A 的上三角为 R, 严格下三角为各个 Householder 向量, R 的对角元素非负。
+    //! 各块的上三角矩阵 T 依次保存在 T 中, 之后作用 Q 时不必重新计算。
+    //!
+    //! @param [in] m, n A 的尺寸
+    //! @param [in|out] A, rsA, csA 待分解矩阵
+    //! @param [out] tau 各个反射的系数, 至少 min(m, n) 个元素
+    //! @param [out] T 列优先存储的 nb x min(m, n) 矩阵, 第 j 块的 T 从第 j*nb 列开始
+    //! @param [in] nb 分块大小
+    template <typename Scalar>
+    void HouseholderQR(int m, int n, Scalar * A, int rsA, int csA, Scalar * tau, Scalar * T, int nb)
+    {
+        int kmax = std::min(m, n);
+        for (int j = 0; j < kmax; j += nb) {
+            int jb = std::min(nb, kmax - j);
+            Scalar * Ajj = A + j * rsA + j * csA;
+            Scalar * Tj = T + j * nb;
+            HouseholderPanel(m - j, jb, Ajj, rsA, csA, tau + j);
+            HouseholderBlockT(m - j, jb, Ajj, rsA, csA, tau + j, Tj, nb);
+
+            if (j + jb < n)
+                HouseholderBlockApply(m - j, n - j - jb, jb, Ajj, rsA, csA, Tj, nb, true,
+                                      Ajj + jb * csA, rsA, csA);
+        }
+    }
+
+    //! @brief 以分块的方式计算 C = Q C 或者 trans 时 C = Q^T C, 其中 Q = H_0 H_1 ... H_{k-1}
+    //!
+    //! @param [in] m C 的行数, 也是 Householder 向量的长度
+    //! @param [in] n C 的列数
+    //! @param [in] k 反射的数量
+    //! @param [in] V, rsV, csV HouseholderQR 输出的分解结果
+    //! @param [in] T HouseholderQR 输出的各块上三角矩阵
+    //! @param [in] nb 分块大小
+    //! @param [in] trans 是否作用 Q^T
+    //! @param [in|out] C, rsC, csC 目标矩阵
+    template <typename Scalar>
+    void HouseholderApplyQ(int m, int n, int k, Scalar const * V, int rsV, int csV,
+                           Scalar const * T, int nb, bool trans,
+                           Scalar * C, int rsC, int csC)
+    {
+        int nblocks = (k + nb - 1) / nb;
+        for (int b = 0; b < nblocks; ++b) {
+            // Q^T = H_{k-1} ... H_0 从前往后作用, Q 则从后往前
+            int j = (trans ? b : nblocks - 1 - b) * nb;
+            int jb = std::min(nb, k - j);
+            HouseholderBlockApply(m - j, n, jb, V + j * rsV + j * csV, rsV, csV,
+                                  T + j * nb, nb, trans, C + j * rsC, rsC, csC);
+        }
+    }
+
+    //! @brief 把列满秩的 m x n 矩阵 A (m >= n) 替换为其 QR 分解中 Q 的前 n 列, 即 A 列空间的单位正交基
+    //!
+    //! @param [in] m, n A 的尺寸
+    //! @param [in|out] A, ldA 列优先存储的矩阵
+    //! @param [out] R, ldR 列优先存储的 n x n 上三角矩阵, 可以为 nullptr
+    //! @param [in] nb 分块大小
+    template <typename Scalar>
+    void HouseholderThinQ(int m, int n, Scalar * A, int ldA, Scalar * R, int ldR, int nb = 32)
+    {
+        WorkspaceFrame frame;
+        Scalar * V = frame.Alloc<Scalar>(m * n);
+        Scalar * tau = frame.Alloc<Scalar>(n);
+        Scalar * T = frame.Alloc<Scalar>(nb * n);
+        for (int c = 0; c < n; ++c)
+            std::copy(A + c * ldA, A + c * ldA + m, V + c * m);
+        HouseholderQR(m, n, V, 1, m, tau, T, nb);
+
+        if (nullptr != R) {
+            for (int c = 0; c < n; ++c)
+                for (int r = 0; r < n; ++r)
+                    R[r + c * ldR] = (r <= c) ? V[r + c * m] : Scalar(0);
+        }
+
+        for (int c = 0; c < n; ++c)
+            for (int r = 0; r < m; ++r)
+                A[r + c * ldA] = (r == c) ? Scalar(1) : Scalar(0);
+        HouseholderApplyQ(m, n, n, V, 1, m, T, nb, false, A, 1, ldA);
+    }
+
+    //! @brief 对 k 个反射按 nb 分块计算各块的 T, 再以分块的方式作用 C = Q C 或 C = Q^T C
+    //!
+    //! 与 HouseholderApplyQ 相同, 只是反射来自 HessenbergReduce 或 BidiagonalReduce 等只输出 tau 的分解
+    template <typename Scalar>
+    void HouseholderApplyReflectors(int m, int n, int k, Scalar const * V, int rsV, int csV,
+                                    Scalar const * tau, int nb, bool trans,
+                                    Scalar * C, int rsC, int csC)
+    {
+        if (k <= 0)
+            return;
+        WorkspaceFrame frame;
+        Scalar * T = frame.Alloc<Scalar>(nb * k);
+        for (int j = 0; j < k; j += nb) {
+            int jb = std::min(nb, k - j);
+            HouseholderBlockT(m - j, jb, V + j * rsV + j * csV, rsV, csV, tau + j, T + j * nb, nb);
+        }
+        HouseholderApplyQ(m, n, k, V, rsV, csV, T, nb, trans, C, rsC, csC);
+    }
+
+    //! @brief 分块约化的块大小
+    constexpr int HouseholderReduceBlock = 32;
+    //! @brief 矩阵尺寸不小于该值时才采用分块约化, 剩下不足该尺寸的右下角也不再分块
+    constexpr int HouseholderReduceCrossover = 128;
+
+    //! @brief 不分块的上 Hessenberg 约化, 从第 k0 列开始, 参考 LAPACK gehd2
+    template <typename Scalar>
+    void HessenbergUnblocked(int n, int k0, Scalar * A, int rsA, int csA, Scalar * tau)
+    {
+        for (int k = k0; k < n - 2; ++k) {
+            int len = n - k - 1;
+            Scalar * v = A + (k + 1) * rsA + k * csA;
+            tau[k] = HouseholderGenerate(len, v, rsA);
+            HouseholderApply(len, n - k - 1, v, rsA, tau[k], v + csA, rsA, csA);
+            HouseholderApply(len, n, v, rsA, tau[k], A + (k + 1) * csA, csA, rsA);
+        }
+    }
+
+    //! @brief 上 Hessenberg 约化的窄条, 参考 LAPACK lahr2
+    //!
+    //! 对从第 p 列开始的 nb 列生成反射, 只更新这 nb 列, 并输出 Y = A V T 供调用者更新剩余的部分。
+    //! 返回时第 p+nb-1 个反射的 v(0) 位置已恢复为次对角元素。
+    //!
+    //! @param [in] n 矩阵尺寸
+    //! @param [in] p 窄条的起始列
+    //! @param [in] nb 窄条的列数
+    //! @param [in|out] A, rsA, csA 整个矩阵
+    //! @param [out] tau nb 个反射的系数
+    //! @param [out] T, ldT 紧凑 WY 形式的上三角矩阵, nb x nb
+    //! @param [out] Y, ldY 列优先存储的 n x nb 矩阵
+    template <typename Scalar>
+    void HessenbergPanel(int n, int p, int nb, Scalar * A, int rsA, int csA, Scalar * tau,
+                         Scalar * T, int ldT, Scalar * Y, int ldY)
+    {
+        auto a = [&](int r, int c) -> Scalar & { return A[r * rsA + c * csA]; };
+        auto y = [&](int r, int c) -> Scalar & { return Y[r + c * ldY]; };
+        auto t = [&](int r, int c) -> Scalar & { return T[r + c * ldT]; };
+
+        WorkspaceFrame frame;
+        Scalar * w = frame.Alloc<Scalar>(nb);
+
+        Scalar ei = 0;
+        for (int j = 0; j < nb; ++j) {
+            int c = p + j;
+            if (j > 0) {
+                // 右乘: a(p+1:n, c) -= Y(p+1:n, 0:j) V(c, 0:j)^T, 上一个反射的 v(0) = 1 暂存在 a(c, c-1)
+                for (int k = 0; k < j; ++k) {
+                    Scalar vk = a(c, p + k);
+                    for (int r = p + 1; r < n; ++r)
+                        a(r, c) -= y(r, k) * vk;
+                }
+
+                // 左乘: a(p+1:n, c) = (I - V T^T V^T) a(p+1:n, c)
+                for (int k = 0; k < j; ++k) {
+                    int rk = p + k + 1;
+                    Scalar s = a(rk, c);
+                    for (int r = rk + 1; r < n; ++r)
+                        s += a(r, p + k) * a(r, c);
+                    w[k] = s;
+                }
+                for (int k = j - 1; k >= 0; --k) {
+                    Scalar s = 0;
+                    for (int l = 0; l <= k; ++l)
+                        s += t(l, k) * w[l];
+                    w[k] = s;
+                }
+                for (int k = 0; k < j; ++k) {
+                    int rk = p + k + 1;
+                    a(rk, c) -= w[k];
+                    for (int r = rk + 1; r < n; ++r)
+                        a(r, c) -= a(r, p + k) * w[k];
+                }
+                a(c, c - 1) = ei;
+            }
+
+            int len = n - c - 1;
+            Scalar * v = &a(c + 1, c);
+            tau[j] = HouseholderGenerate(len, v, rsA);
+            ei = v[0];
+            v[0] = 1;
+
+            // Y(p+1:n, j) = tau (A(p+1:n, c+1:n) v - Y(p+1:n, 0:j) V(c+1:n, 0:j)^T v)
+            for (int r = p + 1; r < n; ++r)
+                y(r, j) = 0;
+            for (int k = 0; k < len; ++k) {
+                Scalar vk = v[k * rsA];
+                for (int r = p + 1; r < n; ++r)
+                    y(r, j) += a(r, c + 1 + k) * vk;
+            }
+            for (int k = 0; k < j; ++k) {
+                Scalar s = 0;
+                for (int r = c + 1; r < n; ++r)
+                    s += a(r, p + k) * a(r, c);
+                t(k, j) = s;
+            }
+            for (int k = 0; k < j; ++k)
+                for (int r = p + 1; r < n; ++r)
+                    y(r, j) -= y(r, k) * t(k, j);
+            for (int r = p + 1; r < n; ++r)
+                y(r, j) *= tau[j];
+
+            // T(0:j, j) = -tau T(0:j, 0:j) V^T v
+            for (int k = 0; k < j; ++k) {
+                Scalar s = 0;
+                for (int l = k; l < j; ++l)
+                    s += t(k, l) * t(l, j);
+                t(k, j) = -tau[j] * s;
+            }
+            t(j, j) = tau[j];
+            for (int k = j + 1; k < nb; ++k)
+                t(k, j) = 0;
+        }
+        a(p + nb, p + nb - 1) = ei;
+
+        // Y(0:p+1, :) = A(0:p+1, p+1:n) V T
+        int K = p + 1;
+        for (int j = 0; j < nb; ++j)
+            for (int r = 0; r < K; ++r)
+                y(r, j) = a(r, K + j);
+        for (int k = 0; k < nb; ++k)
+            for (int l = k + 1; l < nb; ++l) {
+                Scalar vlk = a(K + l, p + k);
+                for (int r = 0; r < K; ++r)
+                    y(r, k) += y(r, l) * vlk;
+            }
+        if (n > K + nb)
+            Gemm(K, nb, n - K - nb, Scalar(1), &a(0, K + nb), rsA, csA, &a(K + nb, p), rsA, csA,
+                 Scalar(1), Y, 1, ldY);
+        for (int k = nb - 1; k >= 0; --k)
+            for (int r = 0; r < K; ++r) {
+                Scalar s = 0;
+                for (int l = 0; l <= k; ++l)
+                    s += y(r, l) * t(l, k);
+                y(r, k) = s;
+            }
+    }
+
+    //! @brief 分块的上 Hessenberg 约化 H = Q^T A Q, 参考 LAPACK gehrd
+    //!
+    //! Q = H_0 H_1 ... H_{n-3}, H_k 作用于第 k+1 行及其以后, 其 Householder 向量保存在第 k 列
+    //! 的第 k+2 行及其以后。每个窄条只做矩阵向量运算, 剩余部分的右乘和左乘各是一次 Gemm 量级的运算,
+    //! 右下角不足 nx 的部分不再分块。
+    //!
+    //! @param [in] n 矩阵尺寸
+    //! @param [in|out] A, rsA, csA 输出时次对角线及以上为 H, 以下为各个 Householder 向量
+    //! @param [out] tau 各个反射的系数, 至少 n-2 个元素
+    //! @param [in] nb 分块大小
+    //! @param [in] nx 不再分块的尺寸
+    template <typename Scalar>
+    void HessenbergReduce(int n, Scalar * A, int rsA, int csA, Scalar * tau,
+                          int nb = HouseholderReduceBlock, int nx = HouseholderReduceCrossover)
+    {
+        auto a = [&](int r, int c) -> Scalar & { return A[r * rsA + c * csA]; };
+        nx = std::max(nx, nb + 2);
+
+        WorkspaceFrame frame;
+        Scalar * T = frame.Alloc<Scalar>(nb * nb);
+        Scalar * Y = frame.Alloc<Scalar>(n * nb);
+
+        int p = 0;
+        for (; p < n - 1 - nx; p += nb) {
+            HessenbergPanel(n, p, nb, A, rsA, csA, tau + p, T, nb, Y, n);
+
+            // 右乘: A(0:n, p+nb:n) -= Y V(p+nb:n, :)^T
+            Scalar ei = a(p + nb, p + nb - 1);
+            a(p + nb, p + nb - 1) = 1;
+            Gemm(n, n - p - nb, nb, Scalar(-1), Y, 1, n, &a(p + nb, p), csA, rsA,
+                 Scalar(1), &a(0, p + nb), rsA, csA);
+            a(p + nb, p + nb - 1) = ei;
+
+            // 右乘: 窄条内各列的前 p+1 行, A(0:p+1, p+1:p+nb) -= Y V1^T
+            for (int j = nb - 2; j >= 0; --j)
+                for (int k = 0; k < j; ++k) {
+                    Scalar vjk = a(p + 1 + j, p + k);
+                    for (int r = 0; r <= p; ++r)
+                        Y[r + j * n] += Y[r + k * n] * vjk;
+                }
+            for (int j = 0; j < nb - 1; ++j)
+                for (int r = 0; r <= p; ++r)
+                    a(r, p + j + 1) -= Y[r + j * n];
+
+            // 左乘: A(p+1:n, p+nb:n) = (I - V T^T V^T) A(p+1:n, p+nb:n)
+            HouseholderBlockApply(n - p - 1, n - p - nb, nb, &a(p + 1, p), rsA, csA, T, nb, true,
+                                  &a(p + 1, p + nb), rsA, csA);
+        }
+        HessenbergUnblocked(n, p, A, rsA, csA, tau);
+    }
+
+    //! @brief 不分块的上双对角约化, 从第 k0 列开始, 参考 LAPACK gebd2, 要求 m >= n
+    template <typename Scalar>
+    void BidiagonalUnblocked(int m, int n, int k0, Scalar * A, int rsA, int csA,
+                             Scalar * tauq, Scalar * taup)
+    {
+        for (int i = k0; i < n; ++i) {
+            Scalar * v = A + i * rsA + i * csA;
+            tauq[i] = HouseholderGenerate(m - i, v, rsA);
+            if (i + 1 >= n) {
+                taup[i] = 0;
+                continue;
+            }
+            HouseholderApply(m - i, n - i - 1, v, rsA, tauq[i], v + csA, rsA, csA);
+
+            Scalar * u = v + csA;
+            taup[i] = HouseholderGenerate(n - i - 1, u, csA);
+            HouseholderApply(n - i - 1, m - i - 1, u, csA, taup[i], u + rsA, csA, rsA);
+        }
+    }
+
+    //! @brief 上双对角约化的窄条, 参考 LAPACK labrd, 要求 m >= n > nb
+    //!
+    //! 对前 nb 行和 nb 列生成反射, 只更新这些行列, 并输出 X, Y 使得剩余部分的更新为
+    //! A22 -= V Y^T + X U^T。返回时各个反射的 v(0), u(0) 位置都为 1, 对角线和次对角线保存在 d, e 中。
+    //!
+    //! @param [in] m, n 矩阵尺寸
+    //! @param [in] nb 窄条宽度
+    //! @param [in|out] A, rsA, csA 待约化矩阵
+    //! @param [out] d, e 双对角矩阵的前 nb 个对角元素和次对角元素
+    //! @param [out] tauq, taup 左右两侧的反射系数
+    //! @param [out] X, ldX 列优先存储的 m x nb 矩阵
+    //! @param [out] Y, ldY 列优先存储的 n x nb 矩阵
+    template <typename Scalar>
+    void BidiagonalPanel(int m, int n, int nb, Scalar * A, int rsA, int csA,
+                         Scalar * d, Scalar * e, Scalar * tauq, Scalar * taup,
+                         Scalar * X, int ldX, Scalar * Y, int ldY)
+    {
+        auto a = [&](int r, int c) -> Scalar & { return A[r * rsA + c * csA]; };
+        auto x = [&](int r, int c) -> Scalar & { return X[r + c * ldX]; };
+        auto y = [&](int r, int c) -> Scalar & { return Y[r + c * ldY]; };
+
+        for (int i = 0; i < nb; ++i) {
+            // 第 i 列: a(i:m, i) -= A(i:m, 0:i) Y(i, 0:i)^T + X(i:m, 0:i) A(0:i, i)
+            for (int k = 0; k < i; ++k) {
+                Scalar yk = y(i, k), ak = a(k, i);
+                for (int r = i; r < m; ++r)
+                    a(r, i) -= a(r, k) * yk + x(r, k) * ak;
+            }
+            tauq[i] = HouseholderGenerate(m - i, &a(i, i), rsA);
+            d[i] = a(i, i);
+            a(i, i) = 1;
+
+            // Y(i+1:n, i) = tauq (A(i:m, i+1:n)^T v - Y(i+1:n, 0:i) A(i:m, 0:i)^T v - A(0:i, i+1:n)^T X(i:m, 0:i)^T v)
+            for (int c = i + 1; c < n; ++c) {
+                Scalar s = 0;
+                for (int r = i; r < m; ++r)
+                    s += a(r, c) * a(r, i);
+                y(c, i) = s;
+            }
+            for (int k = 0; k < i; ++k) {
+                Scalar s = 0;
+                for (int r = i; r < m; ++r)
+                    s += a(r, k) * a(r, i);
+                y(k, i) = s;
+            }
+            for (int k = 0; k < i; ++k)
+                for (int c = i + 1; c < n; ++c)
+                    y(c, i) -= y(c, k) * y(k, i);
+            for (int k = 0; k < i; ++k) {
+                Scalar s = 0;
+                for (int r = i; r < m; ++r)
+                    s += x(r, k) * a(r, i);
+                y(k, i) = s;
+            }
+            for (int c = i + 1; c < n; ++c) {
+                Scalar s = 0;
+                for (int k = 0; k < i; ++k)
+                    s += a(k, c) * y(k, i);
+                y(c, i) = tauq[i] * (y(c, i) - s);
+            }
+
+            // 第 i 行: a(i, i+1:n) -= Y(i+1:n, 0:i+1) A(i, 0:i+1)^T + A(0:i, i+1:n)^T X(i, 0:i)^T
+            for (int c = i + 1; c < n; ++c) {
+                Scalar s = 0;
+                for (int k = 0; k <= i; ++k)
+                    s += y(c, k) * a(i, k);
+                for (int k = 0; k < i; ++k)
+                    s += a(k, c) * x(i, k);
+                a(i, c) -= s;
+            }
+            taup[i] = HouseholderGenerate(n - i - 1, &a(i, i + 1), csA);
+            e[i] = a(i, i + 1);
+            a(i, i + 1) = 1;
+
+            // X(i+1:m, i) = taup (A(i+1:m, i+1:n) u - A(i+1:m, 0:i+1) Y(i+1:n, 0:i+1)^T u - X(i+1:m, 0:i) A(0:i, i+1:n) u)
+            for (int r = i + 1; r < m; ++r)
+                x(r, i) = 0;
+            for (int c = i + 1; c < n; ++c) {
+                Scalar uc = a(i, c);
+                for (int r = i + 1; r < m; ++r)
+                    x(r, i) += a(r, c) * uc;
+            }
+            for (int k = 0; k <= i; ++k) {
+                Scalar s = 0;
+                for (int c = i + 1; c < n; ++c)
+                    s += y(c, k) * a(i, c);
+                x(k, i) = s;
+            }
+            for (int k = 0; k <= i; ++k)
+                for (int r = i + 1; r < m; ++r)
+                    x(r, i) -= a(r, k) * x(k, i);
+            for (int k = 0; k < i; ++k) {
+                Scalar s = 0;
+                for (int c = i + 1; c < n; ++c)
+                    s += a(k, c) * a(i, c);
+                x(k, i) = s;
+            }
+            for (int k = 0; k < i; ++k)
+                for (int r = i + 1; r < m; ++r)
+                    x(r, i) -= x(r, k) * x(k, i);
+            for (int r = i + 1; r < m; ++r)
+                x(r, i) *= taup[i];
+        }
+    }
+
+    //! @brief 分块的上双对角约化 B = Q^T A P, 参考 LAPACK gebrd, 要求 m >= n
+    //!
+    //! Q = H_0 ... H_{n-1}, H_i 的 Householder 向量保存在第 i 列的对角线以下;
+    //! P = G_0 ... G_{n-2}, G_i 的 Householder 向量保存在第 i 行的次对角线以右。
+    //! 每个窄条之后剩余部分的更新为两次 Gemm, 右下角不足 nx 的部分不再分块。
+    //!
+    //! @param [in] m, n 矩阵尺寸
+    //! @param [in|out] A, rsA, csA 输出时对角线和次对角线为 B, 其余为各个 Householder 向量
+    //! @param [out] tauq 左侧反射的系数, n 个元素
+    //! @param [out] taup 右侧反射的系数, n 个元素, 最后一个为 0
+    //! @param [in] nb 分块大小
+    //! @param [in] nx 不再分块的尺寸
+    template <typename Scalar>
+    void BidiagonalReduce(int m, int n, Scalar * A, int rsA, int csA, Scalar * tauq, Scalar * taup,
+                          int nb = HouseholderReduceBlock, int nx = HouseholderReduceCrossover)
+    {
+        assert(m >= n);
+        auto a = [&](int r, int c) -> Scalar & { return A[r * rsA + c * csA]; };
+        nx = std::max(nx, nb + 1);
+
+        WorkspaceFrame frame;
+        Scalar * X = frame.Alloc<Scalar>(m * nb);
+        Scalar * Y = frame.Alloc<Scalar>(n * nb);
+        Scalar * d = frame.Alloc<Scalar>(nb);
+        Scalar * e = frame.Alloc<Scalar>(nb);
+
+        int p = 0;
+        for (; p < n - nx; p += nb) {
+            int mp = m - p, np = n - p;
+            BidiagonalPanel(mp, np, nb, &a(p, p), rsA, csA, d, e, tauq + p, taup + p, X, mp, Y, np);
+
+            // A22 -= V Y^T + X U^T
+            Gemm(mp - nb, np - nb, nb, Scalar(-1), &a(p + nb, p), rsA, csA, Y + nb, np, 1,
+                 Scalar(1), &a(p + nb, p + nb), rsA, csA);
+            Gemm(mp - nb, np - nb, nb, Scalar(-1), X + nb, 1, mp, &a(p, p + nb), rsA, csA,
+                 Scalar(1), &a(p + nb, p + nb), rsA, csA);
+
+            for (int j = 0; j < nb; ++j) {
+                a(p + j, p + j) = d[j];
+                a(p + j, p + j + 1) = e[j];
+            }
+        }
+        BidiagonalUnblocked(m, n, p, A, rsA, csA, tauq, taup);
+    }
+
+}
+
+#endif
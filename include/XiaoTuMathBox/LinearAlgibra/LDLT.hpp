@@ -5,10 +5,103 @@
 #include <vector>
 #include <cmath>
 #include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+
+#include <XiaoTuMathBox/LinearAlgibra/Trsm.hpp>
 
 
 namespace xiaotu {
 
+    //! @brief 不分块的 LDLT 分解, 用于分块算法中的对角块
+    //!
+    //! 与 CholeskyPanel 相同的右视顺序, 只是不开方: 逐列除以主元 d_j, 再用该列更新右侧各列。
+    //! 只读写 A 的下三角, 输出时严格下三角为 L, 对角线置为 1。
+    //!
+    //! @param [in] n A 的尺寸 n x n
+    //! @param [in|out] A, rsA, csA 待分解的对称正定矩阵
+    //! @param [out] d 对角矩阵 D 的对角线, n 个元素
+    template <typename Scalar>
+    void LDLTPanel(int n, Scalar * A, int rsA, int csA, Scalar * d)
+    {
+        for (int j = 0; j < n; ++j) {
+            Scalar * aj = A + j * csA;
+            Scalar dj = aj[j * rsA];
+            if (dj <= 0.0)
+                throw std::runtime_error("非正定矩阵");
+            d[j] = dj;
+            aj[j * rsA] = 1;
+
+            // 先用未缩放的 a_ij = l_ij d_j 更新, 再缩放为 l_ij
+            for (int c = j + 1; c < n; ++c) {
+                Scalar * ac = A + c * csA;
+                Scalar l = aj[c * rsA] / dj;
+                for (int i = c; i < n; ++i)
+                    ac[i * rsA] -= aj[i * rsA] * l;
+            }
+            Scalar inv = 1 / dj;
+            for (int i = j + 1; i < n; ++i)
+                aj[i * rsA] *= inv;
+        }
+    }
+
+    //! @brief 分块的左视 LDLT 分解, 与 CholeskyBlocked 的结构相同
+    //!
+    //! 用左侧已经分解的部分更新 nb 列的窄条时需要 L_j D_j L_j^T, 对称正定时 D > 0,
+    //! 先把 W = L_j D_j^{1/2} 拷贝到临时缓存中, 更新就变成 SyrkLower 和 Gemm。
+    //! 再用 LDLTPanel 分解对角块, 通过单位下三角的 Trsm 求出 L_2j D_jj, 最后除以 D_jj。
+    //! 只读写 A 的下三角。
+    //!
+    //! @param [in] n A 的尺寸 n x n
+    //! @param [in|out] A, rsA, csA 待分解的对称正定矩阵, 输出时严格下三角为 L, 对角线为 1
+    //! @param [out] d 对角矩阵 D 的对角线, n 个元素
+    //! @param [in] nb 分块大小
+    template <typename Scalar>
+    void LDLTBlocked(int n, Scalar * A, int rsA, int csA, Scalar * d, int nb)
+    {
+        WorkspaceFrame frame;
+        Scalar * W = frame.Alloc<Scalar>((std::size_t)n * std::min(n, nb) + 1);
+        Scalar * s = frame.Alloc<Scalar>(n + 1);
+
+        for (int j = 0; j < n; j += nb) {
+            int jb = std::min(nb, n - j);
+            int m2 = n - j - jb;
+            Scalar * Lj = A + j * rsA;
+            Scalar * Ajj = Lj + j * csA;
+            Scalar * A2j = Ajj + jb * rsA;
+
+            // W = [L_j; L_2] D^{1/2}, 按 nb 列一段段地更新, 临时缓存不超过 n x nb
+            for (int k = 0; k < j; k += nb) {
+                int kb = std::min(nb, j - k);
+                int mw = n - j;
+                for (int c = 0; c < kb; ++c) {
+                    Scalar sc = std::sqrt(d[k + c]);
+                    Scalar const * l = Lj + (k + c) * csA;
+                    Scalar * w = W + c * mw;
+                    for (int i = 0; i < mw; ++i)
+                        w[i] = l[i * rsA] * sc;
+                }
+                SyrkLower(jb, kb, Scalar(-1), W, 1, mw, Scalar(1), Ajj, rsA, csA);
+                if (m2 > 0)
+                    Gemm(m2, jb, kb, Scalar(-1), W + jb, 1, mw, W, mw, 1, Scalar(1), A2j, rsA, csA);
+            }
+
+            LDLTPanel(jb, Ajj, rsA, csA, d + j);
+
+            if (m2 > 0) {
+                Trsm(true, true, jb, m2, Ajj, rsA, csA, A2j, csA, rsA);
+                for (int c = 0; c < jb; ++c)
+                    s[c] = 1 / d[j + c];
+                for (int c = 0; c < jb; ++c) {
+                    Scalar * a = A2j + c * csA;
+                    for (int i = 0; i < m2; ++i)
+                        a[i * rsA] *= s[c];
+                }
+            }
+        }
+    }
+
     //! @brief 给定一个 n x n 的对称正定矩阵 A 进行 Cholesky 分解。A = L * L^T
     //! 结果记录在成员变量 mLD 中。
     //!
@@ -22,16 +115,37 @@ namespace xiaotu {
         public:
             typedef typename MatrixViewA::Scalar Scalar;
 
+            //! @brief 分块大小, 即每个窄条的列数
+            constexpr static int BlockSize = 64;
+
+            //! @brief 默认构造函数, 之后通过 Decompose 分解
+            LDLT()
+                : N(0)
+            {}
+
             LDLT(MatrixViewA const & a)
-                : N(a.Rows()), mL(a.Rows(), a.Cols())
+                : N(0)
+            {
+                Decompose(a);
+            }
+
+            //! @brief 分解矩阵 a
+            //!
+            //! 尺寸与上次分解相同时复用已有的内存, 不再申请
+            void Decompose(MatrixViewA const & a)
             {
                 assert(a.Rows() == a.Cols());
+                N = a.Rows();
+                mL.Resize(N, N);
                 mL.Assign(a);
                 mD.resize(N);
-                Decompose();
+                __Decompose__();
             }
 
             //! @brief 求解方程组 Ax=b, b 和 x 可以是同一个对象
+            //!
+            //! 依次求解 L z = b, D y = z 和 L^T x = y, 所有列一起通过分块的 Trsm 求解,
+            //! L^T 通过交换 L 的行列步长得到
             //! 
             //! @param [in] b 方程右侧的列向量
             //! @param [out] x 对应 b 中每一列的解
@@ -39,24 +153,27 @@ namespace xiaotu {
             void Solve(MatrixViewB const & b, MatrixViewB & x)
             {
                 assert(b.Rows() == mL.Rows());
-                const int M = b.Cols();
-                x.Assign(b);
-
-                // 遍历每一列
-                for (int cidx = 0; cidx < M; ++cidx) {
-                    for (int ridx = 0; ridx < N; ++ridx) {
-                        Scalar y = x(ridx, cidx);
-                        for (int k = 0; k < ridx; k++)
-                            y -= mL(ridx, k) * x(k, cidx);
-                        x(ridx, cidx) = y;
-                    }
-
-                    for (int ridx = N-1; ridx >= 0; --ridx) {
-                        Scalar s = x(ridx, cidx) / mD[ridx];
-                        for (int k = ridx+1; k < N; ++k)
-                            s -= mL(k, ridx) * x(k, cidx);
-                        x(ridx, cidx) = s;
-                    }
+                typedef typename std::remove_const<typename MatrixViewB::Scalar>::type BScalar;
+                if constexpr (MatrixViewB::IsStrided && std::is_same<BScalar, Scalar>::value) {
+                    const int M = b.Cols();
+                    x.Assign(b);
+
+                    Scalar * X = x.StorBegin();
+                    int rsX = x.RowStride();
+                    int csX = x.ColStride();
+                    Scalar const * A = mL.StorBegin();
+                    int rsA = mL.RowStride();
+                    int csA = mL.ColStride();
+                    Trsm(true, true, N, M, A, rsA, csA, X, rsX, csX);
+                    for (int cidx = 0; cidx < M; ++cidx)
+                        for (int ridx = 0; ridx < N; ++ridx)
+                            X[ridx * rsX + cidx * csX] /= mD[ridx];
+                    Trsm(false, true, N, M, A, csA, rsA, X, rsX, csX);
+                } else {
+                    // 代理存储的矩阵先拷贝出来
+                    DMatrix<Scalar> tmp = b;
+                    Solve(tmp, tmp);
+                    x = tmp;
                 }
             }
 
@@ -68,23 +185,9 @@ namespace xiaotu {
             }
 
         private:
-            void Decompose()
+            void __Decompose__()
             {
-                for (int ridx = 0; ridx < N; ++ridx) {
-                    for (int cidx = ridx; cidx < N; ++cidx) {
-                        Scalar sum = mL(ridx, cidx);
-                        for (int k = ridx - 1; k >= 0; --k)
-                            sum -= mL(ridx, k) * mD[k] * mL(cidx, k);
-                        if (ridx == cidx) {
-                            if (sum <= 0.0)
-                                throw std::runtime_error("非正定矩阵");
-                            mD[ridx] = sum;
-                            mL(ridx, ridx) = 1;
-                        } else {
-                            mL(cidx, ridx) = sum / mD[ridx];
-                        }
-                    }
-                }
+                LDLTBlocked(N, mL.StorBegin(), mL.RowStride(), mL.ColStride(), mD.data(), BlockSize);
 
                 for (int ridx = 0; ridx < N; ++ridx)
                     for (int cidx = 0; cidx < ridx; ++cidx)
@@ -2,10 +2,108 @@
 #define XTMB_LA_LU_H
 
 #include <cassert>
+#include <cmath>
 #include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <XiaoTuMathBox/LinearAlgibra/Trsm.hpp>
 
 namespace xiaotu {
 
+    //! @brief 不分块的列主元 LU 分解, 用于分块算法中的窄条
+    //!
+    //! 逐列选主元、交换、消元, 内层循环都沿着列方向访问, 列优先存储时是连续的。
+    //! 输出时 A 的上三角为 U, 严格下三角为 L 的单位下三角以下部分。
+    //!
+    //! @param [in] m, n A 的尺寸, 要求 m >= n
+    //! @param [in|out] A, rsA, csA 待分解矩阵
+    //! @param [out] ipiv 第 j 步与第 j 行交换的行索引, n 个元素
+    template <typename Scalar>
+    void LUPanel(int m, int n, Scalar * A, int rsA, int csA, int * ipiv)
+    {
+        for (int j = 0; j < n; ++j) {
+            Scalar * aj = A + j * csA;
+
+            int p = j;
+            Scalar max_abs = std::abs(aj[j * rsA]);
+            for (int i = j + 1; i < m; ++i) {
+                Scalar abs = std::abs(aj[i * rsA]);
+                if (abs > max_abs) {
+                    max_abs = abs;
+                    p = i;
+                }
+            }
+            ipiv[j] = p;
+            if (max_abs < SMALL_VALUE)
+                throw std::runtime_error("奇异矩阵");
+
+            if (p != j) {
+                for (int c = 0; c < n; ++c)
+                    std::swap(A[j * rsA + c * csA], A[p * rsA + c * csA]);
+            }
+
+            Scalar inv = 1 / aj[j * rsA];
+            for (int i = j + 1; i < m; ++i)
+                aj[i * rsA] *= inv;
+
+            for (int c = j + 1; c < n; ++c) {
+                Scalar * ac = A + c * csA;
+                Scalar u = ac[j * rsA];
+                if (0 == u)
+                    continue;
+                for (int i = j + 1; i < m; ++i)
+                    ac[i * rsA] -= aj[i * rsA] * u;
+            }
+        }
+    }
+
+    //! @brief 分块的列主元 LU 分解, 参考 LAPACK getrf 的右视算法
+    //!
+    //! 每次对 nb 列的窄条调用 LUPanel, 把行交换补到窄条两侧, 求解 U12 = L11^{-1} A12,
+    //! 最后通过一次 Gemm 更新右下角的子阵 A22 -= L21 U12, 绝大部分计算量都落在 Gemm 上。
+    //!
+    //! @param [in] n A 的尺寸 n x n
+    //! @param [in|out] A, rsA, csA 待分解矩阵, 输出 L 和 U
+    //! @param [out] ipiv 第 j 步与第 j 行交换的行索引, n 个元素
+    //! @param [in] nb 分块大小
+    template <typename Scalar>
+    void LUBlocked(int n, Scalar * A, int rsA, int csA, int * ipiv, int nb)
+    {
+        for (int j = 0; j < n; j += nb) {
+            int jb = std::min(nb, n - j);
+            Scalar * Ajj = A + j * rsA + j * csA;
+
+            LUPanel(n - j, jb, Ajj, rsA, csA, ipiv + j);
+
+            // 窄条内的行索引换算成全局的, 并对窄条左右两侧的列做同样的交换
+            for (int i = j; i < j + jb; ++i) {
+                ipiv[i] += j;
+                int p = ipiv[i];
+                if (p == i)
+                    continue;
+                for (int c = 0; c < j; ++c)
+                    std::swap(A[i * rsA + c * csA], A[p * rsA + c * csA]);
+                for (int c = j + jb; c < n; ++c)
+                    std::swap(A[i * rsA + c * csA], A[p * rsA + c * csA]);
+            }
+
+            int n2 = n - j - jb;
+            if (n2 <= 0)
+                continue;
+
+            // U12 = L11^{-1} A12, L11 为单位下三角
+            Scalar * A12 = Ajj + jb * csA;
+            Trsm(true, true, jb, n2, Ajj, rsA, csA, A12, rsA, csA, nb);
+
+            // A22 -= L21 U12
+            Scalar * A21 = Ajj + jb * rsA;
+            Scalar * A22 = A21 + jb * csA;
+            Gemm(n2, n2, jb, Scalar(-1), A21, rsA, csA, A12, rsA, csA, Scalar(1), A22, rsA, csA);
+        }
+    }
+
     //! @brief LU 分解, 给定一个 n x n 的矩阵，根据行主元进行重新排序，
     //! 同时对重排的矩阵进行 LU 分解。结果记录在成员变量 mLU 中。
     //!
@@ -20,23 +118,45 @@ namespace xiaotu {
     //! | \alpha_10  \beta_11  \beta_12 \beta_13 |
     //! | \alpha_20 \alpha_21  \beta_22 \beta_23 |
     //! | \alpha_30 \alpha_31 \alpha_32 \beta_33 |
+    //!
+    //! 分解采用 LUBlocked 的分块算法, 右下角子阵的更新由 Gemm 完成。
     template <typename MatrixViewA>
     class LU {
         public:
             typedef typename MatrixViewA::Scalar Scalar;
 
+            //! @brief 分块大小, 即每个窄条的列数
+            constexpr static int BlockSize = 64;
+
+            //! @brief 默认构造函数, 之后通过 Decompose 分解
+            LU()
+                : mLU(nullptr, 0, 0), mSwapTimes(0)
+            {}
+
             LU(MatrixViewA const & a)
-                : mBuffer(a.NumDatas()),
-                  mLU(mBuffer.data(), a.Rows(), a.Cols()),
-                  mSwapTimes(0),
-                  mSwapIndex(a.Rows())
+                : mLU(nullptr, 0, 0), mSwapTimes(0)
+            {
+                Decompose(a);
+            }
+
+            //! @brief 分解矩阵 a
+            //!
+            //! 尺寸与上次分解相同时复用已有的内存, 不再申请
+            void Decompose(MatrixViewA const & a)
             {
                 assert(a.Rows() == a.Cols());
+                mBuffer.resize(a.NumDatas());
+                mSwapIndex.resize(a.Rows());
+                mLU = mBuffer.data();
+                mLU.Reshape(a.Rows(), a.Cols());
                 mLU.Assign(a);
-                Decompose();
+                __Decompose__();
             }
 
             //! @brief 求解方程组 Ax=b, b 和 x 可以是同一个对象
+            //!
+            //! 先按分解时的顺序交换 x 的各行, 再依次求解 L 和 U 两个三角方程组,
+            //! 所有列一起通过分块的 Trsm 求解
             //! 
             //! @param [in] b 方程右侧的列向量
             //! @param [out] x 对应 b 中每一列的解
@@ -44,30 +164,33 @@ namespace xiaotu {
             void Solve(MatrixViewB const & b, MatrixViewB & x)
             {
                 assert(b.Rows() == mLU.Rows());
-            
-                const int N = mLU.Rows();
-                const int M = b.Cols();
-                x.Assign(b);
-
-                // 遍历每一列
-                for (int cidx = 0; cidx < M; ++cidx) {
+                typedef typename std::remove_const<typename MatrixViewB::Scalar>::type BScalar;
+                if constexpr (MatrixViewB::IsStrided && std::is_same<BScalar, Scalar>::value) {
+                    const int N = mLU.Rows();
+                    const int M = b.Cols();
+                    x.Assign(b);
+
+                    Scalar * X = x.StorBegin();
+                    int rsX = x.RowStride();
+                    int csX = x.ColStride();
                     for (int ridx = 0; ridx < N; ++ridx) {
                         int r = mSwapIndex[ridx];
-                        Scalar y = x(r, cidx);
-                        x(r, cidx) = x(ridx, cidx);
-
-                        for (int k = 0; k < ridx; k++)
-                            y -= mLU(ridx, k) * x(k, cidx);
-
-                        x(ridx, cidx) = y;
+                        if (r == ridx)
+                            continue;
+                        for (int cidx = 0; cidx < M; ++cidx)
+                            std::swap(X[ridx * rsX + cidx * csX], X[r * rsX + cidx * csX]);
                     }
 
-                    for (int ridx = N-1; ridx >= 0; --ridx) {
-                        Scalar s = x(ridx, cidx);
-                        for (int k = ridx+1; k < N; ++k)
-                            s -= mLU(ridx, k) * x(k, cidx);
-                        x(ridx, cidx) = s / mLU(ridx, ridx);
-                    }
+                    Scalar const * A = mLU.StorBegin();
+                    int rsA = mLU.RowStride();
+                    int csA = mLU.ColStride();
+                    Trsm(true, true, N, M, A, rsA, csA, X, rsX, csX);
+                    Trsm(false, false, N, M, A, rsA, csA, X, rsX, csX);
+                } else {
+                    // 代理存储的矩阵先拷贝出来
+                    DMatrix<Scalar> tmp = b;
+                    Solve(tmp, tmp);
+                    x = tmp;
                 }
             }
 
@@ -79,54 +202,16 @@ namespace xiaotu {
             }
 
         private:
-            void Decompose()
+            void __Decompose__()
             {
                 const int N = mLU.Rows();
-                // 记录各行主元的倒数
-                std::vector<Scalar> vlot_inv(N);
-                for (int ridx = 0; ridx < N; ridx++) {
-                    Scalar max_abs = 0;
-                    for (int cidx = 0; cidx < N; cidx++) {
-                        Scalar abs = std::abs(mLU(ridx, cidx));
-                        if (abs > max_abs)
-                            max_abs = abs;
-                    }
-                    if (max_abs < SMALL_VALUE)
-                        throw std::runtime_error("奇异矩阵");
-                    vlot_inv[ridx] = 1.0 / max_abs;
-                }
+                LUBlocked(N, mLU.StorBegin(), mLU.RowStride(), mLU.ColStride(),
+                          mSwapIndex.data(), BlockSize);
 
-                // 遍历构造 LU
                 mSwapTimes = 0;
-                for (int count = 0; count < N; count++) {
-                    // 查找当前列的最大值作为主元
-                    Scalar max_abs = 0;
-                    int rmax = count;
-                    for (int ridx = count; ridx < N; ridx++) {
-                        Scalar scaled = vlot_inv[ridx] * std::abs(mLU(ridx, count));
-                        if (scaled > max_abs) {
-                            max_abs = scaled;
-                            rmax = ridx;
-                        }
-                    }
-                    // 若当前行不是主元则交换
-                    if (rmax != count) {
-                        mLU.RowSwap(rmax, count);
+                for (int i = 0; i < N; i++) {
+                    if (mSwapIndex[i] != i)
                         mSwapTimes++;
-                        std::swap(vlot_inv[rmax], vlot_inv[count]);
-                    }
-                    mSwapIndex[count] = rmax;
-                    if (std::abs(mLU(count, count)) < SMALL_VALUE)
-                        throw std::runtime_error("奇异矩阵");
-                    // 更新剩余子阵
-                    for (int ridx = count + 1; ridx < N; ridx++) {
-                        Scalar alpha = mLU(ridx, count) / mLU(count, count);
-                        mLU(ridx, count) = alpha;
-                        for (int cidx = count + 1; cidx < N; cidx++) {
-                            Scalar beta = mLU(ridx, cidx) - alpha * mLU(count, cidx);
-                            mLU(ridx, cidx) = beta;
-                        }
-                    }
                 }
             }
 
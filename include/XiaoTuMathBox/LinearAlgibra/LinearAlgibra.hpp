@@ -10,9 +10,11 @@
 #include <XiaoTuMathBox/LinearAlgibra/LU.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/Cholesky.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/LDLT.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/Batched.hpp>
 
 #include <XiaoTuMathBox/LinearAlgibra/Permutation.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/Givens.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/Householder.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/Bidiagonal.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/UpperHessenberg.hpp>
 
@@ -24,11 +26,18 @@
 
 #include <XiaoTuMathBox/LinearAlgibra/SVD_Naive.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/SVD_GKR.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/SVD_DivideConquer.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/SVD_Jacobi.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/SVD_Randomized.hpp>
+
+#include <XiaoTuMathBox/LinearAlgibra/SparseMatrix.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/SparseCholesky.hpp>
 
 #include <XiaoTuMathBox/LinearAlgibra/MatrixBase.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/MatrixComma.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/MatrixView.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/DMatrixView.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/DMatrixSubView.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/Matrix.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/DMatrix.hpp>
 #include <XiaoTuMathBox/LinearAlgibra/MatrixSubView.hpp>
@@ -4,6 +4,7 @@
 #include <vector>
 #include <iostream>
 #include <initializer_list>
+#include <utility>
 
 namespace xiaotu {
 
@@ -58,15 +59,22 @@ namespace xiaotu {
                 : mData(mv.mData)
             {}
 
+            //! @brief 移动构造, 接管 mv 的存储
+            //!
+            //! 之后 mv 没有存储, 只能被重新赋值(拷贝、移动、矩阵或表达式)或者析构
+            Matrix(Matrix && mv) noexcept
+                : mData(std::move(mv.mData))
+            {}
+
             template <typename M>
             Matrix(M const & mv)
                 : mData(_rows * _cols)
             {
-                assert(Rows() == mv.Rows());
-                assert(Cols() == mv.Cols());
-                for (int ridx = 0; ridx < Rows(); ridx++)
-                    for (int cidx = 0; cidx < Cols(); cidx++)
-                        At(ridx, cidx) = mv(ridx, cidx);
+                // 新分配的存储不会与表达式的操作数重叠
+                if constexpr (IsMatrixExpression<M>::value)
+                    mv.EvalNoAlias(*this, Scalar(1), Scalar(0));
+                else
+                    Assign(mv);
             }
 
             //! @brief 构造,初始化列表
@@ -84,6 +92,23 @@ namespace xiaotu {
                 return *this;
             }
 
+            //! @brief 移动赋值, 与 mv 交换存储, 之后 mv 的元素未指定
+            Matrix & operator = (Matrix && mv) noexcept
+            {
+                mData.swap(mv.mData);
+                return *this;
+            }
+
+            //! @brief 由矩阵或表达式赋值, 被移动构造过的对象先重新分配存储
+            template <typename Mat, bool IsMatrix = Mat::IsMatrix>
+            Matrix & operator = (Mat const & mv)
+            {
+                if (mData.empty())
+                    mData.resize(_rows * _cols);
+                Base::operator=(mv);
+                return *this;
+            }
+
             //! @brief 构造一个全零矩阵
             static Matrix Zero()
             {
@@ -196,11 +221,11 @@ namespace xiaotu {
             template <typename M>
             Matrix(M const & mv)
             {
-                assert(Rows() == mv.Rows());
-                assert(Cols() == mv.Cols());
-                for (int ridx = 0; ridx < Rows(); ridx++)
-                    for (int cidx = 0; cidx < Cols(); cidx++)
-                        At(ridx, cidx) = mv(ridx, cidx);
+                // 新分配的存储不会与表达式的操作数重叠
+                if constexpr (IsMatrixExpression<M>::value)
+                    mv.EvalNoAlias(*this, Scalar(1), Scalar(0));
+                else
+                    Assign(mv);
             }
 
             //! @brief 构造,初始化列表
@@ -2,9 +2,12 @@
 #define XTMB_LA_MATRIX_BASE_H
 
 #include <cmath>
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <initializer_list>
+#include <functional>
+#include <type_traits>
 
 namespace xiaotu {
 
@@ -16,9 +19,24 @@ namespace xiaotu {
     {
         public:
             typedef typename Traits<Derived>::Scalar Scalar;
+            //! 去掉 const 的标量类型, 只读视图的 Scalar 带有 const, 聚合运算的中间结果用它保存
+            typedef typename std::remove_const<Scalar>::type PlainScalar;
             constexpr static bool IsMatrix = true;
             constexpr static EAlignType Align = Traits<Derived>::Align;
             constexpr static EStoreType Store = Traits<Derived>::Store;
+            //! 元素是否从 StorBegin() 开始按 Align 紧密排列, 代理存储和带步长的视图不是
+            constexpr static bool IsContiguous = (EStoreType::eStoreProxy != Store &&
+                                                  EStoreType::eStoreStride != Store);
+            //! 元素 (r, c) 是否位于 StorBegin() + r * RowStride() + c * ColStride(), 代理存储不是
+            constexpr static bool IsStrided = (EStoreType::eStoreProxy != Store);
+
+            //! 子阵视图的类型, IsStrided 的矩阵用 DMatrixSubView, 不论嵌套多少层都是同一个类型
+            typedef typename std::conditional<IsStrided,
+                        DMatrixSubView<Scalar, Align>,
+                        MatrixSubView<Derived>>::type SubView;
+            typedef typename std::conditional<IsStrided,
+                        DMatrixSubView<typename std::add_const<Scalar>::type, Align>,
+                        MatrixConstSubView<Derived>>::type ConstSubView;
         public:
 
             //! @brief 拷贝赋值，不改变矩阵形状，需要保证内存足够
@@ -55,28 +73,28 @@ namespace xiaotu {
             //! @param [in] c 子阵的起始列
             //! @param [in] rows 子阵的行数
             //! @param [in] cols 子阵的列数
-            MatrixSubView<Derived>
-            SubMatrix(int r, int c, int rows, int cols)
+            SubView SubMatrix(int r, int c, int rows, int cols)
             {
-                return MatrixSubView<Derived>(derived(), r, c, rows, cols);
+                if constexpr (IsStrided)
+                    return SubView(StridePtr(r, c), rows, cols, Stride());
+                else
+                    return SubView(derived(), r, c, rows, cols);
             }
 
             //! @brief 获取行向量
             //!
             //! @param [in] r 目标行
-            MatrixSubView<Derived>
-            Row(int r)
+            SubView Row(int r)
             {
-                return MatrixSubView<Derived>(derived(), r, 0, 1, Cols());
+                return SubMatrix(r, 0, 1, Cols());
             }
 
             //! @brief 获取列向量
             //!
             //! @param [in] c 目标行
-            MatrixSubView<Derived>
-            Col(int c)
+            SubView Col(int c)
             {
-                return MatrixSubView<Derived>(derived(), 0, c, Rows(), 1);
+                return SubMatrix(0, c, Rows(), 1);
             }
 
             //! @brief 获取子阵
@@ -85,38 +103,45 @@ namespace xiaotu {
             //! @param [in] c 子阵的起始列
             //! @param [in] rows 子阵的行数
             //! @param [in] cols 子阵的列数
-            MatrixConstSubView<Derived>
-            SubMatrix(int r, int c, int rows, int cols) const
+            ConstSubView SubMatrix(int r, int c, int rows, int cols) const
             {
-                return MatrixConstSubView<Derived>(derived(), r, c, rows, cols);
+                if constexpr (IsStrided)
+                    return ConstSubView(StridePtr(r, c), rows, cols, Stride());
+                else
+                    return ConstSubView(derived(), r, c, rows, cols);
             }
 
             //! @brief 获取行向量
             //!
             //! @param [in] r 目标行
-            MatrixConstSubView<Derived>
-            Row(int r) const
+            ConstSubView Row(int r) const
             {
-                return MatrixConstSubView<Derived>(derived(), r, 0, 1, Cols());
+                return SubMatrix(r, 0, 1, Cols());
             }
 
             //! @brief 获取列向量
             //!
             //! @param [in] c 目标行
-            MatrixConstSubView<Derived>
-            Col(int c) const
+            ConstSubView Col(int c) const
             {
-                return MatrixConstSubView<Derived>(derived(), 0, c, Rows(), 1);
+                return SubMatrix(0, c, Rows(), 1);
             }
 
             //! @brief 深度拷贝 m
             //!
+            //! m 为表达式时直接在本矩阵上求值
+            //!
             //! @param [in] m 将矩阵 m 中的值拷贝过来
             template <typename Mat>
             Derived & Assign(Mat const & m)
             {
                 assert(Rows() == m.Rows() && Cols() == m.Cols());
 
+                if constexpr (IsMatrixExpression<Mat>::value) {
+                    m.EvalTo(derived(), Scalar(1), Scalar(0));
+                    return derived();
+                }
+
                 for (int ridx = 0; ridx < Rows(); ridx++)
                     for (int cidx = 0; cidx < Cols(); cidx++)
                         At(ridx, cidx) = m(ridx, cidx);
@@ -316,19 +341,26 @@ namespace xiaotu {
                 return derived();
             }
 
-            //! @brief 求逆矩阵
-            DMatrix<Scalar> InverseMat() const
+            //! @brief 求逆矩阵, 定长矩阵的逆也是定长的
+            auto InverseMat() const
             {
+                typedef PlainMatrixOf<Derived> Plain;
                 LU lu(derived());
-                DMatrix<Scalar> re(Rows(), Cols());
+                typename Plain::type re = Plain::Make(Rows(), Cols());
                 lu.Inverse(re.View());
                 return re;
             }
 
-            //! @brief 求负矩阵
-            DMatrix<Scalar> operator - () const
+            //! @brief 求负矩阵, 返回表达式
+            auto operator - () const &
+            {
+                return ScalarMultipleExpr<Derived const &>(Scalar(-1), derived());
+            }
+
+            //! @brief 临时矩阵求负, 表达式保存矩阵本身
+            auto operator - () &&
             {
-                return (Scalar)(-1) * (*this);
+                return ScalarMultipleExpr<Derived>(Scalar(-1), std::move(derived()));
             }
 
         public:
@@ -344,12 +376,12 @@ namespace xiaotu {
             //! @return 最大值的展开索引
             int IdxOfMax(std::function<Scalar(Scalar)> Func = [](Scalar s) { return s; })
             {
-                Scalar max = Func(At(0));
+                PlainScalar max = Func(At(0));
                 int idx = 0;
                 int n = NumDatas();
 
                 for (int i = 1; i < n; ++i) {
-                    Scalar tmp = Func(At(i));
+                    PlainScalar tmp = Func(At(i));
                     if (tmp > max) {
                         max = tmp;
                         idx = i;
@@ -375,7 +407,7 @@ namespace xiaotu {
             //! @return 和
             Scalar Sum(std::function<Scalar(Scalar)> Func = [](Scalar s) { return s; })
             {
-                Scalar sum = 0;
+                PlainScalar sum = 0;
                 int n = NumDatas();
 
                 for (int i = 0; i < n; ++i) {
@@ -388,7 +420,7 @@ namespace xiaotu {
             //! @brief 所有元素的平方和
             Scalar SquaredNorm() const
             {
-                return Dot(*this);
+                return Dot(derived());
             }
 
             //! @brief 向量的二范数, 模
@@ -400,13 +432,25 @@ namespace xiaotu {
             //! @brief 向量的 p-范数
             Scalar PNorm(int p)
             {
-                Scalar sum = Sum([p](Scalar s) { return std::pow(std::abs(s), p); });
+                if constexpr (SimdOperand<Derived>::value) {
+                    if (1 == p && NumDatas() >= SimdMinSize)
+                        return SimdSumAbs(NumDatas(), derived().StorBegin());
+                }
+                if (2 == p)
+                    return Norm();
+
+                PlainScalar sum = Sum([p](Scalar s) { return std::pow(std::abs(s), p); });
                 return std::pow(sum, 1.0 / p);
             }
 
             //! @brief 向量的无穷范数
             Scalar InftyNorm()
             {
+                if constexpr (SimdOperand<Derived>::value) {
+                    if (NumDatas() >= SimdMinSize)
+                        return SimdMaxAbs(NumDatas(), derived().StorBegin());
+                }
+
                 int idx = IdxOfMax([](Scalar s) { return std::abs(s); });
                 return std::abs(At(idx));
             }
@@ -423,7 +467,14 @@ namespace xiaotu {
             Scalar Dot(MType const & m) const
             {
                 assert(NumDatas() == m.NumDatas());
-                Scalar re = 0;
+                // 与逐元素的实现一样按存储顺序对应, 不要求两者的存储顺序一致
+                if constexpr (SimdOperand<Derived>::value && SimdOperand<MType>::value &&
+                              std::is_same<PlainScalar, typename std::remove_const<typename MType::Scalar>::type>::value) {
+                    if (NumDatas() >= SimdMinSize)
+                        return SimdDot(NumDatas(), derived().StorBegin(), m.StorBegin());
+                }
+
+                PlainScalar re = 0;
                 for (int i = 0; i < NumDatas(); i++)
                     re += At(i) * m(i);
                 return re;
@@ -577,25 +628,41 @@ namespace xiaotu {
             //!
             //! A = Q^T * A * Q
             //!
+            //! 各个反射原位作用到 A 和 Q 上, 只从 Workspace 中申请一个向量。
+            //!
             //! @param [out] Q 用于记录正交矩阵,调用者负责维护 Q 的形式
             template <typename MatrixQ = Derived>
             Derived & UpperHessenbergByHouseholder(MatrixQ * Q = nullptr)
             {
                 Derived & H = derived();
                 int m = H.Rows();
-                int n = H.Cols();
 
-                for (int k = 0; k < (m - 2); k++) {
-                    auto Hk = DMatrix<Scalar>::Eye(m, m);
-                    auto H_k = Hk.SubMatrix(k+1, k+1, m-k-1, m-k-1);
-
-                    auto a_1 = H.SubMatrix(k + 1, k, m - k - 1, 1);
-                    auto v = HouseholderVector(a_1);
-                    HouseholderMatrix(v, H_k);
+                WorkspaceFrame frame;
+                if constexpr (BlockReducible<MatrixQ>) {
+                    if (m >= HouseholderReduceCrossover) {
+                        int rs = RowStride(), cs = ColStride();
+                        PlainScalar * A = StridePtr(0, 0);
+                        PlainScalar * tau = frame.Alloc<PlainScalar>(m);
+                        HessenbergReduce(m, A, rs, cs, tau);
+                        if (nullptr != Q)
+                            HouseholderApplyReflectors(m - 1, Q->Cols(), m - 2, A + rs, rs, cs, tau,
+                                                       HouseholderReduceBlock, true,
+                                                       Q->StorBegin() + Q->RowStride(), Q->RowStride(), Q->ColStride());
+                        for (int c = 0; c < m; c++)
+                            for (int r = c + 2; r < m; r++)
+                                A[r * rs + c * cs] = 0;
+                        return H;
+                    }
+                }
 
-                    H = Hk * H * Hk.Transpose();
+                PlainScalar * v = frame.Alloc<PlainScalar>(m);
+                for (int k = 0; k < (m - 2); k++) {
+                    int len = m - k - 1;
+                    PlainScalar tau = HouseholderReflect(H.SubMatrix(k + 1, k, len, 1), v);
+                    HouseholderLeftApply(v, tau, H.SubMatrix(k + 1, k + 1, len, len));
+                    HouseholderRightApply(v, tau, H.SubMatrix(0, k + 1, m, len));
                     if (nullptr != Q)
-                        *Q = Hk * (*Q);
+                        HouseholderLeftApply(v, tau, Q->SubMatrix(k + 1, 0, len, Q->Cols()));
                 }
                 return H;
             }
@@ -604,6 +671,8 @@ namespace xiaotu {
             //!
             //! A = U^T * A * V
             //!
+            //! 交替地从左侧消去列、从右侧消去行, 反射原位作用, 只从 Workspace 中申请一个向量。
+            //!
             //! @param [out] UT 用于记录左侧矩阵, m x m, 调用者负责维护
             //! @param [out] V  用于记录右侧矩阵, n x n, 调用者负责维护
             template <typename MatrixU = Derived, typename MatrixV = Derived>
@@ -612,29 +681,28 @@ namespace xiaotu {
                 int m = Rows();
                 int n = Cols();
 
-                for (int k = 0; k < n ; k++) {
-                    auto A_k = SubMatrix(k, k, m - k, n - k);
-                    auto u = HouseholderVector(A_k.Col(0));
-                    auto H = DMatrix<Scalar>::Eye(m-k, m-k);
-                    HouseholderMatrix(u, H);
-                    A_k = H * A_k;
-
-                    if (nullptr != UT) {
-                        auto UT_k = UT->SubMatrix(k, 0, m - k, m);
-                        UT_k = H * UT_k;
+                WorkspaceFrame frame;
+                if constexpr (BlockReducible<MatrixU> && BlockReducible<MatrixV>) {
+                    if (m >= n && n >= HouseholderReduceCrossover) {
+                        BlockBidiagonal(m, n, StridePtr(0, 0), RowStride(), ColStride(), UT, V, false);
+                        return derived();
                     }
+                }
+
+                PlainScalar * v = frame.Alloc<PlainScalar>(std::max(m, n));
+                for (int k = 0; k < n ; k++) {
+                    PlainScalar tau = HouseholderReflect(SubMatrix(k, k, m - k, 1), v);
+                    if (k < (n - 1))
+                        HouseholderLeftApply(v, tau, SubMatrix(k, k + 1, m - k, n - k - 1));
+                    if (nullptr != UT)
+                        HouseholderLeftApply(v, tau, UT->SubMatrix(k, 0, m - k, UT->Cols()));
 
                     if (k < (n - 1)) {
-                        auto v = HouseholderVector(A_k.SubMatrix(0, 1, 1, n-k-1));
-                        auto vH = DMatrix<Scalar>::Eye(n-k, n-k);
-                        auto H_k = vH.SubMatrix(1, 1, n-k-1, n- k-1);
-                        HouseholderMatrix_Row(v, H_k);
-                        A_k = A_k * vH;
-
-                        if (nullptr != V) {
-                            auto V_k = V->SubMatrix(0, k, n, n - k);
-                            V_k = V_k * vH;
-                        }
+                        tau = HouseholderReflect(SubMatrix(k, k + 1, 1, n - k - 1), v);
+                        if (k < (m - 1))
+                            HouseholderRightApply(v, tau, SubMatrix(k + 1, k + 1, m - k - 1, n - k - 1));
+                        if (nullptr != V)
+                            HouseholderRightApply(v, tau, V->SubMatrix(0, k + 1, V->Rows(), n - k - 1));
                     }
                 }
                 return derived();
@@ -644,6 +712,8 @@ namespace xiaotu {
             //!
             //! A = U^T * A * V
             //!
+            //! 交替地从右侧消去行、从左侧消去列, 反射原位作用, 只从 Workspace 中申请一个向量。
+            //!
             //! @param [out] UT 用于记录左侧矩阵, m x m, 调用者负责维护
             //! @param [out] V  用于记录右侧矩阵, n x n, 调用者负责维护
             template <typename MatrixU = Derived, typename MatrixV = Derived>
@@ -652,32 +722,29 @@ namespace xiaotu {
                 int m = Rows();
                 int n = Cols();
 
-                for (int k = 0; k < m ; k++) {
-                    auto A_k = SubMatrix(k, k, m - k, n - k);
-                    auto v = HouseholderVector(A_k.Row(0));
-                    auto H = DMatrix<Scalar>::Eye(n-k, n-k);
-                    HouseholderMatrix_Row(v, H);
-                    A_k = A_k * H;
-
-                    if (nullptr != V) {
-                        auto V_k = V->SubMatrix(0, k, n, n-k);
-                        V_k = V_k * H;
+                WorkspaceFrame frame;
+                if constexpr (BlockReducible<MatrixU> && BlockReducible<MatrixV>) {
+                    // 对 A^T 做上二对角化, 其左右两侧分别对应 V^T 和 UT^T
+                    if (n >= m && m >= HouseholderReduceCrossover) {
+                        BlockBidiagonal(n, m, StridePtr(0, 0), ColStride(), RowStride(), V, UT, true);
+                        return derived();
                     }
+                }
+
+                PlainScalar * v = frame.Alloc<PlainScalar>(std::max(m, n));
+                for (int k = 0; k < m ; k++) {
+                    PlainScalar tau = HouseholderReflect(SubMatrix(k, k, 1, n - k), v);
+                    if (k < (m - 1))
+                        HouseholderRightApply(v, tau, SubMatrix(k + 1, k, m - k - 1, n - k));
+                    if (nullptr != V)
+                        HouseholderRightApply(v, tau, V->SubMatrix(0, k, V->Rows(), n - k));
 
                     if (k < (m - 1)) {
-                        auto u = HouseholderVector(A_k.SubMatrix(1, 0, m-k-1, 1));
-                        if (u.IsZero())
-                            continue;
-                        auto uH = DMatrix<Scalar>::Eye(m-k, m-k);
-                        auto H_k = uH.SubMatrix(1, 1, m-k-1, m-k-1);
-                        HouseholderMatrix(u, H_k);
-
-                        A_k = uH * A_k;
-
-                        if (nullptr != UT) {
-                            auto UT_k = UT->SubMatrix(k, 0, m-k, m);
-                            UT_k = uH * UT_k;
-                        }
+                        tau = HouseholderReflect(SubMatrix(k + 1, k, m - k - 1, 1), v);
+                        if (k < (n - 1))
+                            HouseholderLeftApply(v, tau, SubMatrix(k + 1, k + 1, m - k - 1, n - k - 1));
+                        if (nullptr != UT)
+                            HouseholderLeftApply(v, tau, UT->SubMatrix(k + 1, 0, m - k - 1, UT->Cols()));
                     }
                 }
                 return derived();
@@ -722,7 +789,8 @@ namespace xiaotu {
             inline int Idx(int idx) const
             {
                 switch (Store) {
-                    case EStoreType::eStoreProxy: {
+                    case EStoreType::eStoreProxy:
+                    case EStoreType::eStoreStride: {
                         int r = idx / Cols();
                         int c = idx % Cols();
                         return Idx(r, c);
@@ -732,6 +800,29 @@ namespace xiaotu {
                 }
             }
 
+            //! @brief 主维度步长, 列优先时为相邻两列的间隔, 行优先时为相邻两行的间隔
+            //!
+            //! 仅对 IsStrided 的矩阵有意义, 紧密排列时就是行数或者列数
+            inline int Stride() const
+            {
+                if constexpr (EStoreType::eStoreStride == Store)
+                    return derived().Stride();
+                else
+                    return (eRowMajor == Align) ? Cols() : Rows();
+            }
+
+            //! @brief 相邻两行同列元素在存储中的间隔, 仅对 IsStrided 的矩阵有意义
+            inline int RowStride() const
+            {
+                return (eRowMajor == Align) ? Stride() : 1;
+            }
+
+            //! @brief 相邻两列同行元素在存储中的间隔, 仅对 IsStrided 的矩阵有意义
+            inline int ColStride() const
+            {
+                return (eRowMajor == Align) ? 1 : Stride();
+            }
+
             //! @brief 获取指定位置的元素指针
             //!
             //! @param [in] idx 元素的展开索引
@@ -877,7 +968,64 @@ namespace xiaotu {
             template <typename OtherDerived>
             MatrixComma<Derived> operator << (MatrixBase<OtherDerived> const & m);
 
+            template <typename OtherDerived>
+            MatrixComma<Derived> operator << (MatrixExpr<OtherDerived> const & m);
+
         private:
+            //! @brief 自身和记录变换的矩阵都是按步长存储的浮点矩阵时, 才能采用分块约化
+            template <typename M>
+            constexpr static bool BlockReducible = IsStrided && std::is_floating_point<Scalar>::value &&
+                                                   M::IsStrided && std::is_same<typename M::Scalar, Scalar>::value;
+
+            //! @brief 分块的上二对角化, m >= n
+            //!
+            //! 下二对角化时传入 A^T 的步长, 并交换 UT 和 V, 此时 UT^T 累积左侧变换, V^T 累积右侧变换
+            //!
+            //! @param [in] m, n, A, rs, cs 待约化矩阵
+            //! @param [out] L 不转置时为 UT, 左乘 Q^T
+            //! @param [out] R 不转置时为 V, 右乘 P
+            //! @param [in] trans 是否传入的是 A^T
+            template <typename MatrixL, typename MatrixR>
+            static void BlockBidiagonal(int m, int n, PlainScalar * A, int rs, int cs,
+                                        MatrixL * L, MatrixR * R, bool trans)
+            {
+                WorkspaceFrame frame;
+                PlainScalar * tauq = frame.Alloc<PlainScalar>(n);
+                PlainScalar * taup = frame.Alloc<PlainScalar>(n);
+                BidiagonalReduce(m, n, A, rs, cs, tauq, taup);
+
+                // 转置时 L 为 V, 需要 V^T = Q^T V^T; R 为 UT, 需要 UT = P^T UT
+                if (nullptr != L) {
+                    int lrs = trans ? L->ColStride() : L->RowStride();
+                    int lcs = trans ? L->RowStride() : L->ColStride();
+                    HouseholderApplyReflectors(m, trans ? L->Rows() : L->Cols(), n, A, rs, cs, tauq,
+                                               HouseholderReduceBlock, true, L->StorBegin(), lrs, lcs);
+                }
+                if (nullptr != R) {
+                    // 不转置时需要 V = V P, 即 V^T = P^T V^T
+                    int rrs = trans ? R->RowStride() : R->ColStride();
+                    int rcs = trans ? R->ColStride() : R->RowStride();
+                    HouseholderApplyReflectors(n - 1, trans ? R->Cols() : R->Rows(), n - 1, A + cs, cs, rs, taup,
+                                               HouseholderReduceBlock, true, R->StorBegin() + rrs, rrs, rcs);
+                }
+
+                for (int c = 0; c < n; c++)
+                    for (int r = 0; r < m; r++)
+                        if (r != c && r + 1 != c)
+                            A[r * rs + c * cs] = 0;
+            }
+
+            //! @brief 按步长计算元素指针, 不检查索引, 用于构造子阵视图
+            inline Scalar * StridePtr(int row, int col)
+            {
+                return derived().StorBegin() + row * RowStride() + col * ColStride();
+            }
+
+            inline Scalar const * StridePtr(int row, int col) const
+            {
+                return derived().StorBegin() + row * RowStride() + col * ColStride();
+            }
+
             Derived & derived() { return *static_cast<Derived*>(this); }
             Derived const & derived() const { return *static_cast<const Derived*>(this); }
     };
@@ -44,6 +44,17 @@ namespace xiaotu {
                 col_idx_ += s.Cols();
             }
 
+            template <typename OtherDerived>
+            MatrixComma(Derived & m, MatrixExpr<OtherDerived> const & s)
+                : target_(m), row_idx_(0), col_idx_(0), cur_row_block_size_(s.Rows())
+            {
+                assert(m.Cols() > 0);
+                assert(m.Rows() > 0);
+
+                target_.Assign(row_idx_, col_idx_, s);
+                col_idx_ += s.Cols();
+            }
+
             MatrixComma & operator , (Scalar const & s)
             {
                 if (target_.Cols() == col_idx_) {
@@ -77,6 +88,23 @@ namespace xiaotu {
                 return *this;
             }
 
+            template <typename MatrixA>
+            MatrixComma & operator , (MatrixExpr<MatrixA> const & m)
+            {
+                if (target_.Cols() == col_idx_) {
+                    row_idx_ += cur_row_block_size_;
+                    col_idx_ = 0;
+                    cur_row_block_size_ = m.Rows();
+                    assert((row_idx_ + cur_row_block_size_) <= target_.Rows());
+                }
+                assert(m.Rows() == cur_row_block_size_);
+                assert((col_idx_ + m.Cols()) <= target_.Cols());
+                target_.Assign(row_idx_, col_idx_, m);
+                col_idx_ += m.Cols();
+
+                return *this;
+            }
+
         private:
             //! @brief 目标矩阵
             Derived & target_;
@@ -104,6 +132,14 @@ namespace xiaotu {
         return MatrixComma<Derived>(*static_cast<Derived*>(this), m);
     }
 
+    template <typename Derived> 
+    template <typename OtherDerived> 
+    MatrixComma<Derived> MatrixBase<Derived>::operator
+    << (MatrixExpr<OtherDerived> const & m)
+    {
+        return MatrixComma<Derived>(*static_cast<Derived*>(this), m);
+    }
+
 }
 
 #endif
@@ -0,0 +1,640 @@
+#ifndef XTMB_LA_MATRIX_EXPRESSION_H
+#define XTMB_LA_MATRIX_EXPRESSION_H
+
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <optional>
+#include <type_traits>
+
+#include <XiaoTuMathBox/Common/ThreadPool.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 矩阵表达式模板
+//
+// 运算符 +, -, * 和数乘、数除不再立即计算, 而是返回一个记录了操作数的表达式节点。
+// 表达式赋值给矩阵时, 才在目标矩阵上求值:
+//   - 逐元素的运算链(加减、数乘)融合成一次遍历, 不产生中间矩阵;
+//   - 矩阵乘积直接通过 Gemm 写入目标矩阵, 系数和累加项折算到 alpha, beta 中;
+//   - 只有目标矩阵与操作数的存储重叠时, 才借助临时矩阵求值。
+//
+// 表达式的求值类型 PlainType 由操作数的编译期尺寸决定: 定长的小矩阵得到栈上的 AMatrix,
+// 定长的大矩阵得到 VMatrix, 尺寸不定时才得到 DMatrix。
+//
+// 左值操作数保存引用, 右值(临时对象)操作数保存副本, 所以 auto x = A * B 是安全的,
+// 但 x 记录的是 A, B 的引用, 修改 A, B 后再访问 x 的结果是未定义的。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 判定 T 是否为矩阵表达式
+    template <typename T, typename = void>
+    struct IsMatrixExpression : std::false_type {};
+
+    template <typename T>
+    struct IsMatrixExpression<T, std::void_t<decltype(T::IsExpression)>>
+        : std::integral_constant<bool, T::IsExpression> {};
+
+    //! @brief 判定 T 是否为包含矩阵乘积的表达式
+    template <typename T, typename = void>
+    struct HasMatrixProduct : std::false_type {};
+
+    template <typename T>
+    struct HasMatrixProduct<T, std::void_t<decltype(T::HasProduct)>>
+        : std::integral_constant<bool, T::HasProduct> {};
+
+    //! @brief 编译期不确定的矩阵尺寸
+    constexpr int DynamicSize = -1;
+
+    //! @brief 编译期的矩阵行数, 类型没有定义 NumRows 时为 DynamicSize
+    template <typename T, typename = void>
+    struct StaticRows : std::integral_constant<int, DynamicSize> {};
+
+    template <typename T>
+    struct StaticRows<T, std::void_t<decltype(T::NumRows)>>
+        : std::integral_constant<int, T::NumRows> {};
+
+    //! @brief 编译期的矩阵列数, 类型没有定义 NumCols 时为 DynamicSize
+    template <typename T, typename = void>
+    struct StaticCols : std::integral_constant<int, DynamicSize> {};
+
+    template <typename T>
+    struct StaticCols<T, std::void_t<decltype(T::NumCols)>>
+        : std::integral_constant<int, T::NumCols> {};
+
+    //! @brief 两个操作数尺寸必须一致时, 取其中编译期确定的那个
+    constexpr int MergeSize(int a, int b) { return DynamicSize == a ? b : a; }
+
+    //! @brief 在栈上分配的矩阵元素个数上限, 超过该值的定长矩阵改用 std::vector 存储
+    constexpr int FixedSizeLimit = 16 * 16;
+
+    //! @brief 根据编译期尺寸选择保存求值结果的矩阵类型
+    //!
+    //! 尺寸确定且较小时为 AMatrix, 尺寸确定但较大时为 VMatrix, 否则为 DMatrix
+    template <typename Scalar, int Rows, int Cols>
+    struct PlainMatrix {
+        constexpr static bool IsFixed = (Rows > 0 && Cols > 0);
+        constexpr static bool OnStack = IsFixed && (Rows * Cols <= FixedSizeLimit);
+
+        typedef typename std::conditional<OnStack, AMatrix<Scalar, Rows, Cols>,
+                typename std::conditional<IsFixed, VMatrix<Scalar, Rows, Cols>,
+                DMatrix<Scalar>>::type>::type type;
+
+        //! @brief 构造一个 rows x cols 的矩阵, 定长矩阵忽略参数
+        static type Make(int rows, int cols)
+        {
+            if constexpr (IsFixed) {
+                assert(Rows == rows && Cols == cols);
+                return type();
+            } else {
+                return type(rows, cols);
+            }
+        }
+    };
+
+    //! @brief 矩阵(或表达式)类型 M 求值结果的类型
+    template <typename M>
+    using PlainMatrixOf = PlainMatrix<typename std::remove_const<typename M::Scalar>::type,
+                                      StaticRows<M>::value, StaticCols<M>::value>;
+
+    //! @brief 表达式保存操作数的方式, 左值保存常引用, 右值保存副本
+    template <typename T>
+    using ExprOperand = typename std::conditional<std::is_lvalue_reference<T>::value,
+                                                  typename std::decay<T>::type const &,
+                                                  typename std::decay<T>::type>::type;
+
+    //! @brief 操作数与目标矩阵的存储重叠情况
+    enum EAliasType {
+        //! 不重叠
+        eAliasNone = 0,
+        //! 完全重合, 逐元素计算时每个元素都是先读后写, 是安全的
+        eAliasSame = 1,
+        //! 部分重叠或者无法判定
+        eAliasPartial = 2
+    };
+
+    //! @brief 判定矩阵(或表达式) m 与目标矩阵 dst 的存储重叠情况
+    //!
+    //! 代理存储无法确定所占的内存范围, 只要标量类型一致就认为可能重叠
+    template <typename Mat, typename Dst>
+    EAliasType AliasOf(Mat const & m, Dst const & dst)
+    {
+        if constexpr (IsMatrixExpression<Mat>::value) {
+            return m.AliasWith(dst);
+        } else {
+            typedef typename std::remove_const<typename Mat::Scalar>::type MScalar;
+            typedef typename std::remove_const<typename Dst::Scalar>::type DScalar;
+            if constexpr (!std::is_same<MScalar, DScalar>::value) {
+                return eAliasNone;
+            } else {
+                if (std::is_same<Mat, Dst>::value && (void const *)&m == (void const *)&dst)
+                    return eAliasSame;
+
+                if constexpr (Mat::IsStrided && Dst::IsStrided) {
+                    if (0 == m.NumDatas() || 0 == dst.NumDatas())
+                        return eAliasNone;
+                    // 带步长的视图按首尾元素之间的范围判定, 交错而不重叠的视图也当作重叠
+                    MScalar const * m0 = m.StorBegin();
+                    MScalar const * m1 = m0 + (m.Rows() - 1) * m.RowStride() + (m.Cols() - 1) * m.ColStride() + 1;
+                    DScalar const * d0 = dst.StorBegin();
+                    DScalar const * d1 = d0 + (dst.Rows() - 1) * dst.RowStride() + (dst.Cols() - 1) * dst.ColStride() + 1;
+                    if (m1 <= d0 || d1 <= m0)
+                        return eAliasNone;
+                    if (m0 == d0 && m.Rows() == dst.Rows() && m.Cols() == dst.Cols() && Mat::Align == Dst::Align &&
+                        m.Stride() == dst.Stride())
+                        return eAliasSame;
+                }
+                return eAliasPartial;
+            }
+        }
+    }
+
+    //! @brief 逐元素计算 dst = alpha * src + beta * dst
+    //!
+    //! 按照 dst 的存储顺序遍历。beta 为 0 时不读取 dst。
+    //! dst 为定长矩阵时循环次数是编译期常量, 编译器可以完全展开。
+    //! 变长矩阵的元素数量超过 ParallelCwiseSize 时, 按外层循环切块并行;
+    //! src 中含有矩阵乘积时, 逐元素访问会触发乘积的延迟求值, 所以不并行。
+    template <typename Dst, typename Src, typename Scalar>
+    void CwiseAssign(Dst & dst, Src const & src, Scalar alpha, Scalar beta)
+    {
+        constexpr bool rowMajor = (EAlignType::eRowMajor == Dst::Align);
+        constexpr int fixedOuter = rowMajor ? StaticRows<Dst>::value : StaticCols<Dst>::value;
+        constexpr int fixedInner = rowMajor ? StaticCols<Dst>::value : StaticRows<Dst>::value;
+        int outer = (DynamicSize == fixedOuter) ? (rowMajor ? dst.Rows() : dst.Cols()) : fixedOuter;
+        int inner = (DynamicSize == fixedInner) ? (rowMajor ? dst.Cols() : dst.Rows()) : fixedInner;
+
+        auto range = [&](int begin, int end, auto op) {
+#pragma GCC unroll 16
+            for (int o = begin; o < end; ++o) {
+#pragma GCC unroll 16
+                for (int i = 0; i < inner; ++i) {
+                    int r = rowMajor ? o : i;
+                    int c = rowMajor ? i : o;
+                    op(dst(r, c), src(r, c));
+                }
+            }
+        };
+
+        auto loop = [&](auto op) {
+            if constexpr (DynamicSize == fixedOuter && !HasMatrixProduct<Src>::value) {
+                if ((long)outer * inner >= ParallelCwiseSize && ParallelEnabled()) {
+                    ParallelFor(0, outer, ParallelGrain(outer, 1, 1), [&](int b, int e) { range(b, e, op); });
+                    return;
+                }
+            }
+            range(0, outer, op);
+        };
+
+        if (0 != beta)
+            loop([alpha, beta](auto & d, auto s) { d = alpha * s + beta * d; });
+        else if (1 != alpha)
+            loop([alpha](auto & d, auto s) { d = alpha * s; });
+        else
+            loop([](auto & d, auto s) { d = s; });
+    }
+
+    //! @brief 在 dst 上求值 dst = alpha * m + beta * dst, m 可以是矩阵也可以是表达式
+    template <typename Mat, typename Dst, typename Scalar>
+    void ExprEvalTo(Mat const & m, Dst & dst, Scalar alpha, Scalar beta)
+    {
+        if constexpr (IsMatrixExpression<Mat>::value) {
+            m.EvalTo(dst, alpha, beta);
+        } else {
+            if (eAliasPartial == AliasOf(m, dst)) {
+                typename PlainMatrixOf<Mat>::type tmp = m;
+                CwiseAssign(dst, tmp, alpha, beta);
+            } else {
+                CwiseAssign(dst, m, alpha, beta);
+            }
+        }
+    }
+
+    //! @brief 同 ExprEvalTo, 但由调用者保证 m 不读取 dst 的存储
+    template <typename Mat, typename Dst, typename Scalar>
+    void ExprEvalNoAlias(Mat const & m, Dst & dst, Scalar alpha, Scalar beta)
+    {
+        if constexpr (IsMatrixExpression<Mat>::value)
+            m.EvalNoAlias(dst, alpha, beta);
+        else
+            CwiseAssign(dst, m, alpha, beta);
+    }
+
+    //! @brief 表达式的操作数求值, 表达式返回计算结果, 矩阵返回其自身的引用
+    template <typename Mat>
+    decltype(auto) EvalOperand(Mat const & m)
+    {
+        if constexpr (IsMatrixExpression<Mat>::value)
+            return m.Eval();
+        else
+            return (m);
+    }
+
+    /**
+     * @brief 矩阵表达式的基类
+     *
+     * 只读, 提供元素访问和一些常用的聚合运算。需要修改的操作请先 Eval()。
+     * 展开索引按照列优先的顺序。
+     */
+    template <typename Derived>
+    class MatrixExpr
+    {
+        public:
+            typedef typename Traits<Derived>::Scalar Scalar;
+            typedef typename Traits<Derived>::PlainType PlainType;
+            constexpr static bool IsMatrix = true;
+            constexpr static bool IsExpression = true;
+            constexpr static bool IsContiguous = false;
+            constexpr static bool IsStrided = false;
+            constexpr static EAlignType Align = Traits<Derived>::Align;
+            constexpr static EStoreType Store = Traits<Derived>::Store;
+            constexpr static int NumRows = Traits<Derived>::NumRows;
+            constexpr static int NumCols = Traits<Derived>::NumCols;
+
+        public:
+            //! @brief 在目标矩阵上求值 dst = alpha * expr + beta * dst
+            //!
+            //! 缺省的实现逐元素计算, 存储部分重叠时借助临时矩阵
+            template <typename Dst>
+            void EvalTo(Dst & dst, Scalar alpha, Scalar beta) const
+            {
+                assert(dst.Rows() == Rows() && dst.Cols() == Cols());
+                if (eAliasPartial == derived().AliasWith(dst))
+                    EvalByTemp(dst, alpha, beta);
+                else
+                    CwiseAssign(dst, derived(), alpha, beta);
+            }
+
+            //! @brief 先求值到临时矩阵, 再计算 dst = alpha * tmp + beta * dst
+            template <typename Dst>
+            void EvalByTemp(Dst & dst, Scalar alpha, Scalar beta) const
+            {
+                PlainType tmp = Allocate();
+                derived().EvalNoAlias(tmp, Scalar(1), Scalar(0));
+                CwiseAssign(dst, tmp, alpha, beta);
+            }
+
+            //! @brief 构造一个与表达式尺寸一致的矩阵, 不初始化
+            PlainType Allocate() const
+            {
+                return PlainMatrix<Scalar, NumRows, NumCols>::Make(Rows(), Cols());
+            }
+
+            //! @brief 求值
+            PlainType Eval() const
+            {
+                PlainType re = Allocate();
+                derived().EvalNoAlias(re, Scalar(1), Scalar(0));
+                return re;
+            }
+
+            //! @brief 转置, 先求值
+            auto Transpose() const { return Eval().Transpose(); }
+
+            //! @brief 求逆矩阵, 先求值
+            auto InverseMat() const { return Eval().InverseMat(); }
+
+            //! @brief 截断接近 0 的元素, 返回求值后的矩阵
+            PlainType Truncate(Scalar tolerance = SMALL_VALUE) const
+            {
+                PlainType re = Eval();
+                re.Truncate(tolerance);
+                return re;
+            }
+
+            //! @brief 求负, 临时表达式以副本的形式保存
+            auto operator - () const &;
+            auto operator - () &&;
+
+        public:
+            //! @brief 点积
+            template <typename MType>
+            Scalar Dot(MType const & m) const
+            {
+                assert(NumDatas() == m.NumDatas());
+                Scalar re = 0;
+                for (int i = 0; i < NumDatas(); i++)
+                    re += (*this)(i) * m(i);
+                return re;
+            }
+
+            Scalar SquaredNorm() const { return Dot(*this); }
+            Scalar Norm() const { return std::sqrt(SquaredNorm()); }
+
+            bool IsIdentity(Scalar tolerance = SMALL_VALUE) const { return Eval().IsIdentity(tolerance); }
+            bool IsZero(Scalar tolerance = SMALL_VALUE) const { return Eval().IsZero(tolerance); }
+            bool IsSymmetric(Scalar tolerance = SMALL_VALUE) const { return Eval().IsSymmetric(tolerance); }
+
+        public:
+            inline int Rows() const { return derived().Rows(); }
+            inline int Cols() const { return derived().Cols(); }
+            inline int NumDatas() const { return Rows() * Cols(); }
+
+            inline Scalar operator() (int row, int col) const
+            {
+                return derived().Coeff(row, col);
+            }
+
+            inline Scalar operator() (int idx) const
+            {
+                return derived().Coeff(idx % Rows(), idx / Rows());
+            }
+
+            friend std::ostream & operator << (std::ostream & s, MatrixExpr const & m)
+            {
+                s << std::endl;
+                for (int ridx = 0; ridx < m.Rows(); ridx++) {
+                    s << m(ridx, 0);
+                    for (int cidx = 1; cidx < m.Cols(); cidx++)
+                        s << "\t" << m(ridx, cidx);
+                    s << std::endl;
+                }
+                return s;
+            }
+
+        protected:
+            Derived const & derived() const { return *static_cast<const Derived*>(this); }
+    };
+
+    //! @brief 逐元素加法
+    struct ExprPlus {
+        constexpr static int Sign = 1;
+        template <typename Scalar>
+        static Scalar Apply(Scalar a, Scalar b) { return a + b; }
+    };
+
+    //! @brief 逐元素减法
+    struct ExprMinus {
+        constexpr static int Sign = -1;
+        template <typename Scalar>
+        static Scalar Apply(Scalar a, Scalar b) { return a - b; }
+    };
+
+    template <typename Op, typename Lhs, typename Rhs>
+    class CwiseBinaryExpr;
+
+    template <typename Mat>
+    class ScalarMultipleExpr;
+
+    template <typename Lhs, typename Rhs>
+    class ProductExpr;
+
+    template <typename Op, typename Lhs, typename Rhs>
+    struct Traits<CwiseBinaryExpr<Op, Lhs, Rhs>> {
+        typedef typename std::decay<Lhs>::type LhsType;
+        typedef typename std::decay<Rhs>::type RhsType;
+        typedef typename std::remove_const<typename LhsType::Scalar>::type Scalar;
+        constexpr static int NumRows = MergeSize(StaticRows<LhsType>::value, StaticRows<RhsType>::value);
+        constexpr static int NumCols = MergeSize(StaticCols<LhsType>::value, StaticCols<RhsType>::value);
+        typedef typename PlainMatrix<Scalar, NumRows, NumCols>::type PlainType;
+        constexpr static EAlignType Align = EAlignType::eColMajor;
+        constexpr static EStoreType Store = EStoreType::eStoreProxy;
+    };
+
+    template <typename Mat>
+    struct Traits<ScalarMultipleExpr<Mat>> {
+        typedef typename std::decay<Mat>::type MatType;
+        typedef typename std::remove_const<typename MatType::Scalar>::type Scalar;
+        constexpr static int NumRows = StaticRows<MatType>::value;
+        constexpr static int NumCols = StaticCols<MatType>::value;
+        typedef typename PlainMatrix<Scalar, NumRows, NumCols>::type PlainType;
+        constexpr static EAlignType Align = EAlignType::eColMajor;
+        constexpr static EStoreType Store = EStoreType::eStoreProxy;
+    };
+
+    template <typename Lhs, typename Rhs>
+    struct Traits<ProductExpr<Lhs, Rhs>> {
+        typedef typename std::decay<Lhs>::type LhsType;
+        typedef typename std::decay<Rhs>::type RhsType;
+        typedef typename std::remove_const<typename LhsType::Scalar>::type Scalar;
+        constexpr static int NumRows = StaticRows<LhsType>::value;
+        constexpr static int NumCols = StaticCols<RhsType>::value;
+        typedef typename PlainMatrix<Scalar, NumRows, NumCols>::type PlainType;
+        constexpr static EAlignType Align = EAlignType::eColMajor;
+        constexpr static EStoreType Store = EStoreType::eStoreProxy;
+    };
+
+    /**
+     * @brief 逐元素的二元运算 A + B, A - B
+     */
+    template <typename Op, typename Lhs, typename Rhs>
+    class CwiseBinaryExpr : public MatrixExpr<CwiseBinaryExpr<Op, Lhs, Rhs>>
+    {
+        public:
+            typedef MatrixExpr<CwiseBinaryExpr> Base;
+            typedef typename Base::Scalar Scalar;
+            typedef typename std::decay<Lhs>::type LhsType;
+            typedef typename std::decay<Rhs>::type RhsType;
+            constexpr static bool HasProduct = HasMatrixProduct<LhsType>::value ||
+                                               HasMatrixProduct<RhsType>::value;
+
+        public:
+            CwiseBinaryExpr(Lhs && lhs, Rhs && rhs)
+                : mLhs(std::forward<Lhs>(lhs)), mRhs(std::forward<Rhs>(rhs))
+            {
+                assert(mLhs.Rows() == mRhs.Rows() && mLhs.Cols() == mRhs.Cols());
+            }
+
+            inline int Rows() const { return mLhs.Rows(); }
+            inline int Cols() const { return mLhs.Cols(); }
+
+            inline Scalar Coeff(int row, int col) const
+            {
+                return Op::Apply(Scalar(mLhs(row, col)), Scalar(mRhs(row, col)));
+            }
+
+            template <typename Dst>
+            EAliasType AliasWith(Dst const & dst) const
+            {
+                return std::max(AliasOf(mLhs, dst), AliasOf(mRhs, dst));
+            }
+
+            //! @brief dst = alpha * (L op R) + beta * dst
+            //!
+            //! 包含矩阵乘积时, 先把一侧写入 dst, 再把另一侧累加上去,
+            //! 要求后计算的一侧不读取 dst。其它情况逐元素融合计算。
+            template <typename Dst>
+            void EvalTo(Dst & dst, Scalar alpha, Scalar beta) const
+            {
+                if constexpr (HasProduct) {
+                    Scalar sign(Op::Sign);
+                    if (eAliasNone == AliasOf(mRhs, dst)) {
+                        ExprEvalTo(mLhs, dst, alpha, beta);
+                        ExprEvalTo(mRhs, dst, sign * alpha, Scalar(1));
+                    } else if (eAliasNone == AliasOf(mLhs, dst)) {
+                        ExprEvalTo(mRhs, dst, sign * alpha, beta);
+                        ExprEvalTo(mLhs, dst, alpha, Scalar(1));
+                    } else {
+                        Base::EvalByTemp(dst, alpha, beta);
+                    }
+                } else {
+                    Base::EvalTo(dst, alpha, beta);
+                }
+            }
+
+            //! @brief 同 EvalTo, 但由调用者保证表达式不读取 dst 的存储
+            template <typename Dst>
+            void EvalNoAlias(Dst & dst, Scalar alpha, Scalar beta) const
+            {
+                if constexpr (HasProduct) {
+                    ExprEvalNoAlias(mLhs, dst, alpha, beta);
+                    ExprEvalNoAlias(mRhs, dst, Scalar(Op::Sign) * alpha, Scalar(1));
+                } else {
+                    CwiseAssign(dst, *this, alpha, beta);
+                }
+            }
+
+        private:
+            ExprOperand<Lhs> mLhs;
+            ExprOperand<Rhs> mRhs;
+    };
+
+    /**
+     * @brief 数乘 aA
+     */
+    template <typename Mat>
+    class ScalarMultipleExpr : public MatrixExpr<ScalarMultipleExpr<Mat>>
+    {
+        public:
+            typedef MatrixExpr<ScalarMultipleExpr> Base;
+            typedef typename Base::Scalar Scalar;
+            typedef typename std::decay<Mat>::type MatType;
+            constexpr static bool HasProduct = HasMatrixProduct<MatType>::value;
+
+        public:
+            ScalarMultipleExpr(Scalar const & a, Mat && m)
+                : mScalar(a), mMat(std::forward<Mat>(m))
+            {}
+
+            inline int Rows() const { return mMat.Rows(); }
+            inline int Cols() const { return mMat.Cols(); }
+
+            inline Scalar Coeff(int row, int col) const
+            {
+                return mScalar * mMat(row, col);
+            }
+
+            template <typename Dst>
+            EAliasType AliasWith(Dst const & dst) const
+            {
+                return AliasOf(mMat, dst);
+            }
+
+            //! @brief dst = alpha * a * M + beta * dst, 系数并入 M 的求值过程
+            template <typename Dst>
+            void EvalTo(Dst & dst, Scalar alpha, Scalar beta) const
+            {
+                ExprEvalTo(mMat, dst, alpha * mScalar, beta);
+            }
+
+            template <typename Dst>
+            void EvalNoAlias(Dst & dst, Scalar alpha, Scalar beta) const
+            {
+                ExprEvalNoAlias(mMat, dst, alpha * mScalar, beta);
+            }
+
+        private:
+            Scalar mScalar;
+            ExprOperand<Mat> mMat;
+    };
+
+    /**
+     * @brief 矩阵乘积 AB
+     *
+     * 赋值时直接调用 Gemm 写入目标矩阵。
+     * 逐元素访问时先把乘积求值到内部的缓存中, 之后的访问都读缓存。
+     */
+    template <typename Lhs, typename Rhs>
+    class ProductExpr : public MatrixExpr<ProductExpr<Lhs, Rhs>>
+    {
+        public:
+            typedef MatrixExpr<ProductExpr> Base;
+            typedef typename Base::Scalar Scalar;
+            typedef typename Base::PlainType PlainType;
+            constexpr static bool HasProduct = true;
+
+        public:
+            ProductExpr(Lhs && lhs, Rhs && rhs)
+                : mLhs(std::forward<Lhs>(lhs)), mRhs(std::forward<Rhs>(rhs))
+            {
+                assert(mLhs.Cols() == mRhs.Rows());
+            }
+
+            inline int Rows() const { return mLhs.Rows(); }
+            inline int Cols() const { return mRhs.Cols(); }
+
+            inline Scalar Coeff(int row, int col) const
+            {
+                return Cache()(row, col);
+            }
+
+            //! @brief 乘积的每个元素都依赖整行整列, 只要有重叠就不能直接写入
+            template <typename Dst>
+            EAliasType AliasWith(Dst const & dst) const
+            {
+                if (eAliasNone == AliasOf(mLhs, dst) && eAliasNone == AliasOf(mRhs, dst))
+                    return eAliasNone;
+                return eAliasPartial;
+            }
+
+            //! @brief dst = alpha * AB + beta * dst
+            template <typename Dst>
+            void EvalTo(Dst & dst, Scalar alpha, Scalar beta) const
+            {
+                assert(dst.Rows() == Rows() && dst.Cols() == Cols());
+                if (eAliasNone != AliasWith(dst))
+                    CwiseAssign(dst, Cache(), alpha, beta);
+                else
+                    EvalNoAlias(dst, alpha, beta);
+            }
+
+            //! @brief 同 EvalTo, 但由调用者保证 A, B 不读取 dst 的存储
+            template <typename Dst>
+            void EvalNoAlias(Dst & dst, Scalar alpha, Scalar beta) const
+            {
+                auto const & a = EvalOperand(mLhs);
+                auto const & b = EvalOperand(mRhs);
+                bool success = Gemm(alpha, a, b, beta, dst);
+                assert(success);
+            }
+
+            //! @brief 乘积结果的视图, 数据存储在内部缓存中
+            auto View() const
+            {
+                Cache();
+                return mCache->View();
+            }
+
+        private:
+            PlainType const & Cache() const
+            {
+                if (!mCache) {
+                    mCache.emplace(Base::Allocate());
+                    EvalNoAlias(*mCache, Scalar(1), Scalar(0));
+                }
+                return *mCache;
+            }
+
+        private:
+            ExprOperand<Lhs> mLhs;
+            ExprOperand<Rhs> mRhs;
+            mutable std::optional<PlainType> mCache;
+    };
+
+    template <typename Derived>
+    auto MatrixExpr<Derived>::operator - () const &
+    {
+        return ScalarMultipleExpr<Derived const &>(Scalar(-1), derived());
+    }
+
+    template <typename Derived>
+    auto MatrixExpr<Derived>::operator - () &&
+    {
+        return ScalarMultipleExpr<Derived>(Scalar(-1), std::move(static_cast<Derived &>(*this)));
+    }
+
+}
+
+#endif
@@ -6,6 +6,12 @@
 #include <vector>
 #include <cmath>
 #include <iostream>
+#include <type_traits>
+#include <utility>
+
+#include <XiaoTuMathBox/LinearAlgibra/Gemm.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/Simd.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/MatrixExpression.hpp>
 
 
 /////////////////////////////////////////////////////////////////////////
@@ -15,6 +21,96 @@
 /////////////////////////////////////////////////////////////////////////
 namespace xiaotu {
 
+    //! @brief 判定乘法 R = AB 能否直接交给 Gemm
+    //!
+    //! 要求三者都可以用行列步长寻址(连续存储或者其子阵), 标量类型相同且为浮点数, R 可写。
+    //! 代理存储(代理的子阵、行列视图)仍然走逐元素的通用实现。
+    template <typename MatrixA, typename MatrixB, typename MatrixRe>
+    struct GemmDispatchable {
+        typedef typename std::remove_const<typename MatrixRe::Scalar>::type Scalar;
+        constexpr static bool value =
+            MatrixA::IsStrided && MatrixB::IsStrided && MatrixRe::IsStrided &&
+            std::is_floating_point<Scalar>::value &&
+            !std::is_const<typename MatrixRe::Scalar>::value &&
+            std::is_same<Scalar, typename std::remove_const<typename MatrixA::Scalar>::type>::value &&
+            std::is_same<Scalar, typename std::remove_const<typename MatrixB::Scalar>::type>::value;
+    };
+
+    //! @brief 判定矩阵能否作为 Simd.hpp 中计算核心的操作数
+    //!
+    //! 要求连续存储, 标量为浮点数。行列数都在编译期确定的小矩阵交给编译器展开, 不走 SIMD。
+    template <typename Mat, typename = void>
+    struct SimdOperand : std::false_type {};
+
+    template <typename Mat>
+    struct SimdOperand<Mat, std::void_t<decltype(Mat::IsContiguous),
+                                        decltype(std::declval<Mat const &>().StorBegin())>> {
+        typedef typename std::remove_const<typename Mat::Scalar>::type Scalar;
+        constexpr static bool value =
+            Mat::IsContiguous && std::is_floating_point<Scalar>::value &&
+            (DynamicSize == StaticRows<Mat>::value || DynamicSize == StaticCols<Mat>::value);
+    };
+
+    //! @brief 判定逐元素运算 R = op(A, ...) 能否直接交给 Simd.hpp 中的计算核心
+    //!
+    //! 各操作数都满足 SimdOperand, 标量类型和存储顺序都与 R 相同, R 可写。
+    //! 此时各矩阵的元素在存储中一一对应, 可以当作一维数组处理。
+    template <typename MatrixRe, typename... Mats>
+    struct SimdDispatchable {
+        typedef typename std::remove_const<typename MatrixRe::Scalar>::type Scalar;
+        constexpr static bool value =
+            SimdOperand<MatrixRe>::value && !std::is_const<typename MatrixRe::Scalar>::value &&
+            (... && (SimdOperand<Mats>::value && MatrixRe::Align == Mats::Align &&
+                     std::is_same<Scalar, typename std::remove_const<typename Mats::Scalar>::type>::value));
+    };
+
+    //! @brief 以一维数组的方式逐元素执行 func(b, e), 元素数量超过 ParallelCwiseSize 时切块并行
+    template <typename Func>
+    void ForEachChunk(int n, Func && func)
+    {
+        if (n >= ParallelCwiseSize && ParallelEnabled()) {
+            ParallelFor(0, n, ParallelGrain(n, 64, 4096), func);
+            return;
+        }
+
+        func(0, n);
+    }
+
+    //! @brief 以 SIMD 的方式计算 R = op(A, B), 要求满足 SimdDispatchable 且尺寸一致
+    //!
+    //! @return 元素数量少于 SimdMinSize 时不做计算并返回 false, 由调用者逐元素计算
+    template <typename Op, typename MatrixA, typename MatrixB, typename MatrixRe>
+    bool SimdCwise(MatrixA const & A, MatrixB const & B, MatrixRe & R)
+    {
+        int num = R.NumDatas();
+        if (num < SimdMinSize)
+            return false;
+
+        auto a = A.StorBegin();
+        auto b = B.StorBegin();
+        auto r = R.StorBegin();
+        ForEachChunk(num, [&](int begin, int end) {
+            SimdMap<Op>(end - begin, a + begin, b + begin, r + begin);
+        });
+        return true;
+    }
+
+    //! @brief 逐行执行 func(ridx), 元素数量 m x n 超过 ParallelCwiseSize 时按行切块并行
+    template <typename Func>
+    void ForEachRow(int m, int n, Func && func)
+    {
+        if ((long)m * n >= ParallelCwiseSize && ParallelEnabled()) {
+            ParallelFor(0, m, ParallelGrain(m, 1, 1), [&](int b, int e) {
+                for (int ridx = b; ridx < e; ++ridx)
+                    func(ridx);
+            });
+            return;
+        }
+
+        for (int ridx = 0; ridx < m; ++ridx)
+            func(ridx);
+    }
+
     //! @brief 矩阵 A 的转置
     //!
     //! @return 矩阵尺寸是否合法
@@ -26,9 +122,10 @@ namespace xiaotu {
 
         int m = A.Rows();
         int n = A.Cols();
-        for (int ridx = 0; ridx < m; ++ridx)
+        ForEachRow(m, n, [&](int ridx) {
             for (int cidx = 0; cidx < n; ++cidx)
                 T(cidx, ridx) = A(ridx, cidx);
+        });
 
         return true;
     }
@@ -90,30 +187,42 @@ namespace xiaotu {
             R.Cols() != B.Cols() || R.Rows() != B.Rows())
             return false;
 
+        if constexpr (SimdDispatchable<MatrixRe, MatrixA, MatrixB>::value) {
+            if (SimdCwise<SimdPlus>(A, B, R))
+                return true;
+        }
+
         int m = R.Rows();
         int n = R.Cols();
-        for (int ridx = 0; ridx < m; ++ridx)
+        ForEachRow(m, n, [&](int ridx) {
             for (int cidx = 0; cidx < n; ++cidx)
                 R(ridx, cidx) = A(ridx, cidx) + B(ridx, cidx);
+        });
 
         return true;
     }
 
-    //! @brief 矩阵的加法 Re = A + B
-    template <typename MatrixA, typename MatrixB, bool AIsMatrix = MatrixA::IsMatrix, bool BIsMatrix = MatrixB::IsMatrix>
-    DMatrix<typename MatrixA::Scalar>
-    operator + (MatrixA const & A, MatrixB const & B)
+    //! @brief 矩阵的加法 Re = A + B, 返回表达式, 赋值时求值
+    template <typename MatrixA, typename MatrixB,
+              bool AIsMatrix = std::decay<MatrixA>::type::IsMatrix,
+              bool BIsMatrix = std::decay<MatrixB>::type::IsMatrix>
+    CwiseBinaryExpr<ExprPlus, MatrixA, MatrixB>
+    operator + (MatrixA && A, MatrixB && B)
     {
-        DMatrix<typename MatrixA::Scalar> re(A.Rows(), B.Cols());
-        bool success = Add(A, B, re);
-        assert(success);
-        return re;
+        return CwiseBinaryExpr<ExprPlus, MatrixA, MatrixB>(std::forward<MatrixA>(A), std::forward<MatrixB>(B));
     }
 
     //! @brief 矩阵的加法 A += B
     template <typename MatrixA, typename MatrixB>
     MatrixA & operator += (MatrixA & A, MatrixB const & B)
     {
+        if constexpr (IsMatrixExpression<MatrixB>::value) {
+            typedef typename MatrixA::Scalar Scalar;
+            assert(A.Rows() == B.Rows() && A.Cols() == B.Cols());
+            B.EvalTo(A, Scalar(1), Scalar(1));
+            return A;
+        }
+
         bool success = Add(A, B, A);
         assert(success);
         return A;
@@ -135,32 +244,42 @@ namespace xiaotu {
             R.Cols() != B.Cols() || R.Rows() != B.Rows())
             return false;
 
+        if constexpr (SimdDispatchable<MatrixRe, MatrixA, MatrixB>::value) {
+            if (SimdCwise<SimdMinus>(A, B, R))
+                return true;
+        }
+
         int m = R.Rows();
         int n = R.Cols();
-        for (int ridx = 0; ridx < m; ++ridx)
+        ForEachRow(m, n, [&](int ridx) {
             for (int cidx = 0; cidx < n; ++cidx)
                 R(ridx, cidx) = A(ridx, cidx) - B(ridx, cidx);
+        });
 
         return true;
     }
 
-    //! @brief 矩阵的减法 Re = A - B
+    //! @brief 矩阵的减法 Re = A - B, 返回表达式, 赋值时求值
     template <typename MatrixA, typename MatrixB,
-              bool AIsMatrix = MatrixA::IsMatrix,
-              bool BIsMatrix = MatrixB::IsMatrix>
-    DMatrix<typename MatrixA::Scalar>
-    operator - (MatrixA const & A, MatrixB const & B)
+              bool AIsMatrix = std::decay<MatrixA>::type::IsMatrix,
+              bool BIsMatrix = std::decay<MatrixB>::type::IsMatrix>
+    CwiseBinaryExpr<ExprMinus, MatrixA, MatrixB>
+    operator - (MatrixA && A, MatrixB && B)
     {
-        DMatrix<typename MatrixA::Scalar> re(A.Rows(), B.Cols());
-        bool success = Sub(A, B, re);
-        assert(success);
-        return re;
+        return CwiseBinaryExpr<ExprMinus, MatrixA, MatrixB>(std::forward<MatrixA>(A), std::forward<MatrixB>(B));
     }
 
     //! @brief 矩阵的减法 A -= B
     template <typename MatrixA, typename MatrixB>
     MatrixA & operator -= (MatrixA & A, MatrixB const & B)
     {
+        if constexpr (IsMatrixExpression<MatrixB>::value) {
+            typedef typename MatrixA::Scalar Scalar;
+            assert(A.Rows() == B.Rows() && A.Cols() == B.Cols());
+            B.EvalTo(A, Scalar(-1), Scalar(1));
+            return A;
+        }
+
         bool success = Sub(A, B, A);
         assert(success);
         return A;
@@ -182,6 +301,22 @@ namespace xiaotu {
         if (n != y.NumDatas())
             return false;
 
+        // 逐元素的计算按存储顺序进行, 不要求 x 和 y 的存储顺序一致
+        typedef typename std::remove_const<typename VectorY::Scalar>::type YScalar;
+        if constexpr (SimdOperand<VectorX>::value && SimdOperand<VectorY>::value &&
+                      !std::is_const<typename VectorY::Scalar>::value &&
+                      std::is_same<YScalar, typename std::remove_const<typename VectorX::Scalar>::type>::value) {
+            if (n >= SimdMinSize) {
+                YScalar ya = a;
+                auto px = x.StorBegin();
+                auto py = y.StorBegin();
+                ForEachChunk(n, [&](int begin, int end) {
+                    SimdAxpy(end - begin, ya, px + begin, py + begin);
+                });
+                return true;
+            }
+        }
+
         for (int i = 0; i < n; ++i)
             y(i) += a * x(i);
         return true;
@@ -200,17 +335,8 @@ namespace xiaotu {
               bool CIsMatrix = MatrixC::IsMatrix>
     bool Gaxpy(MatrixA const & A, MatrixB const & B, MatrixC & C)
     {
-        int m = A.Rows();
-        int r = A.Cols();
-        int n = B.Cols();
-        if (B.Rows() != r || C.Rows() != m || C.Cols() != n)
-            return false;
-
-        for (int midx = 0; midx < m; ++midx)
-            for (int ridx = 0; ridx < r; ++ridx)
-                for (int nidx = 0; nidx < n; ++nidx)
-                    C(midx, nidx) += A(midx, ridx) * B(ridx, nidx);
-        return true;
+        typedef typename MatrixC::Scalar Scalar;
+        return Gemm(Scalar(1), A, B, Scalar(1), C);
     }
 
     //! @brief 矩阵的加法 A = A + uI
@@ -257,43 +383,84 @@ namespace xiaotu {
 /////////////////////////////////////////////////////////////////////////
 namespace xiaotu {
 
-    //! @brief 矩阵的乘法 Re = AB
+    //! @brief 矩阵乘法的一般形式 C = alpha * AB + beta * C
     //!
     //! 适用于 MatrixView, Matrix
+    //! 连续存储的浮点矩阵调用分块的 Gemm, 其中编译期尺寸较小的调用 GemmFixed,
+    //! 其它情况逐元素计算。
+    //! C 不能与 A, B 共享存储。beta 为 0 时不读取 C 原有的数据。
     //!
-    //! @param [in] A 矩阵 A
-    //! @param [in] B 矩阵 B
-    //! @param [out] R R = AB
+    //! @param [in] alpha 乘积的系数
+    //! @param [in] A 矩阵 A, (m x l)
+    //! @param [in] B 矩阵 B, (l x n)
+    //! @param [in] beta C 的系数
+    //! @param [in|out] C 矩阵 C, (m x n)
     //!
     //! @return 矩阵尺寸是否合法
-    template <typename MatrixA, typename MatrixB, typename MatrixRe>
-    bool Multiply(MatrixA const & A, MatrixB const & B, MatrixRe & R)
+    template <typename Scalar, typename MatrixA, typename MatrixB, typename MatrixC>
+    bool Gemm(Scalar alpha, MatrixA const & A, MatrixB const & B, Scalar beta, MatrixC & C)
     {
-        if (A.Cols() != B.Rows() || R.Rows() != A.Rows() || R.Cols() != B.Cols())
+        if (A.Cols() != B.Rows() || C.Rows() != A.Rows() || C.Cols() != B.Cols())
             return false;
 
         int l = A.Cols();
-        int m = R.Rows();
-        int n = R.Cols();
+        int m = C.Rows();
+        int n = C.Cols();
+
+        constexpr int M = StaticRows<MatrixC>::value;
+        constexpr int N = StaticCols<MatrixC>::value;
+        constexpr int L = StaticCols<MatrixA>::value;
+        constexpr bool isFixed = M > 0 && N > 0 && L > 0 && M * N <= FixedSizeLimit && L <= 16;
+
+        if constexpr (GemmDispatchable<MatrixA, MatrixB, MatrixC>::value && isFixed) {
+            GemmFixed<typename MatrixC::Scalar, M, N, L>(alpha,
+                                 A.StorBegin(), A.RowStride(), A.ColStride(),
+                                 B.StorBegin(), B.RowStride(), B.ColStride(),
+                 beta, C.StorBegin(), C.RowStride(), C.ColStride());
+            return true;
+        } else if constexpr (GemmDispatchable<MatrixA, MatrixB, MatrixC>::value) {
+            Gemm(m, n, l, alpha, A.StorBegin(), A.RowStride(), A.ColStride(),
+                                 B.StorBegin(), B.RowStride(), B.ColStride(),
+                 beta, C.StorBegin(), C.RowStride(), C.ColStride());
+            return true;
+        }
+
         for (int ridx = 0; ridx < m; ++ridx)
             for (int cidx = 0; cidx < n; ++cidx) {
-                R(ridx, cidx) = 0;
+                Scalar sum = 0;
                 for (int k = 0; k < l; ++k)
-                    R(ridx, cidx) += A(ridx, k) * B(k, cidx);
+                    sum += A(ridx, k) * B(k, cidx);
+                C(ridx, cidx) = (0 == beta) ? alpha * sum : alpha * sum + beta * C(ridx, cidx);
             }
 
         return true;
     }
 
     //! @brief 矩阵的乘法 Re = AB
-    template <typename MatrixA, typename MatrixB, bool AIsMatrix = MatrixA::IsMatrix, bool BIsMatrix = MatrixB::IsMatrix>
-    DMatrix<typename MatrixA::Scalar>
-    operator * (MatrixA const & A, MatrixB const & B)
+    //!
+    //! 适用于 MatrixView, Matrix
+    //! R 不能与 A, B 共享存储。
+    //!
+    //! @param [in] A 矩阵 A
+    //! @param [in] B 矩阵 B
+    //! @param [out] R R = AB
+    //!
+    //! @return 矩阵尺寸是否合法
+    template <typename MatrixA, typename MatrixB, typename MatrixRe>
+    bool Multiply(MatrixA const & A, MatrixB const & B, MatrixRe & R)
     {
-        DMatrix<typename MatrixA::Scalar> re(A.Rows(), B.Cols());
-        bool success = Multiply(A, B, re);
-        assert(success);
-        return re;
+        typedef typename MatrixRe::Scalar Scalar;
+        return Gemm(Scalar(1), A, B, Scalar(0), R);
+    }
+
+    //! @brief 矩阵的乘法 Re = AB, 返回表达式, 赋值时求值
+    template <typename MatrixA, typename MatrixB,
+              bool AIsMatrix = std::decay<MatrixA>::type::IsMatrix,
+              bool BIsMatrix = std::decay<MatrixB>::type::IsMatrix>
+    ProductExpr<MatrixA, MatrixB>
+    operator * (MatrixA && A, MatrixB && B)
+    {
+        return ProductExpr<MatrixA, MatrixB>(std::forward<MatrixA>(A), std::forward<MatrixB>(B));
     }
 
 }
@@ -320,6 +487,19 @@ namespace xiaotu {
         if (A.Cols() != R.Cols() || A.Rows() != R.Rows())
             return false;
 
+        if constexpr (SimdDispatchable<MatrixRe, MatrixA>::value) {
+            int num = R.NumDatas();
+            if (num >= SimdMinSize) {
+                typename SimdDispatchable<MatrixRe, MatrixA>::Scalar ra = a;
+                auto pa = A.StorBegin();
+                auto pr = R.StorBegin();
+                ForEachChunk(num, [&](int begin, int end) {
+                    SimdScale(end - begin, ra, pa + begin, pr + begin);
+                });
+                return true;
+            }
+        }
+
         int m = R.Rows();
         int n = R.Cols();
         for (int ridx = 0; ridx < m; ++ridx)
@@ -329,15 +509,12 @@ namespace xiaotu {
         return true;
     }
 
-    //! @brief 矩阵的数乘 Re = aA
-    template <typename Matrix>
-    DMatrix<typename Matrix::Scalar>
-    operator * (typename Matrix::Scalar const & a, Matrix const & A)
+    //! @brief 矩阵的数乘 Re = aA, 返回表达式, 赋值时求值
+    template <typename Matrix, bool MIsMatrix = std::decay<Matrix>::type::IsMatrix>
+    ScalarMultipleExpr<Matrix>
+    operator * (typename std::decay<Matrix>::type::Scalar const & a, Matrix && A)
     {
-        DMatrix<typename Matrix::Scalar> re(A.Rows(), A.Cols());
-        bool success = ScalarMultiply(a, A, re);
-        assert(success);
-        return re;
+        return ScalarMultipleExpr<Matrix>(a, std::forward<Matrix>(A));
     }
 
     //! @brief 矩阵的数乘 A *= a
@@ -349,24 +526,21 @@ namespace xiaotu {
         return A;
     }
 
-    //! @brief 矩阵的数乘 Re = aA
-    template <typename Matrix>
-    DMatrix<typename Matrix::Scalar>
-    operator * (Matrix const & A, typename Matrix::Scalar const & a)
+    //! @brief 矩阵的数乘 Re = aA, 返回表达式, 赋值时求值
+    template <typename Matrix, bool MIsMatrix = std::decay<Matrix>::type::IsMatrix>
+    ScalarMultipleExpr<Matrix>
+    operator * (Matrix && A, typename std::decay<Matrix>::type::Scalar const & a)
     {
-        DMatrix<typename Matrix::Scalar> re(A.Rows(), A.Cols());
-        bool success = ScalarMultiply(a, A, re);
-        assert(success);
-        return re;
+        return ScalarMultipleExpr<Matrix>(a, std::forward<Matrix>(A));
     }
 
-    //! @brief 矩阵的数除 Re = A / a
-    template <typename Matrix>
-    DMatrix<typename Matrix::Scalar>
-    operator / (Matrix const & A, typename Matrix::Scalar const & a)
+    //! @brief 矩阵的数除 Re = A / a, 返回表达式, 赋值时求值
+    template <typename Matrix, bool MIsMatrix = std::decay<Matrix>::type::IsMatrix>
+    ScalarMultipleExpr<Matrix>
+    operator / (Matrix && A, typename std::decay<Matrix>::type::Scalar const & a)
     {
         auto a_inv = 1 / a;
-        return A * a_inv;
+        return ScalarMultipleExpr<Matrix>(a_inv, std::forward<Matrix>(A));
     }
 }
 
@@ -387,10 +561,15 @@ namespace xiaotu {
     template <typename MatrixA, typename MatrixB, typename MatrixRe>
     bool PointwiseMultiply(MatrixA const & A, MatrixB const & B, MatrixRe & R)
     {
-        if (A.Cols() != B.Rows() || R.Rows() != A.Rows() || R.Cols() != B.Cols())
+        if (A.Cols() != B.Cols() || A.Rows() != B.Rows() ||
+            R.Cols() != B.Cols() || R.Rows() != B.Rows())
             return false;
 
-        int l = A.Cols();
+        if constexpr (SimdDispatchable<MatrixRe, MatrixA, MatrixB>::value) {
+            if (SimdCwise<SimdMultiply>(A, B, R))
+                return true;
+        }
+
         int m = R.Rows();
         int n = R.Cols();
         for (int ridx = 0; ridx < m; ++ridx)
@@ -410,10 +589,15 @@ namespace xiaotu {
     template <typename MatrixA, typename MatrixB, typename MatrixRe>
     bool PointwiseDivision(MatrixA const & A, MatrixB const & B, MatrixRe & R)
     {
-        if (A.Cols() != B.Rows() || R.Rows() != A.Rows() || R.Cols() != B.Cols())
+        if (A.Cols() != B.Cols() || A.Rows() != B.Rows() ||
+            R.Cols() != B.Cols() || R.Rows() != B.Rows())
             return false;
 
-        int l = A.Cols();
+        if constexpr (SimdDispatchable<MatrixRe, MatrixA, MatrixB>::value) {
+            if (SimdCwise<SimdDivide>(A, B, R))
+                return true;
+        }
+
         int m = R.Rows();
         int n = R.Cols();
         for (int ridx = 0; ridx < m; ++ridx)
@@ -615,6 +799,86 @@ namespace xiaotu {
         H = DMatrix<Scalar>::Eye(H.Rows(), H.Cols()) - 2 / v_norm * vTv;
     }
 
+    //! @brief 原位生成 Householder 反射, 使得 (I - tau v v^T) x = alpha e_0
+    //!
+    //! 与 HouseholderVector 相同, alpha = -sign(x_0) |x|, 只是不构造 Householder 矩阵,
+    //! x 直接改写为 alpha e_0, 配合 HouseholderLeftApply 和 HouseholderRightApply 使用,
+    //! 整个过程没有临时矩阵。
+    //!
+    //! @param [in|out] x 目标向量, 行向量或者列向量
+    //! @param [out] v Householder 向量, 长度与 x 相同, v(0) = 1
+    //! @return tau, x 为 0 时返回 0
+    template <typename VectorX, typename Scalar>
+    Scalar HouseholderReflect(VectorX && x, Scalar * v)
+    {
+        int n = x.NumDatas();
+        Scalar sigma = 0;
+        for (int i = 1; i < n; ++i) {
+            v[i] = x(i);
+            sigma += v[i] * v[i];
+        }
+        Scalar x0 = x(0);
+        Scalar x_norm = std::sqrt(x0 * x0 + sigma);
+        v[0] = 1;
+        if (0 == x_norm)
+            return 0;
+
+        Scalar alpha = -std::copysign(x_norm, x0);
+        Scalar v0 = x0 - alpha;
+        Scalar v0_inv = 1 / v0;
+        for (int i = 1; i < n; ++i)
+            v[i] *= v0_inv;
+
+        x(0) = alpha;
+        for (int i = 1; i < n; ++i)
+            x(i) = 0;
+        return 2 * v0 * v0 / (v0 * v0 + sigma);
+    }
+
+    //! @brief 左乘反射 C = (I - tau v v^T) C
+    //!
+    //! @param [in] v Householder 向量, 长度为 C 的行数
+    //! @param [in] tau 反射系数
+    //! @param [in|out] C 目标矩阵
+    template <typename Scalar, typename MatrixC>
+    void HouseholderLeftApply(Scalar const * v, Scalar tau, MatrixC && C)
+    {
+        if (0 == tau)
+            return;
+        int m = C.Rows();
+        int n = C.Cols();
+        for (int c = 0; c < n; ++c) {
+            Scalar w = 0;
+            for (int r = 0; r < m; ++r)
+                w += v[r] * C(r, c);
+            w *= tau;
+            for (int r = 0; r < m; ++r)
+                C(r, c) -= w * v[r];
+        }
+    }
+
+    //! @brief 右乘反射 C = C (I - tau v v^T)
+    //!
+    //! @param [in] v Householder 向量, 长度为 C 的列数
+    //! @param [in] tau 反射系数
+    //! @param [in|out] C 目标矩阵
+    template <typename Scalar, typename MatrixC>
+    void HouseholderRightApply(Scalar const * v, Scalar tau, MatrixC && C)
+    {
+        if (0 == tau)
+            return;
+        int m = C.Rows();
+        int n = C.Cols();
+        for (int r = 0; r < m; ++r) {
+            Scalar w = 0;
+            for (int c = 0; c < n; ++c)
+                w += C(r, c) * v[c];
+            w *= tau;
+            for (int c = 0; c < n; ++c)
+                C(r, c) -= w * v[c];
+        }
+    }
+
 
 }
 
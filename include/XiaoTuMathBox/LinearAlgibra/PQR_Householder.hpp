@@ -1,15 +1,27 @@
 #ifndef XTMB_LA_PQR_HOUSEHOLDER_H
 #define XTMB_LA_PQR_HOUSEHOLDER_H
 
+#include <XiaoTuMathBox/LinearAlgibra/Householder.hpp>
+
+#include <type_traits>
+#include <vector>
+
 namespace xiaotu {
 
     //! @brief 基于 Householder 的列主元 QR 分解 AP = QR
     //!
     //! 将输入的矩阵，分解为一个正交矩阵 Q 和一个上三角矩阵 R
+    //!
+    //! 与 QR_Householder 一样, 分解结果紧凑地保存在 mQR 中, Q 只在访问时才构造。
+    //! 每一步都要根据剩余列的范数选主元, 所以分解本身不能分块,
+    //! 分解完成后再计算各块的紧凑 WY 形式, 之后以分块的方式作用 Q。
     template <typename MatViewIn>
     class PQR_Householder {
         public:
-            typedef typename MatViewIn::Scalar Scalar;
+            typedef typename std::remove_const<typename MatViewIn::Scalar>::type Scalar;
+
+            //! @brief 分块大小, 即作用 Q 时每次以 WY 形式合并的反射数量
+            constexpr static int BlockSize = 32;
 
             /**
              * @brief 默认构造函数
@@ -19,38 +31,58 @@ namespace xiaotu {
 
             /**
              * @brief 构造函数
-             * 
+             *
              * @param [in] a 待分解矩阵
              */
             PQR_Householder(MatViewIn const & a)
-                : mQ(a.Rows(), a.Rows()), mR(a.Rows(), a.Cols())
             {
-                mQ.Identity();
-                mR = a;
-                mP.Resize(a.Cols());
-                __Decompose__();
+                Decompose(a);
             }
 
             /**
              * @brief 执行 QR 分解
-             * 
+             *
              * 针对 QR 迭代的优化, 减少迭代过程中重新申请内存的次数
-             * 
+             *
              * @param [in] a 待分解矩阵
              */
             void Decompose(MatViewIn const & a)
             {
-                if (mR.Rows() != a.Rows() || mR.Cols() != a.Cols()) {
-                    mQ.Resize(a.Rows(), a.Rows());
-                    mR.Resize(a.Rows(), a.Cols());
-                }
+                int m = a.Rows();
+                int n = a.Cols();
+                if (mQR.Rows() != m || mQR.Cols() != n)
+                    mQR.Resize(m, n);
+                mQR = a;
+                mP.Resize(n);
+                mTau.resize(std::min(m, n));
+                mT.resize(BlockSize * mTau.size());
 
-                mQ.Identity();
-                mR = a;
-                mP.Resize(a.Cols());
                 __Decompose__();
+                mQValid = false;
+                mRValid = false;
             }
 
+            /**
+             * @brief 计算 M = QM
+             *
+             * @param [in|out] M 目标矩阵, 行数与待分解矩阵一致
+             */
+            template <typename Mat>
+            void ApplyQ(Mat & M) const
+            {
+                Apply(M, false);
+            }
+
+            /**
+             * @brief 计算 M = Q^T M
+             *
+             * @param [in|out] M 目标矩阵, 行数与待分解矩阵一致
+             */
+            template <typename Mat>
+            void ApplyQT(Mat & M) const
+            {
+                Apply(M, true);
+            }
 
         private:
 
@@ -59,78 +91,158 @@ namespace xiaotu {
              */
             void __Decompose__()
             {
-                int m = mR.Rows();
-                int n = mR.Cols();
-                
-                for (int k = 0; k < (m - 1); k++) {
-                    auto A_k = mR.SubMatrix(k, k, m - k, n - k);
-                    SwapColPivot(k, A_k);
-                    auto a_1 = A_k.Col(0);
-
-                    auto H = DMatrix<Scalar>::Eye(m, m);
-                    auto H_k = H.SubMatrix(k, k, m - k, m - k);
-                    auto v = HouseholderVector(a_1);
-                    HouseholderMatrix(v, H_k);
-
-                    A_k = H_k * A_k;
-                    mQ = mQ * H;
+                int m = mQR.Rows();
+                int n = mQR.Cols();
+                int k = mTau.size();
+                Scalar * A = mQR.StorBegin();
+                int rs = mQR.RowStride();
+                int cs = mQR.ColStride();
+
+                for (int j = 0; j < k; j++) {
+                    SwapColPivot(j);
+                    Scalar * a = A + j * rs + j * cs;
+                    mTau[j] = HouseholderGenerate(m - j, a, rs);
+                    if (j + 1 < n)
+                        HouseholderApply(m - j, n - j - 1, a, rs, mTau[j], a + cs, rs, cs);
+                }
+
+                for (int j = 0; j < k; j += BlockSize) {
+                    int jb = std::min(BlockSize, k - j);
+                    HouseholderBlockT(m - j, jb, A + j * rs + j * cs, rs, cs,
+                                      mTau.data() + j, mT.data() + j * BlockSize, BlockSize);
                 }
-                
-                FixDiag();
             }
 
             /**
              * @brief 计算列主元并交换
+             *
+             * 在第 k 列及其右侧各列中, 选取第 k 行以下部分范数最大的一列交换到第 k 列
              */
-            void SwapColPivot(int k, MatrixSubView<DMatrix<Scalar>> & sub)
+            void SwapColPivot(int k)
             {
-                int max_idx = 0;
-                Scalar max = sub.Col(0).InftyNorm();
+                int m = mQR.Rows();
+                int n = mQR.Cols();
+                auto sub = mQR.SubMatrix(k, k, m - k, n - k);
 
-                int n = sub.Cols();
-                for (int i = 1; i < n; i++) {
-                    Scalar norm = sub.Col(i).InftyNorm();
+                int max_idx = 0;
+                Scalar max = sub.Col(0).SquaredNorm();
+                for (int i = 1; i < n - k; i++) {
+                    Scalar norm = sub.Col(i).SquaredNorm();
                     if (norm > max) {
                         max_idx = i;
                         max = norm;
                     }
                 }
 
-                mP.Swap(k, max_idx);
-                mR.ColSwap(k, max_idx);
+                if (0 != max_idx) {
+                    mP.Swap(k, k + max_idx);
+                    mQR.ColSwap(k, k + max_idx);
+                }
+            }
+
+            template <typename Mat>
+            void Apply(Mat & M, bool trans) const
+            {
+                assert(M.Rows() == mQR.Rows());
+                typedef typename Mat::Scalar MScalar;
+                if constexpr (Mat::IsStrided && std::is_same<MScalar, Scalar>::value) {
+                    HouseholderApplyQ(mQR.Rows(), M.Cols(), (int)mTau.size(),
+                                      mQR.StorBegin(), mQR.RowStride(), mQR.ColStride(),
+                                      mT.data(), BlockSize, trans,
+                                      M.StorBegin(), M.RowStride(), M.ColStride());
+                } else {
+                    // 代理存储的矩阵先拷贝出来
+                    DMatrix<Scalar> tmp = M;
+                    Apply(tmp, trans);
+                    M = tmp;
+                }
+            }
+
+        public:
+            //! @brief 正交矩阵 Q, m x m
+            DMatrix<Scalar> const & Q()
+            {
+                if (!mQValid) {
+                    mQ.Resize(mQR.Rows(), mQR.Rows()).Identity();
+                    ApplyQ(mQ);
+                    mQValid = true;
+                }
+                return mQ;
+            }
+
+            //! @brief 上三角矩阵 R, m x n, 对角元素非负且绝对值递减
+            DMatrix<Scalar> const & R()
+            {
+                if (!mRValid) {
+                    int m = mQR.Rows();
+                    int n = mQR.Cols();
+                    mR.Resize(m, n);
+                    for (int c = 0; c < n; c++)
+                        for (int r = 0; r < m; r++)
+                            mR(r, c) = (r <= c) ? mQR(r, c) : Scalar(0);
+                    mRValid = true;
+                }
+                return mR;
+            }
+
+            Permutation const & P() const { return mP; }
+
+            //! @brief 瘦 QR 分解中的 Q, 即 Q 的前 min(m, n) 列
+            DMatrix<Scalar> ThinQ() const
+            {
+                int m = mQR.Rows();
+                int k = mTau.size();
+                DMatrix<Scalar> re(m, k);
+                re.Zeroing();
+                for (int i = 0; i < k; i++)
+                    re(i, i) = 1;
+                ApplyQ(re);
+                return re;
             }
 
             /**
-             * @brief 修正对角元素，保证它们为正数
+             * @brief 求解最小二乘问题 min ||Ax - b||
+             *
+             * 先回代求解 R y = (Q^T b)(0:n), 再还原列交换 x = P y, 要求 m >= n 且 A 列满秩
              *
-             * 为了保证 QR 分解唯一，添加约束 R 的对角元素都是正数
-             * https://gaoyichao.com/Xiaotu/?book=algebra&title=QR算法的收敛原理
+             * @param [in] b 右侧的向量们, m x p
+             * @param [out] x 解, n x p
+             * @return A 列秩亏时返回 false
              */
-            void FixDiag()
+            template <typename MatB, typename MatX>
+            bool SolveLeastSquares(MatB const & b, MatX & x) const
             {
-                int rows = mR.Rows();
-                int cols = mR.Cols();
-                int n = cols < rows ? cols : rows;
-
-                for (int i = 0; i < n; i++) {
-                    if (mR(i, i) < 0) {
-                        auto r = mR.Row(i);
-                        r *= -1.0;
-                        auto q = mQ.Col(i);
-                        q *= -1.0;
-                    }
-                }
+                int m = mQR.Rows();
+                int n = mQR.Cols();
+                assert(m >= n && b.Rows() == m);
+                assert(x.Rows() == n && x.Cols() == b.Cols());
+
+                DMatrix<Scalar> c = b;
+                ApplyQT(c);
+                DMatrix<Scalar> y = c.SubMatrix(0, 0, n, c.Cols());
+                if (!BackSubstitute(mQR, y))
+                    return false;
+                mP.Transpose().LeftApplyOn(y);
+                x = y;
+                return true;
             }
 
-        public:
-            DMatrix<Scalar> const & Q() { return mQ; }
-            DMatrix<Scalar> const & R() { return mR; }
-            Permutation const & P() { return mP; }
+            //! @brief 紧凑保存的分解结果, 上三角为 R, 严格下三角为 Householder 向量
+            DMatrix<Scalar> const & Factors() const { return mQR; }
+            //! @brief 各个 Householder 反射的系数
+            std::vector<Scalar> const & Tau() const { return mTau; }
 
         private:
+            DMatrix<Scalar> mQR;
+            std::vector<Scalar> mTau;
+            //! @brief 各块紧凑 WY 形式中的上三角矩阵
+            std::vector<Scalar> mT;
+            Permutation mP;
+
             DMatrix<Scalar> mQ;
             DMatrix<Scalar> mR;
-            Permutation mP;
+            bool mQValid = false;
+            bool mRValid = false;
     };
 
 }
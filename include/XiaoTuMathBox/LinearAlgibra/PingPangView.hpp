@@ -16,7 +16,7 @@ namespace xiaotu {
     class PingPangView
     {
         public:
-            typedef MatrixSubView<Mat> SubView;
+            typedef typename Mat::SubView SubView;
 
             /**
              * @brief 默认构造函数
@@ -1,15 +1,22 @@
 #ifndef XTMB_LA_QR_GIVENS_H
 #define XTMB_LA_QR_GIVENS_H
 
+#include <type_traits>
+#include <vector>
+
 namespace xiaotu {
 
     //! @brief 基于 Givens 的 QR 分解
     //!
     //! 将输入的矩阵，分解为一个正交矩阵 Q 和一个上三角矩阵 R
+    //!
+    //! 分解过程只记录各个 Givens 旋转和修正对角元素时的符号翻转, Q 在第一次访问时才构造,
+    //! 也可以通过 ApplyQ/ApplyQT 隐式地作用到其它矩阵上。
+    //! 记 G = G_N ... G_1, D 为符号翻转的对角矩阵, 则 R = D G A, Q = G^T D。
     template <typename MatViewIn>
     class QR_Givens {
         public:
-            typedef typename MatViewIn::Scalar Scalar;
+            typedef typename std::remove_const<typename MatViewIn::Scalar>::type Scalar;
 
             /**
              * @brief 默认构造函数
@@ -23,11 +30,8 @@ namespace xiaotu {
              * @param [in] a 待分解矩阵
              */
             QR_Givens(MatViewIn const & a)
-                : mQ(a.Rows(), a.Rows()), mR(a.Rows(), a.Cols())
             {
-                mQ.Identity();
-                mR = a;
-                __Decompose__();
+                Decompose(a);
             }
 
             /**
@@ -39,13 +43,7 @@ namespace xiaotu {
              */
             void Decompose(MatViewIn const & a)
             {
-                if (mR.Rows() != a.Rows() || mR.Cols() != a.Cols()) {
-                    mQ.Resize(a.Rows(), a.Rows());
-                    mR.Resize(a.Rows(), a.Cols());
-                }
-
-                mQ.Identity();
-                mR = a;
+                Prepare(a);
                 __Decompose__();
             }
 
@@ -54,19 +52,50 @@ namespace xiaotu {
              */
             void DecomposeHessenberg(MatViewIn const & a)
             {
-                if (mR.Rows() != a.Rows() || mR.Cols() != a.Cols()) {
-                    mQ.Resize(a.Rows(), a.Rows());
-                    mR.Resize(a.Rows(), a.Cols());
-                }
-
-                mQ.Identity();
-                mR = a;
+                Prepare(a);
                 __DecomposeHessenberg__();
+            }
+
+            /**
+             * @brief 计算 M = QM
+             *
+             * @param [in|out] M 目标矩阵, 行数与待分解矩阵一致
+             */
+            template <typename Mat>
+            void ApplyQ(Mat & M) const
+            {
+                assert(M.Rows() == mR.Rows());
+                FlipRows(M);
+                for (int i = (int)mGivens.size() - 1; i >= 0; i--)
+                    mGivens[i].TLeftApplyOn(M);
+            }
 
+            /**
+             * @brief 计算 M = Q^T M
+             *
+             * @param [in|out] M 目标矩阵, 行数与待分解矩阵一致
+             */
+            template <typename Mat>
+            void ApplyQT(Mat & M) const
+            {
+                assert(M.Rows() == mR.Rows());
+                for (auto const & G : mGivens)
+                    G.LeftApplyOn(M);
+                FlipRows(M);
             }
 
         private:
 
+            void Prepare(MatViewIn const & a)
+            {
+                if (mR.Rows() != a.Rows() || mR.Cols() != a.Cols())
+                    mR.Resize(a.Rows(), a.Cols());
+                mR = a;
+                mGivens.clear();
+                mFlip.clear();
+                mQValid = false;
+            }
+
             /**
              * @brief 具体的分解实现
              */
@@ -81,7 +110,7 @@ namespace xiaotu {
                             continue;
                         Givens<Scalar> G(cidx, ridx, mR(cidx, cidx), mR(ridx, cidx));
                         G.LeftApplyOn(mR);
-                        G.TRightApplyOn(mQ);
+                        mGivens.push_back(G);
                     }
                 }
                 
@@ -93,7 +122,6 @@ namespace xiaotu {
              */
             void __DecomposeHessenberg__()
             {
-                int rows = mR.Rows();
                 int cols = mR.Cols() - 1;
                 
                 for (int cidx = 0; cidx < cols; cidx++) {
@@ -102,7 +130,7 @@ namespace xiaotu {
                         continue;
                     Givens<Scalar> G(cidx, ridx, mR(cidx, cidx), mR(ridx, cidx));
                     G.LeftApplyOn(mR);
-                    G.TRightApplyOn(mQ);
+                    mGivens.push_back(G);
                 }
                 
                 FixDiag();
@@ -125,20 +153,80 @@ namespace xiaotu {
                     if (mR(i, i) < 0) {
                         auto r = mR.Row(i);
                         r *= -1.0;
-                        auto q = mQ.Col(i);
-                        q *= -1.0;
+                        mFlip.push_back(i);
                     }
                 }
             }
 
+            //! @brief M = D M, 翻转 FixDiag 修正过的行
+            template <typename Mat>
+            void FlipRows(Mat & M) const
+            {
+                int cols = M.Cols();
+                for (int i : mFlip)
+                    for (int c = 0; c < cols; c++)
+                        M(i, c) = -M(i, c);
+            }
+
         public:
-            DMatrix<Scalar> const & Q() { return mQ; }
+            //! @brief 正交矩阵 Q, m x m
+            DMatrix<Scalar> const & Q()
+            {
+                if (!mQValid) {
+                    mQ.Resize(mR.Rows(), mR.Rows()).Identity();
+                    ApplyQ(mQ);
+                    mQValid = true;
+                }
+                return mQ;
+            }
+
             DMatrix<Scalar> const & R() { return mR; }
 
+            //! @brief 瘦 QR 分解中的 Q, 即 Q 的前 min(m, n) 列
+            DMatrix<Scalar> ThinQ() const
+            {
+                int m = mR.Rows();
+                int k = std::min(m, mR.Cols());
+                DMatrix<Scalar> re(m, k);
+                re.Zeroing();
+                for (int i = 0; i < k; i++)
+                    re(i, i) = 1;
+                ApplyQ(re);
+                return re;
+            }
+
+            /**
+             * @brief 求解最小二乘问题 min ||Ax - b||
+             *
+             * 只需要对 b 作用各个旋转得到 Q^T b, 再回代求解 R x = (Q^T b)(0:n), 要求 m >= n 且 A 列满秩
+             *
+             * @param [in] b 右侧的向量们, m x p
+             * @param [out] x 解, n x p
+             * @return A 列秩亏时返回 false
+             */
+            template <typename MatB, typename MatX>
+            bool SolveLeastSquares(MatB const & b, MatX & x) const
+            {
+                int m = mR.Rows();
+                int n = mR.Cols();
+                assert(m >= n && b.Rows() == m);
+                assert(x.Rows() == n && x.Cols() == b.Cols());
+
+                DMatrix<Scalar> c = b;
+                ApplyQT(c);
+                x = c.SubMatrix(0, 0, n, c.Cols());
+                return BackSubstitute(mR, x);
+            }
+
         private:
-            DMatrix<Scalar> mQ;
             DMatrix<Scalar> mR;
+            //! @brief 按作用顺序记录的 Givens 旋转
+            std::vector<Givens<Scalar>> mGivens;
+            //! @brief FixDiag 中翻转了符号的行
+            std::vector<int> mFlip;
 
+            DMatrix<Scalar> mQ;
+            bool mQValid = false;
     };
 }
 
@@ -1,15 +1,28 @@
 #ifndef XTMB_LA_QR_HOUSEHOLDER_H
 #define XTMB_LA_QR_HOUSEHOLDER_H
 
+#include <XiaoTuMathBox/LinearAlgibra/Householder.hpp>
+
+#include <type_traits>
+#include <vector>
+
 namespace xiaotu {
 
     //! @brief 基于 Householder 的 QR 分解
     //!
     //! 将输入的矩阵，分解为一个正交矩阵 Q 和一个上三角矩阵 R
+    //!
+    //! 分解采用分块的紧凑 WY 形式, 反射不再展开成 m x m 的矩阵。
+    //! 分解结果紧凑地保存在 mQR 中: 上三角为 R, 严格下三角为 Householder 向量。
+    //! Q 和 R 在第一次访问时才构造, 也可以通过 ApplyQ/ApplyQT 隐式地作用到其它矩阵上,
+    //! 求解最小二乘问题时不必构造 m x m 的 Q。
     template <typename MatViewIn>
     class QR_Householder {
         public:
-            typedef typename MatViewIn::Scalar Scalar;
+            typedef typename std::remove_const<typename MatViewIn::Scalar>::type Scalar;
+
+            //! @brief 分块大小, 即每次以 WY 形式合并的反射数量
+            constexpr static int BlockSize = 32;
 
             /**
              * @brief 默认构造函数
@@ -19,95 +32,158 @@ namespace xiaotu {
 
             /**
              * @brief 构造函数
-             * 
+             *
              * @param [in] a 待分解矩阵
              */
             QR_Householder(MatViewIn const & a)
-                : mQ(a.Rows(), a.Rows()), mR(a.Rows(), a.Cols())
             {
-                mQ.Identity();
-                mR = a;
-                __Decompose__();
+                Decompose(a);
             }
 
             /**
              * @brief 执行 QR 分解
-             * 
+             *
              * 针对 QR 迭代的优化, 减少迭代过程中重新申请内存的次数
-             * 
+             *
              * @param [in] a 待分解矩阵
              */
             void Decompose(MatViewIn const & a)
             {
-                if (mR.Rows() != a.Rows() || mR.Cols() != a.Cols()) {
-                    mQ.Resize(a.Rows(), a.Rows());
-                    mR.Resize(a.Rows(), a.Cols());
-                }
-
-                mQ.Identity();
-                mR = a;
-                __Decompose__();
+                int m = a.Rows();
+                int n = a.Cols();
+                if (mQR.Rows() != m || mQR.Cols() != n)
+                    mQR.Resize(m, n);
+                mQR = a;
+                mTau.resize(std::min(m, n));
+                mT.resize(BlockSize * mTau.size());
+
+                HouseholderQR(m, n, mQR.StorBegin(), mQR.RowStride(), mQR.ColStride(),
+                              mTau.data(), mT.data(), BlockSize);
+                mQValid = false;
+                mRValid = false;
             }
 
-        private:
+            /**
+             * @brief 计算 M = QM
+             *
+             * @param [in|out] M 目标矩阵, 行数与待分解矩阵一致
+             */
+            template <typename Mat>
+            void ApplyQ(Mat & M) const
+            {
+                Apply(M, false);
+            }
 
             /**
-             * @brief 具体的分解实现
+             * @brief 计算 M = Q^T M
+             *
+             * @param [in|out] M 目标矩阵, 行数与待分解矩阵一致
              */
-            void __Decompose__()
+            template <typename Mat>
+            void ApplyQT(Mat & M) const
             {
-                int m = mR.Rows();
-                int n = mR.Cols();
-                
-                for (int k = 0; k < (m - 1); k++) {
-                    auto A_k = mR.SubMatrix(k, k, m - k, n - k);
-                    auto a_1 = A_k.Col(0);
+                Apply(M, true);
+            }
 
-                    auto H = DMatrix<Scalar>::Eye(m, m);
-                    auto H_k = H.SubMatrix(k, k, m - k, m - k);
+        private:
+            template <typename Mat>
+            void Apply(Mat & M, bool trans) const
+            {
+                assert(M.Rows() == mQR.Rows());
+                typedef typename Mat::Scalar MScalar;
+                if constexpr (Mat::IsStrided && std::is_same<MScalar, Scalar>::value) {
+                    HouseholderApplyQ(mQR.Rows(), M.Cols(), (int)mTau.size(),
+                                      mQR.StorBegin(), mQR.RowStride(), mQR.ColStride(),
+                                      mT.data(), BlockSize, trans,
+                                      M.StorBegin(), M.RowStride(), M.ColStride());
+                } else {
+                    // 代理存储的矩阵先拷贝出来
+                    DMatrix<Scalar> tmp = M;
+                    Apply(tmp, trans);
+                    M = tmp;
+                }
+            }
 
-                    auto v = HouseholderVector(a_1);
-                    HouseholderMatrix(v, H_k);
+        public:
+            //! @brief 正交矩阵 Q, m x m
+            DMatrix<Scalar> const & Q()
+            {
+                if (!mQValid) {
+                    mQ.Resize(mQR.Rows(), mQR.Rows()).Identity();
+                    ApplyQ(mQ);
+                    mQValid = true;
+                }
+                return mQ;
+            }
 
-                    A_k = H_k * A_k;
-                    mQ = mQ * H;
+            //! @brief 上三角矩阵 R, m x n, 对角元素非负
+            DMatrix<Scalar> const & R()
+            {
+                if (!mRValid) {
+                    int m = mQR.Rows();
+                    int n = mQR.Cols();
+                    mR.Resize(m, n);
+                    for (int c = 0; c < n; c++)
+                        for (int r = 0; r < m; r++)
+                            mR(r, c) = (r <= c) ? mQR(r, c) : Scalar(0);
+                    mRValid = true;
                 }
-                
-                FixDiag();
+                return mR;
+            }
+
+            //! @brief 瘦 QR 分解中的 Q, 即 Q 的前 min(m, n) 列
+            DMatrix<Scalar> ThinQ() const
+            {
+                int m = mQR.Rows();
+                int k = mTau.size();
+                DMatrix<Scalar> re(m, k);
+                re.Zeroing();
+                for (int i = 0; i < k; i++)
+                    re(i, i) = 1;
+                ApplyQ(re);
+                return re;
             }
+
             /**
-             * @brief 修正对角元素，保证它们为正数
+             * @brief 求解最小二乘问题 min ||Ax - b||
              *
-             * 为了保证 QR 分解唯一，添加约束 R 的对角元素都是正数
-             * https://gaoyichao.com/Xiaotu/?book=algebra&title=QR算法的收敛原理
+             * 只需要隐式地计算 Q^T b, 再回代求解 R x = (Q^T b)(0:n), 要求 m >= n 且 A 列满秩
+             *
+             * @param [in] b 右侧的向量们, m x p
+             * @param [out] x 解, n x p
+             * @return A 列秩亏时返回 false
              */
-            void FixDiag()
+            template <typename MatB, typename MatX>
+            bool SolveLeastSquares(MatB const & b, MatX & x) const
             {
-                int rows = mR.Rows();
-                int cols = mR.Cols();
-                int n = cols < rows ? cols : rows;
-
-                for (int i = 0; i < n; i++) {
-                    if (mR(i, i) < 0) {
-                        auto r = mR.Row(i);
-                        r *= -1.0;
-                        auto q = mQ.Col(i);
-                        q *= -1.0;
-                    }
-                }
+                int m = mQR.Rows();
+                int n = mQR.Cols();
+                assert(m >= n && b.Rows() == m);
+                assert(x.Rows() == n && x.Cols() == b.Cols());
+
+                DMatrix<Scalar> c = b;
+                ApplyQT(c);
+                x = c.SubMatrix(0, 0, n, c.Cols());
+                return BackSubstitute(mQR, x);
             }
 
-        public:
-            DMatrix<Scalar> const & Q() { return mQ; }
-            DMatrix<Scalar> const & R() { return mR; }
+            //! @brief 紧凑保存的分解结果, 上三角为 R, 严格下三角为 Householder 向量
+            DMatrix<Scalar> const & Factors() const { return mQR; }
+            //! @brief 各个 Householder 反射的系数
+            std::vector<Scalar> const & Tau() const { return mTau; }
 
         private:
+            DMatrix<Scalar> mQR;
+            std::vector<Scalar> mTau;
+            //! @brief 各块紧凑 WY 形式中的上三角矩阵
+            std::vector<Scalar> mT;
+
             DMatrix<Scalar> mQ;
             DMatrix<Scalar> mR;
-
+            bool mQValid = false;
+            bool mRValid = false;
     };
 }
 
 
 #endif
-
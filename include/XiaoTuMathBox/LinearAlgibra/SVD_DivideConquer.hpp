@@ -0,0 +1,771 @@
+#ifndef XTMB_LA_SVD_DIVIDE_CONQUER_H
+#define XTMB_LA_SVD_DIVIDE_CONQUER_H
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+
+#include <XiaoTuMathBox/LinearAlgibra/Gemm.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 分治法计算上二对角矩阵的 SVD, 参考 LAPACK bdsdc/lasd0
+//
+// 把 n x (n + sqre) 的上二对角矩阵在第 k 行处切开, 上下两块分别递归求解后,
+// 合并问题化为一个箭形矩阵 M = [z^T; 0 diag(d)] 的 SVD。M 的奇异值是久期方程
+// 1 + sum z_i^2 / (d_i^2 - s^2) = 0 的根, 按 Gu & Eisenstat 的方法由求得的根重新计算 z,
+// 保证奇异向量的正交性。子问题的奇异向量与合并问题的奇异向量相乘时都是 Gemm。
+// 同一层的子问题互不相关, 并行求解; 足够小的子问题直接用隐式 QR 迭代。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 上二对角矩阵的隐式 QR 迭代, 带 Wilkinson 偏移, 参考 Numerical Recipes 中的 svdcmp
+    //!
+    //! B = U diag(d) V^T, 旋转累积到 U 和 V 的列上, 对角线上为 0 时先通过旋转把对应的次对角元素消去。
+    //!
+    //! @param [in] n 矩阵尺寸
+    //! @param [in|out] d 对角线, 输出非负的奇异值, 未排序
+    //! @param [in|out] e 次对角线, e[i] = B(i, i+1), n-1 个元素
+    //! @param [in|out] U, ldU 列优先存储的 nu x n 矩阵
+    //! @param [in|out] V, ldV 列优先存储的 nv x n 矩阵
+    //! @param [in] max_iter 每个奇异值的最大迭代次数
+    //! @return 总的迭代次数
+    template <typename Scalar>
+    int BidiagonalSVDQR(int n, Scalar * d, Scalar * e, Scalar * U, int ldU, int nu,
+                        Scalar * V, int ldV, int nv, int max_iter)
+    {
+        if (n <= 0)
+            return 0;
+
+        auto rotate = [](Scalar * x, Scalar * y, int len, Scalar c, Scalar s) {
+            for (int i = 0; i < len; ++i) {
+                Scalar a = x[i], b = y[i];
+                x[i] = a * c + b * s;
+                y[i] = b * c - a * s;
+            }
+        };
+
+        // f[i] = B(i-1, i), f[0] = 0
+        WorkspaceFrame frame;
+        Scalar * f = frame.Alloc<Scalar>(n);
+        f[0] = 0;
+        for (int i = 1; i < n; ++i)
+            f[i] = e[i - 1];
+
+        constexpr Scalar eps = std::numeric_limits<Scalar>::epsilon();
+        Scalar anorm = 0;
+        for (int i = 0; i < n; ++i)
+            anorm = std::max(anorm, std::abs(d[i]) + std::abs(f[i]));
+
+        int total = 0;
+        for (int k = n - 1; k >= 0; --k) {
+            for (int iter = 0; ; ++iter) {
+                // 寻找可以分裂的位置 l, f[l] 可以忽略, 或者 d[l-1] 为 0
+                bool cancel = true;
+                int l = k;
+                for (; l >= 0; --l) {
+                    if (0 == l || std::abs(f[l]) <= eps * anorm) {
+                        cancel = false;
+                        break;
+                    }
+                    if (std::abs(d[l - 1]) <= eps * anorm)
+                        break;
+                }
+
+                if (cancel) {
+                    // d[l-1] 为 0, 从左侧旋转把 f[l..k] 依次消去
+                    Scalar c = 0, s = 1;
+                    int nm = l - 1;
+                    for (int i = l; i <= k; ++i) {
+                        Scalar g = s * f[i];
+                        f[i] = c * f[i];
+                        if (std::abs(g) <= eps * anorm)
+                            break;
+                        Scalar h = std::hypot(g, d[i]);
+                        c = d[i] / h;
+                        s = -g / h;
+                        d[i] = h;
+                        rotate(U + nm * ldU, U + i * ldU, nu, c, s);
+                    }
+                }
+
+                Scalar z = d[k];
+                if (l == k) {
+                    if (z < 0) {
+                        d[k] = -z;
+                        for (int i = 0; i < nv; ++i)
+                            V[i + k * ldV] = -V[i + k * ldV];
+                    }
+                    break;
+                }
+                if (iter == max_iter)
+                    throw std::runtime_error("迭代不收敛");
+                total++;
+
+                // 右下角 2x2 块的 Wilkinson 偏移
+                Scalar x = d[l];
+                Scalar y = d[k - 1];
+                Scalar g = f[k - 1];
+                Scalar h = f[k];
+                Scalar ff = ((y - z) * (y + z) + (g - h) * (g + h)) / (2 * h * y);
+                g = std::hypot(ff, Scalar(1));
+                ff = ((x - z) * (x + z) + h * ((y / (ff + std::copysign(g, ff))) - h)) / x;
+
+                Scalar c = 1, s = 1;
+                for (int j = l; j < k; ++j) {
+                    int i = j + 1;
+                    g = f[i];
+                    y = d[i];
+                    h = s * g;
+                    g = c * g;
+                    z = std::hypot(ff, h);
+                    f[j] = z;
+                    c = ff / z;
+                    s = h / z;
+                    ff = x * c + g * s;
+                    g = g * c - x * s;
+                    h = y * s;
+                    y *= c;
+                    rotate(V + j * ldV, V + i * ldV, nv, c, s);
+
+                    z = std::hypot(ff, h);
+                    d[j] = z;
+                    if (0 != z) {
+                        c = ff / z;
+                        s = h / z;
+                    }
+                    ff = c * g + s * y;
+                    x = c * y - s * g;
+                    rotate(U + j * ldU, U + i * ldU, nu, c, s);
+                }
+                f[l] = 0;
+                f[k] = ff;
+                d[k] = x;
+            }
+        }
+        return total;
+    }
+
+    //! @brief 求解久期方程 1 + sum z_i^2 / (d_i^2 - s^2) = 0 的第 j 个根, 参考 LAPACK lasd4
+    //!
+    //! 以较近的极点 o 为原点, 求 mu = s^2 - o^2, 这样 d_i^2 - s^2 = (d_i - o)(d_i + o) - mu 没有相消误差。
+    //! 每步把极点两侧的部分分别近似为一个有理函数, 解出二次方程, 越出区间时退化为二分。
+    //!
+    //! @param [in] K 方程阶数
+    //! @param [in] d 升序排列, d[0] = 0, 互不相同
+    //! @param [in] z 各项系数, 都不为 0
+    //! @param [in] zz z 的模的平方
+    //! @param [in] j 第 j 个根, 在 (d_j, d_{j+1}) 中, 最后一个根在 (d_{K-1}, sqrt(d_{K-1}^2 + zz)) 中
+    //! @param [out] diff d_i^2 - s^2, K 个元素
+    //! @return 第 j 个根 s
+    template <typename Scalar>
+    Scalar SecularRoot(int K, Scalar const * d, Scalar const * z, Scalar zz, int j, Scalar * diff)
+    {
+        constexpr Scalar eps = std::numeric_limits<Scalar>::epsilon();
+        bool last = (j + 1 == K);
+
+        Scalar o, lo, hi;
+        if (!last) {
+            // 在区间中点处 f 的符号决定根靠近哪个极点
+            Scalar h = (d[j + 1] - d[j]) * (d[j + 1] + d[j]) / 2;
+            Scalar f = 1;
+            for (int i = 0; i < K; ++i)
+                f += z[i] * z[i] / ((d[i] - d[j]) * (d[i] + d[j]) - h);
+            if (f >= 0) {
+                o = d[j];
+                lo = 0;
+                hi = h;
+            } else {
+                o = d[j + 1];
+                lo = -h;
+                hi = 0;
+            }
+        } else {
+            o = d[j];
+            lo = 0;
+            hi = zz;
+        }
+
+        for (int i = 0; i < K; ++i)
+            diff[i] = (d[i] - o) * (d[i] + o);
+        Scalar pl = diff[j];
+        Scalar pr = last ? Scalar(0) : diff[j + 1];
+
+        Scalar mu = (lo + hi) / 2;
+        for (int iter = 0; iter < 100; ++iter) {
+            Scalar psi = 0, dpsi = 0, phi = 0, dphi = 0;
+            for (int i = 0; i <= j; ++i) {
+                Scalar t = z[i] / (diff[i] - mu);
+                psi += z[i] * t;
+                dpsi += t * t;
+            }
+            for (int i = j + 1; i < K; ++i) {
+                Scalar t = z[i] / (diff[i] - mu);
+                phi += z[i] * t;
+                dphi += t * t;
+            }
+            Scalar f = 1 + psi + phi;
+            if (std::abs(f) <= 8 * eps * K * (1 + std::abs(psi) + std::abs(phi)))
+                break;
+            if (f > 0)
+                hi = mu;
+            else
+                lo = mu;
+
+            // psi ~ c1 + s1 / (pl - x), phi ~ c2 + s2 / (pr - x), 求解 t = x - mu
+            Scalar dl = pl - mu;
+            Scalar s1 = dpsi * dl * dl;
+            Scalar c1 = psi - dpsi * dl;
+            Scalar t = std::numeric_limits<Scalar>::quiet_NaN();
+            if (last) {
+                Scalar C = 1 + c1;
+                if (C > 0)
+                    t = dl + s1 / C;
+            } else {
+                Scalar dr = pr - mu;
+                Scalar s2 = dphi * dr * dr;
+                Scalar c2 = phi - dphi * dr;
+                Scalar C = 1 + c1 + c2;
+                Scalar a = C * (dl + dr) + s1 + s2;
+                Scalar b = C * dl * dr + s1 * dr + s2 * dl;
+                if (0 == C) {
+                    t = b / a;
+                } else {
+                    Scalar disc = std::max(a * a - 4 * C * b, Scalar(0));
+                    Scalar q = (a + std::copysign(std::sqrt(disc), a)) / 2;
+                    if (0 != q) {
+                        t = q / C;
+                        if (!(t > dl && t < dr))
+                            t = b / q;
+                    }
+                }
+            }
+
+            Scalar next = mu + t;
+            if (!(next > lo && next < hi))
+                next = (lo + hi) / 2;
+            if (next == mu || hi - lo <= 2 * eps * std::max(std::abs(lo), std::abs(hi)))
+                break;
+            mu = next;
+        }
+
+        for (int i = 0; i < K; ++i)
+            diff[i] -= mu;
+        return std::sqrt(o * o + mu);
+    }
+
+    //! @brief 箭形矩阵 M = [z^T; 0 diag(d_1, ..., d_{n-1})] 的 SVD, M = U diag(s) V^T, 参考 LAPACK lasd2/lasd3
+    //!
+    //! 先收缩: z_i 可以忽略时 d_i 即为奇异值; d_i 与 d_j 相近时通过两侧的旋转消去 z_j;
+    //! d_i 接近 0 时通过右侧的旋转把 z_i 合并到 z_0 上。剩下的 K 阶问题求解久期方程,
+    //! 再由求得的根重新计算 z, 最后把收缩过程中的旋转作用到奇异向量上。
+    //!
+    //! @param [in] n 矩阵尺寸
+    //! @param [in|out] d d[0] 不读取, 视为 0, 其余非负, 不要求有序
+    //! @param [in|out] z 箭形矩阵的第 0 行
+    //! @param [in] tol 收缩的阈值
+    //! @param [out] s 奇异值, 未排序
+    //! @param [out] U, ldU 列优先存储的 n x n 矩阵
+    //! @param [out] V, ldV 列优先存储的 n x n 矩阵
+    template <typename Scalar>
+    void ArrowSVD(int n, Scalar * d, Scalar * z, Scalar tol, Scalar * s,
+                  Scalar * U, int ldU, Scalar * V, int ldV)
+    {
+        WorkspaceFrame frame;
+        int * idx = frame.Alloc<int>(n);
+        int * kept = frame.Alloc<int>(n);
+        int * defl = frame.Alloc<int>(n);
+        // 收缩旋转 (p, q, c, s): 新的第 p 列 = c p + s q, 新的第 q 列 = -s p + c q
+        int * rp = frame.Alloc<int>(n);
+        int * rq = frame.Alloc<int>(n);
+        bool * rboth = frame.Alloc<bool>(n);
+        Scalar * rc = frame.Alloc<Scalar>(n);
+        Scalar * rs = frame.Alloc<Scalar>(n);
+
+        d[0] = 0;
+        for (int i = 0; i < n; ++i)
+            idx[i] = i;
+        std::sort(idx + 1, idx + n, [d](int a, int b) { return d[a] < d[b]; });
+        if (std::abs(z[0]) <= tol)
+            z[0] = tol;
+
+        int K = 0, nd = 0, nr = 0;
+        kept[K++] = 0;
+        for (int t = 1; t < n; ++t) {
+            int i = idx[t];
+            if (std::abs(z[i]) <= tol) {
+                defl[nd++] = i;
+                continue;
+            }
+
+            int p = kept[K - 1];
+            if (0 == p && d[i] <= tol) {
+                // 奇异值为 0, 右侧旋转把 z_i 合并到 z_0
+                Scalar r = std::hypot(z[0], z[i]);
+                rp[nr] = 0; rq[nr] = i; rboth[nr] = false;
+                rc[nr] = z[0] / r; rs[nr] = z[i] / r;
+                nr++;
+                z[0] = r;
+                z[i] = 0;
+                d[i] = 0;
+                defl[nd++] = i;
+            } else if (0 != p && d[i] - d[p] <= tol) {
+                // d_p 与 d_i 相近, 两侧同时旋转消去 z_p
+                Scalar r = std::hypot(z[p], z[i]);
+                rp[nr] = p; rq[nr] = i; rboth[nr] = true;
+                rc[nr] = z[i] / r; rs[nr] = -z[p] / r;
+                nr++;
+                z[i] = r;
+                z[p] = 0;
+                kept[K - 1] = i;
+                defl[nd++] = p;
+            } else {
+                kept[K++] = i;
+            }
+        }
+
+        // 缩放到 1 附近, 求解 K 阶的久期方程
+        Scalar * dk = frame.Alloc<Scalar>(K);
+        Scalar * zk = frame.Alloc<Scalar>(K);
+        Scalar * sk = frame.Alloc<Scalar>(K);
+        Scalar * zh = frame.Alloc<Scalar>(K);
+        Scalar * Uk = frame.Alloc<Scalar>(K * K);
+        Scalar * Vk = frame.Alloc<Scalar>(K * K);
+        Scalar scale = 0;
+        for (int t = 0; t < K; ++t)
+            scale = std::max({ scale, d[kept[t]], std::abs(z[kept[t]]) });
+        Scalar zz = 0;
+        for (int t = 0; t < K; ++t) {
+            dk[t] = d[kept[t]] / scale;
+            zk[t] = z[kept[t]] / scale;
+            zz += zk[t] * zk[t];
+        }
+        dk[0] = 0;
+
+        // Vk 的第 j 列暂存 d_i^2 - s_j^2
+        ParallelFor(0, K, ParallelGrain(K, 1, 16), [&](int b, int end) {
+            for (int j = b; j < end; ++j)
+                sk[j] = SecularRoot(K, dk, zk, zz, j, Vk + j * K);
+        });
+
+        // Gu & Eisenstat: 由求得的根重新计算 z, 按交错性质成对地计算各个比值, 避免溢出
+        ParallelFor(0, K, ParallelGrain(K, 1, 16), [&](int b, int end) {
+            for (int i = b; i < end; ++i) {
+                Scalar prod = -Vk[i + (K - 1) * K];
+                for (int k = 0; k < i; ++k)
+                    prod *= Vk[i + k * K] / ((dk[i] - dk[k]) * (dk[k] + dk[i]));
+                for (int k = i; k < K - 1; ++k)
+                    prod *= -Vk[i + k * K] / ((dk[k + 1] - dk[i]) * (dk[k + 1] + dk[i]));
+                zh[i] = std::copysign(std::sqrt(std::abs(prod)), zk[i]);
+            }
+        });
+
+        // v_i = z_i / (d_i^2 - s^2), u = (-1, d_i z_i / (d_i^2 - s^2))
+        ParallelFor(0, K, ParallelGrain(K, 1, 16), [&](int b, int end) {
+            for (int j = b; j < end; ++j) {
+                Scalar * u = Uk + j * K;
+                Scalar * v = Vk + j * K;
+                Scalar nu = 0, nv = 0;
+                for (int i = 0; i < K; ++i) {
+                    v[i] = zh[i] / v[i];
+                    u[i] = (0 == i) ? Scalar(-1) : dk[i] * v[i];
+                    nu += u[i] * u[i];
+                    nv += v[i] * v[i];
+                }
+                nu = std::sqrt(nu);
+                nv = std::sqrt(nv);
+                for (int i = 0; i < K; ++i) {
+                    u[i] /= nu;
+                    v[i] /= nv;
+                }
+            }
+        });
+
+        for (int c = 0; c < n; ++c) {
+            std::fill(U + c * ldU, U + c * ldU + n, Scalar(0));
+            std::fill(V + c * ldV, V + c * ldV + n, Scalar(0));
+        }
+        for (int j = 0; j < K; ++j) {
+            s[j] = sk[j] * scale;
+            for (int t = 0; t < K; ++t) {
+                U[kept[t] + j * ldU] = Uk[t + j * K];
+                V[kept[t] + j * ldV] = Vk[t + j * K];
+            }
+        }
+        for (int j = 0; j < nd; ++j) {
+            int i = defl[j];
+            s[K + j] = d[i];
+            U[i + (K + j) * ldU] = 1;
+            V[i + (K + j) * ldV] = 1;
+        }
+
+        // 收缩时的旋转依次右乘, 逆序作用到各行上
+        auto rotate_rows = [n](Scalar * X, int ldX, int p, int q, Scalar c, Scalar s) {
+            for (int j = 0; j < n; ++j) {
+                Scalar a = X[p + j * ldX], b = X[q + j * ldX];
+                X[p + j * ldX] = c * a - s * b;
+                X[q + j * ldX] = s * a + c * b;
+            }
+        };
+        for (int r = nr - 1; r >= 0; --r) {
+            rotate_rows(V, ldV, rp[r], rq[r], rc[r], rs[r]);
+            if (rboth[r])
+                rotate_rows(U, ldU, rp[r], rq[r], rc[r], rs[r]);
+        }
+    }
+
+    //! @brief 分治法计算上二对角矩阵的 SVD, B = U diag(d) V^T
+    //!
+    //! @param [in] n 矩阵尺寸
+    //! @param [in|out] d 对角线, 输出非负的奇异值, 未排序
+    //! @param [in|out] e 次对角线, e[i] = B(i, i+1), n-1 个元素, 输出时被破坏
+    //! @param [out] U, ldU 列优先存储的 n x n 矩阵
+    //! @param [out] V, ldV 列优先存储的 n x n 矩阵
+    //! @param [in] leaf 子问题不超过该尺寸时直接用隐式 QR 迭代
+    //! @param [in] max_iter 隐式 QR 迭代中每个奇异值的最大迭代次数
+    //! @param [in] tol 收缩的绝对阈值, 实际的阈值不小于 8 eps 乘以子问题的尺度
+    //! @return 各个子问题的隐式 QR 迭代次数之和
+    template <typename Scalar>
+    int BidiagonalDivideConquer(int n, Scalar * d, Scalar * e, Scalar * U, int ldU, Scalar * V, int ldV,
+                                int leaf = 25, int max_iter = 30, Scalar tol = 0)
+    {
+        if (n <= 0)
+            return 0;
+        leaf = std::max(leaf, 3);
+
+        // 子问题为从第 r0 行开始的 n x (n + sqre) 块
+        struct Node {
+            int r0, n, sqre, depth;
+        };
+        std::vector<Node> nodes;
+        int max_depth = 0;
+        auto build = [&](auto & self, int r0, int m, int sqre, int depth) -> void {
+            nodes.push_back({ r0, m, sqre, depth });
+            max_depth = std::max(max_depth, depth);
+            if (m <= leaf)
+                return;
+            int k = m / 2;
+            self(self, r0, k, 1, depth + 1);
+            self(self, r0 + k + 1, m - k - 1, sqre, depth + 1);
+        };
+        build(build, 0, n, 0, 0);
+
+        auto at = [](Scalar * X, int ldX, int r, int c) -> Scalar & { return X[r + c * ldX]; };
+        std::atomic<int> sweeps(0);
+
+        auto solve_leaf = [&](Node const & node) {
+            int r0 = node.r0, m = node.n, nv = m + node.sqre;
+            Scalar * Ub = &at(U, ldU, r0, r0);
+            Scalar * Vb = &at(V, ldV, r0, r0);
+            for (int c = 0; c < m; ++c)
+                for (int r = 0; r < m; ++r)
+                    at(Ub, ldU, r, c) = (r == c) ? Scalar(1) : Scalar(0);
+            for (int c = 0; c < nv; ++c)
+                for (int r = 0; r < nv; ++r)
+                    at(Vb, ldV, r, c) = (r == c) ? Scalar(1) : Scalar(0);
+
+            Scalar * dd = d + r0;
+            Scalar * ee = e + r0;
+            if (node.sqre) {
+                // 从右侧旋转把最后一列的 e[m-1] 向上追赶消去, 化为 m x m 的方阵
+                Scalar f = ee[m - 1];
+                for (int i = m - 1; i >= 0 && 0 != f; --i) {
+                    Scalar r = std::hypot(dd[i], f);
+                    Scalar c = dd[i] / r, s = f / r;
+                    dd[i] = r;
+                    if (i > 0) {
+                        f = -s * ee[i - 1];
+                        ee[i - 1] *= c;
+                    }
+                    Scalar * vi = Vb + i * ldV;
+                    Scalar * vm = Vb + m * ldV;
+                    for (int k = 0; k < nv; ++k) {
+                        Scalar a = vi[k], b = vm[k];
+                        vi[k] = c * a + s * b;
+                        vm[k] = c * b - s * a;
+                    }
+                }
+            }
+            sweeps.fetch_add(BidiagonalSVDQR(m, dd, ee, Ub, ldU, m, Vb, ldV, nv, max_iter));
+        };
+
+        auto merge = [&](Node const & node) {
+            int r0 = node.r0, m = node.n, sqre = node.sqre;
+            int k = m / 2, nr = m - k - 1, nv = m + sqre;
+            Scalar * Ub = &at(U, ldU, r0, r0);
+            Scalar * Vb = &at(V, ldV, r0, r0);
+            Scalar * U1 = Ub;
+            Scalar * U2 = &at(Ub, ldU, k + 1, k + 1);
+            Scalar * V1 = Vb;
+            Scalar * V2 = &at(Vb, ldV, k + 1, k + 1);
+            Scalar alpha = d[r0 + k];
+            Scalar beta = e[r0 + k];
+
+            WorkspaceFrame frame;
+            Scalar * dA = frame.Alloc<Scalar>(m);
+            Scalar * zA = frame.Alloc<Scalar>(m);
+            Scalar * sA = frame.Alloc<Scalar>(m);
+
+            // 箭形矩阵: 第 0 行为中间一行与子问题右奇异向量的乘积, 第 0 列对应上方子问题的零空间
+            Scalar c0 = 1, s0 = 0;
+            zA[0] = alpha * at(V1, ldV, k, k);
+            if (sqre) {
+                Scalar zn = beta * at(V2, ldV, 0, nr);
+                Scalar r = std::hypot(zA[0], zn);
+                if (0 != r) {
+                    c0 = zA[0] / r;
+                    s0 = zn / r;
+                }
+                zA[0] = r;
+            }
+            for (int a = 1; a <= k; ++a) {
+                dA[a] = d[r0 + a - 1];
+                zA[a] = alpha * at(V1, ldV, k, a - 1);
+            }
+            for (int a = k + 1; a < m; ++a) {
+                dA[a] = d[r0 + a];
+                zA[a] = beta * at(V2, ldV, 0, a - k - 1);
+            }
+
+            Scalar scale = std::max(std::abs(alpha), std::abs(beta));
+            for (int a = 1; a < m; ++a)
+                scale = std::max(scale, dA[a]);
+            Scalar thresh = std::max(8 * std::numeric_limits<Scalar>::epsilon() * scale, tol);
+
+            Scalar * Ua = frame.Alloc<Scalar>(m * m);
+            Scalar * Va = frame.Alloc<Scalar>(m * m);
+            ArrowSVD(m, dA, zA, thresh, sA, Ua, m, Va, m);
+
+            // 箭形矩阵的第 0 行对应第 k 行, 第 a 行对应第 a-1 行 (a <= k) 或第 a 行
+            Scalar * QU = frame.Alloc<Scalar>(m * m);
+            for (int j = 0; j < m; ++j) {
+                at(QU, m, k, j) = at(Ua, m, 0, j);
+                for (int a = 1; a <= k; ++a)
+                    at(QU, m, a - 1, j) = at(Ua, m, a, j);
+                for (int a = k + 1; a < m; ++a)
+                    at(QU, m, a, j) = at(Ua, m, a, j);
+            }
+            Scalar * QV = frame.Alloc<Scalar>(nv * nv);
+            for (int j = 0; j < m; ++j) {
+                at(QV, nv, k, j) = c0 * at(Va, m, 0, j);
+                if (sqre)
+                    at(QV, nv, m, j) = s0 * at(Va, m, 0, j);
+                for (int a = 1; a <= k; ++a)
+                    at(QV, nv, a - 1, j) = at(Va, m, a, j);
+                for (int a = k + 1; a < m; ++a)
+                    at(QV, nv, a, j) = at(Va, m, a, j);
+            }
+            if (sqre) {
+                std::fill(QV + m * nv, QV + (m + 1) * nv, Scalar(0));
+                at(QV, nv, k, m) = -s0;
+                at(QV, nv, m, m) = c0;
+            }
+
+            // U = diag(U1, 1, U2) QU, V = diag(V1, V2) QV
+            Scalar * T = frame.Alloc<Scalar>(nv * nv);
+            Gemm(k, m, k, Scalar(1), U1, 1, ldU, QU, 1, m, Scalar(0), T, 1, m);
+            for (int j = 0; j < m; ++j)
+                at(T, m, k, j) = at(QU, m, k, j);
+            Gemm(nr, m, nr, Scalar(1), U2, 1, ldU, QU + k + 1, 1, m, Scalar(0), T + k + 1, 1, m);
+            for (int j = 0; j < m; ++j)
+                std::copy(T + j * m, T + (j + 1) * m, Ub + j * ldU);
+
+            Gemm(k + 1, nv, k + 1, Scalar(1), V1, 1, ldV, QV, 1, nv, Scalar(0), T, 1, nv);
+            Gemm(nv - k - 1, nv, nv - k - 1, Scalar(1), V2, 1, ldV, QV + k + 1, 1, nv,
+                 Scalar(0), T + k + 1, 1, nv);
+            for (int j = 0; j < nv; ++j)
+                std::copy(T + j * nv, T + (j + 1) * nv, Vb + j * ldV);
+
+            std::copy(sA, sA + m, d + r0);
+        };
+
+        // 自底向上逐层求解, 同一层的子问题并行
+        std::vector<int> level;
+        for (int depth = max_depth; depth >= 0; --depth) {
+            level.clear();
+            for (int i = 0; i < (int)nodes.size(); ++i)
+                if (nodes[i].depth == depth)
+                    level.push_back(i);
+            ParallelFor(0, (int)level.size(), 1, [&](int b, int end) {
+                for (int i = b; i < end; ++i) {
+                    Node const & node = nodes[level[i]];
+                    if (node.n <= leaf)
+                        solve_leaf(node);
+                    else
+                        merge(node);
+                }
+            });
+        }
+        return sweeps.load();
+    }
+
+
+    /**
+     * @brief 分治法进行 SVD 分解
+     *
+     * \Sigma = U^T A V
+     *
+     * 用法与 SVD_GKR 相同: 构造或 Decompose 时二对角化, Iterate 时求解二对角矩阵的 SVD,
+     * 输出的 Sigma(), UT(), V() 含义也相同, 奇异值降序排列。两者可以互相替换,
+     * 大矩阵时分治法的合并步骤都是 Gemm, 比逐个 Givens 旋转更新 U 和 V 快得多。
+     * 不需要奇异向量时直接用隐式 QR 迭代, 只有 O(n^2) 的开销。
+     */
+    template <typename MatViewIn>
+    class SVD_DivideConquer {
+        public:
+            typedef typename MatViewIn::Scalar Scalar;
+
+            //! @brief 子问题不超过该尺寸时直接用隐式 QR 迭代
+            constexpr static int LeafSize = 25;
+
+            /**
+             * @brief 默认构造函数, 之后通过 Decompose 二对角化
+             */
+            SVD_DivideConquer()
+            {}
+
+            /**
+             * @brief 构造函数, 完成二对角化, 之后通过 Iterate 求解
+             */
+            SVD_DivideConquer(MatViewIn const & a, bool keepU, bool keepV)
+            {
+                Decompose(a, keepU, keepV);
+            }
+
+            /**
+             * @brief 二对角化, 之后通过 Iterate 求解
+             *
+             * 尺寸与上次相同时复用已有的矩阵, 不再申请内存
+             */
+            void Decompose(MatViewIn const & a, bool keepU, bool keepV)
+            {
+                mKeepU = keepU;
+                mKeepV = keepV;
+
+                int m = a.Rows();
+                int n = a.Cols();
+                mSigma.Resize(m, n) = a;
+                if (keepU)
+                    mUT.Resize(m, m).Identity();
+                if (keepV)
+                    mV.Resize(n, n).Identity();
+                mSigma.Bidiagonal(keepU ? &mUT : nullptr, keepV ? &mV : nullptr);
+            }
+
+            /**
+             * @brief 求解二对角矩阵的 SVD
+             *
+             * @param [in] max_iter 隐式 QR 迭代中每个奇异值的最大迭代次数
+             * @param [in] tolerance 收缩的绝对阈值, 0 时只按机器精度收缩
+             * @return 隐式 QR 迭代的总次数
+             */
+            int Iterate(int max_iter = 30, Scalar tolerance = 0)
+            {
+                int m = mSigma.Rows();
+                int n = mSigma.Cols();
+                int p = std::min(m, n);
+                bool upper = (m >= n);
+
+                mD.resize(p);
+                mE.resize(p);
+                for (int i = 0; i < p; i++) {
+                    mD[i] = mSigma(i, i);
+                    mE[i] = (i + 1 < p) ? (upper ? mSigma(i, i + 1) : mSigma(i + 1, i)) : Scalar(0);
+                }
+
+                int num = 0;
+                if (!mKeepU && !mKeepV) {
+                    num = BidiagonalSVDQR(p, mD.data(), mE.data(), (Scalar*)nullptr, p, 0,
+                                          (Scalar*)nullptr, p, 0, max_iter);
+                    Sort(p);
+                } else {
+                    // 上二对角时 B = Ub S Vb^T, 下二对角时 B^T = Ub S Vb^T
+                    mUb.Resize(p, p);
+                    mVb.Resize(p, p);
+                    num = BidiagonalDivideConquer(p, mD.data(), mE.data(), mUb.StorBegin(), p,
+                                                  mVb.StorBegin(), p, LeafSize, max_iter, tolerance);
+                    Sort(p);
+
+                    DMatrix<Scalar> const & L = upper ? mUb : mVb;
+                    DMatrix<Scalar> const & R = upper ? mVb : mUb;
+                    WorkspaceFrame frame;
+                    if (mKeepU) {
+                        // UT(0:p, :) = L^T UT(0:p, :)
+                        Scalar * T = frame.Alloc<Scalar>(p * m);
+                        Gemm(p, m, p, Scalar(1), SortedCol(L, frame, p), p, 1,
+                             mUT.StorBegin(), mUT.RowStride(), mUT.ColStride(), Scalar(0), T, 1, p);
+                        for (int c = 0; c < m; c++)
+                            for (int r = 0; r < p; r++)
+                                mUT(r, c) = T[r + c * p];
+                    }
+                    if (mKeepV) {
+                        // V(:, 0:p) = V(:, 0:p) R
+                        Scalar * T = frame.Alloc<Scalar>(n * p);
+                        Gemm(n, p, p, Scalar(1), mV.StorBegin(), mV.RowStride(), mV.ColStride(),
+                             SortedCol(R, frame, p), 1, p, Scalar(0), T, 1, n);
+                        for (int c = 0; c < p; c++)
+                            for (int r = 0; r < n; r++)
+                                mV(r, c) = T[r + c * n];
+                    }
+                }
+
+                for (int c = 0; c < n; c++)
+                    for (int r = 0; r < m; r++)
+                        mSigma(r, c) = (r == c) ? mD[r] : Scalar(0);
+                return num;
+            }
+
+        private:
+            //! @brief 奇异值降序排列, 记录排序后的下标
+            void Sort(int p)
+            {
+                mIdx.resize(p);
+                for (int i = 0; i < p; i++)
+                    mIdx[i] = i;
+                std::sort(mIdx.begin(), mIdx.end(), [this](int i, int j) { return mD[i] > mD[j]; });
+                mDTmp.assign(mD.begin(), mD.begin() + p);
+                for (int i = 0; i < p; i++)
+                    mD[i] = mDTmp[mIdx[i]];
+            }
+
+            //! @brief 按排序后的顺序重排 p x p 矩阵 X 的各列, 结果从 Workspace 中申请
+            Scalar const * SortedCol(DMatrix<Scalar> const & X, WorkspaceFrame & frame, int p)
+            {
+                Scalar * Y = frame.Alloc<Scalar>(p * p);
+                for (int j = 0; j < p; j++)
+                    for (int i = 0; i < p; i++)
+                        Y[i + j * p] = X(i, mIdx[j]);
+                return Y;
+            }
+
+        public:
+            DMatrix<Scalar> Sigma() { return mSigma; }
+            DMatrix<Scalar> UT() { return mUT; }
+            DMatrix<Scalar> V() { return mV; }
+
+        private:
+            DMatrix<Scalar> mUT;
+            DMatrix<Scalar> mSigma;
+            DMatrix<Scalar> mV;
+            //! @brief 二对角矩阵的奇异向量
+            DMatrix<Scalar> mUb;
+            DMatrix<Scalar> mVb;
+            std::vector<Scalar> mD;
+            std::vector<Scalar> mE;
+            //! @brief 排序时暂存奇异值
+            std::vector<Scalar> mDTmp;
+            std::vector<int> mIdx;
+
+            //! @brief 是否需要保留 UT
+            bool mKeepU{false};
+            //! @brief 是否需要保留 V
+            bool mKeepV{false};
+    };
+
+}
+
+#endif
@@ -13,20 +13,40 @@ namespace xiaotu {
         public:
             typedef typename MatViewIn::Scalar Scalar;
             typedef DMatrix<Scalar> Mat;
-            typedef MatrixSubView<Mat> SubView;
+            typedef typename Mat::SubView SubView;
 
             /**
-             * @brief 默认构造函数
+             * @brief 默认构造函数, 之后通过 Decompose 二对角化
+             */
+            SVD_GKR()
+            {}
+
+            /**
+             * @brief 构造函数, 完成二对角化, 之后通过 Iterate 迭代
              */
             SVD_GKR(MatViewIn const & a, bool keepU, bool keepV)
-                : mKeepU(keepU), mKeepV(keepV)
             {
+                Decompose(a, keepU, keepV);
+            }
+
+            /**
+             * @brief 二对角化, 之后通过 Iterate 迭代
+             *
+             * 尺寸与上次相同时复用已有的矩阵和乒乓队列, 不再申请内存
+             */
+            void Decompose(MatViewIn const & a, bool keepU, bool keepV)
+            {
+                mKeepU = keepU;
+                mKeepV = keepV;
+
                 int m = a.Rows();
                 int n = a.Cols();
                 int p = (m < n) ? m : n;
 
                 mSigma.Resize(m, n) = a;
                 mSigmaPingPang.Init(std::move(mSigma.SubMatrix(0, 0, p, p)));
+                mUTPingPang.Clear();
+                mVPingPang.Clear();
                 if (keepU) {
                     mUT.Resize(m, m).Identity();
                     mUTPingPang.Init(std::move(mUT.SubMatrix(0, 0, p, m)));
@@ -52,7 +72,6 @@ namespace xiaotu {
                     }
                     PingPang();
                 }
-
             }
 
             int Iterate(int max_iter, Scalar tolerance)
@@ -79,26 +98,61 @@ namespace xiaotu {
                 int n = mSigma.Cols();
                 int p = (m < n) ? m : n;
 
-                std::vector<int> idx(p);
+                WorkspaceFrame frame;
+                int * idx = frame.Alloc<int>(p);
+                Scalar * buf = frame.Alloc<Scalar>(p * std::max(m, n));
                 for (int i = 0; i < p; i++)
                     idx[i] = i;
 
-                std::sort(idx.begin(), idx.end(), [this](int i, int j){
+                std::sort(idx, idx + p, [this](int i, int j){
                     return std::abs(mSigma(i,i)) > std::abs(mSigma(j,j));
                 });
 
-
                 auto sigma = mSigma.SubMatrix(0, 0, p, p);
-                auto ut = mUT.SubMatrix(0, 0, p, m);
-                auto v = mV.SubMatrix(0, 0, n, p);
+                PermuteRows(sigma, idx, buf);
+                PermuteCols(sigma, idx, buf);
+                if (mKeepU) {
+                    auto ut = mUT.SubMatrix(0, 0, p, m);
+                    PermuteRows(ut, idx, buf);
+                }
+                if (mKeepV) {
+                    auto v = mV.SubMatrix(0, 0, n, p);
+                    PermuteCols(v, idx, buf);
+                }
+            }
 
-                Permutation perm(idx);
-                perm.LeftApplyOn(sigma);
-                if (mKeepU)
-                    perm.LeftApplyOn(ut);
-                perm.RightApplyOn(sigma);
-                if (mKeepV)
-                    perm.RightApplyOn(v);
+            /**
+             * @brief 行置换, 第 i 行换成原来的第 idx[i] 行
+             *
+             * @param [in] buf 临时缓存, 至少与 a 的元素数量相同
+             */
+            void PermuteRows(SubView & a, int const * idx, Scalar * buf)
+            {
+                int rows = a.Rows();
+                int cols = a.Cols();
+                for (int c = 0; c < cols; c++)
+                    for (int r = 0; r < rows; r++)
+                        buf[r + c * rows] = a(idx[r], c);
+                for (int c = 0; c < cols; c++)
+                    for (int r = 0; r < rows; r++)
+                        a(r, c) = buf[r + c * rows];
+            }
+
+            /**
+             * @brief 列置换, 第 i 列换成原来的第 idx[i] 列
+             *
+             * @param [in] buf 临时缓存, 至少与 a 的元素数量相同
+             */
+            void PermuteCols(SubView & a, int const * idx, Scalar * buf)
+            {
+                int rows = a.Rows();
+                int cols = a.Cols();
+                for (int c = 0; c < cols; c++)
+                    for (int r = 0; r < rows; r++)
+                        buf[r + c * rows] = a(r, idx[c]);
+                for (int c = 0; c < cols; c++)
+                    for (int r = 0; r < rows; r++)
+                        a(r, c) = buf[r + c * rows];
             }
 
             /**
@@ -148,9 +202,9 @@ namespace xiaotu {
              * @param [in|out] sigma 对角矩阵块
              * @param [out] u 若非 nullptr 则记录变换过程，左乘 Givens 变换
              */
-            void UpperScanDiagonal(MatrixSubView<Mat> & sigma,
-                              MatrixSubView<Mat> * u,
-                              MatrixSubView<Mat> * v)
+            void UpperScanDiagonal(typename Mat::SubView & sigma,
+                              typename Mat::SubView * u,
+                              typename Mat::SubView * v)
             {
                 int p = sigma.Rows();
                 for (int i = 0; i < p; i++) {
@@ -176,7 +230,7 @@ namespace xiaotu {
              * @param [out] v 若非 nullptr 则记录列消解过程, 右乘 Givens 变换
              * @return 是否执行消解操作
              */
-            bool UpperIsAnnZero(MatrixSubView<Mat> & sigma, MatrixSubView<Mat> * v)
+            bool UpperIsAnnZero(typename Mat::SubView & sigma, typename Mat::SubView * v)
             {
                 int p = sigma.Rows();
                 if (std::abs(sigma(p-1, p-1)) > mAbsEps)
@@ -195,7 +249,7 @@ namespace xiaotu {
             /**
              * @brief 对上二对角矩阵 a 计算 Rayleigh 偏移
              */
-            Scalar UpperRayleighShift(MatrixSubView<Mat> const & a)
+            Scalar UpperRayleighShift(typename Mat::SubView const & a)
             {
                 int p = a.Rows() - 1;
                 return a(p, p) * a(p, p) + a(p-1, p) * a(p-1, p);
@@ -205,7 +259,7 @@ namespace xiaotu {
              *
              * 相比于 RayleighShift 收敛性更好一些
              */
-            Scalar UpperWilkinsonShift(MatrixSubView<Mat> const & a)
+            Scalar UpperWilkinsonShift(typename Mat::SubView const & a)
             {
                 int p = a.Rows() - 1;
                 Scalar d_n1 = a(p-1, p-1);
@@ -230,9 +284,9 @@ namespace xiaotu {
                 return diff1 < diff2 ? e1 : e2;
             }
 
-            void UpperImplicitIter(MatrixSubView<Mat> & B,
-                              MatrixSubView<Mat> * pU,
-                              MatrixSubView<Mat> * pV)
+            void UpperImplicitIter(typename Mat::SubView & B,
+                              typename Mat::SubView * pU,
+                              typename Mat::SubView * pV)
             {
                 int n = B.Rows();
                 //Scalar mu = UpperRayleighShift(B);
@@ -315,7 +369,7 @@ namespace xiaotu {
              * @param [out] u 若非 nullptr 则记录列消解过程, 左乘 Givens 变换
              * @return 是否执行消解操作
              */
-            bool LowerIsAnnZero(MatrixSubView<Mat> & sigma, MatrixSubView<Mat> * u)
+            bool LowerIsAnnZero(typename Mat::SubView & sigma, typename Mat::SubView * u)
             {
                 int p = sigma.Rows();
                 if (std::abs(sigma(p-1, p-1)) > mAbsEps)
@@ -337,9 +391,9 @@ namespace xiaotu {
              * @param [in|out] sigma 对角矩阵块
              * @param [out] u 若非 nullptr 则记录变换过程，右乘 Givens 变换
              */
-            void LowerScanDiagonal(MatrixSubView<Mat> & sigma,
-                              MatrixSubView<Mat> * u,
-                              MatrixSubView<Mat> * v)
+            void LowerScanDiagonal(typename Mat::SubView & sigma,
+                              typename Mat::SubView * u,
+                              typename Mat::SubView * v)
             {
                 int p = sigma.Rows();
                 for (int i = 0; i < p; i++) {
@@ -363,7 +417,7 @@ namespace xiaotu {
              *
              * 相比于 RayleighShift 收敛性更好一些
              */
-            Scalar LowerWilkinsonShift(MatrixSubView<Mat> const & a)
+            Scalar LowerWilkinsonShift(typename Mat::SubView const & a)
             {
                 int p = a.Rows() - 1;
                 Scalar d_n1 = a(p-1, p-1);
@@ -388,9 +442,9 @@ namespace xiaotu {
                 return diff1 < diff2 ? e1 : e2;
             }
 
-            void LowerImplicitIter(MatrixSubView<Mat> & B,
-                              MatrixSubView<Mat> * pU,
-                              MatrixSubView<Mat> * pV)
+            void LowerImplicitIter(typename Mat::SubView & B,
+                              typename Mat::SubView * pU,
+                              typename Mat::SubView * pV)
             {
                 int n = B.Rows();
                 Scalar mu = LowerWilkinsonShift(B);
@@ -425,9 +479,9 @@ namespace xiaotu {
             }
 
         public:
-            DMatrix<Scalar> const Sigma() { return mSigma; }
-            DMatrix<Scalar> const UT() { return mUT; }
-            DMatrix<Scalar> const V() { return mV; }
+            DMatrix<Scalar> Sigma() { return mSigma; }
+            DMatrix<Scalar> UT() { return mUT; }
+            DMatrix<Scalar> V() { return mV; }
 
         private:
             DMatrix<Scalar> mUT;
@@ -451,9 +505,9 @@ namespace xiaotu {
              * @param [out] parts 输出分割列表
              * @return 分割的对角块数量
              */
-            int Partition(MatrixSubView<Mat> & sigma,
-                          MatrixSubView<Mat> * pU0,
-                          MatrixSubView<Mat> * pV0,
+            int Partition(typename Mat::SubView & sigma,
+                          typename Mat::SubView * pU0,
+                          typename Mat::SubView * pV0,
                           bool upper)
             {
                 int p = sigma.Rows();
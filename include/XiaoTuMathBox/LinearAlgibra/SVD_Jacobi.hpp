@@ -0,0 +1,272 @@
+#ifndef XTMB_LA_SVD_JACOBI_H
+#define XTMB_LA_SVD_JACOBI_H
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+
+#include <XiaoTuMathBox/LinearAlgibra/Givens.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/Householder.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 单边 Jacobi 奇异值分解, 参考 Demmel & Veselić, "Jacobi's method is more accurate than QR"
+//
+// 不做二对角化, 直接对 W = A 的列两两做 Givens 旋转 W = W J, 使各列相互正交,
+// 收敛后各列的范数就是奇异值, 归一化后就是左奇异向量, 旋转的累积 V = J_1 J_2 ... 为右奇异向量。
+// 每次旋转只用到两列的内积, 当 A = B D 且 B 的条件数不大时, 即使很小的奇异值也有较高的相对精度。
+//
+// 按照循环赛 (round-robin) 的顺序遍历列对, 每一轮的 n/2 个列对互不相交, 可以在多个线程上同时旋转,
+// 每个列对内部沿着行方向通过 Simd.hpp 中的计算核心向量化。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 单边 Jacobi 迭代, 使 W 的各列两两正交
+    //!
+    //! 一次扫描 (sweep) 包含 n-1 轮 (n 为奇数时补一个空列), 每一轮固定第 0 个位置, 其余位置循环移动一位,
+    //! 第 k 个位置与第 N-1-k 个位置配对, 每一对列在一次扫描中恰好相遇一次。
+    //! 列对 (p, q) 满足 |w_p^T w_q| <= tol ||w_p|| ||w_q|| 时认为已经正交, 不再旋转,
+    //! 一次扫描中没有任何旋转时收敛。
+    //!
+    //! @param [in] m, n W 的尺寸
+    //! @param [in|out] W, ldW 列优先存储的矩阵, 输出时各列两两正交
+    //! @param [in|out] V, ldV 列优先存储的 nv x n 矩阵, 旋转累积到其各列上, 可以为 nullptr
+    //! @param [in] nv V 的行数
+    //! @param [in] max_sweeps 最大扫描次数
+    //! @param [in] tol 正交的相对阈值, 0 时取 sqrt(m) eps
+    //! @return 扫描的次数
+    template <typename Scalar>
+    int OneSidedJacobi(int m, int n, Scalar * W, int ldW, Scalar * V, int ldV, int nv,
+                       int max_sweeps, Scalar tol = 0)
+    {
+        if (n < 2)
+            return 0;
+        if (0 == tol)
+            tol = std::sqrt(Scalar(m)) * std::numeric_limits<Scalar>::epsilon();
+
+        int N = n + (n & 1);
+        int npairs = N / 2;
+        std::vector<int> ring(N);
+        for (int i = 0; i < N; i++)
+            ring[i] = i;
+
+        // 每个列对约 6m + 4nv 次浮点运算, 太小时多个列对合成一个任务块
+        int grain = ParallelGrain(npairs, 1, std::max(1, 2048 / (m + nv)));
+
+        for (int sweep = 0; sweep < max_sweeps; sweep++) {
+            std::atomic<int> rotations(0);
+            for (int round = 0; round < N - 1; round++) {
+                ParallelFor(0, npairs, grain, [&](int b, int e) {
+                    int count = 0;
+                    for (int k = b; k < e; k++) {
+                        int p = std::min(ring[k], ring[N - 1 - k]);
+                        int q = std::max(ring[k], ring[N - 1 - k]);
+                        if (q >= n)
+                            continue;
+
+                        Scalar * wp = W + p * ldW;
+                        Scalar * wq = W + q * ldW;
+                        Scalar alpha, beta, gamma;
+                        SimdGram2(m, wp, wq, alpha, beta, gamma);
+                        if (std::abs(gamma) <= tol * std::sqrt(alpha) * std::sqrt(beta))
+                            continue;
+
+                        Givens<Scalar> G = Givens<Scalar>::Jacobi(p, q, alpha, beta, gamma);
+                        G.RightApplyOn(m, wp, wq);
+                        if (nullptr != V)
+                            G.RightApplyOn(nv, V + p * ldV, V + q * ldV);
+                        count++;
+                    }
+                    if (count > 0)
+                        rotations.fetch_add(count);
+                });
+                std::rotate(ring.begin() + 1, ring.end() - 1, ring.end());
+            }
+            if (0 == rotations.load())
+                return sweep + 1;
+        }
+        throw std::runtime_error("迭代不收敛");
+    }
+
+    /**
+     * @brief 单边 Jacobi 奇异值分解 A = U Sigma V^T
+     *
+     * 接口与 SVD_GKR 相同, Sigma = UT A V, 奇异值降序排列。m < n 时对 A^T 迭代。
+     * 不经过二对角化, 适合中小尺寸的矩阵, 以及需要小奇异值相对精度的场合。
+     */
+    template <typename MatViewIn>
+    class SVD_Jacobi {
+        public:
+            typedef typename MatViewIn::Scalar Scalar;
+
+            /**
+             * @brief 默认构造函数, 之后通过 Decompose 分解
+             */
+            SVD_Jacobi()
+            {}
+
+            /**
+             * @brief 构造函数, 拷贝工作矩阵, 之后通过 Iterate 求解
+             */
+            SVD_Jacobi(MatViewIn const & a, bool keepU, bool keepV)
+            {
+                Decompose(a, keepU, keepV);
+            }
+
+            /**
+             * @brief 拷贝工作矩阵 W, 行数不少于列数, 之后通过 Iterate 求解
+             *
+             * 尺寸与上次相同时复用已有的矩阵, 不再申请内存
+             */
+            void Decompose(MatViewIn const & a, bool keepU, bool keepV)
+            {
+                mKeepU = keepU;
+                mKeepV = keepV;
+
+                int m = a.Rows();
+                int n = a.Cols();
+                mTrans = (m < n);
+                if (mTrans) {
+                    mW.Resize(n, m);
+                    for (int c = 0; c < m; c++)
+                        for (int r = 0; r < n; r++)
+                            mW(r, c) = a(c, r);
+                } else {
+                    mW.Resize(m, n);
+                    for (int c = 0; c < n; c++)
+                        for (int r = 0; r < m; r++)
+                            mW(r, c) = a(r, c);
+                }
+                mSigma.Resize(m, n);
+            }
+
+            /**
+             * @brief Jacobi 迭代并构造奇异向量
+             *
+             * @param [in] max_sweeps 最大扫描次数
+             * @param [in] tolerance 两列正交的相对阈值, 0 时取 sqrt(m) eps
+             * @return 扫描的次数
+             */
+            int Iterate(int max_sweeps = 30, Scalar tolerance = 0)
+            {
+                // W = X S Y^T, 不转置时 U = X, V = Y, 转置时 U = Y, V = X
+                int mm = mW.Rows();
+                int nn = mW.Cols();
+                bool keepX = mTrans ? mKeepV : mKeepU;
+                bool keepY = mTrans ? mKeepU : mKeepV;
+
+                Scalar * Y = nullptr;
+                if (keepY) {
+                    mY.Resize(nn, nn).Identity();
+                    Y = mY.StorBegin();
+                }
+                int num = OneSidedJacobi(mm, nn, mW.StorBegin(), mm, Y, nn, nn, max_sweeps, tolerance);
+
+                mD.resize(nn);
+                for (int j = 0; j < nn; j++)
+                    mD[j] = std::sqrt(SimdDot(mm, mW.StorBegin() + j * mm, mW.StorBegin() + j * mm));
+                Sort(nn);
+
+                if (keepX)
+                    FormX(mm, nn);
+
+                int m = mSigma.Rows();
+                int n = mSigma.Cols();
+                for (int c = 0; c < n; c++)
+                    for (int r = 0; r < m; r++)
+                        mSigma(r, c) = (r == c) ? mD[r] : Scalar(0);
+
+                if (mKeepU) {
+                    mUT.Resize(m, m);
+                    DMatrix<Scalar> const & U = mTrans ? mY : mX;
+                    for (int c = 0; c < m; c++)
+                        for (int r = 0; r < m; r++)
+                            mUT(r, c) = U(c, mTrans ? mIdx[r] : r);
+                }
+                if (mKeepV) {
+                    mV.Resize(n, n);
+                    DMatrix<Scalar> const & R = mTrans ? mX : mY;
+                    for (int c = 0; c < n; c++)
+                        for (int r = 0; r < n; r++)
+                            mV(r, c) = R(r, mTrans ? c : mIdx[c]);
+                }
+                return num;
+            }
+
+        private:
+            //! @brief 奇异值降序排列, 记录排序后的下标
+            void Sort(int p)
+            {
+                mIdx.resize(p);
+                for (int i = 0; i < p; i++)
+                    mIdx[i] = i;
+                std::sort(mIdx.begin(), mIdx.end(), [this](int i, int j) { return mD[i] > mD[j]; });
+                mDTmp.assign(mD.begin(), mD.begin() + p);
+                for (int i = 0; i < p; i++)
+                    mD[i] = mDTmp[mIdx[i]];
+            }
+
+            /**
+             * @brief 按排序后的顺序构造 mm x mm 的左奇异向量 X
+             *
+             * 非零奇异值对应 W 归一化后的各列, 其余各列通过一次 Householder QR 补全为正交基:
+             * 对前 r 列 QR 分解, Q 的后 mm - r 列与前 r 列张成的空间正交。
+             */
+            void FormX(int mm, int nn)
+            {
+                mX.Resize(mm, mm);
+                int r = 0;
+                for (; r < nn && mD[r] > std::numeric_limits<Scalar>::min(); r++) {
+                    Scalar const * w = mW.StorBegin() + mIdx[r] * mm;
+                    Scalar * x = mX.StorBegin() + r * mm;
+                    SimdScale(mm, 1 / mD[r], w, x);
+                }
+                if (r == mm)
+                    return;
+
+                constexpr int nb = 32;
+                WorkspaceFrame frame;
+                Scalar * Q = frame.Alloc<Scalar>(mm * r);
+                Scalar * tau = frame.Alloc<Scalar>(r);
+                Scalar * T = frame.Alloc<Scalar>(nb * r);
+                std::copy(mX.StorBegin(), mX.StorBegin() + mm * r, Q);
+                HouseholderQR(mm, r, Q, 1, mm, tau, T, nb);
+
+                Scalar * C = mX.StorBegin() + r * mm;
+                for (int c = 0; c < mm - r; c++)
+                    for (int i = 0; i < mm; i++)
+                        C[i + c * mm] = (i == r + c) ? Scalar(1) : Scalar(0);
+                HouseholderApplyQ(mm, mm - r, r, Q, 1, mm, T, nb, false, C, 1, mm);
+            }
+
+        public:
+            DMatrix<Scalar> Sigma() { return mSigma; }
+            DMatrix<Scalar> UT() { return mUT; }
+            DMatrix<Scalar> V() { return mV; }
+
+        private:
+            DMatrix<Scalar> mUT;
+            DMatrix<Scalar> mSigma;
+            DMatrix<Scalar> mV;
+            //! @brief 工作矩阵, 行数不少于列数
+            DMatrix<Scalar> mW;
+            //! @brief W 的左奇异向量, 按降序排列
+            DMatrix<Scalar> mX;
+            //! @brief W 的右奇异向量, 即旋转的累积, 未排序
+            DMatrix<Scalar> mY;
+            std::vector<Scalar> mD;
+            //! @brief 排序时暂存奇异值
+            std::vector<Scalar> mDTmp;
+            std::vector<int> mIdx;
+            bool mTrans = false;
+            bool mKeepU = false;
+            bool mKeepV = false;
+    };
+
+}
+
+#endif
@@ -31,12 +31,12 @@ namespace xiaotu {
 
                 DMatrix<Scalar> B(p, p);
                 B = mSigma.SubMatrix(0, 0, p, p);
-                auto BTB = B.Transpose() * B;
+                DMatrix<Scalar> BTB = B.Transpose() * B;
 
                 EigenImplicitQR<DMatrix<Scalar>> qr;
                 qr.Iterate(BTB, max_iter, tolerance);
 
-                auto BQ = B * qr.Q().Transpose();
+                DMatrix<Scalar> BQ = B * qr.Q().Transpose();
                 QR_Householder pqr(BQ);
                 mSigma.SubMatrix(0, 0, p, p) = pqr.R();
 
@@ -46,9 +46,9 @@ namespace xiaotu {
                 v = (v * qr.Q().Transpose());
             }
 
-            DMatrix<Scalar> const Sigma() { return mSigma; }
-            DMatrix<Scalar> const UT() { return mUT; }
-            DMatrix<Scalar> const V() { return mV; }
+            DMatrix<Scalar> Sigma() { return mSigma; }
+            DMatrix<Scalar> UT() { return mUT; }
+            DMatrix<Scalar> V() { return mV; }
 
         private:
             DMatrix<Scalar> mUT;
@@ -0,0 +1,169 @@
+#ifndef XTMB_LA_SVD_RANDOMIZED_H
+#define XTMB_LA_SVD_RANDOMIZED_H
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include <XiaoTuMathBox/LinearAlgibra/Householder.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/SVD_DivideConquer.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 随机化的截断奇异值分解 A ≈ U Sigma V^T, 参考 Halko, Martinsson & Tropp,
+// "Finding structure with randomness", 算法 4.4 和 5.1
+//
+// 用 l = k + p 个高斯随机向量 Ω 采样 A 的列空间 Y = A Ω, 再做 q 次幂迭代 Y = (A A^T)^q A Ω,
+// 使奇异值衰减较慢时也能抓住前 k 个方向。对 Y 正交化得到 m x l 的 Q 后, A ≈ Q B, B = Q^T A。
+// 不直接对 l x n 的 B 做 SVD, 而是对 n x l 的 B^T = A^T Q 做 QR 分解 B^T = Q2 R,
+// 只需要对 l x l 的 R^T 做一次小规模的 SVD, 再用 Q 和 Q2 变换回去。
+// 每一步都是 Gemm 或者分块 Householder QR, 只需要 O((m + n) l) 的额外内存。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    /**
+     * @brief 随机化的截断奇异值分解
+     *
+     * 只计算前 k 个奇异值及对应的奇异向量, U 为 m x k, Sigma 为 k x k, V 为 n x k,
+     * 奇异值降序排列。随机数种子固定, 相同的输入得到相同的结果。
+     */
+    template <typename MatViewIn>
+    class SVD_Randomized {
+        public:
+            typedef typename MatViewIn::Scalar Scalar;
+
+            //! @brief QR 分解的分块大小
+            constexpr static int BlockSize = 32;
+
+            /**
+             * @brief 默认构造函数, 之后通过 Decompose 分解
+             */
+            SVD_Randomized()
+            {}
+
+            /**
+             * @brief 构造函数, 完成分解
+             */
+            SVD_Randomized(MatViewIn const & a, int rank, int oversample = 10, int power_iter = 2)
+            {
+                Decompose(a, rank, oversample, power_iter);
+            }
+
+            /**
+             * @brief 计算前 rank 个奇异三元组
+             *
+             * @param [in] a 待分解矩阵, 连续存储的浮点数矩阵直接参与 Gemm, 否则先拷贝一份
+             * @param [in] rank 需要的奇异值数量 k, 超过 min(m, n) 时截断
+             * @param [in] oversample 额外的采样数量 p, 通常取 5 到 10
+             * @param [in] power_iter 幂迭代次数 q, 奇异值衰减越慢需要越多
+             * @param [in] seed 随机数种子
+             */
+            void Decompose(MatViewIn const & a, int rank, int oversample = 10, int power_iter = 2,
+                           unsigned seed = 5489u)
+            {
+                if constexpr (GemmDispatchable<MatViewIn, MatViewIn, DMatrix<Scalar>>::value) {
+                    Solve(a.Rows(), a.Cols(), a.StorBegin(), a.RowStride(), a.ColStride(),
+                          rank, oversample, power_iter, seed);
+                } else {
+                    DMatrix<Scalar> A(a.Rows(), a.Cols());
+                    for (int c = 0; c < A.Cols(); c++)
+                        for (int r = 0; r < A.Rows(); r++)
+                            A(r, c) = a(r, c);
+                    Solve(A.Rows(), A.Cols(), A.StorBegin(), A.RowStride(), A.ColStride(),
+                          rank, oversample, power_iter, seed);
+                }
+            }
+
+            /**
+             * @brief 秩 k 近似 U Sigma V^T, m x n
+             */
+            DMatrix<Scalar> LowRank() const
+            {
+                int m = mU.Rows(), n = mV.Rows(), k = mU.Cols();
+                DMatrix<Scalar> US(mU);
+                for (int j = 0; j < k; j++)
+                    SimdScale(m, mD[j], mU.StorBegin() + j * m, US.StorBegin() + j * m);
+                DMatrix<Scalar> R(m, n);
+                Gemm(m, n, k, Scalar(1), US.StorBegin(), 1, m, mV.StorBegin(), n, 1,
+                     Scalar(0), R.StorBegin(), 1, m);
+                return R;
+            }
+
+        private:
+            void Solve(int m, int n, Scalar const * A, int rsA, int csA,
+                       int rank, int oversample, int power_iter, unsigned seed)
+            {
+                int p = std::min(m, n);
+                int k = std::min(rank, p);
+                int l = std::min(k + oversample, p);
+
+                // Y = A Ω
+                std::mt19937 gen(seed);
+                std::normal_distribution<Scalar> dist;
+                mZ.Resize(n, l);
+                for (int i = 0; i < mZ.NumDatas(); i++)
+                    mZ(i) = dist(gen);
+                mY.Resize(m, l);
+                Gemm(m, l, n, Scalar(1), A, rsA, csA, mZ.StorBegin(), 1, n, Scalar(0), mY.StorBegin(), 1, m);
+
+                // 幂迭代, 每次乘法之后都重新正交化, 避免小奇异值的方向被舍入误差淹没
+                for (int it = 0; it < power_iter; it++) {
+                    HouseholderThinQ(m, l, mY.StorBegin(), m, (Scalar*)nullptr, l, BlockSize);
+                    Gemm(n, l, m, Scalar(1), A, csA, rsA, mY.StorBegin(), 1, m, Scalar(0), mZ.StorBegin(), 1, n);
+                    HouseholderThinQ(n, l, mZ.StorBegin(), n, (Scalar*)nullptr, l, BlockSize);
+                    Gemm(m, l, n, Scalar(1), A, rsA, csA, mZ.StorBegin(), 1, n, Scalar(0), mY.StorBegin(), 1, m);
+                }
+                HouseholderThinQ(m, l, mY.StorBegin(), m, (Scalar*)nullptr, l, BlockSize);
+
+                // B^T = A^T Q = Q2 R, 则 B = R^T Q2^T, 只需要对 l x l 的 R^T 做 SVD
+                Gemm(n, l, m, Scalar(1), A, csA, rsA, mY.StorBegin(), 1, m, Scalar(0), mZ.StorBegin(), 1, n);
+                DMatrix<Scalar> R(l, l);
+                HouseholderThinQ(n, l, mZ.StorBegin(), n, R.StorBegin(), l, BlockSize);
+                DMatrix<Scalar> RT = R.Transpose();
+
+                // R^T = Ur S Vr^T, U = Q Ur, V = Q2 Vr
+                SVD_DivideConquer<DMatrix<Scalar>> svd(RT, true, true);
+                svd.Iterate();
+                DMatrix<Scalar> S = svd.Sigma();
+                DMatrix<Scalar> UT = svd.UT();
+                DMatrix<Scalar> Vr = svd.V();
+
+                mD.resize(k);
+                mSigma.Resize(k, k);
+                for (int c = 0; c < k; c++) {
+                    mD[c] = S(c, c);
+                    for (int r = 0; r < k; r++)
+                        mSigma(r, c) = (r == c) ? mD[c] : Scalar(0);
+                }
+                mU.Resize(m, k);
+                Gemm(m, k, l, Scalar(1), mY.StorBegin(), 1, m, UT.StorBegin(), UT.ColStride(), UT.RowStride(),
+                     Scalar(0), mU.StorBegin(), 1, m);
+                mV.Resize(n, k);
+                Gemm(n, k, l, Scalar(1), mZ.StorBegin(), 1, n, Vr.StorBegin(), Vr.RowStride(), Vr.ColStride(),
+                     Scalar(0), mV.StorBegin(), 1, n);
+            }
+
+        public:
+            //! @brief 前 k 个左奇异向量, m x k
+            DMatrix<Scalar> const & U() const { return mU; }
+            //! @brief 前 k 个奇异值构成的对角矩阵, k x k
+            DMatrix<Scalar> const & Sigma() const { return mSigma; }
+            //! @brief 前 k 个右奇异向量, n x k
+            DMatrix<Scalar> const & V() const { return mV; }
+
+        private:
+            DMatrix<Scalar> mU;
+            DMatrix<Scalar> mSigma;
+            DMatrix<Scalar> mV;
+            //! @brief A 列空间的正交基, m x l
+            DMatrix<Scalar> mY;
+            //! @brief A 行空间的正交基, n x l
+            DMatrix<Scalar> mZ;
+            std::vector<Scalar> mD;
+    };
+
+}
+
+#endif
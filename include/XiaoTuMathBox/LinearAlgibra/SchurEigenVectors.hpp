@@ -0,0 +1,136 @@
+#ifndef XTMB_LA_SCHUR_EIGEN_VECTORS_H
+#define XTMB_LA_SCHUR_EIGEN_VECTORS_H
+
+#include <cmath>
+#include <limits>
+#include <complex>
+#include <algorithm>
+
+#include <XiaoTuMathBox/LinearAlgibra/Gemm.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 由实 Schur 分解 A = Q^T T Q 计算 A 的全部右特征向量
+//
+// T 为拟上三角矩阵, 对每个特征值 λ, 从 λ 所在的对角块开始向上回代求解 (T - λI) y = 0,
+// 遇到 2x2 对角块时解一个 2 阶方程组, 所有特征值共 O(n^3) 次运算。
+// 再通过一次 Gemm 得到 A 的特征向量 V = Q^T Y。共轭复特征值按复数回代, 参考 LAPACK trevc。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 对 T 的左上 m x m 部分回代求解 (T - λI) x = rhs, 结果覆盖 x
+    //!
+    //! 过小的主元替换为 smin, 与 LAPACK trevc 相同, 避免 λ 为重特征值时除以 0
+    template <typename Ty, typename Scalar>
+    void SchurBackSolve(int m, Scalar const * T, int ldT, Ty lambda, Scalar smin, Ty * x)
+    {
+        auto t = [&](int r, int c) { return T[r + c * ldT]; };
+        auto pivot = [&](Ty d) { return (std::abs(d) < smin) ? Ty(smin) : d; };
+
+        int j = m - 1;
+        while (j >= 0) {
+            if (j > 0 && 0 != t(j, j - 1)) {
+                // 2x2 对角块, Cramer 法则
+                Ty a = t(j - 1, j - 1) - lambda, b = t(j - 1, j);
+                Ty c = t(j, j - 1), d = t(j, j) - lambda;
+                Ty det = pivot(a * d - b * c);
+                Ty x0 = (d * x[j - 1] - b * x[j]) / det;
+                Ty x1 = (a * x[j] - c * x[j - 1]) / det;
+                x[j - 1] = x0;
+                x[j] = x1;
+                for (int k = 0; k < j - 1; ++k)
+                    x[k] -= t(k, j - 1) * x0 + t(k, j) * x1;
+                j -= 2;
+            } else {
+                x[j] /= pivot(t(j, j) - lambda);
+                for (int k = 0; k < j; ++k)
+                    x[k] -= t(k, j) * x[j];
+                j -= 1;
+            }
+        }
+    }
+
+    //! @brief 由实 Schur 分解计算全部右特征向量
+    //!
+    //! 与 LAPACK 相同, 实特征值对应 V 的一列; 对角块 (j, j+1) 对应的共轭复特征值 λ = wr + i wi (wi > 0)
+    //! 的特征向量为 V(:, j) + i V(:, j+1), 其共轭即为 λ 的共轭对应的特征向量。各特征向量都归一化为单位长度。
+    //!
+    //! @param [in] n 矩阵尺寸
+    //! @param [in] T, ldT 拟上三角矩阵, 2x2 对角块的次对角元素非 0, 其余次对角元素为 0, 次对角线以下不读取
+    //! @param [in] Q, ldQ 正交矩阵, A = Q^T T Q
+    //! @param [out] V, ldV 特征向量, n x n
+    template <typename Scalar>
+    void SchurEigenVectors(int n, Scalar const * T, int ldT, Scalar const * Q, int ldQ, Scalar * V, int ldV)
+    {
+        typedef std::complex<Scalar> Complex;
+        auto t = [&](int r, int c) { return T[r + c * ldT]; };
+
+        Scalar tnorm = 0;
+        for (int c = 0; c < n; ++c)
+            for (int r = 0; r <= std::min(c + 1, n - 1); ++r)
+                tnorm = std::max(tnorm, std::abs(t(r, c)));
+        Scalar smin = std::max(std::numeric_limits<Scalar>::epsilon() * tnorm,
+                               std::numeric_limits<Scalar>::min());
+
+        WorkspaceFrame frame;
+        Scalar * Y = frame.Alloc<Scalar>(n * n);
+        Complex * x = frame.Alloc<Complex>(n);
+        std::fill(Y, Y + n * n, Scalar(0));
+
+        int j = n - 1;
+        while (j >= 0) {
+            if (j > 0 && 0 != t(j, j - 1)) {
+                // 对角块 (j-1, j) 的共轭复特征值, 取虚部为正的那个
+                Scalar a = t(j - 1, j - 1), b = t(j - 1, j), c = t(j, j - 1), d = t(j, j);
+                Scalar p = (a - d) / 2;
+                Scalar disc = p * p + b * c;
+                Complex lambda((a + d) / 2, std::sqrt(std::abs(disc)));
+
+                // 块内 x = ((λ - d) / c, 1), 满足 2 阶特征方程
+                x[j - 1] = (lambda - d) / c;
+                x[j] = 1;
+                for (int k = 0; k < j - 1; ++k)
+                    x[k] = -(t(k, j - 1) * x[j - 1] + t(k, j));
+                SchurBackSolve(j - 1, T, ldT, lambda, smin, x);
+
+                for (int k = 0; k <= j; ++k) {
+                    Y[k + (j - 1) * n] = x[k].real();
+                    Y[k + j * n] = x[k].imag();
+                }
+                j -= 2;
+            } else {
+                Scalar lambda = t(j, j);
+                Scalar * y = Y + j * n;
+                y[j] = 1;
+                for (int k = 0; k < j; ++k)
+                    y[k] = -t(k, j);
+                SchurBackSolve(j, T, ldT, lambda, smin, y);
+                j -= 1;
+            }
+        }
+
+        // V = Q^T Y
+        Gemm(n, n, n, Scalar(1), Q, ldQ, 1, Y, 1, n, Scalar(0), V, 1, ldV);
+
+        j = 0;
+        while (j < n) {
+            bool pair = (j + 1 < n) && 0 != t(j + 1, j);
+            int w = pair ? 2 : 1;
+            Scalar norm = 0;
+            for (int c = j; c < j + w; ++c)
+                for (int r = 0; r < n; ++r)
+                    norm += V[r + c * ldV] * V[r + c * ldV];
+            norm = std::sqrt(norm);
+            if (norm > 0) {
+                for (int c = j; c < j + w; ++c)
+                    for (int r = 0; r < n; ++r)
+                        V[r + c * ldV] /= norm;
+            }
+            j += w;
+        }
+    }
+
+}
+
+#endif
@@ -0,0 +1,487 @@
+#ifndef XTMB_LA_SIMD_H
+#define XTMB_LA_SIMD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 连续存储上的逐元素运算和归约, SIMD 指令集在运行时根据 CPU 特性选择
+//
+// 计算核心用 GCC 的向量扩展写成模板 SimdKernel<Scalar, Bytes>, Bytes 为向量寄存器的宽度。
+// 它们都是强制内联的, 内联到带有 target 属性的入口函数 SimdRunSSE2/AVX2/AVX512 中之后,
+// 由编译器按照对应的指令集生成代码, 所以不需要用 -mavx2 等选项编译整个工程。
+//
+// 与 Gemm.hpp 一样, 所有接口都基于裸指针, 这里只要求元素在存储中紧密排列。
+//
+/////////////////////////////////////////////////////////////////////////
+
+#define XTMB_ALWAYS_INLINE inline __attribute__((always_inline))
+
+// 向量类型只在强制内联的函数之间以引用传递, 不涉及调用约定, 在本文件内关闭 ABI 警告。
+// 按值传递或返回向量的函数会在翻译单元末尾才给出警告, 超出 push/pop 的范围, 所以这里都不使用。
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace xiaotu {
+
+    //! @brief SIMD 指令集的级别
+    enum class ESimdLevel {
+        eScalar = 0,
+        eSSE2 = 1,
+        eAVX2 = 2,
+        eAVX512 = 3
+    };
+
+    //! @brief 检测 CPU 支持的最高级别
+    inline ESimdLevel DetectSimdLevel()
+    {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return ESimdLevel::eAVX512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return ESimdLevel::eAVX2;
+        if (__builtin_cpu_supports("sse2"))
+            return ESimdLevel::eSSE2;
+#endif
+        return ESimdLevel::eScalar;
+    }
+
+    inline ESimdLevel & SimdLevelStorage()
+    {
+        static ESimdLevel level = DetectSimdLevel();
+        return level;
+    }
+
+    //! @brief 当前使用的 SIMD 级别
+    inline ESimdLevel SimdLevel()
+    {
+        return SimdLevelStorage();
+    }
+
+    //! @brief 限制使用的 SIMD 级别, 不会超过 CPU 实际支持的级别, 用于测试和性能对比
+    inline void SetSimdLevel(ESimdLevel level)
+    {
+        SimdLevelStorage() = std::min(level, DetectSimdLevel());
+    }
+
+    //! @brief 元素数量少于该值时直接逐元素计算, 省去分派的开销
+    constexpr int SimdMinSize = 16;
+
+    struct SimdPlus {
+        template <typename T, typename A, typename B>
+        static XTMB_ALWAYS_INLINE void Apply(T & z, A const & a, B const & b) { z = a + b; }
+    };
+
+    struct SimdMinus {
+        template <typename T, typename A, typename B>
+        static XTMB_ALWAYS_INLINE void Apply(T & z, A const & a, B const & b) { z = a - b; }
+    };
+
+    struct SimdMultiply {
+        template <typename T, typename A, typename B>
+        static XTMB_ALWAYS_INLINE void Apply(T & z, A const & a, B const & b) { z = a * b; }
+    };
+
+    struct SimdDivide {
+        template <typename T, typename A, typename B>
+        static XTMB_ALWAYS_INLINE void Apply(T & z, A const & a, B const & b) { z = a / b; }
+    };
+
+    //! @brief 宽度为 Bytes 字节的向量上的计算核心
+    //!
+    //! 主循环每次处理 W 个元素, 尾部不足 W 个的逐元素处理。
+    //! 归约使用两组累加器, 掩盖加法的延迟, 求和的顺序与逐元素累加不同。
+    template <typename Scalar, int Bytes>
+    struct SimdKernel {
+        typedef Scalar V __attribute__((vector_size(Bytes)));
+        constexpr static int W = Bytes / sizeof(Scalar);
+
+        static XTMB_ALWAYS_INLINE void Load(V & v, Scalar const * p)
+        {
+            std::memcpy(&v, p, sizeof(V));
+        }
+
+        static XTMB_ALWAYS_INLINE void Store(Scalar * p, V const & v)
+        {
+            std::memcpy(p, &v, sizeof(V));
+        }
+
+        //! @brief v = |v|
+        static XTMB_ALWAYS_INLINE void Abs(V & v)
+        {
+            V nv = -v;
+            v = (v > nv) ? v : nv;
+        }
+
+        static XTMB_ALWAYS_INLINE Scalar HorizontalSum(V const & v)
+        {
+            Scalar s = 0;
+            for (int l = 0; l < W; ++l)
+                s += v[l];
+            return s;
+        }
+
+        static XTMB_ALWAYS_INLINE Scalar HorizontalMax(V const & v)
+        {
+            Scalar s = v[0];
+            for (int l = 1; l < W; ++l)
+                s = std::max(s, Scalar(v[l]));
+            return s;
+        }
+
+        //! @brief z = op(x, y)
+        template <typename Op>
+        static XTMB_ALWAYS_INLINE void Map(int n, Scalar const * x, Scalar const * y, Scalar * z)
+        {
+            int i = 0;
+            for (; i + W <= n; i += W) {
+                V vx, vy;
+                Load(vx, x + i);
+                Load(vy, y + i);
+                Op::Apply(vx, vx, vy);
+                Store(z + i, vx);
+            }
+            for (; i < n; ++i)
+                Op::Apply(z[i], x[i], y[i]);
+        }
+
+        //! @brief z = a * x
+        static XTMB_ALWAYS_INLINE void Scale(int n, Scalar a, Scalar const * x, Scalar * z)
+        {
+            V va = V{} + a;
+            int i = 0;
+            for (; i + W <= n; i += W) {
+                V vx;
+                Load(vx, x + i);
+                Store(z + i, va * vx);
+            }
+            for (; i < n; ++i)
+                z[i] = a * x[i];
+        }
+
+        //! @brief y = a * x + y
+        static XTMB_ALWAYS_INLINE void Axpy(int n, Scalar a, Scalar const * x, Scalar * y)
+        {
+            V va = V{} + a;
+            int i = 0;
+            for (; i + W <= n; i += W) {
+                V vx, vy;
+                Load(vx, x + i);
+                Load(vy, y + i);
+                Store(y + i, va * vx + vy);
+            }
+            for (; i < n; ++i)
+                y[i] += a * x[i];
+        }
+
+        static XTMB_ALWAYS_INLINE Scalar Dot(int n, Scalar const * x, Scalar const * y)
+        {
+            V acc0 = {};
+            V acc1 = {};
+            int i = 0;
+            V x0, x1, y0, y1;
+            for (; i + 2 * W <= n; i += 2 * W) {
+                Load(x0, x + i);
+                Load(y0, y + i);
+                Load(x1, x + i + W);
+                Load(y1, y + i + W);
+                acc0 += x0 * y0;
+                acc1 += x1 * y1;
+            }
+            for (; i + W <= n; i += W) {
+                Load(x0, x + i);
+                Load(y0, y + i);
+                acc0 += x0 * y0;
+            }
+
+            Scalar s = HorizontalSum(acc0 + acc1);
+            for (; i < n; ++i)
+                s += x[i] * y[i];
+            return s;
+        }
+
+        //! @brief 一次遍历同时计算 x^T x, y^T y 和 x^T y
+        static XTMB_ALWAYS_INLINE void Gram2(int n, Scalar const * x, Scalar const * y,
+                                             Scalar & xx, Scalar & yy, Scalar & xy)
+        {
+            V axx = {}, ayy = {}, axy = {};
+            int i = 0;
+            for (; i + W <= n; i += W) {
+                V vx, vy;
+                Load(vx, x + i);
+                Load(vy, y + i);
+                axx += vx * vx;
+                ayy += vy * vy;
+                axy += vx * vy;
+            }
+            xx = HorizontalSum(axx);
+            yy = HorizontalSum(ayy);
+            xy = HorizontalSum(axy);
+            for (; i < n; ++i) {
+                xx += x[i] * x[i];
+                yy += y[i] * y[i];
+                xy += x[i] * y[i];
+            }
+        }
+
+        //! @brief 平面旋转 x = c x - s y, y = s x + c y
+        static XTMB_ALWAYS_INLINE void Rotate(int n, Scalar c, Scalar s, Scalar * x, Scalar * y)
+        {
+            V vc = V{} + c, vs = V{} + s;
+            int i = 0;
+            for (; i + W <= n; i += W) {
+                V vx, vy;
+                Load(vx, x + i);
+                Load(vy, y + i);
+                Store(x + i, vc * vx - vs * vy);
+                Store(y + i, vs * vx + vc * vy);
+            }
+            for (; i < n; ++i) {
+                Scalar a = x[i], b = y[i];
+                x[i] = c * a - s * b;
+                y[i] = s * a + c * b;
+            }
+        }
+
+        //! @brief 各元素绝对值之和
+        static XTMB_ALWAYS_INLINE Scalar SumAbs(int n, Scalar const * x)
+        {
+            V acc0 = {};
+            V acc1 = {};
+            int i = 0;
+            for (; i + 2 * W <= n; i += 2 * W) {
+                V a0, a1;
+                Load(a0, x + i);
+                Load(a1, x + i + W);
+                Abs(a0);
+                Abs(a1);
+                acc0 += a0;
+                acc1 += a1;
+            }
+            for (; i + W <= n; i += W) {
+                V a;
+                Load(a, x + i);
+                Abs(a);
+                acc0 += a;
+            }
+
+            Scalar s = HorizontalSum(acc0 + acc1);
+            for (; i < n; ++i)
+                s += std::abs(x[i]);
+            return s;
+        }
+
+        //! @brief 各元素绝对值的最大值
+        static XTMB_ALWAYS_INLINE Scalar MaxAbs(int n, Scalar const * x)
+        {
+            V acc = {};
+            int i = 0;
+            for (; i + W <= n; i += W) {
+                V a;
+                Load(a, x + i);
+                Abs(a);
+                acc = (a > acc) ? a : acc;
+            }
+
+            Scalar s = HorizontalMax(acc);
+            for (; i < n; ++i)
+                s = std::max(s, Scalar(std::abs(x[i])));
+            return s;
+        }
+    };
+
+    //! @brief 各个指令集的入口, 任务的 Run<Bytes>() 内联进来以后按照对应的指令集编译
+    template <typename Task>
+    __attribute__((target("sse2"))) void SimdRunSSE2(Task & task) { task.template Run<16>(); }
+
+    template <typename Task>
+    __attribute__((target("avx2,fma"))) void SimdRunAVX2(Task & task) { task.template Run<32>(); }
+
+    template <typename Task>
+    __attribute__((target("avx512f"))) void SimdRunAVX512(Task & task) { task.template Run<64>(); }
+
+    //! @brief 按照当前的 SIMD 级别执行任务
+    template <typename Task>
+    void SimdRun(Task & task)
+    {
+        typedef typename Task::Scalar Scalar;
+        switch (SimdLevel()) {
+            case ESimdLevel::eAVX512: SimdRunAVX512(task); break;
+            case ESimdLevel::eAVX2:   SimdRunAVX2(task);   break;
+            case ESimdLevel::eSSE2:   SimdRunSSE2(task);   break;
+            default:                  task.template Run<sizeof(Scalar)>(); break;
+        }
+    }
+
+    template <typename _Scalar, typename Op>
+    struct SimdMapTask {
+        typedef _Scalar Scalar;
+        int n;
+        Scalar const * x;
+        Scalar const * y;
+        Scalar * z;
+
+        template <int Bytes>
+        XTMB_ALWAYS_INLINE void Run() { SimdKernel<Scalar, Bytes>::template Map<Op>(n, x, y, z); }
+    };
+
+    template <typename _Scalar>
+    struct SimdScaleTask {
+        typedef _Scalar Scalar;
+        int n;
+        Scalar a;
+        Scalar const * x;
+        Scalar * z;
+
+        template <int Bytes>
+        XTMB_ALWAYS_INLINE void Run() { SimdKernel<Scalar, Bytes>::Scale(n, a, x, z); }
+    };
+
+    template <typename _Scalar>
+    struct SimdAxpyTask {
+        typedef _Scalar Scalar;
+        int n;
+        Scalar a;
+        Scalar const * x;
+        Scalar * y;
+
+        template <int Bytes>
+        XTMB_ALWAYS_INLINE void Run() { SimdKernel<Scalar, Bytes>::Axpy(n, a, x, y); }
+    };
+
+    template <typename _Scalar>
+    struct SimdDotTask {
+        typedef _Scalar Scalar;
+        int n;
+        Scalar const * x;
+        Scalar const * y;
+        Scalar re;
+
+        template <int Bytes>
+        XTMB_ALWAYS_INLINE void Run() { re = SimdKernel<Scalar, Bytes>::Dot(n, x, y); }
+    };
+
+    template <typename _Scalar>
+    struct SimdGram2Task {
+        typedef _Scalar Scalar;
+        int n;
+        Scalar const * x;
+        Scalar const * y;
+        Scalar xx, yy, xy;
+
+        template <int Bytes>
+        XTMB_ALWAYS_INLINE void Run() { SimdKernel<Scalar, Bytes>::Gram2(n, x, y, xx, yy, xy); }
+    };
+
+    template <typename _Scalar>
+    struct SimdRotateTask {
+        typedef _Scalar Scalar;
+        int n;
+        Scalar c, s;
+        Scalar * x;
+        Scalar * y;
+
+        template <int Bytes>
+        XTMB_ALWAYS_INLINE void Run() { SimdKernel<Scalar, Bytes>::Rotate(n, c, s, x, y); }
+    };
+
+    template <typename _Scalar>
+    struct SimdSumAbsTask {
+        typedef _Scalar Scalar;
+        int n;
+        Scalar const * x;
+        Scalar re;
+
+        template <int Bytes>
+        XTMB_ALWAYS_INLINE void Run() { re = SimdKernel<Scalar, Bytes>::SumAbs(n, x); }
+    };
+
+    template <typename _Scalar>
+    struct SimdMaxAbsTask {
+        typedef _Scalar Scalar;
+        int n;
+        Scalar const * x;
+        Scalar re;
+
+        template <int Bytes>
+        XTMB_ALWAYS_INLINE void Run() { re = SimdKernel<Scalar, Bytes>::MaxAbs(n, x); }
+    };
+
+    //! @brief z = op(x, y), op 为 SimdPlus, SimdMinus, SimdMultiply, SimdDivide, z 可以与 x, y 相同
+    template <typename Op, typename Scalar>
+    void SimdMap(int n, Scalar const * x, Scalar const * y, Scalar * z)
+    {
+        SimdMapTask<Scalar, Op> task{ n, x, y, z };
+        SimdRun(task);
+    }
+
+    //! @brief z = a * x, z 可以与 x 相同
+    template <typename Scalar>
+    void SimdScale(int n, Scalar a, Scalar const * x, Scalar * z)
+    {
+        SimdScaleTask<Scalar> task{ n, a, x, z };
+        SimdRun(task);
+    }
+
+    //! @brief y = a * x + y
+    template <typename Scalar>
+    void SimdAxpy(int n, Scalar a, Scalar const * x, Scalar * y)
+    {
+        SimdAxpyTask<Scalar> task{ n, a, x, y };
+        SimdRun(task);
+    }
+
+    //! @brief 内积 x^T y
+    template <typename Scalar>
+    Scalar SimdDot(int n, Scalar const * x, Scalar const * y)
+    {
+        SimdDotTask<Scalar> task{ n, x, y, Scalar(0) };
+        SimdRun(task);
+        return task.re;
+    }
+
+    //! @brief 一次遍历同时计算 x^T x, y^T y 和 x^T y
+    template <typename Scalar>
+    void SimdGram2(int n, Scalar const * x, Scalar const * y, Scalar & xx, Scalar & yy, Scalar & xy)
+    {
+        SimdGram2Task<Scalar> task{ n, x, y, Scalar(0), Scalar(0), Scalar(0) };
+        SimdRun(task);
+        xx = task.xx;
+        yy = task.yy;
+        xy = task.xy;
+    }
+
+    //! @brief 平面旋转 x = c x - s y, y = s x + c y
+    template <typename Scalar>
+    void SimdRotate(int n, Scalar c, Scalar s, Scalar * x, Scalar * y)
+    {
+        SimdRotateTask<Scalar> task{ n, c, s, x, y };
+        SimdRun(task);
+    }
+
+    //! @brief 各元素绝对值之和
+    template <typename Scalar>
+    Scalar SimdSumAbs(int n, Scalar const * x)
+    {
+        SimdSumAbsTask<Scalar> task{ n, x, Scalar(0) };
+        SimdRun(task);
+        return task.re;
+    }
+
+    //! @brief 各元素绝对值的最大值
+    template <typename Scalar>
+    Scalar SimdMaxAbs(int n, Scalar const * x)
+    {
+        SimdMaxAbsTask<Scalar> task{ n, x, Scalar(0) };
+        SimdRun(task);
+        return task.re;
+    }
+
+}
+
+#pragma GCC diagnostic pop
+
+#endif
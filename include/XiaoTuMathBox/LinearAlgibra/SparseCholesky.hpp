@@ -0,0 +1,859 @@
+#ifndef XTMB_LA_SPARSE_CHOLESKY_H
+#define XTMB_LA_SPARSE_CHOLESKY_H
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include <XiaoTuMathBox/LinearAlgibra/SparseMatrix.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/Cholesky.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LDLT.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 对称正定稀疏矩阵的超节点 Cholesky / LDLT 分解 P A P^T = L L^T 或 L D L^T
+//
+// 分为符号分解和数值分解两步, 稀疏模式不变时 (例如位姿图优化的每次迭代) 只需要重复数值分解:
+//   1. 近似最小度 (AMD) 排序, 减少 L 的填充;
+//   2. 消去树及其后序, L 各列的非零元素数量, 由此划分超节点, 即 L 中非零模式相同的相邻列,
+//      再把窄的超节点合并到父节点上 (relaxed amalgamation), 以少量显式的 0 换取更大的稠密块;
+//   3. 每个超节点的行号列表, 以及 A 的各个元素、子节点的更新矩阵在父节点中的位置。
+// 数值分解按多波前 (multifrontal) 的方式遍历超节点: 把 A 的元素和各个子节点的更新矩阵
+// 累加到列优先存储的稠密面板上, 对角块由 CholeskyBlocked / LDLTBlocked 分解, 下方由 Trsm 求解,
+// 更新矩阵由 SyrkLower 计算。按后序遍历时子节点的更新矩阵恰好位于栈顶, 栈的峰值在符号分解时确定。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 以 head, next 表示的森林中, 从 root 开始的非递归深度优先后序遍历
+    //!
+    //! @param [in] root 根节点
+    //! @param [in] k 后序的起始编号
+    //! @param [in|out] head 各节点的第一个子节点, 遍历过程中会被修改
+    //! @param [in] next 各节点的下一个兄弟节点
+    //! @param [out] post post[k] 为后序中第 k 个节点
+    //! @param [out] stack 工作数组, 不少于节点数量
+    //! @return 下一个后序编号
+    inline int TreePostorder(int root, int k, int * head, int const * next, int * post, int * stack)
+    {
+        int top = 0;
+        stack[0] = root;
+        while (top >= 0) {
+            int p = stack[top];
+            int i = head[p];
+            if (-1 == i) {
+                top--;
+                post[k++] = p;
+            } else {
+                head[p] = next[i];
+                stack[++top] = i;
+            }
+        }
+        return k;
+    }
+
+    //! @brief 近似最小度排序
+    //!
+    //! 算法思路见 Amestoy, Davis & Duff, "An approximate minimum degree ordering algorithm"。
+    //! 在商图 (quotient graph) 上模拟消元: 消去的节点 p 成为元素, 其边界 Lp 为 p 的邻居与相邻元素边界的并集,
+    //! 被并入 Lp 的元素随之失效。每个节点记录相邻的元素和相邻的节点, 每步从按度分桶的链表中取出近似外部度最小的节点。
+    //! 消去 p 之后只更新 Lp 中的节点:
+    //!   1. 删去已失效的元素, 以及已经由元素 p 覆盖的邻居;
+    //!   2. 邻接关系完全相同的节点合并为超变量, 一起排序, 候选的节点对先按邻接表之和分组;
+    //!   3. 度取 |Lp \ i| + |Ai| + sum |Le \ Lp| 的上界, 其中 |Le \ Lp| 由一次扫描得到,
+    //!      |Le \ Lp| 为 0 的元素已被 Lp 包含, 直接并入 p。
+    //! 度远大于平均值的稠密节点不参与消元, 放到最后。
+    //!
+    //! @param [in] n 矩阵尺寸
+    //! @param [in] outer, inner 压缩存储的稀疏模式, 使用 A + A^T 的模式, 对角线被忽略
+    //! @param [out] perm 排列, perm[k] 为排在第 k 位的原始下标
+    inline void AmdOrder(int n, int const * outer, int const * inner, std::vector<int> & perm)
+    {
+        perm.resize(n);
+        if (n <= 0)
+            return;
+
+        // A + A^T 中各个节点的邻居, 去掉对角线和重复的元素
+        std::vector<std::vector<int>> adj(n);
+        {
+            std::vector<int> count(n, 0);
+            for (int j = 0; j < n; j++)
+                for (int k = outer[j]; k < outer[j + 1]; k++)
+                    if (inner[k] != j) {
+                        count[inner[k]]++;
+                        count[j]++;
+                    }
+            for (int i = 0; i < n; i++)
+                adj[i].reserve(count[i]);
+        }
+        for (int j = 0; j < n; j++)
+            for (int k = outer[j]; k < outer[j + 1]; k++) {
+                int i = inner[k];
+                if (i == j)
+                    continue;
+                adj[i].push_back(j);
+                adj[j].push_back(i);
+            }
+        long total = 0;
+        for (auto & a : adj) {
+            std::sort(a.begin(), a.end());
+            a.erase(std::unique(a.begin(), a.end()), a.end());
+            total += (long)a.size();
+        }
+
+        // 节点的状态: 未消去的变量, 有效的元素, 以及失效的元素或被合并的变量
+        enum { Variable, Element, Dead };
+        std::vector<char> state(n, Variable);
+        std::vector<int> weight(n, 1);        // 超变量包含的节点数量
+        std::vector<int> degree(n);           // 近似外部度
+        std::vector<int> chain(n, -1);        // 合并到同一个超变量上的节点链表
+        std::vector<int> tail(n);
+        for (int i = 0; i < n; i++)
+            tail[i] = i;
+
+        // 稠密节点直接放到最后, 不再出现在其它节点的邻接表中
+        int denseLimit = std::max(64, (int)(8 * total / n));
+        std::vector<int> dense;
+        for (int i = 0; i < n; i++)
+            if ((int)adj[i].size() > denseLimit) {
+                state[i] = Dead;
+                weight[i] = 0;
+                dense.push_back(i);
+            }
+        if (!dense.empty()) {
+            for (auto & a : adj)
+                a.erase(std::remove_if(a.begin(), a.end(),
+                                       [&](int j) { return Dead == state[j]; }), a.end());
+        }
+
+        std::vector<std::vector<int>> nbrs(std::move(adj));   // 变量: 相邻的变量
+        std::vector<std::vector<int>> elems(n);               // 变量: 相邻的元素
+        std::vector<std::vector<int>> bound(n);               // 元素: 边界上的变量
+        std::vector<int> bsize(n, 0);                         // 元素: 边界上的节点数量
+
+        // 按度分桶的双向链表, 桶内的节点不分先后
+        std::vector<int> first(n + 1, -1), after(n, -1), before(n, -1);
+        auto unlink = [&](int i) {
+            if (before[i] >= 0)
+                after[before[i]] = after[i];
+            else
+                first[degree[i]] = after[i];
+            if (after[i] >= 0)
+                before[after[i]] = before[i];
+        };
+        auto link = [&](int i) {
+            before[i] = -1;
+            after[i] = first[degree[i]];
+            if (after[i] >= 0)
+                before[after[i]] = i;
+            first[degree[i]] = i;
+        };
+        int lowest = n;
+        for (int i = 0; i < n; i++)
+            if (Variable == state[i]) {
+                degree[i] = (int)nbrs[i].size();
+                link(i);
+                lowest = std::min(lowest, degree[i]);
+            }
+
+        std::vector<int> inLp(n, -1);         // 标记当前 Lp 中的节点
+        std::vector<int> seen(n, -1);         // 标记本轮扫描过的元素
+        std::vector<int> outside(n, 0);       // 本轮中 |Le \ Lp|
+        std::vector<int> Lp;
+        std::vector<std::pair<long, int>> keys;
+        std::vector<int> order;
+        order.reserve(n);
+        int remain = n - (int)dense.size();
+
+        while (remain > 0) {
+            while (first[lowest] < 0)
+                lowest++;
+            int p = first[lowest];
+            unlink(p);
+
+            // 消去 p, 构造新元素的边界 Lp, 与 p 相邻的元素并入 p
+            state[p] = Element;
+            remain -= weight[p];
+            for (int i = p; i >= 0; i = chain[i])
+                order.push_back(i);
+
+            Lp.clear();
+            for (int i : nbrs[p])
+                if (Variable == state[i] && inLp[i] != p) {
+                    inLp[i] = p;
+                    Lp.push_back(i);
+                }
+            for (int e : elems[p]) {
+                if (Element != state[e])
+                    continue;
+                for (int i : bound[e])
+                    if (Variable == state[i] && i != p && inLp[i] != p) {
+                        inLp[i] = p;
+                        Lp.push_back(i);
+                    }
+                state[e] = Dead;
+                std::vector<int>().swap(bound[e]);
+            }
+            std::vector<int>().swap(nbrs[p]);
+            std::vector<int>().swap(elems[p]);
+
+            // 删去失效的元素和 Lp 中的邻居, 再加上元素 p
+            keys.clear();
+            for (int i : Lp) {
+                unlink(i);
+                auto & ei = elems[i];
+                ei.erase(std::remove_if(ei.begin(), ei.end(),
+                                        [&](int e) { return Element != state[e]; }), ei.end());
+                ei.push_back(p);
+                auto & vi = nbrs[i];
+                vi.erase(std::remove_if(vi.begin(), vi.end(),
+                                        [&](int j) { return Variable != state[j] || inLp[j] == p; }), vi.end());
+                long h = 0;
+                for (int e : ei)
+                    h += e;
+                for (int j : vi)
+                    h += j;
+                keys.push_back(std::make_pair(h, i));
+            }
+
+            // 邻接表之和相同的节点才可能合并为超变量
+            std::sort(keys.begin(), keys.end());
+            for (int a = 0; a < (int)keys.size(); ) {
+                int b = a + 1;
+                while (b < (int)keys.size() && keys[b].first == keys[a].first)
+                    b++;
+                if (b - a > 1) {
+                    for (int x = a; x < b; x++) {
+                        std::sort(elems[keys[x].second].begin(), elems[keys[x].second].end());
+                        std::sort(nbrs[keys[x].second].begin(), nbrs[keys[x].second].end());
+                    }
+                    for (int x = a; x < b; x++) {
+                        int i = keys[x].second;
+                        if (Variable != state[i])
+                            continue;
+                        for (int y = x + 1; y < b; y++) {
+                            int j = keys[y].second;
+                            if (Variable != state[j] || elems[i] != elems[j] || nbrs[i] != nbrs[j])
+                                continue;
+                            weight[i] += weight[j];
+                            weight[j] = 0;
+                            state[j] = Dead;
+                            chain[tail[i]] = j;
+                            tail[i] = tail[j];
+                            std::vector<int>().swap(elems[j]);
+                            std::vector<int>().swap(nbrs[j]);
+                        }
+                    }
+                }
+                a = b;
+            }
+            Lp.erase(std::remove_if(Lp.begin(), Lp.end(),
+                                    [&](int i) { return Variable != state[i]; }), Lp.end());
+            int wLp = 0;
+            for (int i : Lp)
+                wLp += weight[i];
+            bound[p] = Lp;
+            bsize[p] = wLp;
+
+            // |Le \ Lp| = |Le| 减去 Lp 中与 e 相邻的节点数
+            for (int i : Lp)
+                for (int e : elems[i]) {
+                    if (e == p)
+                        continue;
+                    if (seen[e] != p) {
+                        seen[e] = p;
+                        outside[e] = bsize[e];
+                    }
+                    outside[e] -= weight[i];
+                }
+
+            for (int i : Lp) {
+                long d = wLp - weight[i];
+                for (int j : nbrs[i])
+                    d += weight[j];
+                for (int e : elems[i]) {
+                    if (e == p || Element != state[e])
+                        continue;
+                    if (outside[e] <= 0) {
+                        // e 被 Lp 包含, 并入 p
+                        state[e] = Dead;
+                        std::vector<int>().swap(bound[e]);
+                        continue;
+                    }
+                    d += outside[e];
+                }
+                d = std::min<long>(d, (long)degree[i] + wLp - weight[i]);
+                d = std::min<long>(d, remain - weight[i]);
+                degree[i] = (int)std::max<long>(d, 0);
+                link(i);
+                lowest = std::min(lowest, degree[i]);
+            }
+        }
+
+        std::copy(order.begin(), order.end(), perm.begin());
+        std::copy(dense.begin(), dense.end(), perm.begin() + order.size());
+    }
+
+    /**
+     * @brief 对称正定稀疏矩阵的超节点分解 P A P^T = L L^T 或 L D L^T
+     *
+     * 只读取 A 的下三角, 即行号不小于列号的元素, 上三角可以存储也可以不存储。
+     * Analyze 完成排序和符号分解, Factorize 完成数值分解, 稀疏模式不变时可以只重复调用 Factorize,
+     * 所有的数组都在 Analyze 时确定尺寸, Factorize 不再申请内存。
+     * 通常通过 SparseCholesky, SparseLDLT 使用。
+     */
+    template <typename Scalar, bool UseLDLT>
+    class SparseSupernodal {
+        public:
+            //! @brief 对角块分解的分块大小
+            constexpr static int BlockSize = 64;
+
+            //! @brief 默认构造函数, 之后通过 Decompose 或者 Analyze, Factorize 分解
+            SparseSupernodal()
+            {}
+
+            explicit SparseSupernodal(SparseCSC<Scalar> const & a, bool amd = true)
+            {
+                Decompose(a, amd);
+            }
+
+            //! @brief 符号分解和数值分解
+            void Decompose(SparseCSC<Scalar> const & a, bool amd = true)
+            {
+                Analyze(a, amd);
+                Factorize(a);
+            }
+
+            /**
+             * @brief 符号分解, 只用到 a 的稀疏模式
+             *
+             * @param [in] a 对称矩阵, 只读取下三角的模式
+             * @param [in] amd 是否用 AMD 排序, 否则保持原来的顺序 (仍然按消去树后序重排)
+             */
+            void Analyze(SparseCSC<Scalar> const & a, bool amd = true)
+            {
+                assert(a.Rows() == a.Cols());
+                int n = a.Rows();
+                mN = n;
+                mNnzA = a.NonZeros();
+                int const * Ap = a.OuterIndex();
+                int const * Ai = a.InnerIndex();
+
+                std::vector<int> perm;
+                if (amd) {
+                    AmdOrder(n, Ap, Ai, perm);
+                } else {
+                    perm.resize(n);
+                    for (int k = 0; k < n; k++)
+                        perm[k] = k;
+                }
+
+                // 消去树和各列的非零元素数量, 再按消去树的后序重排, 使每个超节点的列连续
+                std::vector<int> parent, cnt;
+                EliminationTree(a, perm, parent, cnt);
+                std::vector<int> head(n, -1), next(n, -1), post(n), stack(n);
+                for (int j = n - 1; j >= 0; j--)
+                    if (-1 != parent[j]) {
+                        next[j] = head[parent[j]];
+                        head[parent[j]] = j;
+                    }
+                for (int k = 0, j = 0; j < n; j++)
+                    if (-1 == parent[j])
+                        k = TreePostorder(j, k, head.data(), next.data(), post.data(), stack.data());
+
+                std::vector<int> ipost(n);
+                for (int k = 0; k < n; k++)
+                    ipost[post[k]] = k;
+                mPerm.resize(n);
+                std::vector<int> par(n), count(n);
+                for (int k = 0; k < n; k++) {
+                    mPerm[k] = perm[post[k]];
+                    int pk = parent[post[k]];
+                    par[k] = (-1 == pk) ? -1 : ipost[pk];
+                    count[k] = cnt[post[k]];
+                }
+
+                Supernodes(par, count);
+                Structure(a);
+            }
+
+            /**
+             * @brief 数值分解, a 的稀疏模式必须与 Analyze 时相同
+             *
+             * @param [in] a 对称正定矩阵, 只读取下三角
+             */
+            void Factorize(SparseCSC<Scalar> const & a)
+            {
+                assert(a.Rows() == mN && a.NonZeros() == mNnzA);
+                std::fill(mLx.begin(), mLx.end(), Scalar(0));
+                Scalar const * Av = a.Values();
+                for (int p = 0; p < mNnzA; p++)
+                    if (mDest[p] >= 0)
+                        mLx[mDest[p]] += Av[p];
+
+                int nsup = NumSupernodes();
+                std::size_t top = 0;
+                for (int s = 0; s < nsup; s++) {
+                    int f = mSuper[s];
+                    int w = mSuper[s + 1] - f;
+                    int m = mRowPtr[s + 1] - mRowPtr[s];
+                    int ns = m - w;
+                    Scalar * P = mLx.data() + mLxPtr[s];
+                    Scalar * U = mStack.data() + top;
+                    std::fill(U, U + (std::size_t)ns * ns, Scalar(0));
+
+                    for (int q = mChildPtr[s]; q < mChildPtr[s + 1]; q++)
+                        ExtendAdd(mChild[q], w, m, P, U);
+
+                    if constexpr (UseLDLT) {
+                        Scalar * d = mD.data() + f;
+                        LDLTBlocked(w, P, 1, m, d, BlockSize);
+                        if (ns > 0) {
+                            // 单位下三角的 Trsm 得到 L21 D, V = L21 D^{1/2} 用于对称的更新
+                            Trsm(true, true, w, ns, P, 1, m, P + w, m, 1);
+                            WorkspaceFrame frame;
+                            Scalar * V = frame.Alloc<Scalar>((std::size_t)ns * w);
+                            for (int c = 0; c < w; c++) {
+                                Scalar sc = 1 / std::sqrt(d[c]);
+                                Scalar inv = 1 / d[c];
+                                Scalar * l = P + w + (std::size_t)c * m;
+                                Scalar * v = V + (std::size_t)c * ns;
+                                for (int i = 0; i < ns; i++) {
+                                    v[i] = l[i] * sc;
+                                    l[i] *= inv;
+                                }
+                            }
+                            SyrkLower(ns, w, Scalar(-1), V, 1, ns, Scalar(1), U, 1, ns);
+                        }
+                    } else {
+                        CholeskyBlocked(w, P, 1, m, BlockSize);
+                        if (ns > 0) {
+                            Trsm(true, false, w, ns, P, 1, m, P + w, m, 1);
+                            SyrkLower(ns, w, Scalar(-1), P + w, 1, m, Scalar(1), U, 1, ns);
+                        }
+                    }
+
+                    // 子节点的更新矩阵已经用完, 把 U 挪到它们的位置上
+                    Scalar * dst = mStack.data() + mUOff[s];
+                    if (dst != U)
+                        std::copy(U, U + (std::size_t)ns * ns, dst);
+                    top = mUOff[s] + (std::size_t)ns * ns;
+                }
+            }
+
+            /**
+             * @brief 求解方程组 A x = b, b 和 x 可以是同一个对象
+             *
+             * 先按排列拷贝到临时矩阵中, 逐个超节点前代、回代, 对角块由 Trsm 求解,
+             * 非对角块通过 Gemm 更新, 所有的右端项一起计算。
+             *
+             * @param [in] b 方程右侧的矩阵, 每一列为一个右端项
+             * @param [out] x 对应 b 中每一列的解, 需要与 b 的尺寸相同
+             */
+            template <typename MatrixB, typename MatrixX>
+            void Solve(MatrixB const & b, MatrixX & x)
+            {
+                assert(b.Rows() == mN && x.Rows() == mN && x.Cols() == b.Cols());
+                int n = mN;
+                int nrhs = b.Cols();
+                DMatrix<Scalar> tmp(n, nrhs);
+                for (int j = 0; j < nrhs; j++)
+                    for (int k = 0; k < n; k++)
+                        tmp(k, j) = b(mPerm[k], j);
+
+                Scalar * X = tmp.StorBegin();
+                WorkspaceFrame frame;
+                Scalar * T = frame.Alloc<Scalar>((std::size_t)mMaxStruct * nrhs + 1);
+                int nsup = NumSupernodes();
+
+                // L y = b
+                for (int s = 0; s < nsup; s++) {
+                    int f = mSuper[s];
+                    int w = mSuper[s + 1] - f;
+                    int m = mRowPtr[s + 1] - mRowPtr[s];
+                    int ns = m - w;
+                    Scalar const * P = mLx.data() + mLxPtr[s];
+                    int const * rows = mRows.data() + mRowPtr[s] + w;
+                    Trsm(true, UseLDLT, w, nrhs, P, 1, m, X + f, 1, n);
+                    if (0 == ns)
+                        continue;
+                    Gemm(ns, nrhs, w, Scalar(1), P + w, 1, m, X + f, 1, n, Scalar(0), T, 1, ns);
+                    for (int j = 0; j < nrhs; j++)
+                        for (int i = 0; i < ns; i++)
+                            X[rows[i] + (std::size_t)j * n] -= T[i + (std::size_t)j * ns];
+                }
+
+                if constexpr (UseLDLT) {
+                    for (int j = 0; j < nrhs; j++)
+                        for (int k = 0; k < n; k++)
+                            X[k + (std::size_t)j * n] /= mD[k];
+                }
+
+                // L^T x = y, 交换 L 的行列步长
+                for (int s = nsup - 1; s >= 0; s--) {
+                    int f = mSuper[s];
+                    int w = mSuper[s + 1] - f;
+                    int m = mRowPtr[s + 1] - mRowPtr[s];
+                    int ns = m - w;
+                    Scalar const * P = mLx.data() + mLxPtr[s];
+                    int const * rows = mRows.data() + mRowPtr[s] + w;
+                    if (ns > 0) {
+                        for (int j = 0; j < nrhs; j++)
+                            for (int i = 0; i < ns; i++)
+                                T[i + (std::size_t)j * ns] = X[rows[i] + (std::size_t)j * n];
+                        Gemm(w, nrhs, ns, Scalar(-1), P + w, m, 1, T, 1, ns, Scalar(1), X + f, 1, n);
+                    }
+                    Trsm(false, UseLDLT, w, nrhs, P, m, 1, X + f, 1, n);
+                }
+
+                for (int j = 0; j < nrhs; j++)
+                    for (int k = 0; k < n; k++)
+                        x(mPerm[k], j) = tmp(k, j);
+            }
+
+        private:
+            //! @brief P A P^T 的消去树, 以及 L 各列对角线以下的非零元素数量
+            //!
+            //! 第 k 行的非零模式是从 A(k, j), j < k 出发沿消去树向上直到 k 的路径的并集 (行子树),
+            //! 逐行遍历行子树, 途中设置尚未确定的父节点, 参考 Davis 的 LDL。时间为 O(nnz(L))。
+            void EliminationTree(SparseCSC<Scalar> const & a, std::vector<int> const & perm,
+                                 std::vector<int> & parent, std::vector<int> & cnt)
+            {
+                int n = mN;
+                std::vector<int> pinv(n);
+                for (int k = 0; k < n; k++)
+                    pinv[perm[k]] = k;
+
+                // 下三角按行存储, 第 r 行为 P A P^T 中 r 行对角线左侧的各列
+                int const * Ap = a.OuterIndex();
+                int const * Ai = a.InnerIndex();
+                std::vector<int> Rp(n + 1, 0);
+                for (int j = 0; j < n; j++)
+                    for (int p = Ap[j]; p < Ap[j + 1]; p++)
+                        if (Ai[p] > j)
+                            Rp[std::max(pinv[Ai[p]], pinv[j]) + 1]++;
+                for (int k = 0; k < n; k++)
+                    Rp[k + 1] += Rp[k];
+                std::vector<int> Rj(Rp[n]);
+                {
+                    std::vector<int> pos(Rp.begin(), Rp.end() - 1);
+                    for (int j = 0; j < n; j++)
+                        for (int p = Ap[j]; p < Ap[j + 1]; p++)
+                            if (Ai[p] > j) {
+                                int r = pinv[Ai[p]], c = pinv[j];
+                                Rj[pos[std::max(r, c)]++] = std::min(r, c);
+                            }
+                }
+
+                parent.assign(n, -1);
+                cnt.assign(n, 0);
+                std::vector<int> flag(n);
+                for (int k = 0; k < n; k++) {
+                    flag[k] = k;
+                    for (int p = Rp[k]; p < Rp[k + 1]; p++) {
+                        for (int i = Rj[p]; flag[i] != k; i = parent[i]) {
+                            if (-1 == parent[i])
+                                parent[i] = k;
+                            cnt[i]++;
+                            flag[i] = k;
+                        }
+                    }
+                }
+            }
+
+            //! @brief 合并超节点的条件, 合并后越宽, 允许的显式 0 的比例越低
+            //!
+            //! 比 CHOLMOD 的默认值保守: 在二维、三维网格上的测试中, 大量合并并不能加快分解,
+            //! 反而显著增加 L 的存储, 所以只合并新增 0 很少的超节点。
+            static bool Relaxed(int w, double zfrac)
+            {
+                if (w <= 16)
+                    return zfrac < 0.2;
+                if (w <= 48)
+                    return zfrac < 0.05;
+                return zfrac < 0.02;
+            }
+
+            /**
+             * @brief 划分超节点
+             *
+             * 列 j 与 j+1 属于同一个基本超节点, 当且仅当 j+1 是 j 在消去树上唯一的子节点的父节点,
+             * 且 cnt[j] = cnt[j+1] + 1, 即两列的非零模式相同。
+             * 之后从后往前, 把紧邻在前面的子超节点合并进来, 子节点的每一列补齐为父节点的模式,
+             * 由于 struct(子) ⊆ 父节点的列 ∪ struct(父), 合并后父节点的行结构不变, 新增的 0 可以直接算出。
+             */
+            void Supernodes(std::vector<int> const & parent, std::vector<int> const & cnt)
+            {
+                int n = mN;
+                std::vector<int> nchild(n, 0);
+                for (int j = 0; j < n; j++)
+                    if (-1 != parent[j])
+                        nchild[parent[j]]++;
+
+                std::vector<int> first;
+                for (int j = 0; j < n; j++)
+                    if (0 == j || !(parent[j - 1] == j && cnt[j - 1] == cnt[j] + 1 && 1 == nchild[j]))
+                        first.push_back(j);
+                first.push_back(n);
+
+                int nf = (int)first.size() - 1;
+                mSuper.clear();
+                if (nf > 0) {
+                    int bf = first[nf - 1], bl = n - 1;
+                    double bz = 0;
+                    mSuper.push_back(n);
+                    for (int b = nf - 2; b >= 0; b--) {
+                        int pf = first[b], pl = first[b + 1] - 1;
+                        int q = parent[pl];
+                        if (q >= bf && q <= bl) {
+                            double wp = pl - pf + 1, wb = bl - bf + 1;
+                            double nb = cnt[bl], np = cnt[pl];
+                            double w = wp + wb;
+                            double z = bz + wp * (wb + nb - np);
+                            double total = w * (w + 1) / 2 + w * nb;
+                            if (Relaxed((int)w, z / total)) {
+                                bf = pf;
+                                bz = z;
+                                continue;
+                            }
+                        }
+                        mSuper.push_back(bf);
+                        bf = pf;
+                        bl = pl;
+                        bz = 0;
+                    }
+                    mSuper.push_back(bf);
+                    std::reverse(mSuper.begin(), mSuper.end());
+                } else {
+                    mSuper.push_back(0);
+                }
+
+                int nsup = NumSupernodes();
+                mColSuper.resize(n);
+                for (int s = 0; s < nsup; s++)
+                    for (int j = mSuper[s]; j < mSuper[s + 1]; j++)
+                        mColSuper[j] = s;
+
+                mParent.resize(nsup);
+                mChildPtr.assign(nsup + 1, 0);
+                for (int s = 0; s < nsup; s++) {
+                    int q = parent[mSuper[s + 1] - 1];
+                    mParent[s] = (-1 == q) ? -1 : mColSuper[q];
+                    if (-1 != mParent[s])
+                        mChildPtr[mParent[s] + 1]++;
+                }
+                for (int s = 0; s < nsup; s++)
+                    mChildPtr[s + 1] += mChildPtr[s];
+                mChild.resize(mChildPtr[nsup]);
+                std::vector<int> pos(mChildPtr.begin(), mChildPtr.end() - 1);
+                for (int s = 0; s < nsup; s++)
+                    if (-1 != mParent[s])
+                        mChild[pos[mParent[s]]++] = s;
+            }
+
+            /**
+             * @brief 各个超节点的行结构、面板的位置、A 中各元素的目标位置, 以及更新矩阵的栈
+             *
+             * 超节点 s 的行号列表以它自己的各列开头, 之后是升序排列的 struct(s),
+             * 由 A 中这些列的下三角元素和各个子节点的 struct 合并而成。
+             * 子节点 struct 中的每一行在父节点列表中的位置记录在 mRel 中, 用于 ExtendAdd。
+             */
+            void Structure(SparseCSC<Scalar> const & a)
+            {
+                int n = mN;
+                int nsup = NumSupernodes();
+                std::vector<int> pinv(n);
+                for (int k = 0; k < n; k++)
+                    pinv[mPerm[k]] = k;
+
+                // P A P^T 的下三角按列存储, 同时记录元素在 A 中的下标
+                int const * Ap = a.OuterIndex();
+                int const * Ai = a.InnerIndex();
+                std::vector<int> Cp(n + 1, 0);
+                for (int j = 0; j < n; j++)
+                    for (int p = Ap[j]; p < Ap[j + 1]; p++)
+                        if (Ai[p] >= j)
+                            Cp[std::min(pinv[Ai[p]], pinv[j]) + 1]++;
+                for (int k = 0; k < n; k++)
+                    Cp[k + 1] += Cp[k];
+                std::vector<int> Ci(Cp[n]), Cs(Cp[n]);
+                {
+                    std::vector<int> pos(Cp.begin(), Cp.end() - 1);
+                    for (int j = 0; j < n; j++)
+                        for (int p = Ap[j]; p < Ap[j + 1]; p++)
+                            if (Ai[p] >= j) {
+                                int r = pinv[Ai[p]], c = pinv[j];
+                                int q = pos[std::min(r, c)]++;
+                                Ci[q] = std::max(r, c);
+                                Cs[q] = p;
+                            }
+                }
+
+                mRowPtr.assign(nsup + 1, 0);
+                mRows.clear();
+                mMaxStruct = 0;
+                std::vector<int> flag(n, -1);
+                for (int s = 0; s < nsup; s++) {
+                    int f = mSuper[s], l = mSuper[s + 1] - 1;
+                    mRowPtr[s] = (int)mRows.size();
+                    for (int c = f; c <= l; c++) {
+                        mRows.push_back(c);
+                        flag[c] = s;
+                    }
+                    std::size_t st = mRows.size();
+                    for (int c = f; c <= l; c++)
+                        for (int q = Cp[c]; q < Cp[c + 1]; q++) {
+                            int r = Ci[q];
+                            if (r > l && flag[r] != s) {
+                                flag[r] = s;
+                                mRows.push_back(r);
+                            }
+                        }
+                    for (int q = mChildPtr[s]; q < mChildPtr[s + 1]; q++) {
+                        int ch = mChild[q];
+                        int b = mRowPtr[ch] + (mSuper[ch + 1] - mSuper[ch]);
+                        for (int k = b; k < mRowPtr[ch + 1]; k++) {
+                            int r = mRows[k];
+                            if (r > l && flag[r] != s) {
+                                flag[r] = s;
+                                mRows.push_back(r);
+                            }
+                        }
+                    }
+                    std::sort(mRows.begin() + st, mRows.end());
+                    mMaxStruct = std::max(mMaxStruct, (int)(mRows.size() - st));
+                }
+                mRowPtr[nsup] = (int)mRows.size();
+
+                // 面板和更新矩阵的位置, 模拟数值分解中栈的变化
+                mLxPtr.resize(nsup + 1);
+                mUOff.resize(nsup);
+                mLxPtr[0] = 0;
+                std::size_t top = 0, peak = 0;
+                for (int s = 0; s < nsup; s++) {
+                    std::size_t w = mSuper[s + 1] - mSuper[s];
+                    std::size_t m = mRowPtr[s + 1] - mRowPtr[s];
+                    std::size_t size = (m - w) * (m - w);
+                    mLxPtr[s + 1] = mLxPtr[s] + m * w;
+                    std::size_t base = top;
+                    if (mChildPtr[s] < mChildPtr[s + 1])
+                        base = mUOff[mChild[mChildPtr[s]]];
+                    peak = std::max(peak, top + size);
+                    mUOff[s] = base;
+                    top = base + size;
+                }
+                mLx.resize(mLxPtr[nsup]);
+                mStack.resize(peak);
+                if constexpr (UseLDLT)
+                    mD.resize(n);
+
+                // A 的元素在面板中的位置, 子节点 struct 在父节点中的位置
+                mDest.assign(mNnzA, -1);
+                mRel.assign(mRows.size(), 0);
+                std::vector<int> loc(n);
+                for (int s = 0; s < nsup; s++) {
+                    int f = mSuper[s];
+                    int m = mRowPtr[s + 1] - mRowPtr[s];
+                    for (int k = mRowPtr[s]; k < mRowPtr[s + 1]; k++)
+                        loc[mRows[k]] = k - mRowPtr[s];
+                    for (int c = f; c < mSuper[s + 1]; c++)
+                        for (int q = Cp[c]; q < Cp[c + 1]; q++)
+                            mDest[Cs[q]] = (long)(mLxPtr[s] + loc[Ci[q]] + (std::size_t)(c - f) * m);
+                    for (int q = mChildPtr[s]; q < mChildPtr[s + 1]; q++) {
+                        int ch = mChild[q];
+                        int b = mRowPtr[ch] + (mSuper[ch + 1] - mSuper[ch]);
+                        for (int k = b; k < mRowPtr[ch + 1]; k++)
+                            mRel[k] = loc[mRows[k]];
+                    }
+                }
+            }
+
+            /**
+             * @brief 把子节点 c 的更新矩阵累加到当前超节点上
+             *
+             * 更新矩阵 Uc 对应 struct(c) x struct(c) 的下三角, 列落在当前超节点各列上的累加到面板 P,
+             * 其余累加到当前的更新矩阵 U。mRel 单调递增, 下三角仍然映射到下三角。各列的目标互不相同, 按列并行。
+             */
+            void ExtendAdd(int c, int w, int m, Scalar * P, Scalar * U)
+            {
+                int wc = mSuper[c + 1] - mSuper[c];
+                int nc = mRowPtr[c + 1] - mRowPtr[c] - wc;
+                int ns = m - w;
+                Scalar const * Uc = mStack.data() + mUOff[c];
+                int const * rel = mRel.data() + mRowPtr[c] + wc;
+                ParallelFor(0, nc, ParallelGrain(nc, 1, 64), [&](int b, int e) {
+                    for (int jj = b; jj < e; jj++) {
+                        int tc = rel[jj];
+                        Scalar const * u = Uc + (std::size_t)jj * nc;
+                        if (tc < w) {
+                            Scalar * dst = P + (std::size_t)tc * m;
+                            for (int ii = jj; ii < nc; ii++)
+                                dst[rel[ii]] += u[ii];
+                        } else {
+                            Scalar * dst = U + (std::size_t)(tc - w) * ns;
+                            for (int ii = jj; ii < nc; ii++)
+                                dst[rel[ii] - w] += u[ii];
+                        }
+                    }
+                });
+            }
+
+        public:
+            int Rows() const { return mN; }
+            //! @brief 超节点的数量
+            int NumSupernodes() const { return (int)mSuper.size() - 1; }
+            //! @brief L 中存储的元素数量, 包括对角线以及合并超节点时引入的 0
+            long NonZerosL() const
+            {
+                long nnz = 0;
+                for (int s = 0; s < NumSupernodes(); s++) {
+                    long w = mSuper[s + 1] - mSuper[s];
+                    long m = mRowPtr[s + 1] - mRowPtr[s];
+                    nnz += w * (w + 1) / 2 + w * (m - w);
+                }
+                return nnz;
+            }
+            //! @brief 排列, perm[k] 为排在第 k 位的原始下标
+            std::vector<int> const & Permutation() const { return mPerm; }
+
+        private:
+            int mN = 0;
+            int mNnzA = 0;
+            std::vector<int> mPerm;
+            //! @brief 各超节点的起始列, NumSupernodes() + 1 个元素
+            std::vector<int> mSuper;
+            std::vector<int> mColSuper;
+            std::vector<int> mParent;
+            std::vector<int> mChildPtr;
+            std::vector<int> mChild;
+            //! @brief 各超节点的行号列表
+            std::vector<int> mRowPtr;
+            std::vector<int> mRows;
+            //! @brief struct 中各行在父节点行号列表中的位置
+            std::vector<int> mRel;
+            int mMaxStruct = 0;
+            //! @brief 各超节点的面板, m x w 列优先存储
+            std::vector<std::size_t> mLxPtr;
+            std::vector<Scalar> mLx;
+            std::vector<Scalar> mD;
+            //! @brief A 中各元素在 mLx 中的位置, 上三角的元素为 -1
+            std::vector<long> mDest;
+            //! @brief 更新矩阵的栈, 及各超节点的更新矩阵在栈中的位置
+            std::vector<std::size_t> mUOff;
+            std::vector<Scalar> mStack;
+    };
+
+    //! @brief 稀疏矩阵的超节点 Cholesky 分解 P A P^T = L L^T
+    template <typename Scalar>
+    using SparseCholesky = SparseSupernodal<Scalar, false>;
+
+    //! @brief 稀疏矩阵的超节点 LDLT 分解 P A P^T = L D L^T
+    template <typename Scalar>
+    using SparseLDLT = SparseSupernodal<Scalar, true>;
+
+}
+
+#endif
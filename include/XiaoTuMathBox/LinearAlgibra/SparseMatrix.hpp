@@ -0,0 +1,550 @@
+#ifndef XTMB_LA_SPARSE_MATRIX_H
+#define XTMB_LA_SPARSE_MATRIX_H
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include <XiaoTuMathBox/LinearAlgibra/Gemm.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 压缩存储的稀疏矩阵 CSR / CSC
+//
+// 有限元、图等问题的矩阵每行只有十个左右的非零元素, 稠密存储需要 O(n^2) 的内存,
+// 压缩存储只需要 O(nnz)。按主维度 (行优先时为行, 列优先时为列) 压缩:
+//   outer[o] .. outer[o+1] 是第 o 行 (列) 的非零元素在 inner, values 中的区间,
+//   inner 为其列 (行) 号, 每一段内升序排列且不重复。
+// 通过 SparseTriplets 逐个添加 (r, c, v) 三元组, 再一次性压缩, 重复的元素相加。
+//
+// 与稠密矩阵相乘时, 沿主维度的方向是收集 (gather), 各行 (列) 互不依赖, 直接按主维度并行;
+// 另一个方向是分散 (scatter), 多个线程写同一个输出, 每个线程先累加到私有的缓存中再归约。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    template <typename _Scalar, EAlignType _align>
+    struct Traits<SparseMatrix<_Scalar, _align>> {
+        typedef _Scalar Scalar;
+        constexpr static EAlignType Align = _align;
+        constexpr static EStoreType Store = EStoreType::eStoreSparse;
+    };
+
+    template <typename _Scalar, EAlignType _align>
+    struct Traits<const SparseMatrix<_Scalar, _align>> {
+        typedef _Scalar Scalar;
+        constexpr static EAlignType Align = _align;
+        constexpr static EStoreType Store = EStoreType::eStoreSparse;
+    };
+
+    /**
+     * @brief 稀疏矩阵的三元组 (r, c, v) 列表, 用于构造 SparseMatrix
+     *
+     * 以三个数组分别保存行号、列号和数值, 添加的顺序任意, 允许重复。
+     */
+    template <typename Scalar>
+    class SparseTriplets {
+        public:
+            SparseTriplets()
+                : mRows(0), mCols(0)
+            {}
+
+            /**
+             * @brief 构造函数
+             *
+             * @param [in] rows 行数
+             * @param [in] cols 列数
+             * @param [in] reserve 预计的三元组数量
+             */
+            SparseTriplets(int rows, int cols, int reserve = 0)
+                : mRows(rows), mCols(cols)
+            {
+                Reserve(reserve);
+            }
+
+            void Reserve(int n)
+            {
+                mR.reserve(n);
+                mC.reserve(n);
+                mV.reserve(n);
+            }
+
+            //! @brief 清空所有三元组, 保留尺寸和容量
+            void Clear()
+            {
+                mR.clear();
+                mC.clear();
+                mV.clear();
+            }
+
+            //! @brief 添加元素 (r, c) += v
+            void Add(int r, int c, Scalar v)
+            {
+                assert(r >= 0 && r < mRows && c >= 0 && c < mCols);
+                mR.push_back(r);
+                mC.push_back(c);
+                mV.push_back(v);
+            }
+
+            int Rows() const { return mRows; }
+            int Cols() const { return mCols; }
+            int Size() const { return (int)mV.size(); }
+            int Row(int i) const { return mR[i]; }
+            int Col(int i) const { return mC[i]; }
+            Scalar Value(int i) const { return mV[i]; }
+
+        private:
+            int mRows;
+            int mCols;
+            std::vector<int> mR;
+            std::vector<int> mC;
+            std::vector<Scalar> mV;
+    };
+
+    /**
+     * @brief 压缩存储的稀疏矩阵
+     *
+     * Align 为 eRowMajor 时是 CSR, 为 eColMajor 时是 CSC, 通常通过 SparseCSR, SparseCSC 使用。
+     * 只提供只读的元素访问, 修改稀疏模式需要重新从三元组构造; 模式不变时可以通过 Values() 直接改写数值。
+     */
+    template <typename Scalar, EAlignType Align>
+    class SparseMatrix {
+        public:
+            constexpr static EStoreType Store = EStoreType::eStoreSparse;
+            constexpr static bool IsRowMajor = (EAlignType::eRowMajor == Align);
+
+            SparseMatrix()
+                : mRows(0), mCols(0), mOuter(1, 0)
+            {}
+
+            //! @brief 构造 rows x cols 的零矩阵
+            SparseMatrix(int rows, int cols)
+                : mRows(rows), mCols(cols), mOuter((IsRowMajor ? rows : cols) + 1, 0)
+            {}
+
+            explicit SparseMatrix(SparseTriplets<Scalar> const & t)
+            {
+                SetFromTriplets(t);
+            }
+
+            //! @brief CSR 与 CSC 之间的转换
+            template <EAlignType A2, typename = typename std::enable_if<A2 != Align>::type>
+            explicit SparseMatrix(SparseMatrix<Scalar, A2> const & other)
+            {
+                mRows = other.Rows();
+                mCols = other.Cols();
+                Transpose(other.OuterSize(), other.InnerSize(), other.OuterIndex(), other.InnerIndex(), other.Values());
+            }
+
+            /**
+             * @brief 从稠密矩阵构造, 丢弃绝对值不超过 drop 的元素
+             *
+             * @param [in] a 稠密矩阵, 可以是任意的矩阵或者视图
+             * @param [in] drop 丢弃的阈值, 0 时只丢弃 0
+             */
+            template <typename MatrixIn>
+            static SparseMatrix FromDense(MatrixIn const & a, Scalar drop = 0)
+            {
+                SparseMatrix re(a.Rows(), a.Cols());
+                int no = re.OuterSize(), ni = re.InnerSize();
+                for (int o = 0; o < no; o++) {
+                    for (int i = 0; i < ni; i++) {
+                        Scalar v = IsRowMajor ? a(o, i) : a(i, o);
+                        if (std::abs(v) > drop) {
+                            re.mInner.push_back(i);
+                            re.mValues.push_back(v);
+                        }
+                    }
+                    re.mOuter[o + 1] = (int)re.mValues.size();
+                }
+                return re;
+            }
+
+            /**
+             * @brief 压缩三元组, 重复的元素相加
+             *
+             * 先按主维度计数排序, 再并行地对每一段按次维度排序并合并重复的元素。
+             * 结果中保留数值为 0 的元素, 稀疏模式只由三元组的位置决定。
+             */
+            void SetFromTriplets(SparseTriplets<Scalar> const & t)
+            {
+                mRows = t.Rows();
+                mCols = t.Cols();
+                int no = OuterSize();
+                int nt = t.Size();
+
+                std::vector<int> ptr(no + 1, 0);
+                for (int k = 0; k < nt; k++)
+                    ptr[OuterOf(t.Row(k), t.Col(k)) + 1]++;
+                for (int o = 0; o < no; o++)
+                    ptr[o + 1] += ptr[o];
+
+                std::vector<std::pair<int, Scalar>> buf(nt);
+                {
+                    std::vector<int> pos(ptr.begin(), ptr.end() - 1);
+                    for (int k = 0; k < nt; k++) {
+                        int r = t.Row(k), c = t.Col(k);
+                        buf[pos[OuterOf(r, c)]++] = { IsRowMajor ? c : r, t.Value(k) };
+                    }
+                }
+
+                std::vector<int> cnt(no + 1, 0);
+                ParallelFor(0, no, ParallelGrain(no, 1, 1024), [&](int b, int e) {
+                    for (int o = b; o < e; o++) {
+                        auto first = buf.begin() + ptr[o];
+                        auto last = buf.begin() + ptr[o + 1];
+                        if (first == last)
+                            continue;
+                        std::sort(first, last, [](std::pair<int, Scalar> const & x, std::pair<int, Scalar> const & y) {
+                            return x.first < y.first;
+                        });
+                        auto out = first;
+                        for (auto it = first + 1; it != last; ++it) {
+                            if (it->first == out->first)
+                                out->second += it->second;
+                            else
+                                *(++out) = *it;
+                        }
+                        cnt[o + 1] = (int)(out - first) + 1;
+                    }
+                });
+                for (int o = 0; o < no; o++)
+                    cnt[o + 1] += cnt[o];
+
+                mOuter.swap(cnt);
+                mInner.resize(mOuter[no]);
+                mValues.resize(mOuter[no]);
+                ParallelFor(0, no, ParallelGrain(no, 1, 1024), [&](int b, int e) {
+                    for (int o = b; o < e; o++) {
+                        int src = ptr[o];
+                        for (int p = mOuter[o]; p < mOuter[o + 1]; p++, src++) {
+                            mInner[p] = buf[src].first;
+                            mValues[p] = buf[src].second;
+                        }
+                    }
+                });
+            }
+
+            //! @brief 转置, 存储方式不变, 即 CSR 的转置仍然是 CSR
+            SparseMatrix Transpose() const
+            {
+                SparseMatrix re;
+                re.mRows = mCols;
+                re.mCols = mRows;
+                re.Transpose(OuterSize(), InnerSize(), OuterIndex(), InnerIndex(), Values());
+                return re;
+            }
+
+            //! @brief 转换为稠密矩阵
+            DMatrix<Scalar> ToDense() const
+            {
+                DMatrix<Scalar> re(mRows, mCols);
+                for (int o = 0; o < OuterSize(); o++)
+                    for (int p = mOuter[o]; p < mOuter[o + 1]; p++) {
+                        if (IsRowMajor)
+                            re(o, mInner[p]) = mValues[p];
+                        else
+                            re(mInner[p], o) = mValues[p];
+                    }
+                return re;
+            }
+
+            //! @brief 元素 (r, c), 在第 r 行 (列) 中二分查找, 不存在时为 0
+            Scalar operator () (int r, int c) const
+            {
+                assert(r >= 0 && r < mRows && c >= 0 && c < mCols);
+                int o = IsRowMajor ? r : c;
+                int i = IsRowMajor ? c : r;
+                auto first = mInner.begin() + mOuter[o];
+                auto last = mInner.begin() + mOuter[o + 1];
+                auto it = std::lower_bound(first, last, i);
+                return (it != last && *it == i) ? mValues[it - mInner.begin()] : Scalar(0);
+            }
+
+            int Rows() const { return mRows; }
+            int Cols() const { return mCols; }
+            //! @brief 非零元素的数量
+            int NonZeros() const { return mOuter.back(); }
+            //! @brief 主维度的尺寸, CSR 为行数, CSC 为列数
+            int OuterSize() const { return IsRowMajor ? mRows : mCols; }
+            int InnerSize() const { return IsRowMajor ? mCols : mRows; }
+
+            //! @brief 各行 (列) 非零元素的起始位置, OuterSize() + 1 个元素
+            int const * OuterIndex() const { return mOuter.data(); }
+            //! @brief 各个非零元素的列 (行) 号
+            int const * InnerIndex() const { return mInner.data(); }
+            Scalar const * Values() const { return mValues.data(); }
+            //! @brief 稀疏模式不变时可以直接改写数值
+            Scalar * Values() { return mValues.data(); }
+
+        private:
+            int OuterOf(int r, int c) const { return IsRowMajor ? r : c; }
+
+            //! @brief 由另一种压缩方式的数组计数排序, 按原主维度的顺序扫描, 新的每一段自然升序
+            void Transpose(int no, int ni, int const * outer, int const * inner, Scalar const * values)
+            {
+                int nnz = outer[no];
+                mOuter.assign(ni + 1, 0);
+                mInner.resize(nnz);
+                mValues.resize(nnz);
+                for (int p = 0; p < nnz; p++)
+                    mOuter[inner[p] + 1]++;
+                for (int i = 0; i < ni; i++)
+                    mOuter[i + 1] += mOuter[i];
+
+                std::vector<int> pos(mOuter.begin(), mOuter.end() - 1);
+                for (int o = 0; o < no; o++)
+                    for (int p = outer[o]; p < outer[o + 1]; p++) {
+                        int q = pos[inner[p]]++;
+                        mInner[q] = o;
+                        mValues[q] = values[p];
+                    }
+            }
+
+        private:
+            int mRows;
+            int mCols;
+            std::vector<int> mOuter;
+            std::vector<int> mInner;
+            std::vector<Scalar> mValues;
+    };
+
+    //! @brief 行压缩存储的稀疏矩阵
+    template <typename Scalar>
+    using SparseCSR = SparseMatrix<Scalar, EAlignType::eRowMajor>;
+
+    //! @brief 列压缩存储的稀疏矩阵
+    template <typename Scalar>
+    using SparseCSC = SparseMatrix<Scalar, EAlignType::eColMajor>;
+
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 稀疏矩阵与稠密矩阵的乘法
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 压缩存储的稀疏矩阵乘以稠密矩阵 C = alpha op(S) B + beta C
+    //!
+    //! S 是 no 个主维度的压缩存储, 第 o 段的非零元素为 S(o, inner[p])。
+    //! gather 为 true 时 op(S) = S, C 有 no 行, 各行互不依赖, 按行并行;
+    //! 否则 op(S) = S^T, C 有 ni 行, 第 o 段分散地累加到 C 的各行上:
+    //! C 的列数不少于线程数时按列并行, 否则分成若干块分别累加到私有的缓存中再归约。
+    //! 缓存的数量不超过 nnz / ni, 所以额外的内存和归约的读取都不超过 nnz 个元素。
+    //! CSR 的 S B 与 CSC 的 S^T B 是 gather, 反之是 scatter。
+    //!
+    //! @param [in] gather 是否沿主维度收集
+    //! @param [in] no, ni 主维度和次维度的尺寸
+    //! @param [in] n C 和 B 的列数
+    //! @param [in] outer, inner, values 压缩存储的数组
+    //! @param [in] B, rsB, csB 稠密矩阵, gather 时为 ni x n, 否则为 no x n
+    //! @param [in|out] C, rsC, csC 稠密矩阵, gather 时为 no x n, 否则为 ni x n, 不能与 B 共享存储
+    template <typename Scalar>
+    void SparseGemm(bool gather, int no, int ni, int n, Scalar alpha,
+                    int const * outer, int const * inner, Scalar const * values,
+                    Scalar const * B, int rsB, int csB,
+                    Scalar beta, Scalar * C, int rsC, int csC)
+    {
+        if (n <= 0)
+            return;
+        int nnz = outer[no];
+
+        if (gather) {
+            // 每个任务块至少 4096 个非零元素的工作量
+            int per = std::max(1, nnz / std::max(1, no)) * n;
+            int grain = ParallelGrain(no, 1, std::max(1, 4096 / per));
+            ParallelFor(0, no, grain, [&](int b, int e) {
+                for (int o = b; o < e; o++) {
+                    int p0 = outer[o], p1 = outer[o + 1];
+                    for (int j = 0; j < n; j++) {
+                        Scalar const * bj = B + j * csB;
+                        Scalar sum = 0;
+                        for (int p = p0; p < p1; p++)
+                            sum += values[p] * bj[inner[p] * rsB];
+                        Scalar & c = C[o * rsC + j * csC];
+                        c = (0 == beta) ? alpha * sum : alpha * sum + beta * c;
+                    }
+                }
+            });
+            return;
+        }
+
+        // scatter: 先 C = beta C, 再逐段累加
+        auto scale = [&](Scalar * c, int rs) {
+            ParallelFor(0, ni, ParallelGrain(ni, 1, 4096), [&](int b, int e) {
+                for (int i = b; i < e; i++)
+                    c[i * rs] = (0 == beta) ? Scalar(0) : beta * c[i * rs];
+            });
+        };
+        auto accumulate = [&](int b, int e, Scalar const * x, int incx, Scalar * y, int incy) {
+            for (int o = b; o < e; o++) {
+                Scalar xo = alpha * x[o * incx];
+                if (0 == xo)
+                    continue;
+                for (int p = outer[o]; p < outer[o + 1]; p++)
+                    y[inner[p] * incy] += values[p] * xo;
+            }
+        };
+
+        int nt = GetNumThreads();
+        bool parallel = ParallelEnabled() && nnz * (long)n >= 32768;
+        int nb = (int)std::min<long>(nt, nnz / std::max(1, ni));
+        if (!parallel || n >= nt || nb < 2) {
+            ParallelFor(0, n, parallel ? 1 : n, [&](int b, int e) {
+                for (int j = b; j < e; j++) {
+                    Scalar * cj = C + j * csC;
+                    for (int i = 0; i < ni; i++)
+                        cj[i * rsC] = (0 == beta) ? Scalar(0) : beta * cj[i * rsC];
+                    accumulate(0, no, B + j * csB, rsB, cj, rsC);
+                }
+            });
+            return;
+        }
+
+        // 按非零元素的数量把主维度均分为 nb 块, 每块写入私有的 ni 个元素的缓存
+        WorkspaceFrame frame;
+        Scalar * W = frame.Alloc<Scalar>((std::size_t)nb * ni);
+        std::vector<int> split(nb + 1, no);
+        split[0] = 0;
+        for (int t = 1; t < nb; t++)
+            split[t] = (int)(std::upper_bound(outer, outer + no + 1, (long)nnz * t / nb) - outer) - 1;
+        for (int t = 1; t <= nb; t++)
+            split[t] = std::max(split[t], split[t - 1]);
+
+        for (int j = 0; j < n; j++) {
+            Scalar const * bj = B + j * csB;
+            Scalar * cj = C + j * csC;
+            ParallelFor(0, nb, 1, [&](int b, int e) {
+                for (int t = b; t < e; t++) {
+                    Scalar * w = W + (std::size_t)t * ni;
+                    std::fill(w, w + ni, Scalar(0));
+                    accumulate(split[t], split[t + 1], bj, rsB, w, 1);
+                }
+            });
+            scale(cj, rsC);
+            ParallelFor(0, ni, ParallelGrain(ni, 1, 4096), [&](int b, int e) {
+                for (int t = 0; t < nb; t++) {
+                    Scalar const * w = W + (std::size_t)t * ni;
+                    for (int i = b; i < e; i++)
+                        cj[i * rsC] += w[i];
+                }
+            });
+        }
+    }
+
+    //! @brief 稀疏矩阵乘以向量 y = alpha A x + beta y
+    //!
+    //! @param [in] x, incx A.Cols() 个元素的向量
+    //! @param [in|out] y, incy A.Rows() 个元素的向量, 不能与 x 共享存储
+    template <typename Scalar, EAlignType Align>
+    void SpMV(Scalar alpha, SparseMatrix<Scalar, Align> const & A, Scalar const * x, int incx,
+              Scalar beta, Scalar * y, int incy)
+    {
+        constexpr bool row = (EAlignType::eRowMajor == Align);
+        SparseGemm(row, A.OuterSize(), A.InnerSize(), 1, alpha,
+                   A.OuterIndex(), A.InnerIndex(), A.Values(), x, incx, 0, beta, y, incy, 0);
+    }
+
+    //! @brief 稀疏矩阵乘以稠密矩阵 C = alpha A B + beta C
+    //!
+    //! B, C 可以是任意的稠密矩阵或者视图, 可以用行列步长寻址且标量类型相同时直接计算,
+    //! 否则先拷贝到临时的 DMatrix 中。
+    //!
+    //! @return 矩阵尺寸是否合法
+    template <typename Scalar, EAlignType Align, typename MatrixB, typename MatrixC>
+    bool Gemm(Scalar alpha, SparseMatrix<Scalar, Align> const & A, MatrixB const & B, Scalar beta, MatrixC & C)
+    {
+        if (A.Cols() != B.Rows() || C.Rows() != A.Rows() || C.Cols() != B.Cols())
+            return false;
+
+        constexpr bool row = (EAlignType::eRowMajor == Align);
+        if constexpr (GemmDispatchable<MatrixB, MatrixB, MatrixC>::value) {
+            SparseGemm(row, A.OuterSize(), A.InnerSize(), C.Cols(), alpha,
+                       A.OuterIndex(), A.InnerIndex(), A.Values(),
+                       B.StorBegin(), B.RowStride(), B.ColStride(),
+                       beta, C.StorBegin(), C.RowStride(), C.ColStride());
+        } else {
+            DMatrix<Scalar> b(B.Rows(), B.Cols()), c(C.Rows(), C.Cols());
+            for (int j = 0; j < b.Cols(); j++)
+                for (int i = 0; i < b.Rows(); i++)
+                    b(i, j) = B(i, j);
+            for (int j = 0; j < c.Cols(); j++)
+                for (int i = 0; i < c.Rows(); i++)
+                    c(i, j) = C(i, j);
+            SparseGemm(row, A.OuterSize(), A.InnerSize(), c.Cols(), alpha,
+                       A.OuterIndex(), A.InnerIndex(), A.Values(),
+                       b.StorBegin(), 1, b.Rows(), beta, c.StorBegin(), 1, c.Rows());
+            for (int j = 0; j < c.Cols(); j++)
+                for (int i = 0; i < c.Rows(); i++)
+                    C(i, j) = c(i, j);
+        }
+        return true;
+    }
+
+    //! @brief 稠密矩阵乘以稀疏矩阵 C = alpha B A + beta C
+    //!
+    //! 即 C^T = alpha A^T B^T + beta C^T, 交换 B, C 的行列步长后交给 SparseGemm
+    //!
+    //! @return 矩阵尺寸是否合法
+    template <typename Scalar, typename MatrixB, EAlignType Align, typename MatrixC>
+    bool Gemm(Scalar alpha, MatrixB const & B, SparseMatrix<Scalar, Align> const & A, Scalar beta, MatrixC & C)
+    {
+        if (B.Cols() != A.Rows() || C.Rows() != B.Rows() || C.Cols() != A.Cols())
+            return false;
+
+        constexpr bool col = (EAlignType::eColMajor == Align);
+        if constexpr (GemmDispatchable<MatrixB, MatrixB, MatrixC>::value) {
+            SparseGemm(col, A.OuterSize(), A.InnerSize(), C.Rows(), alpha,
+                       A.OuterIndex(), A.InnerIndex(), A.Values(),
+                       B.StorBegin(), B.ColStride(), B.RowStride(),
+                       beta, C.StorBegin(), C.ColStride(), C.RowStride());
+        } else {
+            DMatrix<Scalar> b(B.Rows(), B.Cols()), c(C.Rows(), C.Cols());
+            for (int j = 0; j < b.Cols(); j++)
+                for (int i = 0; i < b.Rows(); i++)
+                    b(i, j) = B(i, j);
+            for (int j = 0; j < c.Cols(); j++)
+                for (int i = 0; i < c.Rows(); i++)
+                    c(i, j) = C(i, j);
+            SparseGemm(col, A.OuterSize(), A.InnerSize(), c.Rows(), alpha,
+                       A.OuterIndex(), A.InnerIndex(), A.Values(),
+                       b.StorBegin(), b.Rows(), 1, beta, c.StorBegin(), c.Rows(), 1);
+            for (int j = 0; j < c.Cols(); j++)
+                for (int i = 0; i < c.Rows(); i++)
+                    C(i, j) = c(i, j);
+        }
+        return true;
+    }
+
+    //! @brief 稀疏矩阵乘以稠密矩阵, 结果为 DMatrix
+    template <typename Scalar, EAlignType Align, typename MatrixB,
+              bool BIsMatrix = MatrixB::IsMatrix>
+    DMatrix<Scalar> operator * (SparseMatrix<Scalar, Align> const & A, MatrixB const & B)
+    {
+        DMatrix<Scalar> C(A.Rows(), B.Cols());
+        bool success = Gemm(Scalar(1), A, B, Scalar(0), C);
+        assert(success);
+        (void)success;
+        return C;
+    }
+
+    //! @brief 稠密矩阵乘以稀疏矩阵, 结果为 DMatrix
+    template <typename MatrixB, typename Scalar, EAlignType Align,
+              bool BIsMatrix = MatrixB::IsMatrix>
+    DMatrix<Scalar> operator * (MatrixB const & B, SparseMatrix<Scalar, Align> const & A)
+    {
+        DMatrix<Scalar> C(B.Rows(), A.Cols());
+        bool success = Gemm(Scalar(1), B, A, Scalar(0), C);
+        assert(success);
+        (void)success;
+        return C;
+    }
+
+}
+
+#endif
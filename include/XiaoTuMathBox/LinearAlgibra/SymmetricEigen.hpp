@@ -0,0 +1,291 @@
+#ifndef XTMB_LA_SYMMETRIC_EIGEN_H
+#define XTMB_LA_SYMMETRIC_EIGEN_H
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include <XiaoTuMathBox/LinearAlgibra/Householder.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 对称矩阵的特征值分解 A = V diag(d) V^T
+//
+// 先通过 Householder 反射把 A 约化为对称三对角矩阵 T = Q^T A Q, 只访问 A 的下三角,
+// 每一步是一次对称矩阵向量乘法和一次对称秩 2 更新, 约 4/3 n^3 次浮点运算。
+// 再对 T 进行带 Wilkinson 偏移的隐式 QL 迭代, 只需要对角线和次对角线两个 O(n) 数组。
+// 只在需要特征向量时才通过分块反射构造 Q, 并在迭代中把 Givens 旋转累积到 Q 的列上。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 通过 Householder 反射把对称矩阵约化为三对角矩阵 T = Q^T A Q
+    //!
+    //! Q = H_0 H_1 ... H_{n-2}, H_k 作用于第 k+1 行及其以后的各行,
+    //! 其 Householder 向量保存在第 k 列的第 k+2 行及其以后, v(0) = 1 不保存。
+    //! 只读写 A 的下三角, 列优先存储。
+    //!
+    //! @param [in] n A 的尺寸 n x n
+    //! @param [in|out] A, ldA 对称矩阵, 输出时严格下三角的次对角线以下为各个 Householder 向量
+    //! @param [out] d 三对角矩阵的对角线, n 个元素
+    //! @param [out] e 三对角矩阵的次对角线, e[k] = T(k+1, k), 至少 n-1 个元素
+    //! @param [out] tau 各个反射的系数, 至少 n-1 个元素
+    template <typename Scalar>
+    void SymmetricTridiagonal(int n, Scalar * A, int ldA, Scalar * d, Scalar * e, Scalar * tau)
+    {
+        WorkspaceFrame frame;
+        Scalar * w = frame.Alloc<Scalar>(n);
+
+        for (int k = 0; k + 1 < n; ++k) {
+            int m = n - k - 1;
+            Scalar * v = A + (k + 1) + k * ldA;
+            Scalar * A22 = v + ldA;
+
+            d[k] = A[k + k * ldA];
+            tau[k] = HouseholderGenerate(m, v, 1);
+            e[k] = v[0];
+            if (0 == tau[k])
+                continue;
+
+            // w = tau A22 v, 只读下三角, 每一列同时贡献一次点积和一次 axpy
+            v[0] = 1;
+            std::fill(w, w + m, Scalar(0));
+            for (int j = 0; j < m; ++j) {
+                Scalar const * a = A22 + j * ldA;
+                Scalar vj = v[j];
+                Scalar s = a[j] * vj;
+                for (int i = j + 1; i < m; ++i) {
+                    w[i] += a[i] * vj;
+                    s += a[i] * v[i];
+                }
+                w[j] += s;
+            }
+
+            // w = w - (tau/2)(w^T v) v, 则 H A22 H = A22 - v w^T - w v^T
+            Scalar wv = 0;
+            for (int i = 0; i < m; ++i) {
+                w[i] *= tau[k];
+                wv += w[i] * v[i];
+            }
+            Scalar alpha = -tau[k] * wv / 2;
+            for (int i = 0; i < m; ++i)
+                w[i] += alpha * v[i];
+
+            ParallelFor(0, m, ParallelGrain(m, 1, 64), [&](int b, int end) {
+                for (int j = b; j < end; ++j) {
+                    Scalar * a = A22 + j * ldA;
+                    Scalar vj = v[j];
+                    Scalar wj = w[j];
+                    for (int i = j; i < m; ++i)
+                        a[i] -= v[i] * wj + w[i] * vj;
+                }
+            });
+            v[0] = e[k];
+        }
+        if (n > 0)
+            d[n - 1] = A[(n - 1) + (n - 1) * ldA];
+    }
+
+    //! @brief 对称三对角矩阵的隐式 QL 迭代, 带 Wilkinson 偏移
+    //!
+    //! 参考 Numerical Recipes 中的 tqli。每次迭代从次对角线可以忽略的位置 m 向上追赶到 l,
+    //! 逐个 Givens 旋转同时更新 d 和 e。Z 不为 nullptr 时把旋转累积到 Z 的第 i, i+1 列上。
+    //!
+    //! @param [in] n 矩阵尺寸
+    //! @param [in|out] d 对角线, 输出特征值, 未排序
+    //! @param [in|out] e 次对角线, e[i] = T(i+1, i), 需要 n 个元素, 输出时全为 0
+    //! @param [in|out] Z, ldZ 列优先存储的 nz x n 矩阵, 可以为 nullptr
+    //! @param [in] nz Z 的行数
+    //! @param [in] max_iter 每个特征值的最大迭代次数
+    //! @return 总的迭代次数
+    template <typename Scalar>
+    int SymmetricTridiagonalQL(int n, Scalar * d, Scalar * e, Scalar * Z, int ldZ, int nz, int max_iter)
+    {
+        if (n <= 0)
+            return 0;
+        e[n - 1] = 0;
+
+        constexpr Scalar eps = std::numeric_limits<Scalar>::epsilon();
+        int total = 0;
+        // 与 EISPACK tql2 相同, 同时以已处理部分的范数 tst 为尺度, 否则接近 0 的特征值聚集时不收敛
+        Scalar tst = 0;
+        for (int l = 0; l < n; ++l) {
+            int iter = 0;
+            int m = l;
+            tst = std::max(tst, std::abs(d[l]) + std::abs(e[l]));
+            do {
+                for (m = l; m < n - 1; ++m) {
+                    Scalar dd = std::abs(d[m]) + std::abs(d[m + 1]);
+                    if (std::abs(e[m]) <= eps * std::max(dd, tst))
+                        break;
+                }
+                if (m == l)
+                    break;
+                if (iter++ == max_iter)
+                    throw std::runtime_error("迭代不收敛");
+                total++;
+
+                // Wilkinson 偏移: 左上角 2x2 块中更接近 d[l] 的特征值
+                Scalar g = (d[l + 1] - d[l]) / (2 * e[l]);
+                Scalar r = std::hypot(g, Scalar(1));
+                g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+
+                Scalar s = 1, c = 1, p = 0;
+                int i = m - 1;
+                for (; i >= l; --i) {
+                    Scalar f = s * e[i];
+                    Scalar b = c * e[i];
+                    r = std::hypot(f, g);
+                    e[i + 1] = r;
+                    if (0 == r) {
+                        // 提前分裂, 消去已经产生的偏差后重新查找
+                        d[i + 1] -= p;
+                        e[m] = 0;
+                        break;
+                    }
+                    s = f / r;
+                    c = g / r;
+                    g = d[i + 1] - p;
+                    r = (d[i] - g) * s + 2 * c * b;
+                    p = s * r;
+                    d[i + 1] = g + p;
+                    g = c * r - b;
+
+                    if (nullptr != Z) {
+                        Scalar * z0 = Z + i * ldZ;
+                        Scalar * z1 = z0 + ldZ;
+                        for (int k = 0; k < nz; ++k) {
+                            Scalar t = z1[k];
+                            z1[k] = s * z0[k] + c * t;
+                            z0[k] = c * z0[k] - s * t;
+                        }
+                    }
+                }
+                if (i >= l)
+                    continue;
+                d[l] -= p;
+                e[l] = g;
+                e[m] = 0;
+            } while (m != l);
+        }
+        return total;
+    }
+
+    /**
+     * @brief 对称矩阵的特征值分解 A = V diag(d) V^T
+     *
+     * 三对角化 + 隐式 QL 迭代, 特征值按升序排列, V 的各列为对应的单位特征向量。
+     * 只读取 a 的下三角。与 EigenImplicitQR 不同, 不把 A 当作一般矩阵处理,
+     * 也不需要在稠密子阵上迭代, 不需要特征向量时只有 O(n^2) 的迭代开销。
+     */
+    template <typename MatViewIn>
+    class SymmetricEigen {
+        public:
+            typedef typename MatViewIn::Scalar Scalar;
+
+            //! @brief 构造 Q 时的分块大小
+            constexpr static int BlockSize = 32;
+
+            //! @brief 默认构造函数, 之后通过 Decompose 分解
+            SymmetricEigen()
+            {}
+
+            SymmetricEigen(MatViewIn const & a, bool keep_vectors = true)
+            {
+                Decompose(a, keep_vectors);
+            }
+
+            /**
+             * @brief 分解对称矩阵 a
+             *
+             * 尺寸与上次分解相同时复用已有的内存, 不再申请
+             *
+             * @param [in] a 对称矩阵, 只读取下三角
+             * @param [in] keep_vectors 是否需要特征向量
+             * @param [in] max_iter 每个特征值的最大 QL 迭代次数
+             * @return QL 迭代的总次数
+             */
+            int Decompose(MatViewIn const & a, bool keep_vectors = true, int max_iter = 30)
+            {
+                assert(a.Rows() == a.Cols());
+                int n = a.Rows();
+
+                mA.Resize(n, n);
+                for (int c = 0; c < n; c++)
+                    for (int r = c; r < n; r++)
+                        mA(r, c) = a(r, c);
+
+                mD.resize(n);
+                mE.resize(n);
+                mTau.resize(n);
+                SymmetricTridiagonal(n, mA.StorBegin(), n, mD.data(), mE.data(), mTau.data());
+
+                Scalar * Z = nullptr;
+                if (keep_vectors) {
+                    FormQ(n);
+                    Z = mV.StorBegin();
+                }
+
+                int iter = SymmetricTridiagonalQL(n, mD.data(), mE.data(), Z, n, n, max_iter);
+                Sort(n, Z);
+                return iter;
+            }
+
+            //! @brief 升序排列的特征值
+            std::vector<Scalar> const & EigenValues() const { return mD; }
+            //! @brief 各列为对应的特征向量, 只在 keep_vectors 时有效
+            DMatrix<Scalar> const & EigenVectors() const { return mV; }
+
+        private:
+            //! @brief 以分块的方式构造 Q = H_0 ... H_{n-2}, 第 0 行和第 0 列为 e_0
+            void FormQ(int n)
+            {
+                mV.Resize(n, n).Identity();
+                int m = n - 1;
+                if (m <= 0)
+                    return;
+
+                int nb = BlockSize;
+                mT.resize(nb * m);
+                Scalar * V = mA.StorBegin() + 1;
+                for (int j = 0; j < m; j += nb) {
+                    int jb = std::min(nb, m - j);
+                    HouseholderBlockT(m - j, jb, V + j + j * n, 1, n, mTau.data() + j, mT.data() + j * nb, nb);
+                }
+                HouseholderApplyQ(m, m, m, V, 1, n, mT.data(), nb, false,
+                                  mV.StorBegin() + 1 + n, 1, n);
+            }
+
+            //! @brief 特征值按升序排列, 同时交换特征向量
+            void Sort(int n, Scalar * Z)
+            {
+                for (int i = 0; i + 1 < n; i++) {
+                    int k = i;
+                    for (int j = i + 1; j < n; j++)
+                        if (mD[j] < mD[k])
+                            k = j;
+                    if (k == i)
+                        continue;
+                    std::swap(mD[i], mD[k]);
+                    if (nullptr != Z)
+                        std::swap_ranges(Z + i * n, Z + (i + 1) * n, Z + k * n);
+                }
+            }
+
+        private:
+            //! @brief 三对角化的工作矩阵, 下三角保存各个 Householder 向量
+            DMatrix<Scalar> mA;
+            DMatrix<Scalar> mV;
+            std::vector<Scalar> mD;
+            std::vector<Scalar> mE;
+            std::vector<Scalar> mTau;
+            std::vector<Scalar> mT;
+    };
+
+}
+
+#endif
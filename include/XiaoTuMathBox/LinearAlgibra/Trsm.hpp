@@ -0,0 +1,114 @@
+#ifndef XTMB_LA_TRSM_H
+#define XTMB_LA_TRSM_H
+
+#include <algorithm>
+
+#include <XiaoTuMathBox/LinearAlgibra/Gemm.hpp>
+
+/////////////////////////////////////////////////////////////////////////
+//
+// 三角方程组求解 TRSM, 原位计算 B = A^{-1} B, A 为三角矩阵, B 有多列
+//
+// 把 A 按 nb 切成对角块, 对角块上逐列回代, 对角块以外的部分用 Gemm 一次更新所有列。
+// 右侧的列越多, 越多的计算量落到 Gemm 上。右侧的各列相互独立, 可以按列并行。
+//
+// 与 Gemm.hpp 一样, 所有接口都基于裸指针和行/列步长。
+// 交换 A 的行列步长即得到 A^T, 下三角的转置是上三角, 所以不单独提供转置的版本。
+//
+/////////////////////////////////////////////////////////////////////////
+namespace xiaotu {
+
+    //! @brief 不分块的三角方程组求解, 用于分块算法中的对角块
+    //!
+    //! 按列遍历 B, 每一列都是沿着 A 的列方向做秩 1 更新, 列优先存储时是连续的
+    //!
+    //! @param [in] lower A 是否为下三角, 否则为上三角
+    //! @param [in] unit A 的对角线是否为 1, 是则不读取对角线
+    //! @param [in] m, n B 的尺寸, A 为 m x m
+    //! @param [in] A, rsA, csA 三角矩阵, 另一半三角不读取
+    //! @param [in|out] B, rsB, csB 输入右侧的矩阵, 输出解
+    template <typename Scalar>
+    void TrsmSmall(bool lower, bool unit, int m, int n,
+                   Scalar const * A, int rsA, int csA,
+                   Scalar * B, int rsB, int csB)
+    {
+        for (int c = 0; c < n; ++c) {
+            Scalar * b = B + c * csB;
+            for (int t = 0; t < m; ++t) {
+                int k = lower ? t : m - 1 - t;
+                Scalar const * a = A + k * csA;
+                if (!unit)
+                    b[k * rsB] /= a[k * rsA];
+                Scalar bk = b[k * rsB];
+                if (0 == bk)
+                    continue;
+
+                int begin = lower ? k + 1 : 0;
+                int end = lower ? m : k;
+                for (int i = begin; i < end; ++i)
+                    b[i * rsB] -= a[i * rsA] * bk;
+            }
+        }
+    }
+
+    //! @brief 单线程的分块三角方程组求解, 参数同 Trsm
+    template <typename Scalar>
+    void TrsmSerial(bool lower, bool unit, int m, int n,
+                    Scalar const * A, int rsA, int csA,
+                    Scalar * B, int rsB, int csB, int nb)
+    {
+        if (lower) {
+            for (int k = 0; k < m; k += nb) {
+                int kb = std::min(nb, m - k);
+                Scalar const * Akk = A + k * rsA + k * csA;
+                Scalar * Bk = B + k * rsB;
+                TrsmSmall(true, unit, kb, n, Akk, rsA, csA, Bk, rsB, csB);
+                if (k + kb < m)
+                    Gemm(m - k - kb, n, kb, Scalar(-1), Akk + kb * rsA, rsA, csA, Bk, rsB, csB,
+                         Scalar(1), Bk + kb * rsB, rsB, csB);
+            }
+        } else {
+            for (int k = (m - 1) / nb * nb; k >= 0; k -= nb) {
+                int kb = std::min(nb, m - k);
+                Scalar const * Akk = A + k * rsA + k * csA;
+                Scalar * Bk = B + k * rsB;
+                TrsmSmall(false, unit, kb, n, Akk, rsA, csA, Bk, rsB, csB);
+                if (k > 0)
+                    Gemm(k, n, kb, Scalar(-1), A + k * csA, rsA, csA, Bk, rsB, csB,
+                         Scalar(1), B, rsB, csB);
+            }
+        }
+    }
+
+    //! @brief 分块的三角方程组求解 B = A^{-1} B
+    //!
+    //! 下三角时从上往下逐块求解, 每解出一块就用 Gemm 更新它下方的所有行; 上三角则从下往上。
+    //! B 的各列相互独立, 计算量超过 ParallelGemmSize 时按列切块并行。
+    //!
+    //! @param [in] lower A 是否为下三角, 否则为上三角
+    //! @param [in] unit A 的对角线是否为 1, 是则不读取对角线
+    //! @param [in] m, n B 的尺寸, A 为 m x m
+    //! @param [in] A, rsA, csA 三角矩阵, 另一半三角不读取
+    //! @param [in|out] B, rsB, csB 输入右侧的矩阵, 输出解
+    //! @param [in] nb 分块大小
+    template <typename Scalar>
+    void Trsm(bool lower, bool unit, int m, int n,
+              Scalar const * A, int rsA, int csA,
+              Scalar * B, int rsB, int csB, int nb = 64)
+    {
+        if (m <= 0 || n <= 0)
+            return;
+
+        if ((long)m * m * n < ParallelGemmSize || !ParallelEnabled()) {
+            TrsmSerial(lower, unit, m, n, A, rsA, csA, B, rsB, csB, nb);
+            return;
+        }
+
+        ParallelFor(0, n, ParallelGrain(n, 1, 16), [&](int b, int e) {
+            TrsmSerial(lower, unit, m, e - b, A, rsA, csA, B + b * csB, rsB, csB, nb);
+        });
+    }
+
+}
+
+#endif
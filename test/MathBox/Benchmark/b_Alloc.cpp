@@ -0,0 +1,114 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+
+using namespace xiaotu;
+
+/*
+ * 统计各个分解类和常见表达式的堆分配次数和分配的字节数
+ *
+ * 通过替换全局的 operator new/delete 计数, 字节数近似反映了深拷贝的数据量。
+ * 最后一部分复用分解对象和 Workspace, 第二轮的分配次数应当都是 0。
+ *
+ * 用法: b_Alloc [n], 默认 n = 64
+ */
+
+static long gNumAllocs = 0;
+static long gNumBytes = 0;
+
+void * operator new(std::size_t size)
+{
+    gNumAllocs++;
+    gNumBytes += size;
+    if (void * p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+}
+
+template <typename Func>
+void Count(std::string const & name, Func && func)
+{
+    long allocs = gNumAllocs;
+    long bytes = gNumBytes;
+    func();
+    XTLog(std::cout) << name << "\t" << (gNumAllocs - allocs) << "\t"
+                     << (gNumBytes - bytes) / 1024.0 << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int n = (argc > 1) ? std::atoi(argv[1]) : 64;
+
+    std::mt19937 gen(1234);
+    DMatrix<double> A(n, n), B(n, n), C(n, n);
+    RandomFill(A, gen);
+    RandomFill(B, gen);
+    DMatrix<double> S = A.Transpose() * A;
+
+    XTLog(std::cout) << "n = " << n << std::endl;
+    XTLog(std::cout) << "case\tallocs\tKiB" << std::endl;
+
+    Count("C = A * B", [&]() { C = A * B; });
+    Count("C = C * B", [&]() { C = C * B; });
+    Count("C = A * B + C", [&]() { C = A * B + C; });
+    Count("DMatrix D = A * B", [&]() { DMatrix<double> D = A * B; });
+    Count("Transpose", [&]() { DMatrix<double> T = A.Transpose(); });
+
+    Count("QR_Householder", [&]() { QR_Householder<DMatrix<double>> qr(A); });
+    Count("QR_Givens", [&]() { QR_Givens<DMatrix<double>> qr(A); });
+    Count("PQR_Householder", [&]() { PQR_Householder<DMatrix<double>> qr(A); });
+    Count("EigenImplicitQR", [&]() {
+        EigenImplicitQR<DMatrix<double>> eig;
+        eig.Iterate(S, 1000, 1e-10);
+    });
+    Count("SVD_GKR", [&]() { SVD_GKR<DMatrix<double>> svd(A, true, true); });
+
+    // 复用分解对象, 预热一次以后同样尺寸的重复分解不应再有堆分配
+    XTLog(std::cout) << "reuse after warm-up" << std::endl;
+    Workspace ws;
+    LU<DMatrix<double>> lu;
+    Cholesky<DMatrix<double>> chol;
+    LDLT<DMatrix<double>> ldlt;
+    QR_Householder<DMatrix<double>> qr;
+    PQR_Householder<DMatrix<double>> pqr;
+    QR_Givens<DMatrix<double>> qrg;
+    Bidiagonal<DMatrix<double>> bidiag;
+    UpperHessenberg<DMatrix<double>> hess;
+    EigenImplicitQR<DMatrix<double>> eig;
+    SVD_GKR<DMatrix<double>> svd;
+    for (int warm = 0; warm < 2; warm++) {
+        std::string tag = (0 == warm) ? " (1st)" : " (2nd)";
+        WorkspaceGuard guard(ws);
+        Count("LU" + tag, [&]() { lu.Decompose(A); lu.Solve(B, C); });
+        Count("Cholesky" + tag, [&]() { chol.Decompose(S); chol.Solve(B, C); });
+        Count("LDLT" + tag, [&]() { ldlt.Decompose(S); ldlt.Solve(B, C); });
+        Count("QR_Householder" + tag, [&]() { qr.Decompose(A); });
+        Count("PQR_Householder" + tag, [&]() { pqr.Decompose(A); });
+        Count("QR_Givens" + tag, [&]() { qrg.Decompose(A); });
+        Count("Bidiagonal" + tag, [&]() { bidiag.Decompose(A); });
+        Count("UpperHessenberg" + tag, [&]() { hess.ByHouseholder(A); });
+        Count("EigenImplicitQR" + tag, [&]() { eig.Iterate(S, 1000, 1e-10); });
+        Count("SVD_GKR" + tag, [&]() { svd.Decompose(A, true, true); svd.Iterate(1000, 1e-10); });
+    }
+    XTLog(std::cout) << "workspace KiB\t" << ws.Capacity() / 1024.0 << std::endl;
+
+    return 0;
+}
+
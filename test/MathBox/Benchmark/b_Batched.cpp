@@ -0,0 +1,104 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+/*
+ * count 个 N x N 对称正定方程组的分解和求解耗时(ms), 单线程
+ *
+ * object: 逐个构造 LU/Cholesky 对象并求解
+ * 其余各列: BatchedLU + BatchedLUSolve 和 BatchedCholesky + BatchedCholeskySolve 在各个 SIMD 级别下的耗时
+ *
+ * 用法: b_Batched [count], 默认 100000
+ */
+template <int N>
+void Run(int count)
+{
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<AMatrix<double, N, N>> As(count);
+    std::vector<AMatrix<double, N, 1>> Bs(count);
+    BatchedMatrix<double, N, N> A(count);
+    BatchedMatrix<double, N, 1> B(count);
+    for (int b = 0; b < count; b++) {
+        for (int r = 0; r < N; r++) {
+            for (int c = 0; c < N; c++)
+                As[b](r, c) = dist(gen) + ((r == c) ? N : 0);
+            Bs[b](r) = dist(gen);
+        }
+        for (int r = 0; r < N; r++)
+            for (int c = 0; c < r; c++)
+                As[b](c, r) = As[b](r, c);
+        A.Set(b, As[b]);
+        B.Set(b, Bs[b]);
+    }
+
+    int repeat = std::max(1, (int)(2e6 / count));
+    AMatrix<double, N, 1> x;
+    double tlu = Seconds([&]() {
+        for (int b = 0; b < count; b++) {
+            LU<AMatrix<double, N, N>> lu(As[b]);
+            lu.Solve(Bs[b], x);
+        }
+    }, repeat);
+    double tchol = Seconds([&]() {
+        for (int b = 0; b < count; b++) {
+            Cholesky<AMatrix<double, N, N>> chol(As[b]);
+            chol.Solve(Bs[b], x);
+        }
+    }, repeat);
+    XTLog(std::cout) << N << "x" << N << "\tobject\t" << tlu * 1e3 << "\t" << tchol * 1e3 << std::endl;
+
+    const char * names[] = { "scalar", "sse2", "avx2", "avx512" };
+    ESimdLevel detected = DetectSimdLevel();
+    BatchedMatrix<double, N, N> W;
+    BatchedMatrix<double, N, 1> piv, X;
+    for (int l = 0; l <= (int)detected; l++) {
+        SetSimdLevel(ESimdLevel(l));
+        double blu = Seconds([&]() {
+            W = A;
+            X = B;
+            BatchedLU(W, piv);
+            BatchedLUSolve(W, piv, X);
+        }, repeat);
+        double bchol = Seconds([&]() {
+            W = A;
+            X = B;
+            BatchedCholesky(W);
+            BatchedCholeskySolve(W, X);
+        }, repeat);
+        XTLog(std::cout) << N << "x" << N << "\t" << names[l] << "\t" << blu * 1e3 << "\t" << bchol * 1e3 << std::endl;
+    }
+    SetSimdLevel(detected);
+}
+
+int main(int argc, char *argv[])
+{
+    int count = (argc >= 2) ? std::atoi(argv[1]) : 100000;
+    SetNumThreads(1);
+
+    XTLog(std::cout) << "count = " << count << std::endl;
+    XTLog(std::cout) << "size\tmethod\tLU\tCholesky" << std::endl;
+    Run<3>(count);
+    Run<4>(count);
+    Run<6>(count);
+
+    return 0;
+}
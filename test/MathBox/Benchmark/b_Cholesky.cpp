@@ -0,0 +1,73 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+}
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+/*
+ * Cholesky 分解的耗时, A 为 n x n 的对称正定矩阵
+ *
+ * unblocked: 逐列的秩 1 更新, 即 CholeskyPanel
+ * blocked:   Cholesky, 左视分块, 窄条的更新由 SyrkLower 和 Gemm 完成
+ *
+ * 用法: b_Cholesky [n], 默认依次测试 200, 500, 1000, 2000
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<int> sizes;
+    if (argc >= 2)
+        sizes.push_back(std::atoi(argv[1]));
+    else
+        sizes = { 200, 500, 1000, 2000 };
+
+    std::mt19937 gen(1234);
+    XTLog(std::cout) << "n\tunblocked(s)\tblocked(s)\tGFLOP/s" << std::endl;
+    for (int n : sizes) {
+        DMatrix<double> B(n, n);
+        RandomFill(B, gen);
+        DMatrix<double> A(n, n);
+        Gemm(n, n, n, 1.0, B.StorBegin(), 1, n, B.StorBegin(), n, 1, 0.0, A.StorBegin(), 1, n);
+        for (int i = 0; i < n; i++)
+            A(i, i) += n;
+
+        double flops = 1.0 / 3.0 * n * n * n;
+        int repeat = std::max(1, (int)(1e9 / flops));
+
+        DMatrix<double> W = A;
+        double tu = Seconds([&]() {
+            W = A;
+            CholeskyPanel(n, W.StorBegin(), W.RowStride(), W.ColStride());
+        }, repeat);
+
+        double tb = Seconds([&]() { Cholesky<DMatrixView<double>> c(A.View()); }, repeat);
+
+        XTLog(std::cout) << n << "\t" << tu << "\t" << tb << "\t"
+                         << flops / tb * 1e-9 << std::endl;
+    }
+
+    return 0;
+}
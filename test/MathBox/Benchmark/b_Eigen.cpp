@@ -0,0 +1,188 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+/*
+ * n x n 随机对称矩阵的特征值分解耗时(s)
+ *
+ * implicit QR: EigenImplicitQR, 保留 Q
+ * values:      SymmetricEigen, 只求特征值
+ * vectors:     SymmetricEigen, 同时求特征向量
+ *
+ * 以及 n x n 随机一般矩阵的实 Schur 分解耗时(s)和迭代次数, 都保留 Q
+ *
+ * implicit QR: EigenImplicitQR, 单偏移, 最多迭代 10n 次, 有复特征值时通常达不到收敛
+ * Francis:     EigenFrancisQR, 双重步偏移和激进的早期收缩
+ *
+ * 以及在 Francis 分解的基础上求特征向量的耗时(s)
+ *
+ * inverse power: 对每个实特征值构造一次 LU, OffInvPowerIterate 求其特征向量, 不含复特征值
+ * Schur:         EigenFrancisQR::EigenVectors, 回代加一次 Gemm, 包含全部特征值
+ *
+ * 以及对称矩阵最大的 10 个特征对的耗时(s)
+ *
+ * full:    SymmetricEigen 完整分解
+ * Lanczos: EigenLanczos, 隐式重启, restarts 为重启次数
+ *
+ * 以及 n x n 高斯核矩阵模最大的 16 个特征对的耗时(s), 默认测试 n = 1000, 2000, 5000
+ *
+ * Lanczos:  EigenLanczos
+ * subspace: EigenSubspace, 随机初值, iter 为迭代次数
+ * warm:     EigenSubspace, 核矩阵的点稍微移动以后以上次的子空间为初值
+ *
+ * 用法: b_Eigen [n], 默认依次测试 100, 200, 400, 1000
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<int> sizes = { 100, 200, 400, 1000 };
+    if (argc >= 2)
+        sizes = { std::atoi(argv[1]) };
+
+    XTLog(std::cout) << "n\timplicit QR\tvalues\tvectors" << std::endl;
+    for (int n : sizes) {
+        std::mt19937 gen(n);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        DMatrix<double> S(n, n);
+        for (int c = 0; c < n; c++)
+            for (int r = c; r < n; r++)
+                S(r, c) = S(c, r) = dist(gen);
+
+        int repeat = (n <= 200) ? 5 : 1;
+        double tqr = Seconds([&]() {
+            EigenImplicitQR<DMatrix<double>> qr;
+            qr.Iterate(S, 100 * n, SMALL_VALUE);
+        }, repeat);
+
+        SymmetricEigen<DMatrix<double>> eig;
+        double tval = Seconds([&]() { eig.Decompose(S, false); }, repeat);
+        double tvec = Seconds([&]() { eig.Decompose(S, true); }, repeat);
+
+        XTLog(std::cout) << n << "\t" << tqr << "\t" << tval << "\t" << tvec << std::endl;
+    }
+
+    XTLog(std::cout) << "n\timplicit QR\titer\tFrancis\titer" << std::endl;
+    for (int n : sizes) {
+        std::mt19937 gen(n);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        DMatrix<double> A(n, n);
+        for (int i = 0; i < n * n; i++)
+            A(i) = dist(gen);
+
+        int iqr = 0, ifr = 0;
+        double tqr = Seconds([&]() {
+            EigenImplicitQR<DMatrix<double>> qr;
+            iqr = qr.Iterate(A, 10 * n, SMALL_VALUE);
+        }, 1);
+        EigenFrancisQR<DMatrix<double>> fr;
+        double tfr = Seconds([&]() { ifr = fr.Iterate(A); }, 1);
+
+        XTLog(std::cout) << n << "\t" << tqr << "\t" << iqr << "\t" << tfr << "\t" << ifr << std::endl;
+    }
+
+    XTLog(std::cout) << "n\tinverse power\t#real\tSchur" << std::endl;
+    for (int n : sizes) {
+        std::mt19937 gen(n);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        DMatrix<double> A(n, n);
+        for (int i = 0; i < n * n; i++)
+            A(i) = dist(gen);
+        EigenFrancisQR<DMatrix<double>> fr(A);
+        auto const & wr = fr.EigenValuesReal();
+        auto const & wi = fr.EigenValuesImag();
+
+        int nreal = 0;
+        double tinv = Seconds([&]() {
+            DMatrix<double> v(n, 1);
+            for (int j = 0; j < n; j++) {
+                if (0 != wi[j])
+                    continue;
+                for (int i = 0; i < n; i++)
+                    v(i) = 1;
+                // 偏移稍微离开特征值, 避免 LU 奇异
+                OffInvPowerIterate(A, v, wr[j] + 1e-10, 1e-12, 3);
+                nreal++;
+            }
+        }, 1);
+
+        DMatrix<double> V;
+        double tsch = Seconds([&]() { fr.EigenVectors(V); }, 1);
+        XTLog(std::cout) << n << "\t" << tinv << "\t" << nreal << "\t" << tsch << std::endl;
+    }
+
+    XTLog(std::cout) << "n\tfull\tLanczos\trestarts" << std::endl;
+    for (int n : sizes) {
+        std::mt19937 gen(n);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        DMatrix<double> S(n, n);
+        for (int c = 0; c < n; c++)
+            for (int r = c; r < n; r++)
+                S(r, c) = S(c, r) = dist(gen);
+
+        SymmetricEigen<DMatrix<double>> eig;
+        double tfull = Seconds([&]() { eig.Decompose(S, true); }, 1);
+        EigenLanczos<double> lanczos;
+        int restarts = 0;
+        double tlz = Seconds([&]() { restarts = lanczos.Compute(S, 10, KrylovWhich::LargestReal); }, 1);
+        XTLog(std::cout) << n << "\t" << tfull << "\t" << tlz << "\t" << restarts << std::endl;
+    }
+
+    std::vector<int> kernel_sizes = { 1000, 2000, 5000 };
+    if (argc >= 2)
+        kernel_sizes = { std::atoi(argv[1]) };
+    XTLog(std::cout) << "n\tLanczos\tsubspace\titer\twarm\titer" << std::endl;
+    for (int n : kernel_sizes) {
+        std::mt19937 gen(n);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        std::vector<double> px(n), py(n);
+        for (int i = 0; i < n; i++) {
+            px[i] = dist(gen);
+            py[i] = dist(gen);
+        }
+        DMatrix<double> K(n, n);
+        auto kernel = [&]() {
+            for (int c = 0; c < n; c++)
+                for (int r = 0; r < n; r++) {
+                    double dx = px[r] - px[c], dy = py[r] - py[c];
+                    K(r, c) = std::exp(-(dx * dx + dy * dy) / 0.5);
+                }
+        };
+        kernel();
+
+        EigenLanczos<double> lanczos;
+        double tlz = Seconds([&]() { lanczos.Compute(K, 16, KrylovWhich::LargestReal); }, 1);
+
+        EigenSubspace<DMatrix<double>> sub;
+        int iter = 0, iter_warm = 0;
+        double tsub = Seconds([&]() { iter = sub.Compute(K, 16); }, 1);
+
+        for (int i = 0; i < n; i++) {
+            px[i] += 0.01 * dist(gen);
+            py[i] += 0.01 * dist(gen);
+        }
+        kernel();
+        double twarm = Seconds([&]() { iter_warm = sub.Compute(K, 16); }, 1);
+
+        XTLog(std::cout) << n << "\t" << tlz << "\t" << tsub << "\t" << iter << "\t"
+                         << twarm << "\t" << iter_warm << std::endl;
+    }
+
+    return 0;
+}
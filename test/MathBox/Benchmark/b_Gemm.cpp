@@ -0,0 +1,84 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+//! 逐元素三重循环的上限, 再大就太慢了
+const int NaiveLimit = 1000;
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+}
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+/*
+ * 稠密矩阵乘法 C = AB 的吞吐量, 单位 GFLOP/s
+ *
+ * naive: 子阵视图走的逐元素三重循环
+ * gemm:  DMatrix 直接调用的分块 Gemm
+ *
+ * 用法: b_Gemm [n1 n2 ...], 默认 64 128 256 500 1000 2000
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty())
+        sizes = { 64, 128, 256, 500, 1000, 2000 };
+
+    std::mt19937 gen(1234);
+    XTLog(std::cout) << "n\tnaive(GFLOP/s)\tgemm(GFLOP/s)\tspeedup\tmax|diff|" << std::endl;
+    for (int n : sizes) {
+        DMatrix<double> A(n, n), B(n, n), C(n, n), D(n, n);
+        RandomFill(A, gen);
+        RandomFill(B, gen);
+
+        double flops = 2.0 * n * n * n;
+        int repeat = std::max(1, (int)(2e9 / flops));
+
+        double tgemm = Seconds([&]() { Multiply(A, B, C); }, repeat);
+        double ggemm = flops / tgemm * 1e-9;
+
+        if (n > NaiveLimit) {
+            XTLog(std::cout) << n << "\t-\t" << ggemm << "\t-\t-" << std::endl;
+            continue;
+        }
+
+        auto a = A.SubMatrix(0, 0, n, n);
+        auto b = B.SubMatrix(0, 0, n, n);
+        auto d = D.SubMatrix(0, 0, n, n);
+        double tnaive = Seconds([&]() { Multiply(a, b, d); }, std::max(1, repeat / 4));
+        double gnaive = flops / tnaive * 1e-9;
+
+        double diff = 0;
+        for (int i = 0; i < C.NumDatas(); i++)
+            diff = std::max(diff, std::abs(C(i) - D(i)));
+
+        XTLog(std::cout) << n << "\t" << gnaive << "\t" << ggemm << "\t"
+                         << tnaive / tgemm << "\t" << diff << std::endl;
+    }
+
+    return 0;
+}
+
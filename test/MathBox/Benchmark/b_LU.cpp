@@ -0,0 +1,83 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+}
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+/*
+ * 列主元 LU 分解的耗时, A 为 n x n
+ *
+ * unblocked: 逐列的秩 1 更新, 即 LUPanel
+ * blocked:   LU, 窄条分解 + Gemm 更新右下角子阵
+ * solve:     LU::Solve 同时求解 500 列右侧向量, 逐列回代(TrsmSmall)与分块 Trsm 的对比
+ *
+ * 用法: b_LU [n], 默认依次测试 200, 500, 1000, 2000, 3000
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<int> sizes;
+    if (argc >= 2)
+        sizes.push_back(std::atoi(argv[1]));
+    else
+        sizes = { 200, 500, 1000, 2000, 3000 };
+
+    std::mt19937 gen(1234);
+    XTLog(std::cout) << "n\tunblocked(s)\tblocked(s)\tGFLOP/s\tsolve unblocked(s)\tsolve blocked(s)" << std::endl;
+    for (int n : sizes) {
+        DMatrix<double> A(n, n);
+        RandomFill(A, gen);
+
+        double flops = 2.0 / 3.0 * n * n * n;
+        int repeat = std::max(1, (int)(1e9 / flops));
+
+        DMatrix<double> W = A;
+        std::vector<int> ipiv(n);
+        double tu = Seconds([&]() {
+            W = A;
+            LUPanel(n, n, W.StorBegin(), W.RowStride(), W.ColStride(), ipiv.data());
+        }, repeat);
+
+        double tb = Seconds([&]() { LU<DMatrixView<double>> lu(A.View()); }, repeat);
+
+        int nrhs = 500;
+        DMatrix<double> b(n, nrhs), x(n, nrhs);
+        RandomFill(b, gen);
+        LU<DMatrixView<double>> lu(A.View());
+        double const * L = lu().StorBegin();
+        double tsu = Seconds([&]() {
+            x = b;
+            TrsmSmall(true, true, n, nrhs, L, 1, n, x.StorBegin(), 1, n);
+            TrsmSmall(false, false, n, nrhs, L, 1, n, x.StorBegin(), 1, n);
+        }, 1);
+        double tsb = Seconds([&]() { lu.Solve(b, x); }, 1);
+
+        XTLog(std::cout) << n << "\t" << tu << "\t" << tb << "\t"
+                         << flops / tb * 1e-9 << "\t" << tsu << "\t" << tsb << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+}
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+/*
+ * Householder QR 分解 A = QR 的耗时, A 为 m x n
+ *
+ * unblocked: 逐列的秩 1 更新, 即 HouseholderPanel
+ * blocked:   QR_Householder, 紧凑 WY 形式的分块更新
+ * Q^T b:     隐式地计算 Q^T b, 不构造 Q
+ *
+ * 用法: b_QR [m n], 默认依次测试 500x100, 1000x200, 4000x200, 1000x1000
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<std::pair<int, int>> sizes;
+    if (argc >= 3)
+        sizes.push_back({ std::atoi(argv[1]), std::atoi(argv[2]) });
+    else
+        sizes = { { 500, 100 }, { 1000, 200 }, { 4000, 200 }, { 1000, 1000 } };
+
+    std::mt19937 gen(1234);
+    XTLog(std::cout) << "m x n\tunblocked(s)\tblocked(s)\tGFLOP/s\tQ^T b(s)" << std::endl;
+    for (auto & s : sizes) {
+        int m = s.first, n = s.second;
+        DMatrix<double> A(m, n), b(m, 1);
+        RandomFill(A, gen);
+        RandomFill(b, gen);
+
+        double flops = 2.0 * n * n * (m - n / 3.0);
+        int repeat = std::max(1, (int)(1e9 / flops));
+
+        DMatrix<double> W = A;
+        std::vector<double> tau(std::min(m, n));
+        double tu = Seconds([&]() {
+            W = A;
+            HouseholderPanel(m, n, W.StorBegin(), W.RowStride(), W.ColStride(), tau.data());
+        }, repeat);
+
+        QR_Householder<DMatrix<double>> qr;
+        double tb = Seconds([&]() { qr.Decompose(A); }, repeat);
+
+        DMatrix<double> c = b;
+        double tq = Seconds([&]() { c = b; qr.ApplyQT(c); }, repeat);
+
+        XTLog(std::cout) << m << "x" << n << "\t" << tu << "\t" << tb << "\t"
+                         << flops / tb * 1e-9 << "\t" << tq << std::endl;
+    }
+
+    return 0;
+}
+
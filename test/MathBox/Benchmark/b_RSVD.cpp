@@ -0,0 +1,82 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+/*
+ * m x n 矩阵前 k 个奇异三元组的耗时, 矩阵为按 0.95^i 衰减的秩 200 部分加上小的噪声
+ *
+ * full:     SVD_DivideConquer 完整分解后截取前 k 个, 只在 m <= 4000 时测试
+ * rand:     SVD_Randomized, 过采样 p = 10, 幂迭代 q = 2
+ * err:      rand 的前 k 个奇异值与 full 的最大相对误差, 没有 full 时为 0
+ *
+ * 用法: b_RSVD [m n k], 默认依次测试 2000x500, 4000x1000, 20000x2000, k = 10, 50
+ */
+int main(int argc, char *argv[])
+{
+    struct Case { int m, n, k; };
+    std::vector<Case> cases;
+    if (argc >= 4)
+        cases.push_back({ std::atoi(argv[1]), std::atoi(argv[2]), std::atoi(argv[3]) });
+    else
+        cases = { { 2000, 500, 10 }, { 2000, 500, 50 }, { 4000, 1000, 10 }, { 4000, 1000, 50 },
+                  { 20000, 2000, 10 }, { 20000, 2000, 50 } };
+
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    XTLog(std::cout) << "m\tn\tk\tfull(s)\trand(s)\tspeedup\terr" << std::endl;
+    for (auto const & c : cases) {
+        int rank = std::min(200, std::min(c.m, c.n));
+        DMatrix<double> X(c.m, rank), Y(rank, c.n);
+        for (int j = 0; j < rank; j++)
+            for (int i = 0; i < c.m; i++)
+                X(i, j) = std::pow(0.95, j) * dist(gen);
+        for (int i = 0; i < Y.NumDatas(); i++)
+            Y(i) = dist(gen);
+        DMatrix<double> A = X * Y;
+        for (int i = 0; i < A.NumDatas(); i++)
+            A(i) += 1e-3 * dist(gen);
+
+        DMatrix<double> S0;
+        double tf = 0;
+        if (c.m <= 4000) {
+            SVD_DivideConquer<DMatrix<double>> dc;
+            tf = Seconds([&]() {
+                dc.Decompose(A, true, true);
+                dc.Iterate();
+            }, 1);
+            S0 = dc.Sigma();
+        }
+
+        SVD_Randomized<DMatrix<double>> rsvd;
+        double tr = Seconds([&]() { rsvd.Decompose(A, c.k); }, 3);
+
+        double err = 0;
+        if (tf > 0) {
+            DMatrix<double> S = rsvd.Sigma();
+            for (int i = 0; i < c.k; i++)
+                err = std::max(err, std::abs(S(i, i) - S0(i, i)) / S0(i, i));
+        }
+        XTLog(std::cout) << c.m << "\t" << c.n << "\t" << c.k << "\t" << tf << "\t" << tr << "\t"
+                         << ((tf > 0) ? tf / tr : 0.0) << "\t" << err << std::endl;
+    }
+
+    return 0;
+}
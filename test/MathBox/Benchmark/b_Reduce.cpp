@@ -0,0 +1,88 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+}
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+/*
+ * 上 Hessenberg 约化和上二对角约化的耗时, 只约化不累积正交矩阵
+ *
+ * unblocked: 逐列的秩 1 更新, 即 HessenbergReduce/BidiagonalReduce 的 nx 取矩阵尺寸
+ * blocked:   窄条 + 剩余部分的 Gemm 更新, 默认的分块参数
+ *
+ * 用法: b_Reduce [n], 默认依次测试 n = 200, 500, 1000, 二对角约化的矩阵为 2n x n
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<int> sizes;
+    if (argc >= 2)
+        sizes.push_back(std::atoi(argv[1]));
+    else
+        sizes = { 200, 500, 1000 };
+
+    std::mt19937 gen(1234);
+    XTLog(std::cout) << "Hessenberg n\tunblocked(s)\tblocked(s)\tspeedup" << std::endl;
+    for (int n : sizes) {
+        DMatrix<double> A(n, n), W(n, n);
+        RandomFill(A, gen);
+        std::vector<double> tau(n);
+
+        double flops = 10.0 / 3.0 * n * n * n;
+        int repeat = std::max(1, (int)(1e9 / flops));
+        double tu = Seconds([&]() {
+            W = A;
+            HessenbergReduce(n, W.StorBegin(), 1, n, tau.data(), HouseholderReduceBlock, n);
+        }, repeat);
+        double tb = Seconds([&]() {
+            W = A;
+            HessenbergReduce(n, W.StorBegin(), 1, n, tau.data());
+        }, repeat);
+        XTLog(std::cout) << n << "\t" << tu << "\t" << tb << "\t" << tu / tb << std::endl;
+    }
+
+    XTLog(std::cout) << "Bidiagonal m x n\tunblocked(s)\tblocked(s)\tspeedup" << std::endl;
+    for (int n : sizes) {
+        int m = 2 * n;
+        DMatrix<double> A(m, n), W(m, n);
+        RandomFill(A, gen);
+        std::vector<double> tauq(n), taup(n);
+
+        double flops = 4.0 * n * n * (m - n / 3.0);
+        int repeat = std::max(1, (int)(1e9 / flops));
+        double tu = Seconds([&]() {
+            W = A;
+            BidiagonalReduce(m, n, W.StorBegin(), 1, m, tauq.data(), taup.data(), HouseholderReduceBlock, n);
+        }, repeat);
+        double tb = Seconds([&]() {
+            W = A;
+            BidiagonalReduce(m, n, W.StorBegin(), 1, m, tauq.data(), taup.data());
+        }, repeat);
+        XTLog(std::cout) << m << "x" << n << "\t" << tu << "\t" << tb << "\t" << tu / tb << std::endl;
+    }
+
+    return 0;
+}
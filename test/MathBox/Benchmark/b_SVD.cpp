@@ -0,0 +1,88 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+}
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+/*
+ * n x n 方阵的完整 SVD 分解耗时, 包括二对角化和 U, V 的累积
+ *
+ * GKR:      SVD_GKR, Givens 旋转逐个作用到 U^T 和 V 上, 只在 n <= 200 时测试
+ * D&C:      SVD_DivideConquer, 分治法, 合并步骤为 Gemm
+ * values:   SVD_DivideConquer 只计算奇异值
+ * Jacobi:   SVD_Jacobi, 单边 Jacobi, 循环赛顺序并行旋转列对, 只在 n <= 500 时测试
+ *
+ * 用法: b_SVD [n], 默认依次测试 n = 100, 200, 500, 1000
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<int> sizes;
+    if (argc >= 2)
+        sizes.push_back(std::atoi(argv[1]));
+    else
+        sizes = { 100, 200, 500, 1000 };
+
+    std::mt19937 gen(1234);
+    XTLog(std::cout) << "n\tGKR(s)\tD&C(s)\tvalues(s)\tJacobi(s)\tspeedup" << std::endl;
+    for (int n : sizes) {
+        DMatrix<double> A(n, n);
+        RandomFill(A, gen);
+        int repeat = std::max(1, 200 / n);
+
+        double tg = 0;
+        if (n <= 200) {
+            tg = Seconds([&]() {
+                SVD_GKR<DMatrix<double>> svd(A, true, true);
+                svd.Iterate(100 * n, SMALL_VALUE);
+            }, repeat);
+        }
+
+        SVD_DivideConquer<DMatrix<double>> dc;
+        double td = Seconds([&]() {
+            dc.Decompose(A, true, true);
+            dc.Iterate();
+        }, repeat);
+        double tv = Seconds([&]() {
+            dc.Decompose(A, false, false);
+            dc.Iterate();
+        }, repeat);
+
+        double tj = 0;
+        if (n <= 500) {
+            SVD_Jacobi<DMatrix<double>> jacobi;
+            tj = Seconds([&]() {
+                jacobi.Decompose(A, true, true);
+                jacobi.Iterate();
+            }, repeat);
+        }
+
+        XTLog(std::cout) << n << "\t" << tg << "\t" << td << "\t" << tv << "\t" << tj << "\t"
+                         << ((tg > 0) ? tg / td : 0.0) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(0.5, 2.0);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+}
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+/*
+ * 逐元素运算和归约在各个 SIMD 级别下的耗时, 单线程, 向量长度为 n
+ *
+ * 每一行为一个级别, 各列依次为 Add, ScalarMultiply, PointwiseDivision, Saxpy, Dot, PNorm(1), InftyNorm
+ * 的耗时(ms), 超过 CPU 支持的级别会被限制为实际支持的级别。
+ *
+ * 用法: b_Simd [n], 默认 1000000
+ */
+template <typename Scalar>
+void Run(int n)
+{
+    std::mt19937 gen(1234);
+    DMatrix<Scalar> x(n, 1), y(n, 1), z(n, 1);
+    RandomFill(x, gen);
+    RandomFill(y, gen);
+    int repeat = std::max(1, (int)(2e8 / n));
+
+    const char * names[] = { "scalar", "sse2", "avx2", "avx512" };
+    ESimdLevel detected = DetectSimdLevel();
+    XTLog(std::cout) << "level\tadd\tscale\tdiv\tsaxpy\tdot\tnorm1\tinfty" << std::endl;
+    for (int l = 0; l <= (int)detected; l++) {
+        SetSimdLevel(ESimdLevel(l));
+        Scalar sink = 0;
+        double ta = Seconds([&]() { Add(x, y, z); }, repeat);
+        double ts = Seconds([&]() { ScalarMultiply(Scalar(1.5), x, z); }, repeat);
+        double tdv = Seconds([&]() { PointwiseDivision(x, y, z); }, repeat);
+        double tx = Seconds([&]() { Saxpy(Scalar(1e-6), x, z); }, repeat);
+        double td = Seconds([&]() { sink += x.Dot(y); }, repeat);
+        double t1 = Seconds([&]() { sink += x.PNorm(1); }, repeat);
+        double ti = Seconds([&]() { sink += x.InftyNorm(); }, repeat);
+        XTLog(std::cout) << names[l] << "\t" << ta * 1e3 << "\t" << ts * 1e3 << "\t" << tdv * 1e3 << "\t"
+                         << tx * 1e3 << "\t" << td * 1e3 << "\t" << t1 * 1e3 << "\t" << ti * 1e3
+                         << "\t(" << sink << ")" << std::endl;
+    }
+    SetSimdLevel(detected);
+}
+
+int main(int argc, char *argv[])
+{
+    int n = (argc >= 2) ? std::atoi(argv[1]) : 1000000;
+    SetNumThreads(1);
+
+    XTLog(std::cout) << "double, n = " << n << std::endl;
+    Run<double>(n);
+    XTLog(std::cout) << "float, n = " << n << std::endl;
+    Run<float>(n);
+
+    return 0;
+}
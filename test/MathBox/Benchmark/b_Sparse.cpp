@@ -0,0 +1,89 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+//! N x N 网格上的 9 点 Laplace 算子, N^2 个未知数, 每行约 9 个非零元素
+SparseTriplets<double> Laplacian(int N)
+{
+    SparseTriplets<double> t(N * N, N * N, 9 * N * N);
+    for (int y = 0; y < N; y++)
+        for (int x = 0; x < N; x++) {
+            int r = y * N + x;
+            for (int dy = -1; dy <= 1; dy++)
+                for (int dx = -1; dx <= 1; dx++) {
+                    int xx = x + dx, yy = y + dy;
+                    if (xx < 0 || yy < 0 || xx >= N || yy >= N)
+                        continue;
+                    t.Add(r, yy * N + xx, (0 == dx && 0 == dy) ? 8.0 : -1.0);
+                }
+        }
+    return t;
+}
+
+/*
+ * 稀疏矩阵的构造和乘法, 矩阵为 N x N 网格上的 9 点 Laplace 算子
+ *
+ * build:    由三元组压缩为 CSR 的耗时
+ * csr/csc:  SpMV y = A x 的耗时, csr 按行收集, csc 按列分散后归约
+ * spmm:     CSR 乘以 n x 8 的 DMatrix 的耗时
+ * GB/s:     csr 的 SpMV 读取 values, inner 和 x 的有效带宽
+ *
+ * 用法: b_Sparse [N], 默认依次测试 N = 300, 1000, 分别用 1 个线程和全部线程
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<int> sizes;
+    if (argc >= 2)
+        sizes.push_back(std::atoi(argv[1]));
+    else
+        sizes = { 300, 1000 };
+    std::vector<int> threads = { 1 };
+    int hw = (int)std::thread::hardware_concurrency();
+    if (hw > 1)
+        threads.push_back(hw);
+
+    XTLog(std::cout) << "n\tnnz\tthreads\tbuild(s)\tcsr(s)\tcsc(s)\tspmm(s)\tGB/s" << std::endl;
+    for (int N : sizes) {
+        SparseTriplets<double> t = Laplacian(N);
+        int n = N * N;
+        DMatrix<double> x(n, 1), y(n, 1), X(n, 8), Y(n, 8);
+        for (int i = 0; i < n; i++)
+            x(i) = std::sin(i);
+        for (int i = 0; i < X.NumDatas(); i++)
+            X(i) = std::cos(i);
+
+        for (int nt : threads) {
+            SetNumThreads(nt);
+            SparseCSR<double> R;
+            double tb = Seconds([&]() { R.SetFromTriplets(t); }, 3);
+            SparseCSC<double> C(t);
+
+            double tr = Seconds([&]() { SpMV(1.0, R, x.StorBegin(), 1, 0.0, y.StorBegin(), 1); }, 20);
+            double tc = Seconds([&]() { SpMV(1.0, C, x.StorBegin(), 1, 0.0, y.StorBegin(), 1); }, 20);
+            double tm = Seconds([&]() { Gemm(1.0, R, X, 0.0, Y); }, 5);
+            double bytes = R.NonZeros() * (8.0 + 4.0 + 8.0) + n * 8.0;
+            XTLog(std::cout) << n << "\t" << R.NonZeros() << "\t" << nt << "\t" << tb << "\t" << tr << "\t"
+                             << tc << "\t" << tm << "\t" << bytes / tr * 1e-9 << std::endl;
+        }
+    }
+
+    return 0;
+}
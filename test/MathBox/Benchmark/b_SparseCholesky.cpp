@@ -0,0 +1,101 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Func>
+double Seconds(Func && func, int repeat)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++)
+        func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / repeat;
+}
+
+//! N x N 网格上的 5 点 Laplace 算子加上 shift 倍的单位阵, 只存储下三角
+SparseCSC<double> Laplacian(int N, double shift)
+{
+    int n = N * N;
+    SparseTriplets<double> t(n, n, 3 * n);
+    for (int y = 0; y < N; y++)
+        for (int x = 0; x < N; x++) {
+            int r = y * N + x;
+            t.Add(r, r, 4 + shift);
+            if (x + 1 < N)
+                t.Add(r + 1, r, -1);
+            if (y + 1 < N)
+                t.Add(r + N, r, -1);
+        }
+    return SparseCSC<double>(t);
+}
+
+/*
+ * 稀疏 Cholesky 分解, 矩阵为 N x N 网格上的 5 点 Laplace 算子, 只存储下三角
+ *
+ * nnzL:     L 的非零元素数量 (包括超节点中显式的 0), natural 为原始顺序, amd 为 AMD 排序
+ * analyze:  AMD 排序和符号分解的耗时
+ * factor:   数值分解的耗时, 稀疏模式不变时重复分解只需要这一步
+ * ldlt:     LDLT 数值分解的耗时
+ * solve:    求解 A x = b 的耗时
+ * resid:    ||A x - b|| / ||b||
+ *
+ * 用法: b_SparseCholesky [N], 默认依次测试 N = 100, 300, 700
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<int> sizes;
+    if (argc >= 2)
+        sizes.push_back(std::atoi(argv[1]));
+    else
+        sizes = { 100, 300, 700 };
+
+    XTLog(std::cout) << "n\tnnz(A)\tnnzL(natural)\tnnzL(amd)\tsupernodes\tanalyze(s)\tfactor(s)\tldlt(s)\tsolve(s)\tresid"
+                     << std::endl;
+    for (int N : sizes) {
+        SparseCSC<double> A = Laplacian(N, 0.01);
+        int n = A.Rows();
+        DMatrix<double> b(n, 1), x(n, 1);
+        for (int i = 0; i < n; i++)
+            b(i) = std::sin(i + 1.0);
+
+        long nnz_natural = -1;
+        if (N <= 300) {
+            SparseCholesky<double> natural;
+            natural.Analyze(A, false);
+            nnz_natural = natural.NonZerosL();
+        }
+
+        SparseCholesky<double> llt;
+        SparseLDLT<double> ldlt;
+        double ta = Seconds([&]() { llt.Analyze(A); }, 3);
+        ldlt.Analyze(A);
+        double tf = Seconds([&]() { llt.Factorize(A); }, 3);
+        double tl = Seconds([&]() { ldlt.Factorize(A); }, 3);
+        double ts = Seconds([&]() { llt.Solve(b, x); }, 5);
+
+        // 只存储了下三角, 完整的矩阵为 A + A^T - diag(A)
+        DMatrix<double> r(n, 1);
+        SpMV(1.0, A, x.StorBegin(), 1, 0.0, r.StorBegin(), 1);
+        SpMV(1.0, A.Transpose(), x.StorBegin(), 1, 1.0, r.StorBegin(), 1);
+        double rr = 0, bb = 0;
+        for (int i = 0; i < n; i++) {
+            r(i) -= A(i, i) * x(i) + b(i);
+            rr += r(i) * r(i);
+            bb += b(i) * b(i);
+        }
+
+        XTLog(std::cout) << n << "\t" << A.NonZeros() << "\t" << nnz_natural << "\t" << llt.NonZerosL() << "\t"
+                         << llt.NumSupernodes() << "\t" << ta << "\t" << tf << "\t" << tl << "\t" << ts << "\t"
+                         << std::sqrt(rr / bb) << std::endl;
+    }
+
+    return 0;
+}
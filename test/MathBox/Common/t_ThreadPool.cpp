@@ -0,0 +1,96 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace xiaotu;
+
+TEST(ThreadPool, ParallelFor)
+{
+    SetNumThreads(4);
+    EXPECT_EQ(4, GetNumThreads());
+
+    // 每个元素恰好访问一次, 覆盖尾部不足一块的情况
+    std::vector<std::atomic<int>> hits(1003);
+    ParallelFor(0, (int)hits.size(), 10, [&](int b, int e) {
+        for (int i = b; i < e; i++)
+            hits[i]++;
+    });
+    for (auto & h : hits)
+        EXPECT_EQ(1, h.load());
+
+    // 嵌套调用退化为串行
+    std::atomic<int> count{0};
+    ParallelFor(0, 8, 1, [&](int, int) {
+        EXPECT_TRUE(ThreadPool::InParallel());
+        ParallelFor(0, 8, 1, [&](int, int) { count++; });
+    });
+    EXPECT_EQ(64, count.load());
+    EXPECT_FALSE(ThreadPool::InParallel());
+
+    // 任务中的异常在调用线程重新抛出, 线程池仍然可用
+    EXPECT_THROW(ParallelFor(0, 100, 1, [&](int b, int) {
+        if (37 == b)
+            throw std::runtime_error("37");
+    }), std::runtime_error);
+    count = 0;
+    ParallelFor(0, 100, 1, [&](int, int) { count++; });
+    EXPECT_EQ(100, count.load());
+
+    SetNumThreads(1);
+    EXPECT_EQ(1, GetNumThreads());
+}
+
+TEST(ThreadPool, Kernels)
+{
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    int n = 300;
+    DMatrix<double> A(n, n), B(n, 200);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+    for (int i = 0; i < B.NumDatas(); i++)
+        B(i) = dist(gen);
+    for (int i = 0; i < n; i++)
+        A(i, i) += n;
+
+    SetNumThreads(1);
+    DMatrix<double> C1 = A * B;
+    DMatrix<double> S1 = A + A.Transpose();
+    DMatrix<double> X1(n, 200);
+    LU lu1(A.View());
+    lu1.Solve(B, X1);
+
+    SetNumThreads(4);
+    DMatrix<double> C4 = A * B;
+    DMatrix<double> S4 = A + A.Transpose();
+    DMatrix<double> X4(n, 200);
+    LU lu4(A.View());
+    lu4.Solve(B, X4);
+
+    // 各个任务块的计算顺序与串行时一致
+    for (int i = 0; i < C1.NumDatas(); i++)
+        EXPECT_EQ(C1(i), C4(i));
+    for (int i = 0; i < S1.NumDatas(); i++)
+        EXPECT_EQ(S1(i), S4(i));
+    for (int i = 0; i < X1.NumDatas(); i++)
+        EXPECT_NEAR(X1(i), X4(i), 1e-12);
+
+    DMatrix<double> S = S4;
+    Cholesky cholesky(S.View());
+    DMatrix<double> Y(n, 200);
+    cholesky.Solve(B, Y);
+    DMatrix<double> r = S * Y - B;
+    for (int i = 0; i < r.NumDatas(); i++)
+        EXPECT_NEAR(0, r(i), 1e-10);
+
+    SetNumThreads(1);
+}
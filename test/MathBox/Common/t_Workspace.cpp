@@ -0,0 +1,150 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+using namespace xiaotu;
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+}
+
+template <typename MatA, typename MatB>
+bool IsClose(MatA const & A, MatB const & B, double tol)
+{
+    if (A.Rows() != B.Rows() || A.Cols() != B.Cols())
+        return false;
+    for (int r = 0; r < A.Rows(); r++)
+        for (int c = 0; c < A.Cols(); c++)
+            if (std::abs(A(r, c) - B(r, c)) > tol)
+                return false;
+    return true;
+}
+
+TEST(Workspace, Frame)
+{
+    Workspace ws(1000);
+    EXPECT_EQ(1024u, ws.Capacity());
+
+    {
+        WorkspaceFrame f0(ws);
+        double * a = f0.Alloc<double>(10);
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(a) % Workspace::Alignment);
+        EXPECT_EQ(128u, ws.Used());
+        {
+            WorkspaceFrame f1(ws);
+            int * b = f1.Alloc<int>(3);
+            EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(b) % Workspace::Alignment);
+            EXPECT_EQ(192u, ws.Used());
+        }
+        EXPECT_EQ(128u, ws.Used());
+
+        // 超出容量时临时向堆申请, 仍然可以正常读写
+        float * c = f0.Alloc<float>(1000);
+        for (int i = 0; i < 1000; i++)
+            c[i] = i;
+        EXPECT_EQ(999.0f, c[999]);
+        EXPECT_EQ(1024u, ws.Capacity());
+    }
+
+    // 全部释放以后扩到峰值
+    EXPECT_EQ(0u, ws.Used());
+    EXPECT_EQ(128u + 4032u, ws.Peak());
+    EXPECT_EQ(ws.Peak(), ws.Capacity());
+}
+
+TEST(Workspace, Guard)
+{
+    Workspace ws;
+    Workspace * local = &CurrentWorkspace();
+    {
+        WorkspaceGuard guard(ws);
+        EXPECT_EQ(&ws, &CurrentWorkspace());
+        {
+            Workspace inner;
+            WorkspaceGuard guard2(inner);
+            EXPECT_EQ(&inner, &CurrentWorkspace());
+        }
+        EXPECT_EQ(&ws, &CurrentWorkspace());
+    }
+    EXPECT_EQ(local, &CurrentWorkspace());
+}
+
+//! 同一个对象重复分解, 结果与新对象一致; 第二次分解时绑定的 Workspace 不再扩容
+TEST(Workspace, Reuse)
+{
+    int n = 150;
+    std::mt19937 gen(42);
+    DMatrix<double> A(n, n), B(n, 3), X(n, 3);
+    RandomFill(A, gen);
+    RandomFill(B, gen);
+    DMatrix<double> S = A.Transpose() * A;
+    for (int i = 0; i < n; i++)
+        S(i, i) += n;
+
+    Workspace ws;
+    LU<DMatrix<double>> lu;
+    Cholesky<DMatrix<double>> chol;
+    LDLT<DMatrix<double>> ldlt;
+    QR_Householder<DMatrix<double>> qr;
+    Bidiagonal<DMatrix<double>> bidiag;
+    UpperHessenberg<DMatrix<double>> hess;
+    EigenImplicitQR<DMatrix<double>> eig;
+    SVD_GKR<DMatrix<double>> svd;
+
+    auto run = [&]() {
+        WorkspaceGuard guard(ws);
+        lu.Decompose(A);
+        chol.Decompose(S);
+        ldlt.Decompose(S);
+        qr.Decompose(A);
+        bidiag.Decompose(A);
+        hess.ByHouseholder(A);
+        eig.Iterate(S, 1000, 1e-10);
+        svd.Decompose(A, true, true);
+        svd.Iterate(1000, 1e-10);
+    };
+
+    run();
+    std::size_t capacity = ws.Capacity();
+    EXPECT_GT(capacity, 0u);
+    run();
+    EXPECT_EQ(capacity, ws.Capacity());
+    EXPECT_EQ(0u, ws.Used());
+
+    LU<DMatrix<double>> lu2(A);
+    EXPECT_TRUE(IsClose(lu(), lu2(), 1e-12));
+    lu.Solve(B, X);
+    EXPECT_TRUE(IsClose(A * X, B, 1e-9));
+
+    Cholesky<DMatrix<double>> chol2(S);
+    EXPECT_TRUE(IsClose(chol(), chol2(), 1e-12));
+    chol.Solve(B, X);
+    EXPECT_TRUE(IsClose(S * X, B, 1e-9));
+
+    ldlt.Solve(B, X);
+    EXPECT_TRUE(IsClose(S * X, B, 1e-9));
+
+    EXPECT_TRUE(IsClose(qr.Q() * qr.R(), A, 1e-10));
+
+    EXPECT_TRUE(bidiag.B().IsUpperBiDiagonal(1e-10));
+    EXPECT_TRUE(IsClose(bidiag.UT().Transpose() * bidiag.B() * bidiag.V().Transpose(), A, 1e-10));
+
+    EXPECT_TRUE(IsClose(hess.Q().Transpose() * hess.H() * hess.Q(), A, 1e-10));
+
+    EXPECT_TRUE(IsClose(eig.Q().Transpose() * eig.Sigma() * eig.Q(), S, 1e-8));
+
+    EXPECT_TRUE(IsClose(svd.UT().Transpose() * svd.Sigma() * svd.V().Transpose(), A, 1e-10));
+    for (int i = 1; i < n; i++)
+        EXPECT_GE(std::abs(svd.Sigma()(i - 1, i - 1)), std::abs(svd.Sigma()(i, i)));
+}
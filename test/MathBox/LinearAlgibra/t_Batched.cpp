@@ -0,0 +1,176 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename MatA, typename MatB>
+bool IsClose(MatA const & A, MatB const & B, double tol)
+{
+    if (A.Rows() != B.Rows() || A.Cols() != B.Cols())
+        return false;
+    for (int r = 0; r < A.Rows(); r++)
+        for (int c = 0; c < A.Cols(); c++)
+            if (std::abs(A(r, c) - B(r, c)) > tol)
+                return false;
+    return true;
+}
+
+//! 与逐个分解的 LU, Cholesky, LDLT 对比, count 不是组大小的整数倍, 覆盖最后一组的填充通道
+template <typename Scalar, int N>
+void CheckBatched(int count, double tol)
+{
+    std::mt19937 gen(count * 7 + N);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    BatchedMatrix<Scalar, N, N> A(count), S(count);
+    BatchedMatrix<Scalar, N, 2> B(count), X(count);
+    std::vector<DMatrix<double>> As, Ss, Bs;
+    for (int b = 0; b < count; b++) {
+        DMatrix<double> a(N, N), bb(N, 2);
+        for (int i = 0; i < N * N; i++)
+            a(i) = dist(gen);
+        for (int i = 0; i < N * 2; i++)
+            bb(i) = dist(gen);
+        DMatrix<double> s = a.Transpose() * a;
+        for (int i = 0; i < N; i++)
+            s(i, i) += 1.0;
+
+        A.Set(b, a);
+        S.Set(b, s);
+        B.Set(b, bb);
+        As.push_back(a);
+        Ss.push_back(s);
+        Bs.push_back(bb);
+    }
+
+    BatchedMatrix<Scalar, N, 1> piv;
+    BatchedMatrix<Scalar, N, N> LU_ = A;
+    EXPECT_EQ(0, BatchedLU(LU_, piv));
+    X = B;
+    BatchedLUSolve(LU_, piv, X);
+    for (int b = 0; b < count; b++) {
+        LU<DMatrix<double>> lu(As[b]);
+        EXPECT_TRUE(IsClose(LU_.Get(b), lu(), tol));
+        EXPECT_TRUE(IsClose(As[b] * X.Get(b), Bs[b], tol));
+    }
+
+    BatchedMatrix<Scalar, N, N> L = S;
+    EXPECT_EQ(0, BatchedCholesky(L));
+    X = B;
+    BatchedCholeskySolve(L, X);
+    for (int b = 0; b < count; b++) {
+        Cholesky<DMatrix<double>> chol(Ss[b]);
+        EXPECT_TRUE(IsClose(L.Get(b), chol(), tol));
+        EXPECT_TRUE(IsClose(Ss[b] * X.Get(b), Bs[b], tol));
+    }
+
+    BatchedMatrix<Scalar, N, N> LD = S;
+    EXPECT_EQ(0, BatchedLDLT(LD));
+    X = B;
+    BatchedLDLTSolve(LD, X);
+    for (int b = 0; b < count; b++) {
+        LDLT<DMatrix<double>> ldlt(Ss[b]);
+        auto ld = LD.Get(b);
+        auto l = ldlt.L();
+        auto d = ldlt.D();
+        for (int r = 0; r < N; r++)
+            for (int c = 0; c <= r; c++)
+                EXPECT_NEAR((r == c) ? d(r, r) : l(r, c), ld(r, c), tol);
+        EXPECT_TRUE(IsClose(Ss[b] * X.Get(b), Bs[b], tol));
+    }
+}
+
+TEST(Batched, Solvers)
+{
+    ESimdLevel detected = DetectSimdLevel();
+    std::vector<ESimdLevel> levels = {
+        ESimdLevel::eScalar, ESimdLevel::eSSE2, ESimdLevel::eAVX2, ESimdLevel::eAVX512
+    };
+    for (auto level : levels) {
+        SetSimdLevel(level);
+        CheckBatched<double, 3>(37, 1e-9);
+        CheckBatched<double, 4>(8, 1e-9);
+        CheckBatched<double, 6>(101, 1e-9);
+        CheckBatched<float, 3>(37, 1e-3);
+        CheckBatched<float, 6>(33, 1e-3);
+    }
+    SetSimdLevel(detected);
+}
+
+TEST(Batched, Failures)
+{
+    // 混入奇异矩阵和非正定矩阵, 只统计实际的矩阵, 不影响同组的其它矩阵
+    int count = 21;
+    BatchedMatrix<double, 3, 3> A(count);
+    BatchedMatrix<double, 3, 1> B(count);
+    for (int b = 0; b < count; b++) {
+        AMatrix<double, 3, 3> a = {
+            4, 1, 0,
+            1, 3, 1,
+            0, 1, 2
+        };
+        if (0 == b % 5)
+            a(2, 2) = -2;
+        if (7 == b)
+            for (int i = 0; i < 9; i++)
+                a(i) = 0;
+        A.Set(b, a);
+        for (int i = 0; i < 3; i++)
+            B.At(b, i, 0) = i + 1;
+    }
+
+    BatchedMatrix<double, 3, 3> L = A;
+    EXPECT_EQ(6, BatchedCholesky(L));
+    BatchedMatrix<double, 3, 3> LD = A;
+    EXPECT_EQ(6, BatchedLDLT(LD));
+    BatchedMatrix<double, 3, 1> piv;
+    BatchedMatrix<double, 3, 3> LU_ = A;
+    EXPECT_EQ(1, BatchedLU(LU_, piv));
+
+    BatchedCholeskySolve(L, B);
+    auto x = B.Get(1);
+    auto a = A.Get(1);
+    auto ax = a * x;
+    for (int i = 0; i < 3; i++)
+        EXPECT_NEAR(i + 1, ax(i), 1e-12);
+}
+
+TEST(Batched, Parallel)
+{
+    // 多线程的结果与单线程一致
+    int count = 20000;
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    BatchedMatrix<double, 4, 4> A(count);
+    BatchedMatrix<double, 4, 1> B(count);
+    for (int b = 0; b < count; b++) {
+        for (int r = 0; r < 4; r++) {
+            for (int c = 0; c < 4; c++)
+                A.At(b, r, c) = dist(gen) + ((r == c) ? 4 : 0);
+            B.At(b, r, 0) = dist(gen);
+        }
+    }
+
+    BatchedMatrix<double, 4, 1> piv1, piv4;
+    BatchedMatrix<double, 4, 4> A1 = A, A4 = A;
+    BatchedMatrix<double, 4, 1> X1 = B, X4 = B;
+    SetNumThreads(1);
+    BatchedLU(A1, piv1);
+    BatchedLUSolve(A1, piv1, X1);
+    SetNumThreads(4);
+    BatchedLU(A4, piv4);
+    BatchedLUSolve(A4, piv4, X4);
+    SetNumThreads(1);
+
+    for (int b = 0; b < count; b++)
+        for (int r = 0; r < 4; r++)
+            EXPECT_EQ(X1.At(b, r, 0), X4.At(b, r, 0));
+}
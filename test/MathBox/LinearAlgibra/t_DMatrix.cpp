@@ -170,7 +170,7 @@ TEST(LinearAlgibra, Operations)
         4,  2, 1
     };
     auto B = Matrix<double, 3, 3>::Eye() * 2;
-    auto C = A + A;
+    DMatrix<double> C = A + A;
     auto D = A * B;
     for (int idx = 0; idx < A.NumDatas(); idx++)
         EXPECT_TRUE(std::abs(C(idx) - D(idx)) < 1e-9);
@@ -268,3 +268,74 @@ TEST(LinearAlgibra, QR_Householder)
     XTLog(std::cout) << "a = " << a << std::endl;
 }
 
+TEST(LinearAlgibra, DMatrixMove)
+{
+    static_assert(std::is_nothrow_move_constructible<DMatrix<double>>::value);
+    static_assert(std::is_nothrow_move_assignable<DMatrix<double>>::value);
+
+    DMatrix<double> A = DMatrix<double>::Eye(4, 4);
+    double const * data = A.StorBegin();
+
+    DMatrix<double> B(std::move(A));
+    EXPECT_EQ(data, B.StorBegin());
+    EXPECT_EQ(4, B.Rows());
+    EXPECT_EQ(4, B.Cols());
+    EXPECT_TRUE(B.IsIdentity());
+    EXPECT_EQ(0, A.Rows());
+    EXPECT_EQ(0, A.Cols());
+
+    DMatrix<double> C(2, 3);
+    C = std::move(B);
+    EXPECT_EQ(data, C.StorBegin());
+    EXPECT_EQ(4, C.Rows());
+    EXPECT_TRUE(C.IsIdentity());
+    EXPECT_EQ(0, B.NumDatas());
+
+    // 被移动的对象可以重新赋值
+    A = C;
+    EXPECT_TRUE(A.IsIdentity());
+
+    // 自乘需要临时矩阵, 求值后直接接管临时矩阵的存储
+    DMatrix<double> D = DMatrix<double>::Eye(4, 4);
+    D(0, 1) = 2;
+    D = D * D;
+    EXPECT_DOUBLE_EQ(4, D(0, 1));
+    EXPECT_DOUBLE_EQ(1, D(0, 0));
+}
+
+TEST(LinearAlgibra, DMatrixResizeAssign)
+{
+    DMatrix<double> A(2, 3);
+    A = {
+        1, 2, 3,
+        4, 5, 6
+    };
+
+    // 尺寸不一致时按照右侧重新分配
+    DMatrix<double> B(4, 4);
+    B = A;
+    EXPECT_EQ(2, B.Rows());
+    EXPECT_EQ(3, B.Cols());
+    for (int i = 0; i < A.NumDatas(); i++)
+        EXPECT_DOUBLE_EQ(A(i), B(i));
+
+    B = A.Transpose() * A;
+    EXPECT_EQ(3, B.Rows());
+    EXPECT_EQ(3, B.Cols());
+    EXPECT_DOUBLE_EQ(17, B(0, 0));
+    EXPECT_DOUBLE_EQ(36, B(1, 2));
+
+    Matrix<double, 2, 2> F = Matrix<double, 2, 2>::Eye();
+    B = F;
+    EXPECT_EQ(2, B.Rows());
+    EXPECT_EQ(2, B.Cols());
+    EXPECT_TRUE(B.IsIdentity());
+
+    // 右侧引用了自己的数据
+    B = A;
+    B = B.SubMatrix(0, 1, 2, 2);
+    EXPECT_EQ(2, B.Rows());
+    EXPECT_EQ(2, B.Cols());
+    EXPECT_DOUBLE_EQ(2, B(0, 0));
+    EXPECT_DOUBLE_EQ(6, B(1, 1));
+}
@@ -8,6 +8,7 @@
 #include <memory>
 #include <vector>
 #include <cmath>
+#include <random>
 
 using namespace xiaotu;
 
@@ -186,3 +187,453 @@ TEST(Eigen, ImplicitQR_Complex_Eigen)
 }
 
 
+
+//! 检查 A V = V diag(d), V^T V = I, 且特征值升序排列
+template <typename Mat>
+void CheckSymmetricEigen(Mat const & A, SymmetricEigen<Mat> const & eig, double tol)
+{
+    int n = A.Rows();
+    auto const & d = eig.EigenValues();
+    auto const & V = eig.EigenVectors();
+    DMatrix<double> AV = A * V;
+    DMatrix<double> VtV = V.Transpose() * V;
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) {
+            EXPECT_NEAR(AV(r, c), V(r, c) * d[c], tol);
+            EXPECT_NEAR(VtV(r, c), (r == c) ? 1.0 : 0.0, tol);
+        }
+    }
+    for (int i = 1; i < n; i++)
+        EXPECT_LE(d[i - 1], d[i]);
+}
+
+TEST(Eigen, Symmetric)
+{
+    Matrix<double, 5, 5> A = {
+        3, 1, 1, 1, 1,
+        1, 2, 1, 1, 1,
+        1, 1, 2, 1, 1,
+        1, 1, 1, 2, 1,
+        1, 1, 1, 1, 3,
+    };
+
+    {
+        SymmetricEigen<Matrix<double, 5, 5>> eig(A);
+        CheckSymmetricEigen(A, eig, 1e-12);
+
+        EigenImplicitQR<Matrix<double, 5, 5>> qr;
+        qr.Iterate(A, 25, SMALL_VALUE);
+        auto eigen_values = qr.EigenValues();
+        std::sort(eigen_values.begin(), eigen_values.end());
+        for (int i = 0; i < 5; i++)
+            EXPECT_NEAR(eigen_values[i], eig.EigenValues()[i], 1e-9);
+
+        MatrixView<double, 5, 1> lambdas(const_cast<double *>(eig.EigenValues().data()));
+        XTLog(std::cout) << "lambdas = " << lambdas << std::endl;
+    }
+
+    // 重特征值
+    Matrix<double, 3, 3> B = {
+        2, 1, 1,
+        1, 2, 1,
+        1, 1, 2
+    };
+    {
+        SymmetricEigen<Matrix<double, 3, 3>> eig(B);
+        CheckSymmetricEigen(B, eig, 1e-12);
+        EXPECT_NEAR(1.0, eig.EigenValues()[0], 1e-12);
+        EXPECT_NEAR(1.0, eig.EigenValues()[1], 1e-12);
+        EXPECT_NEAR(4.0, eig.EigenValues()[2], 1e-12);
+    }
+
+    // 随机矩阵, 只求特征值时结果一致; 同一个对象重复分解
+    int n = 120;
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    DMatrix<double> S(n, n);
+    for (int c = 0; c < n; c++)
+        for (int r = c; r < n; r++)
+            S(r, c) = S(c, r) = dist(gen);
+
+    SymmetricEigen<DMatrix<double>> eig;
+    eig.Decompose(S, false);
+    std::vector<double> values = eig.EigenValues();
+    eig.Decompose(S);
+    CheckSymmetricEigen(S, eig, 1e-10);
+    for (int i = 0; i < n; i++)
+        EXPECT_NEAR(values[i], eig.EigenValues()[i], 1e-10);
+
+    // 已经是对角阵
+    DMatrix<double> D(4, 4);
+    for (int i = 0; i < 16; i++)
+        D(i) = 0;
+    D(0, 0) = 3; D(1, 1) = -1; D(2, 2) = 2; D(3, 3) = 0;
+    SymmetricEigen<DMatrix<double>> eigD(D);
+    CheckSymmetricEigen(D, eigD, 1e-14);
+    EXPECT_EQ(-1.0, eigD.EigenValues()[0]);
+    EXPECT_EQ(3.0, eigD.EigenValues()[3]);
+}
+
+//! 检查 A = Q^T T Q, Q 正交, T 为拟上三角矩阵, 且对角块与输出的特征值一致
+template <typename Mat>
+void CheckFrancisQR(Mat const & A, EigenFrancisQR<Mat> const & qr, double tol)
+{
+    int n = A.Rows();
+    auto const & T = qr.T();
+    auto const & Q = qr.Q();
+    auto const & wr = qr.EigenValuesReal();
+    auto const & wi = qr.EigenValuesImag();
+
+    DMatrix<double> QtTQ = Q.Transpose() * T * Q;
+    DMatrix<double> QQt = Q * Q.Transpose();
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) {
+            EXPECT_NEAR(A(r, c), QtTQ(r, c), tol);
+            EXPECT_NEAR((r == c) ? 1.0 : 0.0, QQt(r, c), tol);
+            if (r > c + 1) {
+                EXPECT_EQ(0.0, T(r, c));
+            }
+        }
+    }
+
+    double trace = 0, sum = 0;
+    for (int i = 0; i < n; i++)
+        trace += A(i, i);
+    for (int i = 0; i < n; i++) {
+        sum += wr[i];
+        if (0 == wi[i]) {
+            EXPECT_EQ(wr[i], T(i, i));
+            if (i + 1 < n) {
+                EXPECT_EQ(0.0, T(i + 1, i));
+            }
+        } else {
+            // 2x2 块的特征值 wr +- i wi
+            ASSERT_LT(i + 1, n);
+            EXPECT_GT(wi[i], 0);
+            EXPECT_EQ(-wi[i], wi[i + 1]);
+            double tr = T(i, i) + T(i + 1, i + 1);
+            double det = T(i, i) * T(i + 1, i + 1) - T(i, i + 1) * T(i + 1, i);
+            EXPECT_NEAR(tr, 2 * wr[i], tol);
+            EXPECT_NEAR(det, wr[i] * wr[i] + wi[i] * wi[i], tol);
+            sum += wr[i + 1];
+            i++;
+        }
+    }
+    EXPECT_NEAR(trace, sum, tol * n);
+}
+
+TEST(Eigen, FrancisQR)
+{
+    // 特征值为 -1 的 5 次方根, 两对共轭复数
+    Matrix<double, 5, 5> A = {
+        0, 1, 0, 0, 0,
+        0, 0, 1, 0, 0,
+        0, 0, 0, 1, 0,
+        0, 0, 0, 0, 1,
+       -1, 0, 0, 0, 0,
+    };
+
+    {
+        EigenFrancisQR<Matrix<double, 5, 5>> qr;
+        int n = qr.Iterate(A);
+        XTLog(std::cout) << "迭代次数: " << n << std::endl;
+        XTLog(std::cout) << "T = " << qr.T() << std::endl;
+        CheckFrancisQR(A, qr, 1e-12);
+
+        int ncomplex = 0;
+        for (int i = 0; i < 5; i++) {
+            double re = qr.EigenValuesReal()[i];
+            double im = qr.EigenValuesImag()[i];
+            EXPECT_NEAR(1.0, re * re + im * im, 1e-12);
+            if (0 != im)
+                ncomplex++;
+        }
+        EXPECT_EQ(4, ncomplex);
+    }
+
+    // 随机的一般矩阵, 活动块足够大时会进行激进的早期收缩
+    int n = 200;
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    DMatrix<double> B(n, n);
+    for (int i = 0; i < n * n; i++)
+        B(i) = dist(gen);
+
+    EigenFrancisQR<DMatrix<double>> qr;
+    int sweeps = qr.Iterate(B);
+    XTLog(std::cout) << n << "x" << n << " 迭代次数: " << sweeps << std::endl;
+    CheckFrancisQR(B, qr, 1e-10);
+    EXPECT_LT(sweeps, 3 * n);
+
+    // 只求特征值, 结果一致
+    std::vector<double> wr = qr.EigenValuesReal();
+    std::vector<double> wi = qr.EigenValuesImag();
+    qr.Iterate(B, 30, false);
+    for (int i = 0; i < n; i++) {
+        EXPECT_NEAR(wr[i], qr.EigenValuesReal()[i], 1e-8);
+        EXPECT_NEAR(wi[i], qr.EigenValuesImag()[i], 1e-8);
+    }
+}
+
+//! 检查实特征值 A v = wr v, 共轭复特征值 A (vr + i vi) = (wr + i wi)(vr + i vi), 且各特征向量为单位长度
+template <typename Mat>
+void CheckEigenVectors(Mat const & A, DMatrix<double> const & V,
+                       std::vector<double> const & wr, std::vector<double> const & wi, double tol)
+{
+    int n = A.Rows();
+    DMatrix<double> AV = A * V;
+    for (int j = 0; j < V.Cols(); j++) {
+        double norm = 0;
+        if (0 == wi[j]) {
+            for (int r = 0; r < n; r++) {
+                EXPECT_NEAR(AV(r, j), wr[j] * V(r, j), tol);
+                norm += V(r, j) * V(r, j);
+            }
+        } else {
+            for (int r = 0; r < n; r++) {
+                EXPECT_NEAR(AV(r, j), wr[j] * V(r, j) - wi[j] * V(r, j + 1), tol);
+                EXPECT_NEAR(AV(r, j + 1), wi[j] * V(r, j) + wr[j] * V(r, j + 1), tol);
+                norm += V(r, j) * V(r, j) + V(r, j + 1) * V(r, j + 1);
+            }
+            j++;
+        }
+        EXPECT_NEAR(1.0, norm, tol);
+    }
+}
+
+TEST(Eigen, SchurEigenVectors)
+{
+    Matrix<double, 5, 5> A = {
+        0, 1, 0, 0, 0,
+        0, 0, 1, 0, 0,
+        0, 0, 0, 1, 0,
+        0, 0, 0, 0, 1,
+       -1, 0, 0, 0, 0,
+    };
+
+    {
+        EigenFrancisQR<Matrix<double, 5, 5>> qr(A);
+        DMatrix<double> V;
+        qr.EigenVectors(V);
+        XTLog(std::cout) << "V = " << V << std::endl;
+        CheckEigenVectors(A, V, qr.EigenValuesReal(), qr.EigenValuesImag(), 1e-12);
+    }
+
+    {
+        // EigenImplicitQR 收敛以后, 从 Sigma 的对角块读出特征值
+        double first_off = -1.0;
+        EigenImplicitQR<Matrix<double, 5, 5>> qr;
+        qr.Iterate(A, 1000, SMALL_VALUE, &first_off);
+        DMatrix<double> V;
+        qr.EigenVectors(V);
+
+        auto const & S = qr.Sigma();
+        std::vector<double> wr(5), wi(5, 0.0);
+        for (int j = 0; j < 5; j++) {
+            if (j + 1 < 5 && std::abs(S(j + 1, j)) >= SMALL_VALUE) {
+                double a = S(j, j), b = S(j, j + 1), c = S(j + 1, j), d = S(j + 1, j + 1);
+                double p = (a - d) / 2;
+                wr[j] = wr[j + 1] = (a + d) / 2;
+                wi[j] = std::sqrt(-(p * p + b * c));
+                wi[j + 1] = -wi[j];
+                j++;
+            } else {
+                wr[j] = S(j, j);
+            }
+        }
+        CheckEigenVectors(A, V, wr, wi, 1e-9);
+    }
+
+    // 随机的一般矩阵
+    int n = 80;
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    DMatrix<double> B(n, n);
+    for (int i = 0; i < n * n; i++)
+        B(i) = dist(gen);
+
+    EigenFrancisQR<DMatrix<double>> qr(B);
+    DMatrix<double> V;
+    qr.EigenVectors(V);
+    CheckEigenVectors(B, V, qr.EigenValuesReal(), qr.EigenValuesImag(), 1e-10);
+
+    // 上三角矩阵带重特征值
+    DMatrix<double> U(4, 4);
+    for (int i = 0; i < 16; i++)
+        U(i) = 0;
+    U(0, 0) = 2; U(1, 1) = 2; U(2, 2) = 3; U(3, 3) = -1;
+    U(0, 1) = 1; U(0, 3) = 1; U(1, 2) = 4; U(2, 3) = 0.5;
+    EigenFrancisQR<DMatrix<double>> qrU(U);
+    qrU.EigenVectors(V);
+    CheckEigenVectors(U, V, qrU.EigenValuesReal(), qrU.EigenValuesImag(), 1e-8);
+}
+
+TEST(Eigen, Lanczos)
+{
+    int n = 300;
+    std::mt19937 gen(22);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    DMatrix<double> A(n, n);
+    for (int c = 0; c < n; c++)
+        for (int r = c; r < n; r++)
+            A(r, c) = A(c, r) = dist(gen);
+
+    SymmetricEigen<DMatrix<double>> eig(A, false);
+    auto const & d = eig.EigenValues();
+
+    int k = 5;
+    EigenLanczos<double> lanczos;
+    lanczos.Compute(A, k, KrylovWhich::LargestReal);
+    for (int i = 0; i < k; i++)
+        EXPECT_NEAR(d[n - 1 - i], lanczos.EigenValues()[i], 1e-10);
+    CheckEigenVectors(A, lanczos.EigenVectors(), lanczos.EigenValuesReal(), lanczos.EigenValuesImag(), 1e-8);
+
+    lanczos.Compute(A, k, KrylovWhich::SmallestReal);
+    for (int i = 0; i < k; i++)
+        EXPECT_NEAR(d[i], lanczos.EigenValues()[i], 1e-10);
+    CheckEigenVectors(A, lanczos.EigenVectors(), lanczos.EigenValuesReal(), lanczos.EigenValuesImag(), 1e-8);
+
+    // 移位求逆, 最接近 0.3 的特征值
+    std::vector<double> near(d);
+    std::sort(near.begin(), near.end(), [](double a, double b) { return std::abs(a - 0.3) < std::abs(b - 0.3); });
+    lanczos.ComputeShiftInvert(A, k, 0.3);
+    for (int i = 0; i < k; i++)
+        EXPECT_NEAR(near[i], lanczos.EigenValues()[i], 1e-10);
+    CheckEigenVectors(A, lanczos.EigenVectors(), lanczos.EigenValuesReal(), lanczos.EigenValuesImag(), 1e-8);
+
+    // 不存储矩阵的一维 Laplace 算子, 特征值为 2 - 2cos(j pi / (m + 1)), 最小的几个非常密集,
+    // 以追赶法求解三对角方程组作为移位求逆的算子
+    int m = 1000;
+    auto solve = [m](double const * x, double * y) {
+        std::vector<double> c(m);
+        double b = 2;
+        y[0] = x[0] / b;
+        for (int i = 1; i < m; i++) {
+            c[i] = -1 / b;
+            b = 2 + c[i];
+            y[i] = (x[i] + y[i - 1]) / b;
+        }
+        for (int i = m - 2; i >= 0; i--)
+            y[i] -= c[i + 1] * y[i + 1];
+    };
+    lanczos.ComputeShiftInvert(m, solve, 4, 0.0);
+    for (int i = 0; i < 4; i++) {
+        double lambda = 2 - 2 * std::cos((i + 1) * M_PI / (m + 1));
+        EXPECT_NEAR(1.0, lanczos.EigenValues()[i] / lambda, 1e-10);
+    }
+}
+
+TEST(Eigen, Arnoldi)
+{
+    // 几个分离的实特征值和共轭复特征值, 加上小的随机扰动
+    int n = 200;
+    std::mt19937 gen(23);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    DMatrix<double> A(n, n);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = 0.5 * dist(gen) / std::sqrt(n);
+    A(0, 0) += 5;
+    A(1, 1) += 3; A(1, 2) += 2;
+    A(2, 1) -= 2; A(2, 2) += 3;
+    A(3, 3) -= 4;
+    A(4, 4) += 0.5; A(4, 5) += 3;
+    A(5, 4) -= 3; A(5, 5) += 0.5;
+
+    EigenFrancisQR<DMatrix<double>> qr(A, false);
+    std::vector<std::pair<double, double>> w;
+    for (int i = 0; i < n; i++)
+        w.push_back({ qr.EigenValuesReal()[i], qr.EigenValuesImag()[i] });
+    std::stable_sort(w.begin(), w.end(), [](auto const & a, auto const & b) {
+        return std::hypot(a.first, a.second) > std::hypot(b.first, b.second);
+    });
+
+    EigenArnoldi<double> arnoldi;
+    arnoldi.Compute(A, 6, KrylovWhich::LargestMagnitude);
+    ASSERT_EQ(6u, arnoldi.EigenValuesReal().size());
+    for (int i = 0; i < 6; i++) {
+        EXPECT_NEAR(w[i].first, arnoldi.EigenValuesReal()[i], 1e-10);
+        EXPECT_NEAR(w[i].second, arnoldi.EigenValuesImag()[i], 1e-10);
+    }
+    CheckEigenVectors(A, arnoldi.EigenVectors(), arnoldi.EigenValuesReal(), arnoldi.EigenValuesImag(), 1e-8);
+
+    // 第 k 个是共轭对的前一个, 多输出一个
+    arnoldi.Compute(A, 3, KrylovWhich::LargestMagnitude);
+    EXPECT_EQ(4u, arnoldi.EigenValuesReal().size());
+    CheckEigenVectors(A, arnoldi.EigenVectors(), arnoldi.EigenValuesReal(), arnoldi.EigenValuesImag(), 1e-8);
+
+    // 移位求逆, 最接近 0.4 的特征值
+    std::stable_sort(w.begin(), w.end(), [](auto const & a, auto const & b) {
+        return std::hypot(a.first - 0.4, a.second) < std::hypot(b.first - 0.4, b.second);
+    });
+    arnoldi.ComputeShiftInvert(A, 4, 0.4);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_NEAR(w[i].first, arnoldi.EigenValuesReal()[i], 1e-10);
+        EXPECT_NEAR(std::abs(w[i].second), std::abs(arnoldi.EigenValuesImag()[i]), 1e-10);
+    }
+    CheckEigenVectors(A, arnoldi.EigenVectors(), arnoldi.EigenValuesReal(), arnoldi.EigenValuesImag(), 1e-8);
+}
+
+TEST(Eigen, Subspace)
+{
+    // 二维随机点的高斯核矩阵, 对称半正定, 特征值快速衰减
+    int n = 400;
+    std::mt19937 gen(23);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<double> px(n), py(n);
+    for (int i = 0; i < n; i++) {
+        px[i] = dist(gen);
+        py[i] = dist(gen);
+    }
+    DMatrix<double> K(n, n);
+    for (int c = 0; c < n; c++)
+        for (int r = 0; r < n; r++) {
+            double dx = px[r] - px[c], dy = py[r] - py[c];
+            K(r, c) = std::exp(-(dx * dx + dy * dy) / 0.5);
+        }
+
+    SymmetricEigen<DMatrix<double>> eig(K, false);
+    auto const & d = eig.EigenValues();
+
+    int k = 8;
+    EigenSubspace<DMatrix<double>> sub;
+    int iter = sub.Compute(K, k);
+    XTLog(std::cout) << "iter = " << iter << std::endl;
+    ASSERT_EQ(k, (int)sub.EigenValues().size());
+    for (int i = 0; i < k; i++)
+        EXPECT_NEAR(d[n - 1 - i], sub.EigenValues()[i], 1e-10 * d[n - 1]);
+    std::vector<double> wi(k, 0.0);
+    CheckEigenVectors(K, sub.EigenVectors(), sub.EigenValues(), wi, 1e-8);
+
+    // 以上次的子空间为初值, 同一个矩阵立即收敛
+    int again = sub.Compute(K, k);
+    EXPECT_LE(again, 2);
+
+    // 模最大的特征值有负数, 行视图走逐元素拷贝的路径
+    DMatrix<double> S(60, 60);
+    for (int c = 0; c < 60; c++)
+        for (int r = c; r < 60; r++)
+            S(r, c) = S(c, r) = dist(gen);
+    SymmetricEigen<DMatrix<double>> eigS(S, false);
+    std::vector<double> ds(eigS.EigenValues());
+    std::sort(ds.begin(), ds.end(), [](double a, double b) { return std::abs(a) > std::abs(b); });
+    auto view = S.SubMatrix(0, 0, 60, 60);
+    EigenSubspace<decltype(view)> subS;
+    subS.Compute(view, 3, 20);
+    for (int i = 0; i < 3; i++)
+        EXPECT_NEAR(ds[i], subS.EigenValues()[i], 1e-9);
+
+    // 秩为 3 的奇异矩阵, 要求的特征值包括 0
+    DMatrix<double> B(50, 3);
+    for (int i = 0; i < B.NumDatas(); i++)
+        B(i) = dist(gen);
+    DMatrix<double> Z = B * B.Transpose();
+    SymmetricEigen<DMatrix<double>> eigZ(Z, false);
+    std::vector<double> dz(eigZ.EigenValues());
+    std::sort(dz.begin(), dz.end(), [](double a, double b) { return std::abs(a) > std::abs(b); });
+    EigenSubspace<DMatrix<double>> subZ;
+    subZ.Compute(Z, 5);
+    for (int i = 0; i < 5; i++)
+        EXPECT_NEAR(dz[i], subZ.EigenValues()[i], 1e-10 * dz[0]);
+    std::vector<double> wz(5, 0.0);
+    CheckEigenVectors(Z, subZ.EigenVectors(), subZ.EigenValues(), wz, 1e-8);
+}
@@ -0,0 +1,129 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <random>
+
+using namespace xiaotu;
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+}
+
+//! 用子阵视图走逐元素的通用路径, 作为对照
+template <typename MatA, typename MatB>
+DMatrix<double> NaiveMultiply(MatA & A, MatB & B)
+{
+    DMatrix<double> re(A.Rows(), B.Cols());
+    auto a = A.SubMatrix(0, 0, A.Rows(), A.Cols());
+    auto b = B.SubMatrix(0, 0, B.Rows(), B.Cols());
+    auto r = re.SubMatrix(0, 0, re.Rows(), re.Cols());
+    EXPECT_TRUE(Multiply(a, b, r));
+    return re;
+}
+
+template <typename MatA, typename MatB>
+bool IsClose(MatA const & A, MatB const & B, double tol)
+{
+    if (A.Rows() != B.Rows() || A.Cols() != B.Cols())
+        return false;
+    for (int r = 0; r < A.Rows(); r++)
+        for (int c = 0; c < A.Cols(); c++)
+            if (std::abs(A(r, c) - B(r, c)) > tol)
+                return false;
+    return true;
+}
+
+TEST(LinearAlgibra, Gemm)
+{
+    std::mt19937 gen(1234);
+    int sizes[][3] = {
+        { 1, 1, 1 },
+        { 7, 5, 3 },
+        { 37, 53, 29 },
+        { 130, 300, 70 },
+        { 257, 260, 513 },
+    };
+
+    for (auto & s : sizes) {
+        int m = s[0], k = s[1], n = s[2];
+
+        DMatrix<double> A(m, k);
+        DMatrix<double, eRowMajor> B(k, n);
+        RandomFill(A, gen);
+        RandomFill(B, gen);
+
+        DMatrix<double> ref = NaiveMultiply(A, B);
+
+        DMatrix<double> C(m, n);
+        EXPECT_TRUE(Multiply(A, B, C));
+        EXPECT_TRUE(IsClose(C, ref, 1e-9));
+
+        DMatrix<double, eRowMajor> D(m, n);
+        EXPECT_TRUE(Multiply(A, B, D));
+        EXPECT_TRUE(IsClose(D, ref, 1e-9));
+
+        auto E = A * B;
+        EXPECT_TRUE(IsClose(E, ref, 1e-9));
+
+        // C = C + AB
+        EXPECT_TRUE(Gaxpy(A, B, C));
+        for (int r = 0; r < m; r++)
+            for (int c = 0; c < n; c++)
+                EXPECT_NEAR(2 * ref(r, c), C(r, c), 1e-9);
+    }
+}
+
+TEST(LinearAlgibra, GemmView)
+{
+    std::mt19937 gen(4321);
+    std::vector<double> a(40 * 30), b(30 * 20), c(40 * 20);
+    DMatrixView<double> A(a.data(), 40, 30);
+    DMatrixView<double> B(b.data(), 30, 20);
+    DMatrixView<double> C(c.data(), 40, 20);
+    RandomFill(A, gen);
+    RandomFill(B, gen);
+
+    EXPECT_TRUE(Multiply(A, B, C));
+    EXPECT_TRUE(IsClose(C, NaiveMultiply(A, B), 1e-9));
+
+    AMatrix<double, 3, 3> R;
+    EXPECT_FALSE(Multiply(A, B, R));
+}
+
+
+TEST(LinearAlgibra, Gemv)
+{
+    std::mt19937 gen(22);
+    int sizes[][2] = { { 1, 1 }, { 7, 5 }, { 300, 40 }, { 5000, 30 } };
+
+    for (auto & s : sizes) {
+        int m = s[0], n = s[1];
+        DMatrix<double> A(m, n), x(n, 1), y(m, 1), z(n, 1);
+        RandomFill(A, gen);
+        RandomFill(x, gen);
+        RandomFill(y, gen);
+        DMatrix<double> y0 = y;
+
+        // 列连续: y = 2 A x + 0.5 y
+        Gemv(m, n, 2.0, A.StorBegin(), 1, m, x.StorBegin(), 0.5, y.StorBegin());
+        DMatrix<double> ref = A * x;
+        for (int i = 0; i < m; i++)
+            EXPECT_NEAR(2 * ref(i) + 0.5 * y0(i), y(i), 1e-12);
+
+        // 行连续: z = A^T y
+        Gemv(n, m, 1.0, A.StorBegin(), m, 1, y.StorBegin(), 0.0, z.StorBegin());
+        DMatrix<double> ref2 = A.Transpose() * y;
+        EXPECT_TRUE(IsClose(ref2, z, 1e-10));
+    }
+}
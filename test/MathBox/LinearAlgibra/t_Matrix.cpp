@@ -160,7 +160,7 @@ TEST(LinearAlgibra, Operations)
     EXPECT_TRUE(std::abs(d(1) - a(1)) < SMALL_VALUE);
     EXPECT_TRUE(std::abs(d(2) - a(2)) < SMALL_VALUE);
 
-    auto e = 2.0 * b;
+    Vector<double, 3> e = 2.0 * b;
     EXPECT_TRUE(std::abs(e(0) - c(0)) < SMALL_VALUE);
     EXPECT_TRUE(std::abs(e(1) - c(1)) < SMALL_VALUE);
     EXPECT_TRUE(std::abs(e(2) - c(2)) < SMALL_VALUE);
@@ -192,7 +192,7 @@ TEST(LinearAlgibra, Operations)
         4,  2, 1
     };
     auto B = Matrix<double, 3, 3>::Eye() * 2;
-    auto C = A + A;
+    Matrix<double, 3, 3> C = A + A;
     auto D = A * B;
     for (int idx = 0; idx < A.NumDatas(); idx++)
         EXPECT_TRUE(std::abs(C(idx) - D(idx)) < 1e-9);
@@ -263,6 +263,37 @@ TEST(LinearAlgibra, VMatrix)
 
         XTLog(std::cout) << A << std::endl;
     }
+
+    {
+        static_assert(std::is_nothrow_move_constructible<VMatrix<double, 3, 3>>::value);
+        static_assert(std::is_nothrow_move_assignable<VMatrix<double, 3, 3>>::value);
+
+        VMatrix<double, 3, 3> A = VMatrix<double, 3, 3>::Eye();
+        double const * data = A.StorBegin();
+        VMatrix<double, 3, 3> B(std::move(A));
+        EXPECT_EQ(data, B.StorBegin());
+        EXPECT_TRUE(B.IsIdentity());
+
+        VMatrix<double, 3, 3> C;
+        C = std::move(B);
+        EXPECT_EQ(data, C.StorBegin());
+        EXPECT_TRUE(C.IsIdentity());
+
+        // 被移动的对象可以重新赋值, 包括由表达式赋值
+        A = C;
+        EXPECT_TRUE(A.IsIdentity());
+        B = C + C;
+        for (int i = 0; i < B.NumDatas(); i++)
+            EXPECT_DOUBLE_EQ(2 * C(i), B(i));
+        C = std::move(A);
+        A = B + B;
+        for (int i = 0; i < A.NumDatas(); i++)
+            EXPECT_DOUBLE_EQ(2 * B(i), A(i));
+        VMatrix<double, 3, 3> D(std::move(A));
+        A = D + B;
+        for (int i = 0; i < A.NumDatas(); i++)
+            EXPECT_DOUBLE_EQ(D(i) + B(i), A(i));
+    }
 }
 
 
@@ -0,0 +1,189 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+using namespace xiaotu;
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+}
+
+//! 逐元素三重循环, 作为对照
+DMatrix<double> RefMultiply(DMatrix<double> const & A, DMatrix<double> const & B)
+{
+    DMatrix<double> re(A.Rows(), B.Cols());
+    for (int i = 0; i < A.Rows(); i++) {
+        for (int j = 0; j < B.Cols(); j++) {
+            double sum = 0;
+            for (int k = 0; k < A.Cols(); k++)
+                sum += A(i, k) * B(k, j);
+            re(i, j) = sum;
+        }
+    }
+    return re;
+}
+
+template <typename MatA, typename MatB>
+bool IsClose(MatA const & A, MatB const & B, double tol = 1e-9)
+{
+    if (A.Rows() != B.Rows() || A.Cols() != B.Cols())
+        return false;
+    for (int r = 0; r < A.Rows(); r++)
+        for (int c = 0; c < A.Cols(); c++)
+            if (std::abs(A(r, c) - B(r, c)) > tol)
+                return false;
+    return true;
+}
+
+TEST(LinearAlgibra, MatrixExpression)
+{
+    std::mt19937 gen(1234);
+    DMatrix<double> A(20, 30), B(30, 25), C(20, 15), D(15, 25), E(20, 25);
+    RandomFill(A, gen);
+    RandomFill(B, gen);
+    RandomFill(C, gen);
+    RandomFill(D, gen);
+    RandomFill(E, gen);
+
+    DMatrix<double> AB = RefMultiply(A, B);
+    DMatrix<double> CD = RefMultiply(C, D);
+
+    // 表达式是惰性的, 直到赋值时才求值
+    auto expr = A * B + C * D;
+    EXPECT_EQ(20, expr.Rows());
+    EXPECT_EQ(25, expr.Cols());
+
+    DMatrix<double> F = expr;
+    DMatrix<double> ref(20, 25);
+    for (int i = 0; i < ref.NumDatas(); i++)
+        ref(i) = AB(i) + CD(i);
+    EXPECT_TRUE(IsClose(F, ref));
+
+    F = 2.0 * (A * B) - C * D / 2.0 + E;
+    for (int i = 0; i < ref.NumDatas(); i++)
+        ref(i) = 2 * AB(i) - CD(i) / 2 + E(i);
+    EXPECT_TRUE(IsClose(F, ref));
+
+    F = A * B;
+    F += C * D;
+    F -= E;
+    for (int i = 0; i < ref.NumDatas(); i++)
+        ref(i) = AB(i) + CD(i) - E(i);
+    EXPECT_TRUE(IsClose(F, ref));
+
+    F = -(A * B);
+    for (int i = 0; i < ref.NumDatas(); i++)
+        ref(i) = -AB(i);
+    EXPECT_TRUE(IsClose(F, ref));
+
+    // 临时表达式和临时矩阵求负以后保存副本, auto 保存下来稍后求值也是安全的
+    auto neg = -(A * B + E);
+    auto neg_tmp = -DMatrix<double>(E);
+    F = neg;
+    for (int i = 0; i < ref.NumDatas(); i++)
+        ref(i) = -AB(i) - E(i);
+    EXPECT_TRUE(IsClose(F, ref));
+    F = neg_tmp;
+    for (int i = 0; i < ref.NumDatas(); i++)
+        EXPECT_DOUBLE_EQ(-E(i), F(i));
+
+    // 纯逐元素的表达式
+    Matrix<double, 3, 3> G, H;
+    G << 1, 2, 3,
+         4, 5, 6,
+         7, 8, 9;
+    H = G + G - 0.5 * G;
+    for (int i = 0; i < H.NumDatas(); i++)
+        EXPECT_DOUBLE_EQ(1.5 * G(i), H(i));
+}
+
+TEST(LinearAlgibra, MatrixExpressionAlias)
+{
+    std::mt19937 gen(4321);
+    DMatrix<double> A(12, 12), B(12, 12);
+    RandomFill(A, gen);
+    RandomFill(B, gen);
+
+    DMatrix<double> AB = RefMultiply(A, B);
+    DMatrix<double> BA = RefMultiply(B, A);
+
+    // 目标矩阵出现在乘积的操作数中
+    DMatrix<double> X = A;
+    X = X * B;
+    EXPECT_TRUE(IsClose(X, AB));
+
+    X = A;
+    X = B * X + X;
+    DMatrix<double> ref(12, 12);
+    for (int i = 0; i < ref.NumDatas(); i++)
+        ref(i) = BA(i) + A(i);
+    EXPECT_TRUE(IsClose(X, ref));
+
+    X = A;
+    X = X * B - X * B;
+    EXPECT_TRUE(X.IsZero(1e-12));
+
+    // 目标矩阵与操作数部分重叠
+    X = A;
+    auto sub = X.SubMatrix(0, 0, 6, 6);
+    auto a = A.SubMatrix(0, 0, 6, 6);
+    DMatrix<double> sub_ref = RefMultiply(DMatrix<double>(a), DMatrix<double>(X.SubMatrix(0, 6, 6, 6)));
+    sub = X.SubMatrix(0, 0, 6, 6) * X.SubMatrix(0, 6, 6, 6);
+    EXPECT_TRUE(IsClose(sub, sub_ref));
+
+    X = A;
+    X.SubMatrix(1, 1, 6, 6) = X.SubMatrix(0, 0, 6, 6) + X.SubMatrix(2, 2, 6, 6);
+    for (int r = 0; r < 6; r++)
+        for (int c = 0; c < 6; c++)
+            EXPECT_DOUBLE_EQ(A(r, c) + A(r + 2, c + 2), X(r + 1, c + 1));
+}
+
+TEST(LinearAlgibra, MatrixExpressionFixedSize)
+{
+    AMatrix<double, 3, 3> A, B;
+    AMatrix<double, 3, 1> x;
+    A << 2, 0, 1,
+         0, 3, 0,
+         1, 0, 4;
+    B << 1, 2, 3,
+         4, 5, 6,
+         7, 8, 9;
+    x << 1, 2, 3;
+
+    // 定长矩阵的运算结果也是栈上的定长矩阵
+    static_assert(std::is_same<decltype((A * B).Eval()), AMatrix<double, 3, 3>>::value);
+    static_assert(std::is_same<decltype((A * x).Eval()), AMatrix<double, 3, 1>>::value);
+    static_assert(std::is_same<decltype((A + B - 2.0 * A).Eval()), AMatrix<double, 3, 3>>::value);
+    static_assert(std::is_same<decltype(A.InverseMat()), AMatrix<double, 3, 3>>::value);
+    static_assert(std::is_same<decltype((A.Transpose() * B * A).Eval()), AMatrix<double, 3, 3>>::value);
+
+    // 尺寸较大的定长矩阵改用 VMatrix, 尺寸不定时为 DMatrix
+    static_assert(std::is_same<decltype((VMatrix<double, 20, 20>() * VMatrix<double, 20, 20>()).Eval()),
+                               VMatrix<double, 20, 20>>::value);
+    static_assert(std::is_same<decltype((DMatrix<double>(3, 3) * A).Eval()), DMatrix<double>>::value);
+    static_assert(std::is_same<decltype((DMatrix<double>(3, 3) + A).Eval()), AMatrix<double, 3, 3>>::value);
+
+    AMatrix<double, 3, 1> y = A * x;
+    EXPECT_DOUBLE_EQ(5, y(0));
+    EXPECT_DOUBLE_EQ(6, y(1));
+    EXPECT_DOUBLE_EQ(13, y(2));
+
+    AMatrix<double, 3, 3> C = A.Transpose() * B * A;
+    DMatrix<double> DA = A, DB = B;
+    DMatrix<double> ref = RefMultiply(RefMultiply(DMatrix<double>(DA.Transpose()), DB), DA);
+    EXPECT_TRUE(IsClose(C, ref));
+
+    AMatrix<double, 3, 3> I = A * A.InverseMat();
+    EXPECT_TRUE(I.IsIdentity(1e-12));
+}
+
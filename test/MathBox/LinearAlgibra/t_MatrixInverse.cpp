@@ -8,6 +8,7 @@
 #include <memory>
 #include <vector>
 #include <cmath>
+#include <random>
 
 using namespace xiaotu;
 
@@ -34,3 +35,138 @@ TEST(LinearAlgibra, LU)
 
 
 
+
+TEST(LinearAlgibra, LUBlocked)
+{
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    // 超过分块大小, 覆盖尾部不足一块的情况
+    int n = 150;
+    DMatrix<double> A(n, n);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+
+    LU lu(A.View());
+
+    // 与不分块的结果一致
+    DMatrix<double> W = A;
+    std::vector<int> ipiv(n);
+    LUPanel(n, n, W.StorBegin(), W.RowStride(), W.ColStride(), ipiv.data());
+    for (int i = 0; i < W.NumDatas(); i++)
+        EXPECT_NEAR(W(i), lu()(i), 1e-10);
+
+    DMatrix<double> b(n, 2);
+    for (int i = 0; i < b.NumDatas(); i++)
+        b(i) = dist(gen);
+    DMatrix<double> x(n, 2);
+    lu.Solve(b, x);
+    DMatrix<double> r = A * x - b;
+    for (int i = 0; i < r.NumDatas(); i++)
+        EXPECT_NEAR(0, r(i), 1e-10);
+
+    DMatrix<double> Ainv(n, n);
+    lu.Inverse(Ainv.View());
+    DMatrix<double> eye = Ainv * A;
+    EXPECT_TRUE(eye.IsIdentity(1e-10));
+
+    DMatrix<double> S(n, n);
+    S.Zeroing();
+    EXPECT_THROW(LU<DMatrixView<double>> lu_s(S.View()), std::runtime_error);
+}
+
+TEST(LinearAlgibra, SolveMultiRHS)
+{
+    std::mt19937 gen(4321);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    // 超过 Trsm 的分块大小, 右侧有很多列
+    int n = 150;
+    int m = 130;
+    DMatrix<double> B(n, n);
+    for (int i = 0; i < B.NumDatas(); i++)
+        B(i) = dist(gen);
+    DMatrix<double> A = B.Transpose() * B;
+    for (int i = 0; i < n; i++)
+        A(i, i) += n;
+
+    DMatrix<double> b(n, m);
+    for (int i = 0; i < b.NumDatas(); i++)
+        b(i) = dist(gen);
+
+    auto check = [&](DMatrix<double> const & x) {
+        DMatrix<double> r = A * x - b;
+        for (int i = 0; i < r.NumDatas(); i++)
+            EXPECT_NEAR(0, r(i), 1e-10);
+    };
+
+    DMatrix<double> x(n, m);
+    LU lu(A.View());
+    lu.Solve(b, x);
+    check(x);
+
+    Cholesky cholesky(A.View());
+    cholesky.Solve(b, x);
+    check(x);
+
+    LDLT ldlt(A.View());
+    ldlt.Solve(b, x);
+    check(x);
+
+    // 原位求解
+    x = b;
+    ldlt.Solve(x, x);
+    check(x);
+
+    // 行优先存储
+    DMatrix<double, eRowMajor> br(n, m);
+    DMatrix<double, eRowMajor> xr(n, m);
+    br = b;
+    cholesky.Solve(br, xr);
+    x = xr;
+    check(x);
+}
+
+TEST(LinearAlgibra, CholeskyBlocked)
+{
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    int n = 150;
+    DMatrix<double> B(n, n);
+    for (int i = 0; i < B.NumDatas(); i++)
+        B(i) = dist(gen);
+    DMatrix<double> A = B.Transpose() * B;
+    for (int i = 0; i < n; i++)
+        A(i, i) += 1;
+
+    Cholesky cholesky(A.View());
+    auto & L = cholesky();
+
+    // 与不分块的结果一致, 上三角为 0
+    DMatrix<double> W = A;
+    CholeskyPanel(n, W.StorBegin(), W.RowStride(), W.ColStride());
+    for (int c = 0; c < n; c++) {
+        for (int r = 0; r < c; r++)
+            EXPECT_EQ(0, L(r, c));
+        for (int r = c; r < n; r++)
+            EXPECT_NEAR(W(r, c), L(r, c), 1e-10);
+    }
+
+    DMatrix<double> Ld = L;
+    DMatrix<double> LLT = Ld * Ld.Transpose();
+    for (int i = 0; i < A.NumDatas(); i++)
+        EXPECT_NEAR(A(i), LLT(i), 1e-10);
+
+    // 只读取下三角
+    DMatrix<double> A2 = A;
+    for (int c = 1; c < n; c++)
+        for (int r = 0; r < c; r++)
+            A2(r, c) = 1e10;
+    Cholesky cholesky2(A2.View());
+    for (int i = 0; i < A.NumDatas(); i++)
+        EXPECT_EQ(cholesky()(i), cholesky2()(i));
+
+    A(100, 100) = -1;
+    EXPECT_THROW(Cholesky<DMatrixView<double>> c(A.View()), std::runtime_error);
+}
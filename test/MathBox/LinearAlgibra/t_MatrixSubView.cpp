@@ -8,6 +8,7 @@
 #include <memory>
 #include <vector>
 #include <cmath>
+#include <type_traits>
 
 using namespace xiaotu;
 
@@ -146,3 +147,88 @@ TEST(MatrixSubView, ColSwap)
 
 
 
+
+TEST(MatrixSubView, Strided)
+{
+    DMatrix<double> A(6, 5);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = i;
+
+    // 连续存储矩阵的子阵, 不论嵌套多少层都是同一个带步长的视图
+    auto sub = A.SubMatrix(1, 1, 4, 3);
+    auto ssub = sub.SubMatrix(1, 1, 2, 2);
+    auto col = ssub.Col(1);
+    static_assert(std::is_same<decltype(sub), DMatrixSubView<double>>::value);
+    static_assert(std::is_same<decltype(ssub), DMatrixSubView<double>>::value);
+    static_assert(std::is_same<decltype(col), DMatrixSubView<double>>::value);
+    static_assert(DMatrixSubView<double>::IsStrided && !DMatrixSubView<double>::IsContiguous);
+
+    EXPECT_EQ(A.Ptr(2, 2), ssub.Data());
+    EXPECT_EQ(6, ssub.Stride());
+    EXPECT_EQ(1, ssub.RowStride());
+    EXPECT_EQ(6, ssub.ColStride());
+    EXPECT_DOUBLE_EQ(A(3, 3), col(1));
+
+    sub.Shrink(1, 1, 2, 2);
+    for (int r = 0; r < 2; r++)
+        for (int c = 0; c < 2; c++)
+            EXPECT_DOUBLE_EQ(A(2 + r, 2 + c), sub(r, c));
+
+    // 同类型之间的赋值拷贝元素
+    auto dst = A.SubMatrix(0, 0, 2, 2);
+    dst = ssub;
+    for (int r = 0; r < 2; r++)
+        for (int c = 0; c < 2; c++)
+            EXPECT_DOUBLE_EQ(A(2 + r, 2 + c), A(r, c));
+
+    // 行优先
+    Matrix<double, 4, 5, eRowMajor> B;
+    for (int i = 0; i < B.NumDatas(); i++)
+        B(i) = i;
+    auto bsub = B.SubMatrix(1, 2, 2, 3);
+    EXPECT_EQ(5, bsub.Stride());
+    EXPECT_EQ(5, bsub.RowStride());
+    EXPECT_EQ(1, bsub.ColStride());
+    EXPECT_DOUBLE_EQ(B(2, 3), bsub(1, 1));
+
+    // 只读子阵
+    DMatrix<double> const & cA = A;
+    auto csub = cA.SubMatrix(1, 1, 3, 3).SubMatrix(1, 0, 2, 2);
+    static_assert(std::is_same<decltype(csub), DMatrixSubView<const double>>::value);
+    EXPECT_DOUBLE_EQ(A(2, 1), csub(0, 0));
+    EXPECT_DOUBLE_EQ(A(2, 1) * A(2, 1) + A(3, 1) * A(3, 1) + A(2, 2) * A(2, 2) + A(3, 2) * A(3, 2),
+                     csub.SquaredNorm());
+}
+
+TEST(MatrixSubView, StridedGemm)
+{
+    DMatrix<double> A(40, 40), B(40, 40), C(40, 40);
+    for (int i = 0; i < A.NumDatas(); i++) {
+        A(i) = std::sin(0.1 * i);
+        B(i) = std::cos(0.3 * i);
+    }
+    C.Zeroing();
+
+    // 子阵直接交给 Gemm, 与逐元素计算的结果对比
+    auto a = A.SubMatrix(3, 5, 20, 17);
+    auto b = B.SubMatrix(7, 2, 17, 13);
+    auto c = C.SubMatrix(11, 9, 20, 13);
+    EXPECT_TRUE(Multiply(a, b, c));
+    for (int r = 0; r < 20; r++)
+        for (int j = 0; j < 13; j++) {
+            double s = 0;
+            for (int k = 0; k < 17; k++)
+                s += A(3 + r, 5 + k) * B(7 + k, 2 + j);
+            EXPECT_NEAR(s, C(11 + r, 9 + j), 1e-12);
+        }
+    EXPECT_DOUBLE_EQ(0, C(10, 9));
+    EXPECT_DOUBLE_EQ(0, C(31, 9));
+    EXPECT_DOUBLE_EQ(0, C(11, 22));
+
+    // 重叠的子阵之间的表达式赋值
+    DMatrix<double> X = A;
+    X.SubMatrix(1, 1, 10, 10) = X.SubMatrix(0, 0, 10, 10) + X.SubMatrix(2, 2, 10, 10);
+    for (int r = 0; r < 10; r++)
+        for (int j = 0; j < 10; j++)
+            EXPECT_DOUBLE_EQ(A(r, j) + A(r + 2, j + 2), X(r + 1, j + 1));
+}
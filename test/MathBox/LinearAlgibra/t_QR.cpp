@@ -8,6 +8,7 @@
 #include <memory>
 #include <vector>
 #include <cmath>
+#include <random>
 
 using namespace xiaotu;
 
@@ -111,6 +112,56 @@ TEST(QR, Householder)
     XTLog(std::cout) << "a = " << a << std::endl;
 }
 
+TEST(QR, HouseholderBlocked)
+{
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    // 超过分块大小, 覆盖分块和尾部不足一块的情况; 以及列数多于行数的情况
+    int sizes[][2] = { { 150, 70 }, { 40, 90 }, { 65, 65 } };
+    for (auto & s : sizes) {
+        int m = s[0], n = s[1];
+        DMatrix<double> A(m, n);
+        for (int i = 0; i < A.NumDatas(); i++)
+            A(i) = dist(gen);
+
+        QR_Householder<DMatrix<double>> qr(A);
+        DMatrix<double> const & Q = qr.Q();
+        DMatrix<double> const & R = qr.R();
+
+        DMatrix<double> QTQ = Q.Transpose() * Q;
+        EXPECT_TRUE(QTQ.IsIdentity(1e-12));
+
+        DMatrix<double> QR = Q * R;
+        for (int i = 0; i < A.NumDatas(); i++)
+            EXPECT_NEAR(A(i), QR(i), 1e-12);
+
+        for (int c = 0; c < n; c++) {
+            if (c < m) {
+                EXPECT_GE(R(c, c), 0);
+            }
+            for (int r = c + 1; r < m; r++)
+                EXPECT_EQ(0, R(r, c));
+        }
+
+        // 隐式作用 Q^T A = R, Q Q^T B = B
+        DMatrix<double> B = A;
+        qr.ApplyQT(B);
+        for (int i = 0; i < B.NumDatas(); i++)
+            EXPECT_NEAR(R(i), B(i), 1e-12);
+        qr.ApplyQ(B);
+        for (int i = 0; i < B.NumDatas(); i++)
+            EXPECT_NEAR(A(i), B(i), 1e-12);
+
+        // 代理存储
+        DMatrix<double> C = A;
+        auto c0 = C.Col(0);
+        qr.ApplyQT(c0);
+        for (int r = 0; r < m; r++)
+            EXPECT_NEAR(R(r, 0), C(r, 0), 1e-12);
+    }
+}
+
 TEST(QR, UpperHessenberg)
 {
     Matrix<double, 4, 4> A = {
@@ -128,6 +179,44 @@ TEST(QR, UpperHessenberg)
     XTLog(std::cout) << "ha = " << ha << std::endl;
 }
 
+TEST(QR, UpperHessenbergBlocked)
+{
+    std::mt19937 gen(18);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    for (int n : { 130, 300 }) {
+        DMatrix<double> A(n, n);
+        for (int i = 0; i < A.NumDatas(); i++)
+            A(i) = dist(gen);
+
+        UpperHessenberg<DMatrix<double>> h(A);
+        DMatrix<double> const & H = h.H();
+        DMatrix<double> const & Q = h.Q();
+        for (int c = 0; c < n; c++)
+            for (int r = c + 2; r < n; r++)
+                EXPECT_EQ(0.0, H(r, c));
+
+        DMatrix<double> QA = Q * A;
+        DMatrix<double> HQ = H * Q;
+        DMatrix<double> QQT = Q * Q.Transpose();
+        for (int r = 0; r < n; r++)
+            for (int c = 0; c < n; c++) {
+                EXPECT_NEAR(QA(r, c), HQ(r, c), 1e-11);
+                EXPECT_NEAR((r == c) ? 1.0 : 0.0, QQT(r, c), 1e-12);
+            }
+
+        // 分块与不分块的约化得到相同的反射, 只有舍入误差的差别
+        DMatrix<double> B0 = A, B1 = A;
+        std::vector<double> tau0(n), tau1(n);
+        HessenbergReduce(n, B0.StorBegin(), 1, n, tau0.data(), 32, n);
+        HessenbergReduce(n, B1.StorBegin(), 1, n, tau1.data(), 16, 40);
+        for (int i = 0; i < n * n; i++)
+            EXPECT_NEAR(B0(i), B1(i), 1e-9 * std::max(1.0, std::abs(B0(i))));
+        for (int i = 0; i < n - 2; i++)
+            EXPECT_NEAR(tau0[i], tau1[i], 1e-10);
+    }
+}
+
 TEST(QR, Givens)
 {
     Vector<double, 3> x = { 1, 2, 3 };
@@ -273,3 +362,66 @@ TEST(QR, PQR_Householder)
 }
 
 
+
+//! 三种 QR 分解共用的隐式 Q 检查: 瘦 Q 列正交, ApplyQ/ApplyQT 互逆, 最小二乘解满足正规方程
+template <typename QR>
+void CheckImplicitQ(QR & qr, DMatrix<double> const & A, DMatrix<double> const & b)
+{
+    int m = A.Rows();
+    int n = A.Cols();
+
+    DMatrix<double> Q1 = qr.ThinQ();
+    EXPECT_EQ(m, Q1.Rows());
+    EXPECT_EQ(n, Q1.Cols());
+    DMatrix<double> QTQ = Q1.Transpose() * Q1;
+    EXPECT_TRUE(QTQ.IsIdentity(1e-12));
+    for (int i = 0; i < Q1.NumDatas(); i++)
+        EXPECT_NEAR(qr.Q()(i), Q1(i), 1e-12);
+
+    DMatrix<double> B = b;
+    qr.ApplyQT(B);
+    qr.ApplyQ(B);
+    for (int i = 0; i < B.NumDatas(); i++)
+        EXPECT_NEAR(b(i), B(i), 1e-12);
+
+    DMatrix<double> x(n, b.Cols());
+    EXPECT_TRUE(qr.SolveLeastSquares(b, x));
+    DMatrix<double> r = A * x - b;
+    DMatrix<double> ATr = A.Transpose() * r;
+    for (int i = 0; i < ATr.NumDatas(); i++)
+        EXPECT_NEAR(0, ATr(i), 1e-10);
+}
+
+TEST(QR, ImplicitQ)
+{
+    std::mt19937 gen(4321);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    int m = 80, n = 45;
+    DMatrix<double> A(m, n);
+    DMatrix<double> b(m, 3);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = dist(gen);
+    for (int i = 0; i < b.NumDatas(); i++)
+        b(i) = dist(gen);
+
+    QR_Householder<DMatrix<double>> qr_h(A);
+    CheckImplicitQ(qr_h, A, b);
+
+    PQR_Householder<DMatrix<double>> pqr(A);
+    CheckImplicitQ(pqr, A, b);
+    // 列主元保证 R 的对角元素绝对值递减
+    for (int i = 1; i < n; i++)
+        EXPECT_LE(pqr.R()(i, i), pqr.R()(i - 1, i - 1) + 1e-12);
+
+    QR_Givens<DMatrix<double>> qr_g(A);
+    CheckImplicitQ(qr_g, A, b);
+
+    // 秩亏的矩阵
+    DMatrix<double> A2 = A;
+    for (int r = 0; r < m; r++)
+        A2(r, 1) = 2 * A2(r, 0);
+    QR_Householder<DMatrix<double>> qr_2(A2);
+    DMatrix<double> x(n, b.Cols());
+    EXPECT_FALSE(qr_2.SolveLeastSquares(b, x));
+}
@@ -8,6 +8,8 @@
 #include <memory>
 #include <vector>
 #include <cmath>
+#include <random>
+#include <utility>
 
 using namespace xiaotu;
 
@@ -67,6 +69,47 @@ TEST(SVD, LowerBidiagonal)
 }
 
 
+TEST(SVD, BidiagonalBlocked)
+{
+    std::mt19937 gen(18);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    std::vector<std::pair<int, int>> sizes = { { 300, 200 }, { 200, 300 }, { 256, 256 } };
+    for (auto const & size : sizes) {
+        int m = size.first, n = size.second;
+        DMatrix<double> A(m, n);
+        for (int i = 0; i < A.NumDatas(); i++)
+            A(i) = dist(gen);
+
+        Bidiagonal<DMatrix<double>> bidiag(A);
+        DMatrix<double> const & B = bidiag.B();
+        if (m >= n)
+            EXPECT_TRUE(B.IsUpperBiDiagonal());
+        else
+            EXPECT_TRUE(B.IsLowerBiDiagonal());
+
+        DMatrix<double> _A_ = bidiag.UT().Transpose() * B * bidiag.V().Transpose();
+        for (int i = 0; i < A.NumDatas(); i++)
+            EXPECT_NEAR(A(i), _A_(i), 1e-11);
+    }
+
+    // 分块与不分块的约化得到相同的反射
+    int m = 300, n = 200;
+    DMatrix<double> B0(m, n), B1;
+    for (int i = 0; i < B0.NumDatas(); i++)
+        B0(i) = dist(gen);
+    B1 = B0;
+    std::vector<double> tq0(n), tp0(n), tq1(n), tp1(n);
+    BidiagonalReduce(m, n, B0.StorBegin(), 1, m, tq0.data(), tp0.data(), 32, n);
+    BidiagonalReduce(m, n, B1.StorBegin(), 1, m, tq1.data(), tp1.data(), 16, 40);
+    for (int i = 0; i < m * n; i++)
+        EXPECT_NEAR(B0(i), B1(i), 1e-11);
+    for (int i = 0; i < n; i++) {
+        EXPECT_NEAR(tq0[i], tq1[i], 1e-12);
+        EXPECT_NEAR(tp0[i], tp1[i], 1e-12);
+    }
+}
+
 
 TEST(SVD, SVD_Naive)
 {
@@ -192,3 +235,260 @@ TEST(SVD, SVD_GKR_Case1)
         XTLog(std::cout) << "_A_ = " << _A_.Truncate() << std::endl;
     }
 }
+
+//! 检查 Sigma = UT A V, 奇异值非负且降序排列, UT 和 V 正交
+template <typename SVD>
+void CheckSVD(DMatrix<double> const & A, SVD & svd, double tol)
+{
+    int m = A.Rows(), n = A.Cols(), p = std::min(m, n);
+    DMatrix<double> S = svd.Sigma();
+    DMatrix<double> UT = svd.UT();
+    DMatrix<double> V = svd.V();
+
+    for (int i = 0; i < p; i++) {
+        EXPECT_GE(S(i, i), 0.0);
+        if (i > 0) {
+            EXPECT_GE(S(i - 1, i - 1), S(i, i));
+        }
+    }
+
+    DMatrix<double> UAV = UT * A * V;
+    for (int c = 0; c < n; c++)
+        for (int r = 0; r < m; r++)
+            EXPECT_NEAR((r == c) ? S(r, c) : 0.0, UAV(r, c), tol);
+
+    DMatrix<double> UUT = UT * UT.Transpose();
+    for (int c = 0; c < m; c++)
+        for (int r = 0; r < m; r++)
+            EXPECT_NEAR((r == c) ? 1.0 : 0.0, UUT(r, c), tol);
+    DMatrix<double> VTV = V.Transpose() * V;
+    for (int c = 0; c < n; c++)
+        for (int r = 0; r < n; r++)
+            EXPECT_NEAR((r == c) ? 1.0 : 0.0, VTV(r, c), tol);
+}
+
+TEST(SVD, DivideConquer)
+{
+    std::mt19937 gen(19);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    std::vector<std::pair<int, int>> sizes = { { 7, 5 }, { 300, 200 }, { 200, 300 }, { 150, 150 } };
+    for (auto const & size : sizes) {
+        int m = size.first, n = size.second;
+        DMatrix<double> A(m, n);
+        for (int i = 0; i < A.NumDatas(); i++)
+            A(i) = dist(gen);
+
+        SVD_DivideConquer<DMatrix<double>> svd(A, true, true);
+        svd.Iterate();
+        CheckSVD(A, svd, 1e-10);
+
+        // 奇异值的平方为 A^T A 的特征值, 不要奇异向量时结果相同
+        DMatrix<double> ATA = A.Transpose() * A;
+        SymmetricEigen<DMatrix<double>> eig(ATA, false);
+        SVD_DivideConquer<DMatrix<double>> values(A, false, false);
+        values.Iterate();
+        DMatrix<double> S1 = svd.Sigma(), S2 = values.Sigma();
+        for (int i = 0; i < std::min(m, n); i++) {
+            EXPECT_NEAR(eig.EigenValues()[n - 1 - i], S1(i, i) * S1(i, i), 1e-10);
+            EXPECT_NEAR(S1(i, i), S2(i, i), 1e-10);
+        }
+    }
+
+    // 重复的奇异值和秩亏的矩阵, 合并时需要收缩
+    {
+        int n = 120;
+        DMatrix<double> X(n, n), Y(n, n);
+        for (int i = 0; i < X.NumDatas(); i++) {
+            X(i) = dist(gen);
+            Y(i) = dist(gen);
+        }
+        QR_Householder<DMatrix<double>> qx(X), qy(Y);
+        DMatrix<double> D(n, n);
+        for (int c = 0; c < n; c++)
+            for (int r = 0; r < n; r++)
+                D(r, c) = 0;
+        for (int i = 0; i < n; i++)
+            D(i, i) = (i < 40) ? 2.0 : ((i < 80) ? 1.0 : 0.0);
+        DMatrix<double> A = qx.Q() * D * qy.Q().Transpose();
+
+        SVD_DivideConquer<DMatrix<double>> svd(A, true, true);
+        svd.Iterate();
+        CheckSVD(A, svd, 1e-10);
+        DMatrix<double> S = svd.Sigma();
+        for (int i = 0; i < n; i++)
+            EXPECT_NEAR(D(i, i), S(i, i), 1e-10);
+    }
+
+    // 直接求解二对角矩阵, 很小的叶子使得合并的层数更多, 对角线上有 0
+    {
+        int n = 97;
+        std::vector<double> d(n), e(n), d0, e0;
+        for (int i = 0; i < n; i++) {
+            d[i] = (i % 17 == 5) ? 0.0 : dist(gen);
+            e[i] = (i % 23 == 7) ? 0.0 : dist(gen);
+        }
+        d0 = d;
+        e0 = e;
+        DMatrix<double> U(n, n), V(n, n);
+        BidiagonalDivideConquer(n, d.data(), e.data(), U.StorBegin(), n, V.StorBegin(), n, 4);
+
+        // B V = U diag(d)
+        for (int c = 0; c < n; c++)
+            for (int r = 0; r < n; r++) {
+                double bv = d0[r] * V(r, c) + ((r + 1 < n) ? e0[r] * V(r + 1, c) : 0.0);
+                EXPECT_NEAR(bv, U(r, c) * d[c], 1e-12);
+            }
+        DMatrix<double> UTU = U.Transpose() * U;
+        DMatrix<double> VTV = V.Transpose() * V;
+        for (int c = 0; c < n; c++)
+            for (int r = 0; r < n; r++) {
+                EXPECT_NEAR((r == c) ? 1.0 : 0.0, UTU(r, c), 1e-12);
+                EXPECT_NEAR((r == c) ? 1.0 : 0.0, VTV(r, c), 1e-12);
+            }
+    }
+}
+
+TEST(SVD, Jacobi)
+{
+    std::mt19937 gen(20);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    std::vector<std::pair<int, int>> sizes = { { 7, 5 }, { 5, 7 }, { 1, 4 }, { 120, 80 }, { 80, 120 }, { 101, 101 } };
+    for (auto const & size : sizes) {
+        int m = size.first, n = size.second;
+        DMatrix<double> A(m, n);
+        for (int i = 0; i < A.NumDatas(); i++)
+            A(i) = dist(gen);
+
+        SVD_Jacobi<DMatrix<double>> svd(A, true, true);
+        svd.Iterate();
+        CheckSVD(A, svd, 1e-10);
+
+        SVD_DivideConquer<DMatrix<double>> dc(A, false, false);
+        dc.Iterate();
+        SVD_Jacobi<DMatrix<double>> values(A, false, false);
+        values.Iterate();
+        DMatrix<double> S1 = svd.Sigma(), S2 = values.Sigma(), S3 = dc.Sigma();
+        for (int i = 0; i < std::min(m, n); i++) {
+            EXPECT_NEAR(S3(i, i), S1(i, i), 1e-10);
+            EXPECT_NEAR(S1(i, i), S2(i, i), 1e-12);
+        }
+    }
+
+    // 秩亏的矩阵, 需要补全左奇异向量
+    {
+        int m = 60, n = 40;
+        DMatrix<double> X(m, 10), Y(10, n);
+        for (int i = 0; i < X.NumDatas(); i++)
+            X(i) = dist(gen);
+        for (int i = 0; i < Y.NumDatas(); i++)
+            Y(i) = dist(gen);
+        DMatrix<double> A = X * Y;
+        SVD_Jacobi<DMatrix<double>> svd(A, true, true);
+        svd.Iterate();
+        CheckSVD(A, svd, 1e-10);
+        DMatrix<double> S = svd.Sigma();
+        for (int i = 10; i < n; i++)
+            EXPECT_NEAR(0.0, S(i, i), 1e-12);
+    }
+
+    // A = B D, B = Q R 的条件数较小, D 的对角元素从 1 到 1e-29 分级,
+    // 奇异值之积为 |det A| = prod(R_ii) prod(D_ii), 很小的奇异值也应有较高的相对精度
+    {
+        int n = 30;
+        DMatrix<double> X(n, n), R(n, n), D(n, n);
+        for (int i = 0; i < X.NumDatas(); i++)
+            X(i) = dist(gen);
+        QR_Householder<DMatrix<double>> qx(X);
+        double logdet = 0;
+        for (int c = 0; c < n; c++)
+            for (int r = 0; r < n; r++) {
+                R(r, c) = (r < c) ? 0.1 * dist(gen) : 0.0;
+                D(r, c) = 0.0;
+            }
+        for (int i = 0; i < n; i++) {
+            R(i, i) = 1.5 + 0.5 * dist(gen);
+            D(i, i) = std::pow(10.0, -i);
+            logdet += std::log(R(i, i)) + std::log(D(i, i));
+        }
+        DMatrix<double> A = qx.Q() * R * D;
+
+        SVD_Jacobi<DMatrix<double>> svd(A, false, false);
+        svd.Iterate();
+        DMatrix<double> S = svd.Sigma();
+        double logprod = 0;
+        for (int i = 0; i < n; i++)
+            logprod += std::log(S(i, i));
+        EXPECT_NEAR(logdet, logprod, 1e-10);
+        EXPECT_GT(S(n - 1, n - 1), 1e-31);
+    }
+}
+
+TEST(SVD, Randomized)
+{
+    std::mt19937 gen(21);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    // 秩为 20 的矩阵, 取 k = 20 时精确重构
+    for (auto const & size : std::vector<std::pair<int, int>>{ { 400, 150 }, { 150, 400 } }) {
+        int m = size.first, n = size.second, rank = 20;
+        DMatrix<double> X(m, rank), Y(rank, n);
+        for (int i = 0; i < X.NumDatas(); i++)
+            X(i) = dist(gen);
+        for (int i = 0; i < Y.NumDatas(); i++)
+            Y(i) = dist(gen);
+        DMatrix<double> A = X * Y;
+
+        SVD_Randomized<DMatrix<double>> rsvd(A, rank);
+        DMatrix<double> U = rsvd.U(), S = rsvd.Sigma(), V = rsvd.V();
+        EXPECT_EQ(m, U.Rows());
+        EXPECT_EQ(rank, U.Cols());
+        EXPECT_EQ(n, V.Rows());
+        EXPECT_EQ(rank, V.Cols());
+
+        SVD_DivideConquer<DMatrix<double>> dc(A, false, false);
+        dc.Iterate();
+        DMatrix<double> S0 = dc.Sigma();
+        for (int i = 0; i < rank; i++)
+            EXPECT_NEAR(S0(i, i), S(i, i), 1e-9 * S0(0, 0));
+
+        DMatrix<double> UTU = U.Transpose() * U;
+        DMatrix<double> VTV = V.Transpose() * V;
+        for (int c = 0; c < rank; c++)
+            for (int r = 0; r < rank; r++) {
+                EXPECT_NEAR((r == c) ? 1.0 : 0.0, UTU(r, c), 1e-10);
+                EXPECT_NEAR((r == c) ? 1.0 : 0.0, VTV(r, c), 1e-10);
+            }
+
+        DMatrix<double> L = rsvd.LowRank();
+        for (int i = 0; i < A.NumDatas(); i++)
+            EXPECT_NEAR(A(i), L(i), 1e-9);
+    }
+
+    // 奇异值按 0.8^i 衰减, 秩 k 近似的误差接近最优的 sigma_{k+1}
+    {
+        int m = 300, n = 200, k = 10;
+        DMatrix<double> X(m, n), Y(n, n), D(n, n);
+        for (int i = 0; i < X.NumDatas(); i++)
+            X(i) = dist(gen);
+        for (int i = 0; i < Y.NumDatas(); i++)
+            Y(i) = dist(gen);
+        QR_Householder<DMatrix<double>> qx(X), qy(Y);
+        for (int c = 0; c < n; c++)
+            for (int r = 0; r < n; r++)
+                D(r, c) = (r == c) ? std::pow(0.8, r) : 0.0;
+        DMatrix<double> Q = qx.Q();
+        DMatrix<double> A = Q.SubMatrix(0, 0, m, n) * D * qy.Q().Transpose();
+
+        SVD_Randomized<DMatrix<double>> rsvd(A, k, 10, 2);
+        DMatrix<double> S = rsvd.Sigma();
+        for (int i = 0; i < k; i++)
+            EXPECT_NEAR(D(i, i), S(i, i), 1e-6);
+
+        DMatrix<double> E = A - rsvd.LowRank();
+        SVD_DivideConquer<DMatrix<double>> err(E, false, false);
+        err.Iterate();
+        EXPECT_LT(err.Sigma()(0, 0), 1.01 * D(k, k));
+    }
+}
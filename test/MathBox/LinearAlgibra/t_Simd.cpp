@@ -0,0 +1,141 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename Mat>
+void RandomFill(Mat & A, std::mt19937 & gen)
+{
+    std::uniform_real_distribution<double> dist(0.5, 2.0);
+    std::bernoulli_distribution sign(0.5);
+    for (int i = 0; i < A.NumDatas(); i++)
+        A(i) = sign(gen) ? dist(gen) : -dist(gen);
+}
+
+template <typename MatA, typename MatB>
+bool IsClose(MatA const & A, MatB const & B, double tol)
+{
+    if (A.Rows() != B.Rows() || A.Cols() != B.Cols())
+        return false;
+    for (int r = 0; r < A.Rows(); r++)
+        for (int c = 0; c < A.Cols(); c++)
+            if (std::abs(A(r, c) - B(r, c)) > tol)
+                return false;
+    return true;
+}
+
+//! 在当前的 SIMD 级别下, 与子阵视图走的逐元素通用实现对比
+template <typename Scalar>
+void CheckSimdKernels(int m, int n, double tol)
+{
+    std::mt19937 gen(m * 131 + n);
+    DMatrix<Scalar> A(m, n), B(m, n), R(m, n), E(m, n);
+    RandomFill(A, gen);
+    RandomFill(B, gen);
+    auto a = A.SubMatrix(0, 0, m, n);
+    auto b = B.SubMatrix(0, 0, m, n);
+    auto e = E.SubMatrix(0, 0, m, n);
+
+    EXPECT_TRUE(Add(A, B, R));
+    EXPECT_TRUE(Add(a, b, e));
+    EXPECT_TRUE(IsClose(R, E, tol));
+
+    EXPECT_TRUE(Sub(A, B, R));
+    EXPECT_TRUE(Sub(a, b, e));
+    EXPECT_TRUE(IsClose(R, E, tol));
+
+    EXPECT_TRUE(PointwiseMultiply(A, B, R));
+    EXPECT_TRUE(PointwiseMultiply(a, b, e));
+    EXPECT_TRUE(IsClose(R, E, tol));
+
+    EXPECT_TRUE(PointwiseDivision(A, B, R));
+    EXPECT_TRUE(PointwiseDivision(a, b, e));
+    EXPECT_TRUE(IsClose(R, E, tol));
+
+    EXPECT_TRUE(ScalarMultiply(Scalar(-1.5), A, R));
+    EXPECT_TRUE(ScalarMultiply(Scalar(-1.5), a, e));
+    EXPECT_TRUE(IsClose(R, E, tol));
+
+    R = B;
+    E = B;
+    EXPECT_TRUE(Saxpy(Scalar(0.25), A, R));
+    EXPECT_TRUE(Saxpy(Scalar(0.25), a, e));
+    EXPECT_TRUE(IsClose(R, E, tol));
+
+    // 原位计算
+    R = A;
+    EXPECT_TRUE(Add(R, B, R));
+    EXPECT_TRUE(Add(a, b, e));
+    EXPECT_TRUE(IsClose(R, E, tol));
+
+    // 归约的求和顺序不同, 按元素数量放宽误差
+    double rtol = tol * m * n;
+    EXPECT_NEAR(A.Dot(B), a.Dot(b), rtol);
+    EXPECT_NEAR(A.SquaredNorm(), a.SquaredNorm(), rtol);
+    EXPECT_NEAR(A.PNorm(1), a.PNorm(1), rtol);
+    EXPECT_NEAR(A.PNorm(2), a.PNorm(2), rtol);
+    EXPECT_NEAR(A.PNorm(3), a.PNorm(3), rtol);
+    EXPECT_EQ(A.InftyNorm(), a.InftyNorm());
+}
+
+TEST(Simd, Levels)
+{
+    ESimdLevel detected = DetectSimdLevel();
+    std::vector<ESimdLevel> levels = {
+        ESimdLevel::eScalar, ESimdLevel::eSSE2, ESimdLevel::eAVX2, ESimdLevel::eAVX512
+    };
+
+    // 尺寸覆盖不足一个向量, 主循环和各种长度的尾部
+    std::vector<std::pair<int, int>> sizes = { {3, 5}, {4, 5}, {17, 3}, {31, 33}, {300, 301} };
+    for (auto level : levels) {
+        SetSimdLevel(level);
+        EXPECT_EQ(std::min(level, detected), SimdLevel());
+        for (auto & s : sizes) {
+            CheckSimdKernels<double>(s.first, s.second, 1e-12);
+            CheckSimdKernels<float>(s.first, s.second, 1e-4);
+        }
+    }
+    SetSimdLevel(detected);
+}
+
+TEST(Simd, Layout)
+{
+    std::mt19937 gen(7);
+    int m = 37, n = 29;
+    DMatrix<double> A(m, n), B(m, n), R(m, n);
+    DMatrix<double, eRowMajor> Br(m, n), Rr(m, n);
+    RandomFill(A, gen);
+    RandomFill(B, gen);
+    for (int r = 0; r < m; r++)
+        for (int c = 0; c < n; c++)
+            Br(r, c) = B(r, c);
+
+    // 存储顺序不同时走逐元素的实现, 结果按行列对应
+    EXPECT_TRUE(Add(A, Br, R));
+    EXPECT_TRUE(Add(A, B, Rr));
+    for (int r = 0; r < m; r++)
+        for (int c = 0; c < n; c++) {
+            EXPECT_DOUBLE_EQ(A(r, c) + B(r, c), R(r, c));
+            EXPECT_DOUBLE_EQ(A(r, c) + B(r, c), Rr(r, c));
+        }
+
+    // 尺寸不一致
+    DMatrix<double> C(n, m);
+    EXPECT_FALSE(PointwiseMultiply(A, C, R));
+    EXPECT_FALSE(PointwiseDivision(A, C, R));
+
+    // 数据视图与矩阵混用
+    std::vector<double> buf(m * n, 1.0);
+    DMatrixView<double> V(buf.data(), m, n);
+    EXPECT_TRUE(Saxpy(2.0, A, V));
+    for (int i = 0; i < m * n; i++)
+        EXPECT_DOUBLE_EQ(1.0 + 2.0 * A(i), buf[i]);
+}
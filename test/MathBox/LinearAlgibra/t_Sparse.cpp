@@ -0,0 +1,310 @@
+#include <iostream>
+
+#include <XiaoTuDataBox/Utils.hpp>
+#include <XiaoTuMathBox/LinearAlgibra/LinearAlgibra.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace xiaotu;
+
+template <typename MatA, typename MatB>
+bool IsClose(MatA const & A, MatB const & B, double tol)
+{
+    if (A.Rows() != B.Rows() || A.Cols() != B.Cols())
+        return false;
+    for (int r = 0; r < A.Rows(); r++)
+        for (int c = 0; c < A.Cols(); c++)
+            if (std::abs(A(r, c) - B(r, c)) > tol)
+                return false;
+    return true;
+}
+
+//! 随机的 m x n 稀疏矩阵, 每行约 per 个非零元素, 其中一部分重复添加
+SparseTriplets<double> RandomTriplets(int m, int n, int per, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> col(0, n - 1);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    SparseTriplets<double> t(m, n, m * per);
+    for (int r = 0; r < m; r++) {
+        if (r % 7 == 3)
+            continue;
+        for (int k = 0; k < per; k++)
+            t.Add(r, col(gen), dist(gen));
+    }
+    return t;
+}
+
+TEST(Sparse, Triplets)
+{
+    SparseTriplets<double> t(3, 4);
+    t.Add(2, 1, 1.0);
+    t.Add(0, 3, 2.0);
+    t.Add(2, 1, 0.5);
+    t.Add(0, 0, -1.0);
+    t.Add(1, 2, 0.0);
+
+    SparseCSR<double> R(t);
+    SparseCSC<double> C(t);
+    EXPECT_EQ(4, R.NonZeros());
+    EXPECT_EQ(4, C.NonZeros());
+    EXPECT_DOUBLE_EQ(1.5, R(2, 1));
+    EXPECT_DOUBLE_EQ(1.5, C(2, 1));
+    EXPECT_DOUBLE_EQ(2.0, R(0, 3));
+    EXPECT_DOUBLE_EQ(0.0, R(1, 1));
+    EXPECT_DOUBLE_EQ(0.0, C(1, 0));
+
+    DMatrix<double> D(3, 4);
+    D(0, 0) = -1;
+    D(0, 3) = 2;
+    D(2, 1) = 1.5;
+    EXPECT_TRUE(IsClose(R.ToDense(), D, 0));
+    EXPECT_TRUE(IsClose(C.ToDense(), D, 0));
+
+    // 行内按列号升序
+    int const * outer = R.OuterIndex();
+    int const * inner = R.InnerIndex();
+    EXPECT_EQ(0, outer[0]);
+    EXPECT_EQ(2, outer[1]);
+    EXPECT_EQ(0, inner[0]);
+    EXPECT_EQ(3, inner[1]);
+}
+
+TEST(Sparse, Convert)
+{
+    SparseTriplets<double> t = RandomTriplets(57, 43, 4, 7);
+    SparseCSR<double> R(t);
+    SparseCSC<double> C(t);
+    DMatrix<double> D = R.ToDense();
+
+    SparseCSC<double> RC(R);
+    SparseCSR<double> CR(C);
+    EXPECT_EQ(R.NonZeros(), RC.NonZeros());
+    EXPECT_TRUE(IsClose(RC.ToDense(), D, 0));
+    EXPECT_TRUE(IsClose(CR.ToDense(), D, 0));
+    EXPECT_TRUE(IsClose(R.Transpose().ToDense(), D.Transpose(), 0));
+    EXPECT_TRUE(IsClose(C.Transpose().ToDense(), D.Transpose(), 0));
+
+    SparseCSR<double> F = SparseCSR<double>::FromDense(D);
+    EXPECT_EQ(R.NonZeros(), F.NonZeros());
+    EXPECT_TRUE(IsClose(F.ToDense(), D, 0));
+}
+
+TEST(Sparse, Multiply)
+{
+    SetNumThreads(4);
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    // 包括超过并行阈值的尺寸, 以及列数少于线程数时按私有缓存归约的分散乘法
+    for (int m : { 31, 3000 }) {
+        int n = m + 17;
+        SparseTriplets<double> t = RandomTriplets(m, n, 12, m);
+        SparseCSR<double> R(t);
+        SparseCSC<double> C(t);
+        DMatrix<double> D = R.ToDense();
+
+        for (int k : { 1, 3, 40 }) {
+            DMatrix<double> B(n, k), Y0(m, k), Bt(k, m);
+            for (int i = 0; i < B.NumDatas(); i++)
+                B(i) = dist(gen);
+            for (int i = 0; i < Y0.NumDatas(); i++)
+                Y0(i) = dist(gen);
+            for (int i = 0; i < Bt.NumDatas(); i++)
+                Bt(i) = dist(gen);
+
+            DMatrix<double> ref = D * B;
+            EXPECT_TRUE(IsClose(R * B, ref, 1e-12));
+            EXPECT_TRUE(IsClose(C * B, ref, 1e-12));
+
+            DMatrix<double> Y = Y0;
+            Gemm(2.0, C, B, -0.5, Y);
+            DMatrix<double> expect = 2.0 * ref - 0.5 * Y0;
+            EXPECT_TRUE(IsClose(Y, expect, 1e-12));
+            Y = Y0;
+            Gemm(2.0, R, B, -0.5, Y);
+            EXPECT_TRUE(IsClose(Y, expect, 1e-12));
+
+            // 稠密矩阵乘以稀疏矩阵
+            DMatrix<double> ref2 = Bt * D;
+            EXPECT_TRUE(IsClose(Bt * R, ref2, 1e-12));
+            EXPECT_TRUE(IsClose(Bt * C, ref2, 1e-12));
+        }
+
+        // 向量, 以及带步长的子阵视图作为右端项
+        DMatrix<double> B(n + 5, 4), Y(m, 1);
+        for (int i = 0; i < B.NumDatas(); i++)
+            B(i) = dist(gen);
+        auto sub = B.SubMatrix(5, 1, n, 2);
+        DMatrix<double> ref = D * DMatrix<double>(sub);
+        EXPECT_TRUE(IsClose(R * sub, ref, 1e-12));
+        EXPECT_TRUE(IsClose(C * sub, ref, 1e-12));
+
+        SpMV(1.0, C, B.StorBegin() + 5 + B.Rows(), 1, 0.0, Y.StorBegin(), 1);
+        EXPECT_TRUE(IsClose(Y, ref.SubMatrix(0, 0, m, 1), 1e-12));
+        SpMV(1.0, R, B.StorBegin() + 5 + B.Rows(), 1, 0.0, Y.StorBegin(), 1);
+        EXPECT_TRUE(IsClose(Y, ref.SubMatrix(0, 0, m, 1), 1e-12));
+    }
+}
+
+TEST(Sparse, Serial)
+{
+    SetNumThreads(1);
+    SparseTriplets<double> t = RandomTriplets(2000, 1500, 10, 3);
+    SparseCSC<double> C(t);
+    DMatrix<double> D = C.ToDense();
+    DMatrix<double> B(1500, 2);
+    for (int i = 0; i < B.NumDatas(); i++)
+        B(i) = std::sin(i);
+    EXPECT_TRUE(IsClose(C * B, D * B, 1e-12));
+    SetNumThreads(4);
+}
+
+//! N x N 网格上的 5 点 Laplace 算子加上对角线的偏移, 对称正定; lower 时只存储下三角
+SparseCSC<double> GridLaplacian(int N, double shift, bool lower)
+{
+    int n = N * N;
+    SparseTriplets<double> t(n, n, 5 * n);
+    for (int y = 0; y < N; y++)
+        for (int x = 0; x < N; x++) {
+            int r = y * N + x;
+            t.Add(r, r, 4 + shift);
+            if (x + 1 < N) {
+                t.Add(r + 1, r, -1);
+                if (!lower)
+                    t.Add(r, r + 1, -1);
+            }
+            if (y + 1 < N) {
+                t.Add(r + N, r, -1);
+                if (!lower)
+                    t.Add(r, r + N, -1);
+            }
+        }
+    return SparseCSC<double>(t);
+}
+
+//! 随机图的 Laplace 矩阵加上随机的对角线, 对称正定, n > 5 时另有一个与所有节点相连的稠密行
+SparseCSC<double> RandomSPD(int n, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> node(0, n - 1);
+    std::uniform_real_distribution<double> dist(0.1, 1.0);
+    SparseTriplets<double> t(n, n);
+    auto edge = [&](int i, int j, double v) {
+        t.Add(i, i, v);
+        t.Add(j, j, v);
+        t.Add(i, j, -v);
+        t.Add(j, i, -v);
+    };
+    for (int i = 0; i < n; i++) {
+        t.Add(i, i, dist(gen));
+        for (int k = 0; k < 3; k++) {
+            int j = node(gen);
+            if (j != i)
+                edge(i, j, dist(gen));
+        }
+    }
+    for (int j = 0; j < n && n > 5; j++)
+        if (j != 5)
+            edge(5, j, 0.01);
+    return SparseCSC<double>(t);
+}
+
+TEST(Sparse, Amd)
+{
+    SparseCSC<double> A = RandomSPD(500, 3);
+    std::vector<int> perm;
+    AmdOrder(A.Rows(), A.OuterIndex(), A.InnerIndex(), perm);
+    std::vector<int> sorted(perm);
+    std::sort(sorted.begin(), sorted.end());
+    for (int i = 0; i < A.Rows(); i++)
+        EXPECT_EQ(i, sorted[i]);
+    // 稠密行排在最后
+    EXPECT_EQ(5, perm.back());
+
+    SparseCSC<double> G = GridLaplacian(30, 0, false);
+    SparseCholesky<double> natural, amd;
+    natural.Analyze(G, false);
+    amd.Analyze(G, true);
+    EXPECT_LT(amd.NonZerosL() * 2, natural.NonZerosL());
+}
+
+TEST(Sparse, Cholesky)
+{
+    for (int n : { 1, 7, 60, 400 }) {
+        SparseCSC<double> A = RandomSPD(n, n);
+        DMatrix<double> D = A.ToDense();
+        DMatrix<double> B(n, 3), X(n, 3), X0(n, 3);
+        for (int i = 0; i < B.NumDatas(); i++)
+            B(i) = std::sin(i + 1.0);
+        Cholesky<DMatrix<double>> dense(D);
+        dense.Solve(B, X0);
+
+        SparseCholesky<double> llt(A);
+        llt.Solve(B, X);
+        EXPECT_TRUE(IsClose(X, X0, 1e-9));
+        EXPECT_TRUE(IsClose(A * X, B, 1e-9));
+
+        SparseLDLT<double> ldlt(A);
+        ldlt.Solve(B, X);
+        EXPECT_TRUE(IsClose(X, X0, 1e-9));
+
+        // 原始顺序, 以及 b 和 x 是同一个对象
+        SparseCholesky<double> nat(A, false);
+        X = B;
+        nat.Solve(X, X);
+        EXPECT_TRUE(IsClose(X, X0, 1e-9));
+    }
+
+    // 只存储下三角与存储完整的矩阵结果相同
+    SparseCSC<double> full = GridLaplacian(40, 0.01, false);
+    SparseCSC<double> lower = GridLaplacian(40, 0.01, true);
+    DMatrix<double> B(1600, 1), X1(1600, 1), X2(1600, 1);
+    for (int i = 0; i < 1600; i++)
+        B(i) = std::cos(i);
+    SparseCholesky<double> f1(full), f2(lower);
+    f1.Solve(B, X1);
+    f2.Solve(B, X2);
+    EXPECT_EQ(f1.NonZerosL(), f2.NonZerosL());
+    EXPECT_TRUE(IsClose(X1, X2, 1e-12));
+    EXPECT_TRUE(IsClose(full * X1, B, 1e-9));
+}
+
+TEST(Sparse, Refactorize)
+{
+    SparseCSC<double> A = GridLaplacian(25, 0.5, true);
+    int n = A.Rows();
+    SparseCholesky<double> llt;
+    SparseLDLT<double> ldlt;
+    llt.Analyze(A);
+    ldlt.Analyze(A);
+
+    DMatrix<double> B(n, 2), X(n, 2);
+    for (int i = 0; i < B.NumDatas(); i++)
+        B(i) = std::sin(0.3 * i);
+    for (int it = 0; it < 3; it++) {
+        // 模式不变, 只改写数值, 例如每次迭代重新线性化的法方程
+        double * v = A.Values();
+        for (int p = 0; p < A.NonZeros(); p++)
+            v[p] *= 1.0 + 0.1 * it;
+        llt.Factorize(A);
+        ldlt.Factorize(A);
+
+        SparseCholesky<double> fresh(A);
+        DMatrix<double> X0(n, 2);
+        fresh.Solve(B, X0);
+        llt.Solve(B, X);
+        EXPECT_TRUE(IsClose(X, X0, 1e-12));
+        ldlt.Solve(B, X);
+        EXPECT_TRUE(IsClose(X, X0, 1e-10));
+    }
+
+    // 非正定
+    A.Values()[0] = -1;
+    EXPECT_THROW(llt.Factorize(A), std::runtime_error);
+    EXPECT_THROW(ldlt.Factorize(A), std::runtime_error);
+}